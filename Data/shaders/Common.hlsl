@@ -113,6 +113,15 @@ float3 normal_decode(float3 normal)	{ return normalize(normal); }
 // No encoding required
 float3 normal_encode(float3 normal)	{ return normalize(normal); }
 
+// Quantized vertices store their normals and tangents as two snorm components each
+float3 octahedral_decode(float2 value)
+{
+	float3 direction	= float3(value.x, value.y, 1.0f - abs(value.x) - abs(value.y));
+	float fold			= saturate(-direction.z);
+	direction.xy		+= direction.xy >= 0.0f ? -fold : fold;
+	return normalize(direction);
+}
+
 /*------------------------------------------------------------------------------
 							[DEPTH/POS]
 ------------------------------------------------------------------------------*/
@@ -44,6 +44,13 @@ struct Vertex_PosUvNorTan
     float3 tangent		: TANGENT0;
 };
 
+struct Vertex_PosUvNorTan_Quantized
+{
+	float4 position 		: POSITION0; // within the model's quantization bounds, the transform maps it back to object space
+    float2 uv 				: TEXCOORD0;
+    float4 normal_tangent	: NORMAL0;	 // octahedral encoded
+};
+
 struct Pixel_Pos
 {
     float4 position : SV_POSITION;
@@ -55,8 +55,18 @@ struct PixelOutputType
 	float2 velocity	: SV_Target3;
 };
 
+#if VERTEX_QUANTIZED
+PixelInputType mainVS(Vertex_PosUvNorTan_Quantized input_quantized)
+{
+	Vertex_PosUvNorTan input;
+	input.position	= input_quantized.position;
+	input.uv		= input_quantized.uv;
+	input.normal	= octahedral_decode(input_quantized.normal_tangent.xy);
+	input.tangent	= octahedral_decode(input_quantized.normal_tangent.zw);
+#else
 PixelInputType mainVS(Vertex_PosUvNorTan input)
 {
+#endif
     PixelInputType output;
     
     input.position.w 			= 1.0f;	
@@ -127,8 +137,10 @@ PixelOutputType mainPS(PixelInputType input)
 	#endif
 	
 	#if NORMAL_MAP
-		// Get tangent space normal and apply intensity
-		float3 tangent_normal 	= normalize(unpack(texNormal.Sample(sampler_anisotropic_wrap, texCoords).rgb));
+		// Get tangent space normal (z is reconstructed, since BC5 normal maps only store xy) and apply intensity
+		float3 tangent_normal;
+		tangent_normal.xy 		= unpack(texNormal.Sample(sampler_anisotropic_wrap, texCoords).rg);
+		tangent_normal.z 		= sqrt(saturate(1.0f - dot(tangent_normal.xy, tangent_normal.xy)));
 		tangent_normal.xy 		*= saturate(normal_intensity);
 		normal 					= normalize(mul(tangent_normal, TBN).xyz); // Transform to world space
 	#endif
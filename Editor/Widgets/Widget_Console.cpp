@@ -88,6 +88,7 @@ void Widget_Console::Tick()
 
 	// Content
 	ImGui::BeginChild("scrolling", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+    unique_lock<mutex> lock(m_mutex_logs);
 	for (auto& log : m_logs)
 	{
 		if (!_Widget_Console::log_filter.PassFilter(log.text.c_str()))
@@ -100,6 +101,7 @@ void Widget_Console::Tick()
 			ImGui::PopStyleColor();
 		}
 	}
+    lock.unlock();
 
 	if (_Widget_Console::scroll_to_bottom)
 	{
@@ -112,6 +114,8 @@ void Widget_Console::Tick()
 
 void Widget_Console::AddLogPackage(const LogPackage& package)
 {
+    lock_guard<mutex> lock(m_mutex_logs);
+
     // Save to deque
 	m_logs.push_back(package);
 	if (static_cast<uint32_t>(m_logs.size()) > m_max_log_entries)
@@ -131,6 +135,8 @@ void Widget_Console::AddLogPackage(const LogPackage& package)
 
 void Widget_Console::Clear()
 {
+    lock_guard<mutex> lock(m_mutex_logs);
+
 	m_logs.clear();
 	m_logs.shrink_to_fit();
 
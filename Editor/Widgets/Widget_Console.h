@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <memory>
 #include <functional>
 #include <deque>
+#include <mutex>
 #include "Logging/ILogger.h"
 #include "type_traits"        // for forward, move
 #include "xstring"            // for string
@@ -70,6 +71,7 @@ public:
 private:
 	std::shared_ptr<EngineLogger> m_logger;
 	std::deque<LogPackage> m_logs;
+    std::mutex m_mutex_logs; // the engine logs from its own thread
     bool m_visibility[3]        = { true, true, true };
     uint32_t m_count[3]         = { 0, 0, 0 };
     uint32_t m_max_log_entries  = 1000;
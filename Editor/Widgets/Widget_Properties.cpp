@@ -537,7 +537,9 @@ void Widget_Properties::ShowCollider(shared_ptr<Collider>& collider) const
 			"Cylinder",
 			"Capsule",
 			"Cone",
-			"Mesh"
+			"Mesh",
+			"Mesh (Decomposed)",
+			"Mesh (Static)"
 		};
 		const char* shape_char_ptr		= type[static_cast<int>(collider->GetShapeType())];
 		bool optimize					= collider->GetOptimize();
@@ -585,7 +587,7 @@ void Widget_Properties::ShowCollider(shared_ptr<Collider>& collider) const
 		ImGui::SameLine();								ImGui::PushID("colSizeZ"); ImGui::InputFloat("Z", &collider_bounding_box.z, step, step_fast, precision, input_text_flags); ImGui::PopID();
 
 		// Optimize
-		if (collider->GetShapeType() == ColliderShape_Mesh)
+		if (collider->GetShapeType() == ColliderShape_Mesh || collider->GetShapeType() == ColliderShape_MeshDecomposed)
 		{
 			ImGui::Text("Optimize");
 			ImGui::SameLine(ComponentProperty::g_column); ImGui::Checkbox("##colliderOptimize", &optimize);
@@ -743,7 +745,11 @@ void Widget_Properties::ShowMaterial(shared_ptr<Material>& material) const
                     {
                         ImGui::SameLine();
                         ImGui::PushID(static_cast<int>(ImGui::GetCursorPosX() + ImGui::GetCursorPosY()));
-                        ImGui::DragFloat("", &material->GetMultiplier(texture_type), 0.004f, 0.0f, 1.0f);
+                        auto multiplier = material->GetMultiplier(texture_type);
+                        if (ImGui::DragFloat("", &multiplier, 0.004f, 0.0f, 1.0f))
+                        {
+                            material->SetMultiplier(texture_type, multiplier);
+                        }
                         ImGui::PopID();
                     }
                 };
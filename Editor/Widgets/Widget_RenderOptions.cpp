@@ -65,6 +65,7 @@ void Widget_RenderOptions::Tick()
         auto do_sharperning             = m_renderer->IsFlagSet(Render_Sharpening_LumaSharpen);
         auto do_chromatic_aberration    = m_renderer->IsFlagSet(Render_ChromaticAberration);
         auto do_dithering               = m_renderer->IsFlagSet(Render_Dithering);
+        auto do_meshlet_culling         = m_renderer->IsFlagSet(Render_MeshletCulling);
         auto resolution_shadow          = static_cast<int>(m_renderer->GetShadowResolution());
 
         // Display
@@ -169,6 +170,16 @@ void Widget_RenderOptions::Tick()
 
             // Shadow resolution
             ImGui::InputInt("Shadow Resolution", &resolution_shadow, 1);
+            ImGui::Separator();
+
+            // Level of detail
+            render_option_float("##lod_option_1", "LOD Error", Option_Value_Lod_Error, "The screen space error (in pixels) that a level of detail is allowed to have");
+            ImGui::SameLine(); render_option_float("##lod_option_2", "LOD Shadow Bias", Option_Value_Lod_Shadow_Bias, "Multiplies the allowed error for shadow maps");
+            ImGui::Separator();
+
+            // Meshlet culling
+            ImGui::Checkbox("Meshlet Culling", &do_meshlet_culling);
+            ImGuiEx::Tooltip("Skips the parts of large meshes that are off screen or facing away from the camera");
         }
 
         #define set_flag_if(flag, value) value? m_renderer->SetFlag(flag) : m_renderer->UnsetFlag(flag)
@@ -186,6 +197,7 @@ void Widget_RenderOptions::Tick()
         set_flag_if(Render_Sharpening_LumaSharpen,  do_sharperning);
         set_flag_if(Render_ChromaticAberration,     do_chromatic_aberration);
         set_flag_if(Render_Dithering,               do_dithering);
+        set_flag_if(Render_MeshletCulling,          do_meshlet_culling);
     }
 
     if (ImGui::CollapsingHeader("Debug", ImGuiTreeNodeFlags_None))
@@ -47,7 +47,7 @@ namespace Spartan
 	Audio::~Audio()
 	{
 		// Unsubscribe from events
-		UNSUBSCRIBE_FROM_EVENT(Event_World_Unload, [this](Variant) { m_listener = nullptr; });
+		UNSUBSCRIBE_FROM_EVENT(Event_World_Unload);
 
 		if (!m_system_fmod)
 			return;
@@ -132,7 +132,7 @@ namespace Spartan
         m_profiler = m_context->GetSubsystem<Profiler>().get();
 
         // Subscribe to events
-        SUBSCRIBE_TO_EVENT(Event_World_Unload, [this](Variant) { m_listener = nullptr; });
+        SUBSCRIBE_TO_EVENT(Event_World_Unload, [this](const EventData&) { m_listener = nullptr; });
    
         return true;
     }
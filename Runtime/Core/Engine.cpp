@@ -86,6 +86,9 @@ namespace Spartan
         Timer* timer = m_context->GetSubsystem<Timer>().get();
         m_context->Tick(Tick_Variable, static_cast<float>(timer->GetDeltaTimeSec()));
         m_context->Tick(Tick_Smoothed, static_cast<float>(timer->GetDeltaTimeSmoothedSec()));
+
+        // Deliver the events that were deferred to the end of the frame
+        EventSystem::Get().FireDeferredEvents();
 	}
 
     void Engine::SetWindowData(WindowData& window_data)
@@ -22,8 +22,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES ===============
-#include <map>
+#include <array>
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <typeinfo>
 #include <functional>
 #include "../Core/Variant.h"
 //==========================
@@ -31,12 +35,16 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 /*
 HOW TO USE
 =================================================================================
-To subscribe a function to an event		-> SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
-To unsubscribe a function from an event	-> SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
-To fire an event						-> FIRE_EVENT(EVENT_ID);
-To fire an event with data				-> FIRE_EVENT_DATA(EVENT_ID, Variant);
-
-Note: Currently, this is a blocking event system
+To subscribe a function to an event		    -> SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
+To unsubscribe from an event			    -> UNSUBSCRIBE_FROM_EVENT(EVENT_ID);
+To fire an event						    -> FIRE_EVENT(EVENT_ID);
+To fire an event with data				    -> FIRE_EVENT_DATA(EVENT_ID, Data);
+To fire an event at the end of the frame    -> FIRE_EVENT_DEFERRED(EVENT_ID);
+To fire an event with data at frame end	    -> FIRE_EVENT_DEFERRED_DATA(EVENT_ID, Data);
+
+Note: Immediate events are blocking and must be fired from the main thread. Deferred
+events can be fired from any thread, they are delivered once, at the end of the frame, 
+no matter how many times they were fired (the last data wins).
 =================================================================================
 */
 
@@ -52,29 +60,73 @@ enum Event_Type
 	Event_World_Resolve_Pending,	// The world should resolve
 	Event_World_Resolve_Complete,	// The world has finished resolving
 	Event_World_Stop,		        // The world should stop ticking
-	Event_World_Start		        // The world should start ticking
+	Event_World_Start,		        // The world should start ticking
+	Event_World_Ticked,		        // The world has finished ticking its entities
+    Event_Count
 };
 
-//= MACROS ====================================================================================================
-#define EVENT_HANDLER_EXPRESSION(expression)		[this](const Spartan::Variant& var)	{ ##expression }
-#define EVENT_HANDLER_EXPRESSION_STATIC(expression)	[](const Spartan::Variant& var)		{ ##expression }
+//= MACROS ===============================================================================================================
+#define EVENT_HANDLER_EXPRESSION(expression)		[this](const Spartan::EventData& data)	{ ##expression }
+#define EVENT_HANDLER_EXPRESSION_STATIC(expression)	[](const Spartan::EventData& data)		{ ##expression }
 
-#define EVENT_HANDLER(function)						[this](const Spartan::Variant& var)	{ function(); }
-#define EVENT_HANDLER_STATIC(function)				[](const Spartan::Variant& var)		{ function(); }
+#define EVENT_HANDLER(function)						[this](const Spartan::EventData& data)	{ function(); }
+#define EVENT_HANDLER_STATIC(function)				[](const Spartan::EventData& data)		{ function(); }
 
-#define EVENT_HANDLER_VARIANT(function)				[this](const Spartan::Variant& var)	{ function(var); }
-#define EVENT_HANDLER_VARIANT_STATIC(function)		[](const Spartan::Variant& var)		{ function(var); }
+#define EVENT_HANDLER_DATA(function)				[this](const Spartan::EventData& data)	{ function(data); }
+#define EVENT_HANDLER_DATA_STATIC(function)		    [](const Spartan::EventData& data)		{ function(data); }
 
 #define FIRE_EVENT(eventID)							Spartan::EventSystem::Get().Fire(eventID)
 #define FIRE_EVENT_DATA(eventID, data)				Spartan::EventSystem::Get().Fire(eventID, data)
+#define FIRE_EVENT_DEFERRED(eventID)				Spartan::EventSystem::Get().FireDeferred(eventID)
+#define FIRE_EVENT_DEFERRED_DATA(eventID, data)		Spartan::EventSystem::Get().FireDeferred(eventID, data)
 
-#define SUBSCRIBE_TO_EVENT(eventID, function)		Spartan::EventSystem::Get().Subscribe(eventID, function);
-#define UNSUBSCRIBE_FROM_EVENT(eventID, function)	Spartan::EventSystem::Get().Unsubscribe(eventID, function);
-//=============================================================================================================
+#define SUBSCRIBE_TO_EVENT(eventID, function)		Spartan::EventSystem::Get().Subscribe(eventID, function, this);
+#define UNSUBSCRIBE_FROM_EVENT(eventID)	            Spartan::EventSystem::Get().Unsubscribe(eventID, this);
+//========================================================================================================================
 
 namespace Spartan
 {
-	using subscriber = std::function<void(const Variant&)>;
+    // A typed event payload. Immediate events reference the data of the caller (no copies), 
+    // deferred events own a copy of it since the caller is long gone by the time they are delivered.
+    class EventData
+    {
+    public:
+        EventData() = default;
+
+        template<typename T, class = std::enable_if_t<!std::is_same_v<std::decay_t<T>, EventData>>>
+        EventData(const T& data)
+        {
+            m_data = &data;
+            m_type = &typeid(T);
+        }
+
+        template<typename T>
+        static EventData Copy(T data)
+        {
+            EventData event_data;
+            auto owned              = std::make_shared<T>(std::move(data));
+            event_data.m_data       = owned.get();
+            event_data.m_type       = &typeid(T);
+            event_data.m_data_owned = std::move(owned);
+            return event_data;
+        }
+
+        template<typename T>
+        const T& Get() const
+        {
+            SPARTAN_ASSERT(m_data != nullptr && *m_type == typeid(T));
+            return *static_cast<const T*>(m_data);
+        }
+
+        bool IsEmpty() const { return m_data == nullptr; }
+
+    private:
+        const void* m_data                  = nullptr;
+        const std::type_info* m_type        = nullptr;
+        std::shared_ptr<void> m_data_owned;
+    };
+
+	using subscriber = std::function<void(const EventData&)>;
 
 	class SPARTAN_CLASS EventSystem
 	{
@@ -85,44 +137,95 @@ namespace Spartan
 			return instance;
 		}
 
-		void Subscribe(const Event_Type event_id, subscriber&& function)
+        // Subscribers are expected to register during initialization, not while events are being delivered
+		void Subscribe(const Event_Type event_id, subscriber&& function, const void* owner = nullptr)
 		{
-			m_subscribers[event_id].push_back(std::forward<subscriber>(function));
+			m_subscribers[event_id].push_back({ std::forward<subscriber>(function), owner });
 		}
 
-		void Unsubscribe(const Event_Type event_id, subscriber&& function)
+        // Removes every subscription that the owner has for this event
+		void Unsubscribe(const Event_Type event_id, const void* owner)
 		{
-			const size_t function_adress	= *reinterpret_cast<long*>(reinterpret_cast<char*>(&function));
-			auto& subscribers				= m_subscribers[event_id];
+			auto& subscribers = m_subscribers[event_id];
 
 			for (auto it = subscribers.begin(); it != subscribers.end();)
 			{
-				const size_t subscriber_adress = *reinterpret_cast<long*>(reinterpret_cast<char*>(&(*it)));
-				if (subscriber_adress == function_adress)
-				{
-					it = subscribers.erase(it);
-					return;
-				}
+                it = (it->owner == owner) ? subscribers.erase(it) : it + 1;
 			}
 		}
 
-		void Fire(const Event_Type event_id, const Variant& data = 0)
+        // Immediate delivery
+		void Fire(const Event_Type event_id, const EventData& data = EventData())
 		{
-			if (m_subscribers.find(event_id) == m_subscribers.end())
-				return;
-
-			for (const auto& subscriber : m_subscribers[event_id])
+            const auto& subscribers = m_subscribers[event_id];
+			for (size_t i = 0; i < subscribers.size(); i++)
 			{
-				subscriber(data);
+				subscribers[i].function(data);
 			}
 		}
 
+        // End of frame delivery, callable from any thread
+        void FireDeferred(const Event_Type event_id)
+        {
+            m_deferred_mask.fetch_or(1ull << event_id, std::memory_order_relaxed);
+        }
+
+        template<typename T>
+        void FireDeferred(const Event_Type event_id, T data)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex_deferred);
+                m_deferred_data[event_id] = EventData::Copy(std::move(data));
+            }
+            FireDeferred(event_id);
+        }
+
+        // Delivers all deferred events, invoked by the engine at the end of each frame
+        void FireDeferredEvents()
+        {
+            const uint64_t mask = m_deferred_mask.exchange(0, std::memory_order_acquire);
+            if (mask == 0)
+                return;
+
+            for (uint32_t event_id = 0; event_id < Event_Count; event_id++)
+            {
+                if (!(mask & (1ull << event_id)))
+                    continue;
+
+                EventData data;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex_deferred);
+                    std::swap(data, m_deferred_data[event_id]);
+                }
+
+                Fire(static_cast<Event_Type>(event_id), data);
+            }
+        }
+
 		void Clear() 
 		{
-			m_subscribers.clear(); 
+            for (auto& subscribers : m_subscribers)
+            {
+                subscribers.clear();
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex_deferred);
+            m_deferred_mask = 0;
+            m_deferred_data = {};
 		}
 
 	private:
-		std::map<Event_Type, std::vector<subscriber>> m_subscribers;
+        static_assert(Event_Count <= 64, "The deferred event mask can't fit all events");
+
+        struct Subscription
+        {
+            subscriber function;
+            const void* owner;
+        };
+
+		std::array<std::vector<Subscription>, Event_Count> m_subscribers;
+        std::array<EventData, Event_Count> m_deferred_data;
+        std::atomic<uint64_t> m_deferred_mask = 0;
+        std::mutex m_mutex_deferred;
 	};
 }
@@ -384,6 +384,18 @@ namespace Spartan
 		}
 	}
 
+	uint64_t FileSystem::GetLastWriteTime(const string& file_path)
+	{
+		try
+		{
+			return static_cast<uint64_t>(last_write_time(file_path).time_since_epoch().count());
+		}
+		catch (filesystem_error&)
+		{
+			return 0;
+		}
+	}
+
     bool FileSystem::IsFile(const string& file_path)
     {
         if (IsEmptyOrWhitespace(file_path))
@@ -68,6 +68,7 @@ namespace Spartan
         static bool IsFile(const std::string& file_path);
 		static bool DeleteFile_(const std::string& file_path);
 		static bool CopyFileFromTo(const std::string& source, const std::string& destination);
+		static uint64_t GetLastWriteTime(const std::string& file_path); // 0 if it can't be queried
 
 		// Directory manipulation
 		static std::string GetFileNameFromFilePath(const std::string& file_path);
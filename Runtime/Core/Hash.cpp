@@ -0,0 +1,134 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ====
+#include <cstring>
+#include "Hash.h"
+//===============
+
+namespace Spartan
+{
+	static const uint64_t prime_1 = 11400714785074694791ULL;
+	static const uint64_t prime_2 = 14029467366897019727ULL;
+	static const uint64_t prime_3 = 1609587929392839161ULL;
+	static const uint64_t prime_4 = 9650029242287828579ULL;
+	static const uint64_t prime_5 = 2870177450012600261ULL;
+
+	static uint64_t rotate_left(const uint64_t value, const int bits)
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	static uint64_t read_64(const unsigned char* data)
+	{
+		uint64_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static uint32_t read_32(const unsigned char* data)
+	{
+		uint32_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static uint64_t round_lane(uint64_t accumulator, const uint64_t input)
+	{
+		accumulator += input * prime_2;
+		accumulator = rotate_left(accumulator, 31);
+		return accumulator * prime_1;
+	}
+
+	static uint64_t merge_round(uint64_t accumulator, const uint64_t value)
+	{
+		accumulator ^= round_lane(0, value);
+		return accumulator * prime_1 + prime_4;
+	}
+
+	uint64_t Hash::Compute(const void* data, const uint64_t size, const uint64_t seed /*= 0*/)
+	{
+		auto position	= static_cast<const unsigned char*>(data);
+		const auto end	= position + size;
+		uint64_t hash	= 0;
+
+		// Consume 32 byte stripes in four independent lanes
+		if (size >= 32)
+		{
+			uint64_t lane_1 = seed + prime_1 + prime_2;
+			uint64_t lane_2 = seed + prime_2;
+			uint64_t lane_3 = seed;
+			uint64_t lane_4 = seed - prime_1;
+
+			const auto limit = end - 32;
+			do
+			{
+				lane_1 = round_lane(lane_1, read_64(position));		position += 8;
+				lane_2 = round_lane(lane_2, read_64(position));		position += 8;
+				lane_3 = round_lane(lane_3, read_64(position));		position += 8;
+				lane_4 = round_lane(lane_4, read_64(position));		position += 8;
+			} while (position <= limit);
+
+			hash = rotate_left(lane_1, 1) + rotate_left(lane_2, 7) + rotate_left(lane_3, 12) + rotate_left(lane_4, 18);
+			hash = merge_round(hash, lane_1);
+			hash = merge_round(hash, lane_2);
+			hash = merge_round(hash, lane_3);
+			hash = merge_round(hash, lane_4);
+		}
+		else
+		{
+			hash = seed + prime_5;
+		}
+
+		hash += size;
+
+		// Consume the remainder
+		while (position + 8 <= end)
+		{
+			hash ^= round_lane(0, read_64(position));
+			hash = rotate_left(hash, 27) * prime_1 + prime_4;
+			position += 8;
+		}
+
+		if (position + 4 <= end)
+		{
+			hash ^= static_cast<uint64_t>(read_32(position)) * prime_1;
+			hash = rotate_left(hash, 23) * prime_2 + prime_3;
+			position += 4;
+		}
+
+		while (position < end)
+		{
+			hash ^= (*position) * prime_5;
+			hash = rotate_left(hash, 11) * prime_1;
+			position++;
+		}
+
+		// Avalanche
+		hash ^= hash >> 33;
+		hash *= prime_2;
+		hash ^= hash >> 29;
+		hash *= prime_3;
+		hash ^= hash >> 32;
+
+		return hash;
+	}
+}
@@ -0,0 +1,61 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ======
+#include <vector>
+#include <cstddef>
+//=================
+
+namespace Spartan
+{
+	// A non-owning view of contiguous memory (a subset of C++20's std::span, so it can be swapped for it later)
+	template<typename T>
+	class Span
+	{
+	public:
+		Span() = default;
+		Span(T* data, const size_t size) : m_data(data), m_size(size) {}
+
+		// From a span of a compatible type, e.g. Span<std::byte> to Span<const std::byte>
+		template<typename U>
+		Span(const Span<U>& other) : m_data(other.data()), m_size(other.size()) {}
+
+		template<typename U>
+		Span(std::vector<U>& vec) : m_data(vec.data()), m_size(vec.size()) {}
+
+		template<typename U>
+		Span(const std::vector<U>& vec) : m_data(vec.data()), m_size(vec.size()) {}
+
+		T* data() const						{ return m_data; }
+		size_t size() const					{ return m_size; }
+		size_t size_bytes() const			{ return m_size * sizeof(T); }
+		bool empty() const					{ return m_size == 0; }
+		T* begin() const					{ return m_data; }
+		T* end() const						{ return m_data + m_size; }
+		T& operator[](const size_t i) const	{ return m_data[i]; }
+
+	private:
+		T* m_data		= nullptr;
+		size_t m_size	= 0;
+	};
+}
@@ -22,12 +22,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES ==================
+#include <atomic>
 #include "../Core/EngineDefs.h"
 //=============================
 
 namespace Spartan
 {
-	static uint32_t g_id = 0;
+	static std::atomic<uint32_t> g_id = 0; // objects are created on worker threads too (e.g. worlds decode entities there)
 
 	class SPARTAN_CLASS Spartan_Object
 	{
@@ -30,6 +30,74 @@ using namespace std;
 
 namespace Spartan
 {
+	void FileStream_MemoryBuffer::SetWrite(vector<std::byte>* buffer)
+	{
+		m_buffer = buffer;
+		setp(nullptr, nullptr);
+	}
+
+	void FileStream_MemoryBuffer::SetRead(const std::byte* data, const uint64_t size)
+	{
+		m_buffer	= nullptr;
+		auto begin	= reinterpret_cast<char*>(const_cast<std::byte*>(data));
+		setg(begin, begin, begin + size);
+	}
+
+	streamsize FileStream_MemoryBuffer::xsputn(const char* data, const streamsize size)
+	{
+		if (!m_buffer)
+			return 0;
+
+		const auto bytes = reinterpret_cast<const std::byte*>(data);
+		m_buffer->insert(m_buffer->end(), bytes, bytes + size);
+		return size;
+	}
+
+	FileStream_MemoryBuffer::int_type FileStream_MemoryBuffer::overflow(const int_type c)
+	{
+		if (!m_buffer || traits_type::eq_int_type(c, traits_type::eof()))
+			return traits_type::eof();
+
+		m_buffer->emplace_back(static_cast<std::byte>(traits_type::to_char_type(c)));
+		return c;
+	}
+
+	FileStream_MemoryBuffer::pos_type FileStream_MemoryBuffer::seekoff(const off_type offset, const ios_base::seekdir direction, const ios_base::openmode mode)
+	{
+		// Writing, the end of the buffer is the only position (skipping forward pads with zeros)
+		if (m_buffer)
+		{
+			if (!(mode & ios_base::out) || direction == ios_base::beg || offset < 0)
+				return pos_type(off_type(-1));
+
+			m_buffer->resize(m_buffer->size() + offset);
+			return pos_type(static_cast<off_type>(m_buffer->size()));
+		}
+
+		// Reading
+		if (!(mode & ios_base::in))
+			return pos_type(off_type(-1));
+
+		off_type base = 0;
+		if (direction == ios_base::cur) base = gptr() - eback();
+		if (direction == ios_base::end) base = egptr() - eback();
+
+		const off_type position = base + offset;
+		if (position < 0 || position > egptr() - eback())
+			return pos_type(off_type(-1));
+
+		setg(eback(), eback() + position, egptr());
+		return pos_type(position);
+	}
+
+	FileStream_MemoryBuffer::pos_type FileStream_MemoryBuffer::seekpos(const pos_type position, const ios_base::openmode mode)
+	{
+		if (m_buffer)
+			return (static_cast<off_type>(position) == static_cast<off_type>(m_buffer->size())) ? position : pos_type(off_type(-1));
+
+		return seekoff(static_cast<off_type>(position), ios_base::beg, mode);
+	}
+
 	FileStream::FileStream(const string& path, uint32_t flags)
 	{
 		m_is_open	= false;
@@ -40,26 +108,41 @@ namespace Spartan
 		ios_flags		|= (flags & FileStream_Write)	? ios::out	: 0;
 		ios_flags		|= (flags & FileStream_Append)	? ios::app	: 0;
 
-		if (m_flags & FileStream_Write)
+		// Opening with both read and write flags, allows patching an existing file in place
+		if (!m_buffer_file.open(path, static_cast<ios_base::openmode>(ios_flags)))
 		{
-			out.open(path, ios_flags);
-			if (out.fail())
-			{
-				LOG_ERROR("Failed to open \"%s\" for writing", path.c_str());
-				return;
-			}
+			LOG_ERROR("Failed to open \"%s\" for %s", path.c_str(), (m_flags & FileStream_Write) ? "writing" : "reading");
+			return;
 		}
-		else if (m_flags & FileStream_Read)
+
+		if (m_flags & FileStream_Write)	out.rdbuf(&m_buffer_file);
+		if (m_flags & FileStream_Read)	in.rdbuf(&m_buffer_file);
+
+		m_is_open = true;
+	}
+
+	FileStream::FileStream(vector<std::byte>* buffer)
+	{
+		m_flags		= FileStream_Write;
+		m_is_open	= buffer != nullptr;
+
+		if (m_is_open)
 		{
-			in.open(path, ios_flags);
-			if(in.fail())
-			{
-				LOG_ERROR("Failed to open \"%s\" for reading", path.c_str());
-				return;
-			}
+			m_buffer_memory.SetWrite(buffer);
+			out.rdbuf(&m_buffer_memory);
 		}
+	}
 
-		m_is_open = true;
+	FileStream::FileStream(const std::byte* data, const uint64_t size)
+	{
+		m_flags		= FileStream_Read;
+		m_is_open	= data != nullptr || size == 0;
+
+		if (m_is_open)
+		{
+			m_buffer_memory.SetRead(data, size);
+			in.rdbuf(&m_buffer_memory);
+		}
 	}
 
 	FileStream::~FileStream()
@@ -72,12 +155,37 @@ namespace Spartan
 		if (m_flags & FileStream_Write)
 		{
 			out.flush();
-			out.close();
+		}
+
+		if (m_flags & FileStream_Read)
+		{
+			in.clear();
+		}
+
+		if (m_buffer_file.is_open())
+		{
+			m_buffer_file.close();
+		}
+
+		m_is_open = false;
+	}
+
+	uint64_t FileStream::GetPosition()
+	{
+		const auto position = (m_flags & FileStream_Write) ? out.tellp() : in.tellg();
+		return position < 0 ? 0 : static_cast<uint64_t>(position);
+	}
+
+	void FileStream::Seek(const uint64_t position)
+	{
+		if (m_flags & FileStream_Write)
+		{
+			out.seekp(static_cast<streamoff>(position));
 		}
 		else if (m_flags & FileStream_Read)
 		{
 			in.clear();
-			in.close();
+			in.seekg(static_cast<streamoff>(position));
 		}
 	}
 
@@ -107,6 +215,13 @@ namespace Spartan
 		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(RHI_Vertex_PosTexNorTan) * length);
 	}
 
+	void FileStream::Write(const vector<RHI_Vertex_PosTexNorTan_Quantized>& value)
+	{
+		const auto length = static_cast<uint32_t>(value.size());
+		Write(length);
+		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(RHI_Vertex_PosTexNorTan_Quantized) * length);
+	}
+
 	void FileStream::Write(const vector<uint32_t>& value)
 	{
 		const auto length = static_cast<uint32_t>(value.size());
@@ -114,6 +229,34 @@ namespace Spartan
 		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(uint32_t) * length);
 	}
 
+	void FileStream::Write(const vector<uint16_t>& value)
+	{
+		const auto length = static_cast<uint32_t>(value.size());
+		Write(length);
+		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(uint16_t) * length);
+	}
+
+	void FileStream::Write(const vector<uint64_t>& value)
+	{
+		const auto length = static_cast<uint32_t>(value.size());
+		Write(length);
+		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(uint64_t) * length);
+	}
+
+	void FileStream::Write(const vector<float>& value)
+	{
+		const auto length = static_cast<uint32_t>(value.size());
+		Write(length);
+		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(float) * length);
+	}
+
+	void FileStream::Write(const vector<Math::Vector3>& value)
+	{
+		const auto length = static_cast<uint32_t>(value.size());
+		Write(length);
+		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(Math::Vector3) * length);
+	}
+
 	void FileStream::Write(const vector<unsigned char>& value)
 	{
 		const auto size = static_cast<uint32_t>(value.size());
@@ -128,6 +271,11 @@ namespace Spartan
 		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(std::byte) * size);
 	}
 
+	void FileStream::Write(const std::byte* data, const uint64_t size)
+	{
+		out.write(reinterpret_cast<const char*>(data), static_cast<streamsize>(size));
+	}
+
 	void FileStream::Skip(uint32_t n)
 	{
 		// Set the seek cursor to offset n from the current position
@@ -137,7 +285,7 @@ namespace Spartan
 		}
 		else if (m_flags & FileStream_Read)
 		{
-			in.ignore(n, ios::cur);
+			in.seekg(n, ios::cur);
 		}
 	}
 
@@ -185,6 +333,22 @@ namespace Spartan
 		in.read(reinterpret_cast<char*>(vec->data()), sizeof(RHI_Vertex_PosTexNorTan) * length);
 	}
 
+	void FileStream::Read(vector<RHI_Vertex_PosTexNorTan_Quantized>* vec)
+	{
+		if (!vec)
+			return;
+
+		vec->clear();
+		vec->shrink_to_fit();
+
+		auto length = ReadAs<uint32_t>();
+
+		vec->reserve(length);
+		vec->resize(length);
+
+		in.read(reinterpret_cast<char*>(vec->data()), sizeof(RHI_Vertex_PosTexNorTan_Quantized) * length);
+	}
+
 	void FileStream::Read(vector<uint32_t>* vec)
 	{
 		if (!vec)
@@ -201,6 +365,70 @@ namespace Spartan
 		in.read(reinterpret_cast<char*>(vec->data()), sizeof(uint32_t) * length);
 	}
 
+	void FileStream::Read(vector<uint16_t>* vec)
+	{
+		if (!vec)
+			return;
+
+		vec->clear();
+		vec->shrink_to_fit();
+
+		auto length = ReadAs<uint32_t>();
+
+		vec->reserve(length);
+		vec->resize(length);
+
+		in.read(reinterpret_cast<char*>(vec->data()), sizeof(uint16_t) * length);
+	}
+
+	void FileStream::Read(vector<uint64_t>* vec)
+	{
+		if (!vec)
+			return;
+
+		vec->clear();
+		vec->shrink_to_fit();
+
+		auto length = ReadAs<uint32_t>();
+
+		vec->reserve(length);
+		vec->resize(length);
+
+		in.read(reinterpret_cast<char*>(vec->data()), sizeof(uint64_t) * length);
+	}
+
+	void FileStream::Read(vector<float>* vec)
+	{
+		if (!vec)
+			return;
+
+		vec->clear();
+		vec->shrink_to_fit();
+
+		auto length = ReadAs<uint32_t>();
+
+		vec->reserve(length);
+		vec->resize(length);
+
+		in.read(reinterpret_cast<char*>(vec->data()), sizeof(float) * length);
+	}
+
+	void FileStream::Read(vector<Math::Vector3>* vec)
+	{
+		if (!vec)
+			return;
+
+		vec->clear();
+		vec->shrink_to_fit();
+
+		auto length = ReadAs<uint32_t>();
+
+		vec->reserve(length);
+		vec->resize(length);
+
+		in.read(reinterpret_cast<char*>(vec->data()), sizeof(Math::Vector3) * length);
+	}
+
 	void FileStream::Read(vector<unsigned char>* vec)
 	{
 		if (!vec)
@@ -232,4 +460,9 @@ namespace Spartan
 
 		in.read(reinterpret_cast<char*>(vec->data()), sizeof(std::byte) * length);
 	}
+
+	void FileStream::Read(std::byte* data, const uint64_t size)
+	{
+		in.read(reinterpret_cast<char*>(data), static_cast<streamsize>(size));
+	}
 }
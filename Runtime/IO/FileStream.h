@@ -42,14 +42,35 @@ namespace Spartan
 		FileStream_Append	= 1 << 2,
 	};
 
+	// A stream buffer over memory, appends when writing and reads from a fixed range
+	class FileStream_MemoryBuffer : public std::streambuf
+	{
+	public:
+		void SetWrite(std::vector<std::byte>* buffer);
+		void SetRead(const std::byte* data, uint64_t size);
+
+	protected:
+		std::streamsize xsputn(const char* data, std::streamsize size) override;
+		int_type overflow(int_type c) override;
+		pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode) override;
+		pos_type seekpos(pos_type position, std::ios_base::openmode mode) override;
+
+	private:
+		std::vector<std::byte>* m_buffer = nullptr;
+	};
+
 	class SPARTAN_CLASS FileStream
 	{
 	public:
 		FileStream(const std::string& path, uint32_t flags);
+		FileStream(std::vector<std::byte>* buffer);			// Memory stream, writes are appended to the buffer
+		FileStream(const std::byte* data, uint64_t size);	// Memory stream, reads from the given range
 		~FileStream();
 
 		auto IsOpen() const { return m_is_open; }
 		void Close();
+		uint64_t GetPosition();
+		void Seek(uint64_t position);
 
 		//= WRITING ==================================================
 		template <class T, class = typename std::enable_if<
@@ -79,9 +100,15 @@ namespace Spartan
 		void Write(const std::string& value);
 		void Write(const std::vector<std::string>& value);
 		void Write(const std::vector<RHI_Vertex_PosTexNorTan>& value);
+		void Write(const std::vector<RHI_Vertex_PosTexNorTan_Quantized>& value);
 		void Write(const std::vector<uint32_t>& value);
+		void Write(const std::vector<uint16_t>& value);
+		void Write(const std::vector<uint64_t>& value);
+		void Write(const std::vector<float>& value);
+		void Write(const std::vector<Math::Vector3>& value);
 		void Write(const std::vector<unsigned char>& value);
 		void Write(const std::vector<std::byte>& value);
+		void Write(const std::byte* data, uint64_t size);
 		void Skip(uint32_t n);
 		//===========================================================
 		
@@ -113,9 +140,15 @@ namespace Spartan
 		void Read(std::string* value);
 		void Read(std::vector<std::string>* vec);
 		void Read(std::vector<RHI_Vertex_PosTexNorTan>* vec);
+		void Read(std::vector<RHI_Vertex_PosTexNorTan_Quantized>* vec);
 		void Read(std::vector<uint32_t>* vec);
+		void Read(std::vector<uint16_t>* vec);
+		void Read(std::vector<uint64_t>* vec);
+		void Read(std::vector<float>* vec);
+		void Read(std::vector<Math::Vector3>* vec);
 		void Read(std::vector<unsigned char>* vec);
 		void Read(std::vector<std::byte>* vec);
+		void Read(std::byte* data, uint64_t size);
 
 		// Reading with explicit type definition
 		template <class T, class = typename std::enable_if
@@ -143,8 +176,10 @@ namespace Spartan
 		//=====================================================
 
 	private:
-		std::ofstream out;
-		std::ifstream in;
+		std::filebuf m_buffer_file;
+		FileStream_MemoryBuffer m_buffer_memory;
+		std::ostream out{ nullptr };
+		std::istream in{ nullptr };
 		uint32_t m_flags;
 		bool m_is_open;
 	};
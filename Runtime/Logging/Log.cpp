@@ -23,7 +23,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Log.h"
 #include "ILogger.h"
 #include <fstream>
-#include <cstdarg>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <unordered_map>
+#include <condition_variable>
 #include "../World/Entity.h"
 #include "../Core/EventSystem.h"
 #include "../Core/FileSystem.h"
@@ -40,104 +44,630 @@ namespace Spartan
 	ofstream Log::m_fout;
 	mutex Log::m_mutex_log;
     vector<LogCmd> Log::m_log_buffer;
-	string Log::m_log_file_name	    = "log.txt";
-	bool Log::m_log_to_file		    = true; // start logging to file (unless changed by the user, e.g. Renderer initialization was successful, so logging can happen on screen)
-	bool Log::m_first_log		    = true;
-   
-	// Everything resolves to this
-	void Log::Write(const char* text, const Log_Type type)
-	{
-        if (!text)
+	string Log::m_log_file_name	        = "log.txt";
+	atomic<bool> Log::m_log_to_file     = true; // start logging to file (unless changed by the user, e.g. Renderer initialization was successful, so logging can happen on screen)
+	bool Log::m_first_log		        = true;
+    atomic<uint32_t> Log::m_repeat_limit = 100;
+
+    namespace _Log
+    {
+        // Must be a power of two
+        constexpr uint32_t queue_size = 256;
+
+        // Single producer (the thread that owns it), single consumer (the logging thread)
+        struct LogQueue
         {
-            LOG_ERROR_INVALID_PARAMETER();
-            return;
+            LogRecord records[queue_size];
+            uint64_t sequence       = 0; // only touched by the owning thread
+            atomic<uint32_t> head   = 0;
+            atomic<uint32_t> tail   = 0;
+            atomic<bool> orphaned   = false;
+        };
+
+        // Marks the queue as orphaned when the owning thread exits, the logging thread will then drain and delete it
+        struct LogQueueOwner
+        {
+            ~LogQueueOwner()
+            {
+                if (queue)
+                {
+                    queue->orphaned = true;
+                    queue           = nullptr;
+                }
+            }
+
+            LogQueue* queue = nullptr;
+        };
+
+        enum Worker_State : uint32_t
+        {
+            Worker_NotStarted,
+            Worker_Running,
+            Worker_Stopped
+        };
+
+        static atomic<uint32_t> state      = Worker_NotStarted;
+        thread_local LogQueueOwner queue_owner;
+        thread_local LogRecord record_immediate; // used when there is no logging thread to hand records to
+
+        inline uint64_t hash(const char* data, const size_t size, uint64_t seed = 14695981039346656037ull)
+        {
+            for (size_t i = 0; i < size; i++)
+            {
+                seed ^= static_cast<uint8_t>(data[i]);
+                seed *= 1099511628211ull;
+            }
+            return seed;
         }
 
-        lock_guard<mutex> guard(m_mutex_log);
+        inline uint64_t time_ms()
+        {
+            return static_cast<uint64_t>(chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+        }
 
-        const auto log_to_file = m_logger.expired() || m_log_to_file;
+        inline uint64_t time_ticks()
+        {
+            return static_cast<uint64_t>(chrono::steady_clock::now().time_since_epoch().count());
+        }
 
-        if (log_to_file)
+        struct Argument
         {
-            m_log_buffer.emplace_back(text, type);
-            LogToFile(text, type);
+            LogArg_Type type = LogArg_Int;
+            int64_t i        = 0;
+            uint64_t u       = 0;
+            double d         = 0.0;
+            string_view str;
+        };
+
+        inline bool argument_next(const LogRecord& record, uint16_t& cursor, Argument& arg)
+        {
+            if (cursor >= record.payload_size)
+                return false;
+
+            const std::byte* payload = record.GetPayload();
+            arg.type = static_cast<LogArg_Type>(payload[cursor++]);
+            if (arg.type == LogArg_String)
+            {
+                uint16_t length = 0;
+                memcpy(&length, &payload[cursor], sizeof(uint16_t));
+                arg.str = string_view(reinterpret_cast<const char*>(&payload[cursor + sizeof(uint16_t)]), length);
+                cursor += static_cast<uint16_t>(sizeof(uint16_t) + length);
+            }
+            else
+            {
+                memcpy(&arg.u, &payload[cursor], sizeof(uint64_t));
+                memcpy(&arg.i, &arg.u, sizeof(uint64_t));
+                memcpy(&arg.d, &arg.u, sizeof(uint64_t));
+                cursor += sizeof(uint64_t);
+            }
+
+            return true;
         }
-        else
+
+        inline int64_t argument_to_int(const Argument& arg)
         {
-            FlushBuffer();
-            LogString(text, type);
+            switch (arg.type)
+            {
+                case LogArg_Double:  return static_cast<int64_t>(arg.d);
+                case LogArg_String:  return 0;
+                default:             return arg.i;
+            }
         }
-	}
 
-    void Log::WriteFInfo(const char* text, ...)
-	{
-		char buffer[1024];
-		va_list args;
-		va_start(args, text);
-		auto w = vsnprintf(buffer, sizeof(buffer), text, args);
-		va_end(args);
+        inline double argument_to_double(const Argument& arg)
+        {
+            switch (arg.type)
+            {
+                case LogArg_Int:    return static_cast<double>(arg.i);
+                case LogArg_Double: return arg.d;
+                case LogArg_String: return 0.0;
+                default:            return static_cast<double>(arg.u);
+            }
+        }
 
-		Write(buffer, Log_Info);
-	}
+        template<typename T>
+        inline void append_formatted(string& out, const string& spec, T value)
+        {
+            char buffer[512];
+            const int size = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+            if (size > 0)
+            {
+                out.append(buffer, min(static_cast<size_t>(size), sizeof(buffer) - 1));
+            }
+        }
 
-    void Log::WriteFWarning(const char* text, ...)
-	{
-		char buffer[1024];
-		va_list args;
-		va_start(args, text);
-		auto w = vsnprintf(buffer, sizeof(buffer), text, args);
-		va_end(args);
+        // Same as vsnprintf, except that the arguments come from the record and that they are converted to whatever the
+        // conversion specifier asks for. This way, a mismatch between a specifier and an argument can't result in a crash.
+        inline void format(const LogRecord& record, string& out)
+        {
+            const string_view text = record.format ? string_view(record.format) : string_view(reinterpret_cast<const char*>(record.GetPayload()), record.text_size);
+            uint16_t cursor = record.format ? 0 : record.text_size;
+
+            // Copied text without any arguments is not a format string
+            if (!record.format && record.arg_count == 0)
+            {
+                out.append(text);
+                return;
+            }
+
+            Argument arg;
+            string spec;
+            const size_t size = text.size();
+            for (size_t i = 0; i < size; i++)
+            {
+                if (text[i] != '%')
+                {
+                    out += text[i];
+                    continue;
+                }
+
+                if (i + 1 < size && text[i + 1] == '%')
+                {
+                    out += '%';
+                    i++;
+                    continue;
+                }
+
+                // Flags, width and precision
+                spec = "%";
+                size_t j = i + 1;
+                while (j < size && strchr("-+ #0", text[j]))
+                {
+                    spec += text[j++];
+                }
+                for (auto part = 0; part < 2; part++)
+                {
+                    if (part == 1)
+                    {
+                        if (j >= size || text[j] != '.')
+                            break;
+                        spec += text[j++];
+                    }
+
+                    if (j < size && text[j] == '*')
+                    {
+                        spec += argument_next(record, cursor, arg) ? to_string(argument_to_int(arg)) : "0";
+                        j++;
+                    }
+                    while (j < size && isdigit(static_cast<unsigned char>(text[j])))
+                    {
+                        spec += text[j++];
+                    }
+                }
+
+                // Length modifiers are dropped, the widest type is used instead
+                while (j < size && strchr("hljztLqI", text[j]))
+                {
+                    j += (text[j] == 'I' && j + 2 < size && isdigit(static_cast<unsigned char>(text[j + 1]))) ? 3 : 1;
+                }
+
+                if (j >= size)
+                {
+                    out.append(text.substr(i));
+                    break;
+                }
+
+                const char conversion = text[j];
+                i = j;
+
+                if (!argument_next(record, cursor, arg))
+                {
+                    out += "(missing)";
+                    continue;
+                }
+
+                // A string can only be printed as a string
+                if (arg.type == LogArg_String && conversion != 's')
+                {
+                    out.append(arg.str);
+                    continue;
+                }
+
+                switch (conversion)
+                {
+                    case 'd': case 'i':
+                        append_formatted(out, spec + "lld", static_cast<long long>(argument_to_int(arg)));
+                        break;
+                    case 'u': case 'o': case 'x': case 'X':
+                        append_formatted(out, spec + "ll" + conversion, static_cast<unsigned long long>(argument_to_int(arg)));
+                        break;
+                    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                        append_formatted(out, spec + conversion, argument_to_double(arg));
+                        break;
+                    case 'c':
+                        append_formatted(out, spec + conversion, static_cast<int>(argument_to_int(arg)));
+                        break;
+                    case 'p':
+                        append_formatted(out, spec + conversion, reinterpret_cast<void*>(arg.u));
+                        break;
+                    case 's':
+                        if (arg.type != LogArg_String)
+                        {
+                            out += arg.type == LogArg_Double ? to_string(arg.d) : arg.type == LogArg_Int ? to_string(arg.i) : to_string(arg.u);
+                        }
+                        else if (spec.size() == 1)
+                        {
+                            out.append(arg.str);
+                        }
+                        else
+                        {
+                            append_formatted(out, spec + conversion, string(arg.str).c_str());
+                        }
+                        break;
+                    default:
+                        out.append(text.substr(j - (spec.size() - 1) - 1, spec.size() + 1));
+                        break;
+                }
+            }
+        }
+    }
 
-		Write(buffer, Log_Warning);
-	}
+    using namespace _Log;
 
-    void Log::WriteFError(const char* text, ...)
-	{
-		char buffer[1024];
-		va_list args;
-		va_start(args, text);
-		auto w = vsnprintf(buffer, sizeof(buffer), text, args);
-		va_end(args);
+    class LogWorker
+    {
+    public:
+        static LogWorker& Get()
+        {
+            static LogWorker instance;
+            return instance;
+        }
 
-		Write(buffer, Log_Error);
-	}
+        LogWorker()
+        {
+            m_thread    = thread(&LogWorker::Run, this);
+            state       = Worker_Running;
+        }
 
-    void Log::Write(const string& text, const Log_Type type)
+        ~LogWorker()
+        {
+            {
+                lock_guard<mutex> lock(m_mutex_wake);
+                m_stopping = true;
+            }
+            m_condition.notify_one();
+            m_thread.join();
+
+            // From now on, records get written out by the thread that produces them
+            state = Worker_Stopped;
+
+            for (LogQueue* queue : m_queues)
+            {
+                delete queue;
+            }
+            m_queues.clear();
+        }
+
+        LogQueue* GetQueue()
+        {
+            if (!queue_owner.queue)
+            {
+                queue_owner.queue = new LogQueue();
+
+                lock_guard<mutex> lock(m_mutex_queues);
+                m_queues.emplace_back(queue_owner.queue);
+            }
+
+            return queue_owner.queue;
+        }
+
+        bool IsLoggingThread() const { return this_thread::get_id() == m_thread.get_id(); }
+
+        void Wake()
+        {
+            {
+                lock_guard<mutex> lock(m_mutex_wake);
+                m_wake = true;
+            }
+            m_condition.notify_one();
+        }
+
+        bool IsIdle()
+        {
+            lock_guard<mutex> lock(m_mutex_queues);
+            for (LogQueue* queue : m_queues)
+            {
+                if (queue->head.load(memory_order_acquire) != queue->tail.load(memory_order_acquire))
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        void Run()
+        {
+            while (true)
+            {
+                bool stopping = false;
+                {
+                    // Producers don't notify (that would cost them), so poll at a low frequency unless woken up
+                    unique_lock<mutex> lock(m_mutex_wake);
+                    m_condition.wait_for(lock, chrono::milliseconds(5), [this] { return m_wake || m_stopping; });
+                    m_wake      = false;
+                    stopping    = m_stopping;
+                }
+
+                Drain();
+
+                if (stopping)
+                {
+                    RepeatsFlush(true);
+                    Log::CloseFile();
+                    return;
+                }
+            }
+        }
+
+        void Drain()
+        {
+            // Gather everything that has been published
+            {
+                lock_guard<mutex> lock(m_mutex_queues);
+                for (LogQueue* queue : m_queues)
+                {
+                    const uint32_t head = queue->head.load(memory_order_relaxed);
+                    const uint32_t tail = queue->tail.load(memory_order_acquire);
+                    for (uint32_t i = head; i != tail; i++)
+                    {
+                        m_batch.emplace_back(&queue->records[i & (queue_size - 1)]);
+                    }
+                    m_batch_ends.emplace_back(queue, tail);
+                    m_batch_runs.emplace_back(m_batch.size());
+                }
+            }
+
+            if (!m_batch.empty())
+            {
+                // Restore the order in which the records were produced. The records of each thread are already in
+                // the order of their sequence, so the runs only have to be merged by time (ties keep the earlier run first).
+                for (size_t run = 1; run < m_batch_runs.size(); run++)
+                {
+                    inplace_merge(m_batch.begin(), m_batch.begin() + m_batch_runs[run - 1], m_batch.begin() + m_batch_runs[run], [](const LogRecord* a, const LogRecord* b) { return a->time < b->time; });
+                }
+
+                for (const LogRecord* record : m_batch)
+                {
+                    Process(*record);
+                }
+                m_batch.clear();
+
+                Log::CloseFile();
+            }
+            m_batch_runs.clear();
+
+            // Release the slots and delete the queues of threads that no longer exist
+            {
+                lock_guard<mutex> lock(m_mutex_queues);
+                for (const auto& batch_end : m_batch_ends)
+                {
+                    batch_end.first->head.store(batch_end.second, memory_order_release);
+                }
+                m_batch_ends.clear();
+
+                for (auto it = m_queues.begin(); it != m_queues.end();)
+                {
+                    LogQueue* queue = *it;
+                    if (queue->orphaned && queue->head.load(memory_order_relaxed) == queue->tail.load(memory_order_acquire))
+                    {
+                        delete queue;
+                        it = m_queues.erase(it);
+                    }
+                    else
+                    {
+                        it++;
+                    }
+                }
+            }
+
+            RepeatsFlush(false);
+        }
+
+        void Process(const LogRecord& record)
+        {
+            // Rate limiting, per message (the call site along with the text and arguments that were passed to it)
+            if (const uint32_t limit = Log::m_repeat_limit)
+            {
+                const uint64_t seed = reinterpret_cast<uint64_t>(record.format) ^ (reinterpret_cast<uint64_t>(record.function) * 1099511628211ull);
+                const uint64_t key  = hash(reinterpret_cast<const char*>(record.GetPayload()), record.payload_size, seed);
+
+                const uint64_t now  = time_ms();
+                RepeatEntry& entry  = m_repeats[key];
+                if (now - entry.window_start >= 1000)
+                {
+                    RepeatFlush(entry);
+                    entry.window_start  = now;
+                    entry.count         = 0;
+                }
+
+                if (++entry.count > limit)
+                {
+                    if (entry.suppressed++ == 0)
+                    {
+                        entry.type      = record.type;
+                        entry.function  = record.function;
+                    }
+                    return;
+                }
+            }
+
+            m_text.clear();
+            if (record.function)
+            {
+                m_text += record.function;
+                m_text += ": ";
+            }
+            format(record, m_text);
+
+            Log::Output(m_text, record.type);
+        }
+
+        struct RepeatEntry
+        {
+            uint64_t window_start   = 0;
+            uint32_t count          = 0;
+            uint32_t suppressed     = 0;
+            Log_Type type           = Log_Info;
+            const char* function    = nullptr;
+        };
+
+        void RepeatFlush(RepeatEntry& entry)
+        {
+            if (entry.suppressed == 0)
+                return;
+
+            m_text.clear();
+            if (entry.function)
+            {
+                m_text += entry.function;
+                m_text += ": ";
+            }
+            m_text += "Previous message repeated " + to_string(entry.suppressed) + " more times";
+            Log::Output(m_text, entry.type);
+
+            entry.suppressed = 0;
+        }
+
+        void RepeatsFlush(const bool force)
+        {
+            const uint64_t now = time_ms();
+            if (!force && now - m_repeats_checked < 1000)
+                return;
+
+            m_repeats_checked = now;
+            for (auto it = m_repeats.begin(); it != m_repeats.end();)
+            {
+                if (force || now - it->second.window_start >= 1000)
+                {
+                    RepeatFlush(it->second);
+                    it = m_repeats.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
+            }
+        }
+
+        thread m_thread;
+        mutex m_mutex_wake;
+        mutex m_mutex_queues;
+        condition_variable m_condition;
+        bool m_wake     = false;
+        bool m_stopping = false;
+        vector<LogQueue*> m_queues;
+
+        // Only touched by the logging thread
+        vector<LogRecord*> m_batch;
+        vector<pair<LogQueue*, uint32_t>> m_batch_ends;
+        vector<size_t> m_batch_runs; // where the records of each queue end in the batch
+        unordered_map<uint64_t, RepeatEntry> m_repeats;
+        uint64_t m_repeats_checked = 0;
+        string m_text;
+    };
+
+    LogRecord& Log::RecordBegin(const Log_Type type, const char* function)
     {
-        Write(text.c_str(), type);
+        if (state != Worker_Stopped)
+        {
+            LogWorker& worker   = LogWorker::Get();
+            LogQueue* queue     = worker.GetQueue();
+            const uint32_t tail = queue->tail.load(memory_order_relaxed);
+
+            // If the queue is full, wait for the logging thread to make some room (unless this is the logging thread)
+            bool has_room = true;
+            while (tail - queue->head.load(memory_order_acquire) >= queue_size)
+            {
+                if (worker.IsLoggingThread() || state == Worker_Stopped)
+                {
+                    has_room = false;
+                    break;
+                }
+
+                worker.Wake();
+                this_thread::yield();
+            }
+
+            if (has_room)
+            {
+                LogRecord& record = queue->records[tail & (queue_size - 1)];
+                record.Reset(type, function);
+                return record;
+            }
+        }
+
+        record_immediate.Reset(type, function);
+        return record_immediate;
     }
 
-    void Log::WriteFInfo(const string text, ...)
+    void Log::RecordEnd(LogRecord& record)
     {
-        char buffer[1024];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text.c_str(), args);
-        va_end(args);
+        // Write out immediately
+        if (&record == &record_immediate)
+        {
+            string text;
+            if (record.function)
+            {
+                text += record.function;
+                text += ": ";
+            }
+            format(record, text);
+
+            // The logging thread can only end up here from within Output(), which already holds the lock
+            if (state == Worker_Running && LogWorker::Get().IsLoggingThread())
+            {
+                LogToFile(text.c_str(), record.type);
+                m_fout.flush();
+                return;
+            }
+
+            Output(text, record.type);
+            CloseFile();
+            return;
+        }
 
-        Write(buffer, Log_Info);
+        // Publish
+        LogQueue* queue = queue_owner.queue;
+        record.sequence = queue->sequence++;
+        record.time     = time_ticks();
+        queue->tail.store(queue->tail.load(memory_order_relaxed) + 1, memory_order_release);
     }
 
-    void Log::WriteFWarning(const string text, ...)
+    void Log::SetLogger(const weak_ptr<ILogger>& logger)
     {
-        char buffer[1024];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text.c_str(), args);
-        va_end(args);
-
-        Write(buffer, Log_Warning);
+        lock_guard<mutex> guard(m_mutex_log);
+        m_logger = logger;
     }
 
-    void Log::WriteFError(const string text, ...)
+    void Log::Flush()
     {
-        char buffer[1024];
-        va_list args;
-        va_start(args, text);
-        auto w = vsnprintf(buffer, sizeof(buffer), text.c_str(), args);
-        va_end(args);
+        if (state != Worker_Running)
+            return;
+
+        LogWorker& worker = LogWorker::Get();
+        if (worker.IsLoggingThread())
+            return;
+
+        while (!worker.IsIdle())
+        {
+            worker.Wake();
+            this_thread::sleep_for(chrono::microseconds(100));
+        }
+    }
+
+	void Log::Write(const char* text, const Log_Type type)
+	{
+        if (!text)
+        {
+            LOG_ERROR_INVALID_PARAMETER();
+            return;
+        }
+
+        WriteF(type, nullptr, text);
+	}
 
-        Write(buffer, Log_Error);
+    void Log::Write(const string& text, const Log_Type type)
+    {
+        WriteF(type, nullptr, text);
     }
 
     void Log::Write(const weak_ptr<Entity>& entity, const Log_Type type)
@@ -175,6 +705,25 @@ namespace Spartan
 		Write(value.ToString(), type);
 	}
 
+    // Everything resolves to this
+    void Log::Output(const string& text, const Log_Type type)
+    {
+        lock_guard<mutex> guard(m_mutex_log);
+
+        const auto log_to_file = m_logger.expired() || m_log_to_file;
+
+        if (log_to_file)
+        {
+            m_log_buffer.emplace_back(text, type);
+            LogToFile(text.c_str(), type);
+        }
+        else
+        {
+            FlushBuffer();
+            LogString(text.c_str(), type);
+        }
+    }
+
     void Log::FlushBuffer()
     {
         if (m_logger.expired() || m_log_buffer.empty())
@@ -196,7 +745,10 @@ namespace Spartan
             return;
         }
 
-		m_logger.lock()->Log(string(text), type);
+        if (auto logger = m_logger.lock())
+        {
+		    logger->Log(string(text), type);
+        }
 	}
 
 	void Log::LogToFile(const char* text, const Log_Type type)
@@ -217,16 +769,25 @@ namespace Spartan
 			m_first_log = false;
 		}
 
-		// Open/Create a log file to write the error message to
-		m_fout.open(m_log_file_name, ofstream::out | ofstream::app);
+		// Open/Create a log file to write the error message to (it stays open until the current batch has been written)
+        if (!m_fout.is_open())
+        {
+		    m_fout.open(m_log_file_name, ofstream::out | ofstream::app);
+        }
 
 		if (m_fout.is_open())
 		{
 			// Write out the error message
-			m_fout << final_text << endl;
-
-			// Close the file
-			m_fout.close();
+			m_fout << final_text << "\n";
 		}
 	}
+
+    void Log::CloseFile()
+    {
+        lock_guard<mutex> guard(m_mutex_log);
+        if (m_fout.is_open())
+        {
+            m_fout.close();
+        }
+    }
 }
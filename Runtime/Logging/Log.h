@@ -26,14 +26,16 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <memory>
 #include <mutex>
 #include <vector>
+#include <atomic>
+#include "LogRecord.h"
 #include "../Core/EngineDefs.h"
 //=============================
 
 namespace Spartan
 {
-    #define LOG_INFO(text, ...)	    { Spartan::Log::WriteFInfo(std::string(__FUNCTION__)    + ": " + std::string(text), __VA_ARGS__); }
-    #define LOG_WARNING(text, ...)	{ Spartan::Log::WriteFWarning(std::string(__FUNCTION__) + ": " + std::string(text), __VA_ARGS__); }
-    #define LOG_ERROR(text, ...)	{ Spartan::Log::WriteFError(std::string(__FUNCTION__)   + ": " + std::string(text), __VA_ARGS__); }
+    #define LOG_INFO(text, ...)	    { Spartan::Log::WriteF(Spartan::Log_Info,    __FUNCTION__, text, __VA_ARGS__); }
+    #define LOG_WARNING(text, ...)	{ Spartan::Log::WriteF(Spartan::Log_Warning, __FUNCTION__, text, __VA_ARGS__); }
+    #define LOG_ERROR(text, ...)	{ Spartan::Log::WriteF(Spartan::Log_Error,   __FUNCTION__, text, __VA_ARGS__); }
 
 	// Standard errors
 	#define LOG_ERROR_GENERIC_FAILURE()		LOG_ERROR("Failed.")
@@ -45,6 +47,7 @@ namespace Spartan
 
 	// Forward declarations
 	class Entity;
+	class ILogger;
 	namespace Math
 	{
 		class Quaternion;
@@ -54,13 +57,6 @@ namespace Spartan
 		class Vector4;
 	}
 
-	enum Log_Type
-	{
-		Log_Info,
-		Log_Warning,
-		Log_Error
-	};
-
     struct LogCmd
     {
         LogCmd(const std::string& text, const Log_Type type)
@@ -73,24 +69,42 @@ namespace Spartan
         Log_Type type;
     };
 
+    /*
+    Call sites only pack a LogRecord (format pointer + arguments) into a lock-free queue owned by the calling thread.
+    A dedicated logging thread does the formatting, the file I/O and the ILogger calls, so logging from hot paths and
+    worker threads doesn't serialize them. Identical messages that are fired more than GetRepeatLimit() times per second
+    are suppressed and summarized instead.
+    */
 	class SPARTAN_CLASS Log
 	{
 		friend class ILogger;
+        friend class LogWorker;
 	public:
         Log() = default;
 
 		// Set a logger to be used (if not set, logging will done in a text file.
-		static void SetLogger(const std::weak_ptr<ILogger>& logger) { m_logger = logger; }
+		static void SetLogger(const std::weak_ptr<ILogger>& logger);
+
+        // Blocks until everything logged so far has been written out
+        static void Flush();
+
+        // Max number of identical messages (per call site) per second, 0 means no limit
+        static void SetRepeatLimit(const uint32_t limit)    { m_repeat_limit = limit; }
+        static uint32_t GetRepeatLimit()                    { return m_repeat_limit; }
+
+        // Formatted (printf style)
+        template<typename Text, typename... Args>
+        static void WriteF(const Log_Type type, const char* function, const Text& text, const Args&... args)
+        {
+            LogRecord& record = RecordBegin(type, function);
+            record.SetText(text);
+            (record.Pack(args), ...);
+            RecordEnd(record);
+        }
 
 		// Alpha
 		static void Write(const char* text, const Log_Type type);
-        static void WriteFInfo(const char* text, ...);
-		static void WriteFWarning(const char* text, ...);
-		static void WriteFError(const char* text, ...);
         static void Write(const std::string& text, const Log_Type type);
-        static void WriteFInfo(const std::string text, ...);
-        static void WriteFWarning(const std::string text, ...);
-        static void WriteFError(const std::string text, ...);
 
 		// Numeric
 		template <class T, class = typename std::enable_if<
@@ -106,7 +120,7 @@ namespace Spartan
 		>::type>
 		static void Write(T value, Log_Type type)
 		{
-			Write(to_string(value), type);
+			Write(std::to_string(value), type);
 		}
 
 		// Math
@@ -123,12 +137,19 @@ namespace Spartan
 		static void Write(const std::weak_ptr<Entity>& entity, Log_Type type);
 		static void Write(const std::shared_ptr<Entity>& entity, Log_Type type);
 
-		static bool m_log_to_file;     
+		static std::atomic<bool> m_log_to_file;
 
 	private:
+        // Returns a record to fill (a slot in the calling thread's queue), RecordEnd() publishes it
+        static LogRecord& RecordBegin(Log_Type type, const char* function);
+        static void RecordEnd(LogRecord& record);
+
+        // Invoked by the logging thread (or the calling thread once the logging thread is gone)
+        static void Output(const std::string& text, Log_Type type);
         static void FlushBuffer();
 		static void LogString(const char* text, Log_Type type);
 		static void LogToFile(const char* text, Log_Type type);
+        static void CloseFile();
 
         static std::mutex m_mutex_log;
 		static std::weak_ptr<ILogger> m_logger;
@@ -136,5 +157,6 @@ namespace Spartan
 		static std::string m_log_file_name;
 		static bool m_first_log;
         static std::vector<LogCmd> m_log_buffer;
+        static std::atomic<uint32_t> m_repeat_limit;
 	};
 }
@@ -0,0 +1,208 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+//=============================
+
+namespace Spartan
+{
+    enum Log_Type
+    {
+        Log_Info,
+        Log_Warning,
+        Log_Error
+    };
+
+    enum LogArg_Type : uint8_t
+    {
+        LogArg_Int,
+        LogArg_Uint,
+        LogArg_Double,
+        LogArg_Pointer,
+        LogArg_String
+    };
+
+    // A compact log entry. Call sites fill it in place (inside a per-thread queue) and the logging
+    // thread is the one that turns it into text. Arguments are packed as [type][value] pairs, strings
+    // are copied as [type][length][characters]. Most messages fit inline, longer ones spill to a buffer
+    // that the record allocates the first time it needs it and keeps for the next messages.
+    struct LogRecord
+    {
+        static constexpr uint32_t payload_capacity_inline   = 128;
+        static constexpr uint32_t payload_capacity          = 1024; // same as the longest message that used to be formatted
+
+        // Arrays are assumed to be string literals, so only their address is kept
+        template<typename T>
+        void SetText(const T& text)
+        {
+            if constexpr (std::is_array_v<T>)
+            {
+                format = text;
+            }
+            else if constexpr (std::is_same_v<T, std::string>)
+            {
+                PackText(text.data(), text.size());
+            }
+            else
+            {
+                PackText(text, text ? strlen(text) : 0);
+            }
+        }
+
+        template<typename T>
+        void Pack(const T& value)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                PackScalar(LogArg_Uint, static_cast<uint64_t>(value));
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                PackScalar(LogArg_Int, static_cast<int64_t>(value));
+            }
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            {
+                PackScalar(LogArg_Int, static_cast<int64_t>(value));
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                PackScalar(LogArg_Uint, static_cast<uint64_t>(value));
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                PackScalar(LogArg_Double, static_cast<double>(value));
+            }
+            else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+            {
+                PackString(value.data(), value.size());
+            }
+            else if constexpr (std::is_array_v<T> || std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>)
+            {
+                const char* str = value;
+                PackString(str ? str : "(null)", str ? strlen(str) : 6);
+            }
+            else if constexpr (std::is_pointer_v<T>)
+            {
+                PackScalar(LogArg_Pointer, reinterpret_cast<uint64_t>(value));
+            }
+            else
+            {
+                static_assert(std::is_void_v<T>, "Unsupported log argument type");
+            }
+        }
+
+        void Reset(const Log_Type type, const char* function)
+        {
+            this->type      = type;
+            this->function  = function;
+            format          = nullptr;
+            text_size       = 0;
+            payload_size    = 0;
+            arg_count       = 0;
+            spilled         = false;
+        }
+
+        const std::byte* GetPayload() const { return spilled ? payload_overflow.get() : payload_inline; }
+
+        const char* function    = nullptr;
+        const char* format      = nullptr; // null when the text has been copied to the start of the payload
+        uint64_t sequence       = 0;       // per thread, the records of a thread are published in this order
+        uint64_t time           = 0;       // when it was published, orders the records of different threads
+        Log_Type type           = Log_Info;
+        uint16_t text_size      = 0;
+        uint16_t payload_size   = 0;
+        uint8_t arg_count       = 0;
+
+    private:
+        std::byte* GetPayloadWritable() { return spilled ? payload_overflow.get() : payload_inline; }
+
+        // Returns how much room is left for the given size, moving the payload to the overflow buffer if it doesn't fit inline
+        size_t Reserve(const size_t size)
+        {
+            if (!spilled && payload_size + size > payload_capacity_inline)
+            {
+                if (!payload_overflow)
+                {
+                    payload_overflow = std::make_unique<std::byte[]>(payload_capacity);
+                }
+
+                memcpy(payload_overflow.get(), payload_inline, payload_size);
+                spilled = true;
+            }
+
+            return (spilled ? payload_capacity : payload_capacity_inline) - payload_size;
+        }
+
+        void PackText(const char* text, size_t size)
+        {
+            // The text always goes first, so there is nothing to preserve
+            const size_t available  = Reserve(size);
+            size                    = size < available ? size : available;
+            memcpy(GetPayloadWritable(), text, size);
+            text_size               = static_cast<uint16_t>(size);
+            payload_size            = text_size;
+        }
+
+        template<typename T>
+        void PackScalar(const LogArg_Type arg_type, const T value)
+        {
+            if (Reserve(1 + sizeof(T)) < 1 + sizeof(T))
+                return;
+
+            std::byte* payload = GetPayloadWritable();
+            payload[payload_size] = static_cast<std::byte>(arg_type);
+            memcpy(&payload[payload_size + 1], &value, sizeof(T));
+            payload_size += static_cast<uint16_t>(1 + sizeof(T));
+            arg_count++;
+        }
+
+        void PackString(const char* str, size_t size)
+        {
+            const size_t header     = 1 + sizeof(uint16_t);
+            const size_t available  = Reserve(header + size);
+            if (available < header)
+                return;
+
+            // Truncate strings that don't fit
+            const auto length = static_cast<uint16_t>(size < available - header ? size : available - header);
+
+            std::byte* payload = GetPayloadWritable();
+            payload[payload_size] = static_cast<std::byte>(LogArg_String);
+            memcpy(&payload[payload_size + 1], &length, sizeof(uint16_t));
+            memcpy(&payload[payload_size + header], str, length);
+            payload_size += static_cast<uint16_t>(header + length);
+            arg_count++;
+        }
+
+        std::byte payload_inline[payload_capacity_inline];
+        std::unique_ptr<std::byte[]> payload_overflow;
+        bool spilled = false;
+    };
+}
@@ -37,6 +37,7 @@ namespace Spartan::Math
 		~Frustum() = default;
 
         bool IsVisible(const Vector3& center, const Vector3& extent, bool ignore_near_plane = false) const;
+        bool IsVisible(const Vector3& center, float radius) const { return CheckSphere(center, radius) != Outside; }
 
 	private:
         Intersection CheckCube(const Vector3& center, const Vector3& extent) const;
@@ -20,19 +20,31 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
 //= INCLUDES ===================================================================
+#include <chrono>
 #include "Physics.h"
 #include "PhysicsDebugDraw.h"
+#include "PhysicsQuery.h"
+#include "PhysicsShapeCache.h"
+#include "PhysicsTaskScheduler.h"
 #include "BulletPhysicsHelper.h"
 #include "../Core/Engine.h"
 #include "../Core/Context.h"
 #include "../Core/Settings.h"
+#include "../Core/EventSystem.h"
 #include "../Profiling/Profiler.h"
 #include "../Rendering/Renderer.h"
+#include "../Threading/Threading.h"
+#include "../World/Components/RigidBody.h"
+#include "../World/Components/Transform.h"
 #pragma warning(push, 0) // Hide warnings which belong to Bullet
 #include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
-#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
-#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/Dynamics/btRigidBody.h>
+#include <LinearMath/btDefaultMotionState.h>
 #pragma warning(pop)
 //==============================================================================
 
@@ -43,30 +55,204 @@ using namespace Spartan::Math;
 
 namespace Spartan
 { 
+	namespace _Physics
+	{
+		// Where the asynchronous step is at, it's taken over by whoever gets to it first (a worker or the sync point)
+		enum Step_State : uint32_t
+		{
+			step_idle,
+			step_queued,
+			step_running
+		};
+
+		// Room for the manifolds and collision algorithms of a few thousand touching bodies, so that
+		// the dispatcher doesn't fall back to the (locking) heap allocator when scenes get busy.
+		static const int pool_size = 16384;
+
+		// Queries are executed in chunks, a few per thread so that expensive ones (long rays, crowded overlaps) even out
+		static const uint32_t query_chunks_per_thread	= 4;
+		static const uint32_t query_chunk_size_min		= 16;
+
+		static void create_world(
+			const int thread_count,
+			btBroadphaseInterface** broadphase,
+			btDefaultCollisionConfiguration** collision_configuration,
+			btCollisionDispatcher** dispatcher,
+			btConstraintSolver** constraint_solver,
+			btConstraintSolver** constraint_solver_mt,
+			btDiscreteDynamicsWorld** world
+		)
+		{
+			btDefaultCollisionConstructionInfo construction_info;
+			construction_info.m_defaultMaxPersistentManifoldPoolSize	= pool_size;
+			construction_info.m_defaultMaxCollisionAlgorithmPoolSize	= pool_size;
+
+			*broadphase					= new btDbvtBroadphase();
+			*collision_configuration	= new btDefaultCollisionConfiguration(construction_info);
+			*dispatcher					= new btCollisionDispatcherMt(*collision_configuration);
+			*constraint_solver			= new btConstraintSolverPoolMt(thread_count);
+			*constraint_solver_mt		= new btSequentialImpulseConstraintSolverMt();
+			*world						= new btDiscreteDynamicsWorldMt(
+				*dispatcher,
+				*broadphase,
+				static_cast<btConstraintSolverPoolMt*>(*constraint_solver),
+				*constraint_solver_mt,
+				*collision_configuration
+			);
+		}
+
+		// A world of its own, with a ground and columns of boxes resting on top of each other
+		struct BoxStack
+		{
+			BoxStack(const int thread_count, const uint32_t box_count)
+			{
+				create_world(thread_count, &broadphase, &collision_configuration, &dispatcher, &constraint_solver, &constraint_solver_mt, &world);
+				world->setGravity(btVector3(0.0f, -9.81f, 0.0f));
+
+				ground_shape	= new btBoxShape(btVector3(500.0f, 1.0f, 500.0f));
+				box_shape		= new btBoxShape(btVector3(0.5f, 0.5f, 0.5f));
+
+				// The ground
+				AddBody(ground_shape, 0.0f, btVector3(0.0f, -1.0f, 0.0f));
+
+				// Columns of ten boxes, laid out in a square grid
+				const uint32_t column_height	= 10;
+				const auto column_count			= (box_count + column_height - 1) / column_height;
+				const auto grid_size			= static_cast<uint32_t>(ceil(sqrt(static_cast<float>(column_count))));
+				const auto spacing				= 1.5f;
+				const auto offset				= (grid_size - 1) * spacing * 0.5f;
+				for (uint32_t i = 0; i < box_count; i++)
+				{
+					const auto column	= i / column_height;
+					const auto x		= (column % grid_size) * spacing - offset;
+					const auto z		= (column / grid_size) * spacing - offset;
+					const auto y		= (i % column_height) + 0.5f;
+					AddBody(box_shape, 1.0f, btVector3(x, y, z));
+				}
+			}
+
+			~BoxStack()
+			{
+				for (auto body : bodies)
+				{
+					world->removeRigidBody(body);
+					delete body->getMotionState();
+					delete body;
+				}
+				delete world;
+				delete constraint_solver_mt;
+				delete constraint_solver;
+				delete dispatcher;
+				delete collision_configuration;
+				delete broadphase;
+				delete box_shape;
+				delete ground_shape;
+			}
+
+			void AddBody(btCollisionShape* shape, const float mass, const btVector3& position)
+			{
+				btVector3 inertia(0.0f, 0.0f, 0.0f);
+				if (mass != 0.0f)
+				{
+					shape->calculateLocalInertia(mass, inertia);
+				}
+
+				const auto motion_state = new btDefaultMotionState(btTransform(btQuaternion::getIdentity(), position));
+				auto body = new btRigidBody(btRigidBody::btRigidBodyConstructionInfo(mass, motion_state, shape, inertia));
+				world->addRigidBody(body);
+				bodies.emplace_back(body);
+			}
+
+			btBroadphaseInterface* broadphase							= nullptr;
+			btDefaultCollisionConfiguration* collision_configuration	= nullptr;
+			btCollisionDispatcher* dispatcher							= nullptr;
+			btConstraintSolver* constraint_solver						= nullptr;
+			btConstraintSolver* constraint_solver_mt					= nullptr;
+			btDiscreteDynamicsWorld* world								= nullptr;
+			btCollisionShape* ground_shape								= nullptr;
+			btCollisionShape* box_shape									= nullptr;
+			vector<btRigidBody*> bodies;
+		};
+
+		// Returns the time, in milliseconds, that it took to step a new stack of boxes with the given scheduler
+		static double step_box_stack(btITaskScheduler* task_scheduler, const int thread_count, const uint32_t box_count, const uint32_t step_count)
+		{
+			btSetTaskScheduler(task_scheduler);
+
+			BoxStack stack(thread_count, box_count);
+			const auto time_step = 1.0f / 60.0f;
+
+			const auto time_start = chrono::high_resolution_clock::now();
+			for (uint32_t i = 0; i < step_count; i++)
+			{
+				stack.world->stepSimulation(time_step, 1, time_step);
+			}
+			const chrono::duration<double, milli> duration = chrono::high_resolution_clock::now() - time_start;
+
+			return duration.count();
+		}
+	}
+
 	Physics::Physics(Context* context) : ISubsystem(context)
 	{
+		m_threading = m_context->GetSubsystem<Threading>().get();
+		m_thread_id = this_thread::get_id();
+
+		// Bullet's parallel loops (the multi-threaded world, dispatcher and solver use them) run on our workers.
+		// The scheduler has to be set before those are created, if our pool can't be used, they run serially.
+		if (PhysicsTaskScheduler::IsSupported(m_threading))
+		{
+			m_task_scheduler = new PhysicsTaskScheduler(m_threading);
+			btSetTaskScheduler(m_task_scheduler);
+		}
+		else
+		{
+			LOG_WARNING("The thread pool can't be used by Bullet, physics will be simulated on a single thread");
+			btSetTaskScheduler(btGetSequentialTaskScheduler());
+		}
+
 		// Create physics objects
-		m_broadphase				= new btDbvtBroadphase();
-		m_collision_configuration	= new btDefaultCollisionConfiguration();
-		m_dispatcher				= new btCollisionDispatcher(m_collision_configuration);
-		m_constraint_solver			= new btSequentialImpulseConstraintSolver();
-		m_world						= new btDiscreteDynamicsWorld(m_dispatcher, m_broadphase, m_constraint_solver, m_collision_configuration);
+		_Physics::create_world(
+			btGetTaskScheduler()->getNumThreads(),
+			&m_broadphase,
+			&m_collision_configuration,
+			&m_dispatcher,
+			&m_constraint_solver,
+			&m_constraint_solver_mt,
+			&m_world
+		);
 
 		// Setup world
 		m_world->setGravity(ToBtVector3(m_gravity));
 		m_world->getDispatchInfo().m_useContinuous	= true;
 		m_world->getSolverInfo().m_splitImpulse		= false;
 		m_world->getSolverInfo().m_numIterations	= m_max_solve_iterations;
+
+		// Mesh collision shapes, built once per geometry and shared
+		m_shape_cache = new PhysicsShapeCache(m_context);
+
+		// Asynchronous stepping starts once the world is done with its entities for the frame
+		m_step_state = make_shared<atomic<uint32_t>>(_Physics::step_idle);
+		SUBSCRIBE_TO_EVENT(Event_World_Ticked, [this](const EventData&) { Step_Kick(); });
 	}
 
 	Physics::~Physics()
 	{
+		UNSUBSCRIBE_FROM_EVENT(Event_World_Ticked);
+		Sync();
+
 		safe_delete(m_world);
+		safe_delete(m_constraint_solver_mt);
 		safe_delete(m_constraint_solver);
 		safe_delete(m_dispatcher);
 		safe_delete(m_collision_configuration);
 		safe_delete(m_broadphase);
 		safe_delete(m_debug_draw);
+		safe_delete(m_shape_cache);
+
+		// Bullet keeps a global pointer to the scheduler
+		btSetTaskScheduler(btGetSequentialTaskScheduler());
+		safe_delete(m_task_scheduler);
 	}
 
 	bool Physics::Initialize()
@@ -91,6 +277,18 @@ namespace Spartan
 	{
 		if (!m_world)
 			return;
+
+		// Sync point, the step that ran while the previous frame was rendering has to finish before anything else touches the world
+		if (m_asynchronous)
+		{
+			Sync();
+
+			if (!m_step_published)
+			{
+				Publish(m_step_alpha);
+				m_step_published = true;
+			}
+		}
 		
 		// Debug draw
 		if (m_renderer->GetFlags() & Render_Debug_Physics)
@@ -104,6 +302,13 @@ namespace Spartan
 
 		TIME_BLOCK_START_CPU(m_profiler);
 
+		if (m_asynchronous)
+		{
+			Step_Schedule(delta_time_sec);
+			TIME_BLOCK_END(m_profiler);
+			return;
+		}
+
 		// This equation must be met: timeStep < maxSubSteps * fixedTimeStep
 		auto internal_time_step	= 1.0f / m_internal_fps;
 		auto max_substeps		= static_cast<int>(delta_time_sec * m_internal_fps) + 1;
@@ -122,9 +327,261 @@ namespace Spartan
 		m_world->stepSimulation(delta_time_sec, max_substeps, internal_time_step);
 		m_simulating = false;
 
+		SyncTransforms();
+
 		TIME_BLOCK_END(m_profiler);
 	}
 
+	void Physics::SetAsynchronous(const bool asynchronous)
+	{
+		if (m_asynchronous == asynchronous)
+			return;
+
+		Sync();
+
+		// Start from where the bodies are, the states that were recorded before (if any) are stale
+		if (asynchronous)
+		{
+			auto& objects = m_world->getCollisionObjectArray();
+			for (int i = 0; i < m_world->getNumCollisionObjects(); i++)
+			{
+				const auto body = btRigidBody::upcast(objects[i]);
+				if (const auto rigid_body = body ? static_cast<RigidBody*>(body->getUserPointer()) : nullptr)
+				{
+					rigid_body->Async_Reset();
+				}
+			}
+		}
+		else if (!m_step_published)
+		{
+			Publish(1.0f);
+		}
+
+		m_asynchronous		= asynchronous;
+		m_time_accumulated	= 0.0f;
+		m_step_count		= 0;
+		m_step_published	= true;
+	}
+
+	void Physics::Sync()
+	{
+		// If a worker hasn't picked the step up yet, it's quicker to run it here than to wait for one
+		auto expected = static_cast<uint32_t>(_Physics::step_queued);
+		if (m_step_state->compare_exchange_strong(expected, _Physics::step_running))
+		{
+			Step_Execute();
+			*m_step_state = _Physics::step_idle;
+			return;
+		}
+
+		while (*m_step_state != _Physics::step_idle)
+		{
+			this_thread::yield();
+		}
+	}
+
+	void Physics::Step_Schedule(const float delta_time)
+	{
+		// Fixed steps, the time that doesn't add up to a whole step carries over and is what the interpolation covers
+		auto step_duration		= 1.0f / m_internal_fps;
+		uint32_t step_count		= 0;
+		if (m_max_sub_steps < 0)
+		{
+			step_duration		= delta_time;
+			step_count			= 1;
+			m_time_accumulated	= step_duration;
+		}
+		else
+		{
+			m_time_accumulated	+= delta_time;
+			step_count			= static_cast<uint32_t>(m_time_accumulated / step_duration);
+			m_time_accumulated	-= step_count * step_duration;
+		}
+
+		// Steps that the world didn't get to tick for (e.g. while loading) add up, within the sub step limit, the rest is
+		// dropped so that a slow frame doesn't snowball into slower ones
+		m_step_count = m_step_count + step_count;
+		if (m_max_sub_steps != 0)
+		{
+			m_step_count = Min(m_step_count, static_cast<uint32_t>(Abs(m_max_sub_steps)));
+		}
+
+		m_step_duration	= step_duration;
+		m_step_alpha	= Clamp(m_time_accumulated / step_duration, 0.0f, 1.0f);
+
+		// Nothing to step, only the interpolation moves
+		if (m_step_count == 0)
+		{
+			Publish(m_step_alpha);
+			return;
+		}
+
+		m_step_published = false;
+	}
+
+	void Physics::Step_Kick()
+	{
+		if (!m_asynchronous || m_step_count == 0)
+			return;
+
+		// Steps that were scheduled before the game stopped are dropped
+		if (!m_context->m_engine->EngineMode_IsSet(Engine_Physics) || !m_context->m_engine->EngineMode_IsSet(Engine_Game))
+		{
+			m_step_count = 0;
+			return;
+		}
+
+		*m_step_state = _Physics::step_queued;
+
+		// The state is shared so that a task which lost the step to the sync point doesn't touch the subsystem after that
+		m_threading->AddTask([this, state = m_step_state]()
+		{
+			auto expected = static_cast<uint32_t>(_Physics::step_queued);
+			if (state->compare_exchange_strong(expected, _Physics::step_running))
+			{
+				Step_Execute();
+				*state = _Physics::step_idle;
+			}
+		});
+	}
+
+	void Physics::Step_Execute()
+	{
+		auto& objects = m_world->getCollisionObjectArray();
+
+		m_simulating = true;
+		for (uint32_t step = 0; step < m_step_count; step++)
+		{
+			m_world->stepSimulation(m_step_duration, 1, m_step_duration);
+
+			// Keep the last two states of every body that moves, the motion states don't write to the transforms in this mode
+			for (int i = 0; i < m_world->getNumCollisionObjects(); i++)
+			{
+				const auto body = btRigidBody::upcast(objects[i]);
+				if (!body || body->isStaticOrKinematicObject())
+					continue;
+
+				if (const auto rigid_body = static_cast<RigidBody*>(body->getUserPointer()))
+				{
+					rigid_body->Async_Record();
+				}
+			}
+		}
+		m_step_count = 0;
+		m_simulating = false;
+	}
+
+	void Physics::Publish(const float alpha)
+	{
+		m_transforms_moved.clear();
+
+		const auto& objects = m_world->getCollisionObjectArray();
+		for (int i = 0; i < m_world->getNumCollisionObjects(); i++)
+		{
+			// Sleeping bodies have been still for a while, they are where they were last published
+			const auto body = btRigidBody::upcast(objects[i]);
+			if (!body || body->isStaticOrKinematicObject() || !body->isActive())
+				continue;
+
+			if (const auto rigid_body = static_cast<RigidBody*>(body->getUserPointer()))
+			{
+				rigid_body->Async_Publish(alpha);
+				m_transforms_moved.emplace_back(rigid_body->GetTransform());
+			}
+		}
+
+		Transform::UpdateTransforms(m_transforms_moved);
+	}
+
+	void Physics::SyncTransforms()
+	{
+		// Bullet reported (through the motion states) only the bodies that are awake, write all of their poses
+		// and then update their hierarchies, instead of updating a hierarchy for every position and rotation.
+		m_transforms_moved.clear();
+		for (const auto& rigid_body : m_bodies_moved)
+		{
+			rigid_body->Pose_Publish();
+			m_transforms_moved.emplace_back(rigid_body->GetTransform());
+		}
+		m_bodies_moved.clear();
+
+		Transform::UpdateTransforms(m_transforms_moved);
+	}
+
+	void Physics::Query(PhysicsQuery* query)
+	{
+		if (!m_world || !query || query->GetCount() == 0)
+			return;
+
+		// The world can't be stepping while it's being read
+		if (this_thread::get_id() == m_thread_id)
+		{
+			Sync();
+		}
+		else if (*m_step_state != _Physics::step_idle)
+		{
+			LOG_ERROR("Queries from other threads can only be made while the world ticks");
+			return;
+		}
+
+		const auto count = query->GetCount();
+
+		// Bullet's ray tests share their stacks and its allocators aren't locked unless it's built with BT_THREADSAFE
+		if (!PhysicsTaskScheduler::IsSupported(m_threading))
+		{
+			lock_guard<mutex> lock(m_query_mutex); // scripts that update in parallel can query at the same time
+			query->Execute(m_world, 0, count);
+			return;
+		}
+
+		const auto chunk_size	= Max(count / ((m_threading->GetThreadCount() + 1) * _Physics::query_chunks_per_thread), _Physics::query_chunk_size_min);
+		const auto chunk_count	= (count + chunk_size - 1) / chunk_size;
+
+		if (chunk_count == 1)
+		{
+			query->Execute(m_world, 0, count);
+			return;
+		}
+
+		m_threading->ForEach([this, query, count, chunk_size](const uint32_t chunk)
+		{
+			const auto start = chunk * chunk_size;
+			query->Execute(m_world, start, Min(start + chunk_size, count));
+		}, chunk_count);
+	}
+
+	void Physics::Benchmark(const uint32_t box_count, const uint32_t step_count)
+	{
+		if (!m_task_scheduler)
+		{
+			LOG_WARNING("Physics are simulated on a single thread, there is nothing to compare against");
+			return;
+		}
+
+		if (this_thread::get_id() != m_thread_id)
+		{
+			LOG_ERROR("The benchmark can only be run by the thread that ticks physics");
+			return;
+		}
+
+		// The scheduler is swapped below, a step of the world must not be running on it meanwhile
+		Sync();
+
+		const auto thread_count	= m_task_scheduler->getNumThreads();
+		const auto time_serial	= _Physics::step_box_stack(btGetSequentialTaskScheduler(), thread_count, box_count, step_count);
+		const auto time_threads	= _Physics::step_box_stack(m_task_scheduler, thread_count, box_count, step_count);
+
+		LOG_INFO(
+			"%d boxes, %d steps: %.2f ms on one thread, %.2f ms on %d threads (%.2fx)",
+			box_count,
+			step_count,
+			time_serial,
+			time_threads,
+			thread_count,
+			time_threads != 0.0 ? time_serial / time_threads : 0.0
+		);
+	}
+
 	Vector3 Physics::GetGravity() const
 	{
 		auto gravity = m_world->getGravity();
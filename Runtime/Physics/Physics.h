@@ -22,6 +22,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES ==================
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
 #include "../Core/ISubsystem.h"
 #include "../Math/Vector3.h"
 //=============================
@@ -32,13 +37,19 @@ class btCollisionDispatcher;
 class btConstraintSolver;
 class btDefaultCollisionConfiguration;
 class btDiscreteDynamicsWorld;
+class btITaskScheduler;
 //====================================
 
 namespace Spartan
 {
 	class Renderer;
 	class PhysicsDebugDraw;
+	class PhysicsQuery;
+	class PhysicsShapeCache;
 	class Profiler;
+	class Threading;
+	class RigidBody;
+	class Transform;
 	namespace Math { class Vector3; }	
 
 	class Physics : public ISubsystem
@@ -55,17 +66,49 @@ namespace Spartan
 		Math::Vector3 GetGravity()  const;
 		auto GetWorld()             const { return m_world; }
         auto GetPhysicsDebugDraw()  const { return m_debug_draw; }
+        auto GetShapeCache()        const { return m_shape_cache; }
 		bool IsSimulating()         const { return m_simulating; }
 
+		// Asynchronous stepping, the world is stepped on a worker thread while the frame renders and the results are published
+		// to the transforms (interpolated between the last two fixed steps) when the next frame ticks physics. Anything that
+		// modifies the world outside of the world's tick (editor, importers, other threads) has to call Sync() first.
+		void SetAsynchronous(bool asynchronous);
+		bool IsAsynchronous() const { return m_asynchronous; }
+		void Sync();
+
+		// Called by the motion states during a step, the transforms of the bodies that moved are synchronized in one pass after it
+		void AddMovedBody(RigidBody* body) { m_bodies_moved.emplace_back(body); }
+
+		// Executes a batch of ray, sweep and overlap queries on the worker threads (and the calling thread), returns once they are done.
+		// When Bullet isn't thread safe (see PhysicsTaskScheduler::IsSupported()), they run on the calling thread, one batch at a time.
+		// Asynchronous stepping is synced first, so the queries see the world as of the last step. Only the thread that ticks physics
+		// can sync, other threads (e.g. scripts that update in parallel) can only query while the world ticks, when no step is in flight.
+		void Query(PhysicsQuery* query);
+
+		// Steps a stack of boxes in a world of its own, once on the calling thread alone and once on the worker threads,
+		// and logs how long each took. Nothing is rendered and the scene isn't touched, but the global task scheduler is
+		// swapped while it runs, so it syncs any asynchronous step first and must be called by the thread that ticks physics.
+		void Benchmark(uint32_t box_count = 2000, uint32_t step_count = 300);
+
 	private:
+		void Step_Schedule(float delta_time);
+		void Step_Kick();
+		void Step_Execute();
+		void Publish(float alpha);
+		void SyncTransforms();
+
 		btBroadphaseInterface* m_broadphase                         = nullptr;
 		btCollisionDispatcher* m_dispatcher                         = nullptr;
-		btConstraintSolver* m_constraint_solver                     = nullptr;
+		btConstraintSolver* m_constraint_solver                     = nullptr; // a pool, islands take whichever solver is free
+		btConstraintSolver* m_constraint_solver_mt                  = nullptr; // for islands that are large enough to be solved in parallel
+		btITaskScheduler* m_task_scheduler                          = nullptr;
 		btDefaultCollisionConfiguration* m_collision_configuration  = nullptr;
 		btDiscreteDynamicsWorld* m_world                            = nullptr;
 		PhysicsDebugDraw* m_debug_draw                              = nullptr;
+		PhysicsShapeCache* m_shape_cache                            = nullptr;
         Renderer* m_renderer                                        = nullptr;
         Profiler* m_profiler                                        = nullptr;
+        Threading* m_threading                                      = nullptr;
 
 		//= PROPERTIES =================================================
         int m_max_sub_steps         = 1;
@@ -73,6 +116,21 @@ namespace Spartan
         float m_internal_fps        = 60.0f;
         Math::Vector3 m_gravity     = Math::Vector3(0.0f, -9.81f, 0.0f);
         bool m_simulating           = false;
+		bool m_asynchronous         = false;
+		//==============================================================
+
+		//= ASYNCHRONOUS STEPPING ======================================
+		std::shared_ptr<std::atomic<uint32_t>> m_step_state;
+		std::thread::id m_thread_id; // the one that ticks physics, only it runs or waits for steps
+		float m_time_accumulated    = 0.0f;
+		float m_step_duration       = 0.0f;
+		uint32_t m_step_count       = 0; // scheduled, they start once the world has ticked
+		float m_step_alpha          = 0.0f;
+		bool m_step_published       = true;
 		//==============================================================
+
+		std::vector<RigidBody*> m_bodies_moved;
+		std::vector<Transform*> m_transforms_moved;
+		std::mutex m_query_mutex; // queries share Bullet's ray test stacks when it isn't thread safe
 	};
 }
@@ -0,0 +1,200 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===================================================
+#include "PhysicsQuery.h"
+#include "BulletPhysicsHelper.h"
+#include "../World/Components/RigidBody.h"
+#pragma warning(push, 0) // Hide warnings which belong to Bullet
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
+#pragma warning(pop)
+//==============================================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Spartan::Math;
+//=============================
+
+namespace _PhysicsQuery
+{
+	// Keeps the first contact that actually touches
+	struct OverlapCallback : btCollisionWorld::ContactResultCallback
+	{
+		btScalar addSingleResult(btManifoldPoint& point, const btCollisionObjectWrapper* object_a, int, int, const btCollisionObjectWrapper* object_b, int, int) override
+		{
+			if (object || point.getDistance() > 0.0f)
+				return 0.0f;
+
+			object		= object_b->getCollisionObject();
+			position	= point.getPositionWorldOnB();
+			normal		= point.m_normalWorldOnB;
+			return 0.0f;
+		}
+
+		const btCollisionObject* object = nullptr;
+		btVector3 position;
+		btVector3 normal;
+	};
+}
+
+namespace Spartan
+{
+	uint32_t PhysicsQuery::AddRay(const Vector3& from, const Vector3& to)
+	{
+		return Add(PhysicsQuery_Ray, from, to, 0.0f);
+	}
+
+	uint32_t PhysicsQuery::AddSweep(const Vector3& from, const Vector3& to, const float radius)
+	{
+		return Add(PhysicsQuery_Sweep, from, to, radius);
+	}
+
+	uint32_t PhysicsQuery::AddOverlap(const Vector3& center, const float radius)
+	{
+		return Add(PhysicsQuery_Overlap, center, center, radius);
+	}
+
+	void PhysicsQuery::Clear()
+	{
+		m_type.clear();
+		m_from.clear();
+		m_to.clear();
+		m_radius.clear();
+		m_hit.clear();
+		m_hit_fraction.clear();
+		m_hit_position.clear();
+		m_hit_normal.clear();
+		m_hit_body.clear();
+	}
+
+	bool PhysicsQuery::IsHit(const uint32_t index) const
+	{
+		return index < GetCount() ? m_hit[index] != 0 : false;
+	}
+
+	float PhysicsQuery::GetHitFraction(const uint32_t index) const
+	{
+		return index < GetCount() ? m_hit_fraction[index] : 1.0f;
+	}
+
+	Vector3 PhysicsQuery::GetHitPosition(const uint32_t index) const
+	{
+		return index < GetCount() ? m_hit_position[index] : Vector3::Zero;
+	}
+
+	Vector3 PhysicsQuery::GetHitNormal(const uint32_t index) const
+	{
+		return index < GetCount() ? m_hit_normal[index] : Vector3::Zero;
+	}
+
+	RigidBody* PhysicsQuery::GetHitBody(const uint32_t index) const
+	{
+		return index < GetCount() ? m_hit_body[index] : nullptr;
+	}
+
+	Entity* PhysicsQuery::GetHitEntity(const uint32_t index) const
+	{
+		const auto body = GetHitBody(index);
+		return body ? body->GetEntity_PtrRaw() : nullptr;
+	}
+
+	void PhysicsQuery::Execute(btCollisionWorld* world, const uint32_t start, const uint32_t end)
+	{
+		for (uint32_t i = start; i < end && i < GetCount(); i++)
+		{
+			const auto from	= ToBtVector3(m_from[i]);
+			const auto to	= ToBtVector3(m_to[i]);
+
+			const btCollisionObject* object	= nullptr;
+			btScalar fraction				= 1.0f;
+			btVector3 position				= to;
+			btVector3 normal				= btVector3(0.0f, 0.0f, 0.0f);
+
+			if (m_type[i] == PhysicsQuery_Ray)
+			{
+				btCollisionWorld::ClosestRayResultCallback callback(from, to);
+				world->rayTest(from, to, callback);
+				if (callback.hasHit())
+				{
+					object		= callback.m_collisionObject;
+					fraction	= callback.m_closestHitFraction;
+					position	= callback.m_hitPointWorld;
+					normal		= callback.m_hitNormalWorld;
+				}
+			}
+			else if (m_type[i] == PhysicsQuery_Sweep)
+			{
+				btSphereShape sphere(m_radius[i]);
+				btCollisionWorld::ClosestConvexResultCallback callback(from, to);
+				world->convexSweepTest(&sphere, btTransform(btQuaternion::getIdentity(), from), btTransform(btQuaternion::getIdentity(), to), callback);
+				if (callback.hasHit())
+				{
+					object		= callback.m_hitCollisionObject;
+					fraction	= callback.m_closestHitFraction;
+					position	= callback.m_hitPointWorld;
+					normal		= callback.m_hitNormalWorld;
+				}
+			}
+			else if (m_type[i] == PhysicsQuery_Overlap)
+			{
+				btSphereShape sphere(m_radius[i]);
+				btCollisionObject query_object;
+				query_object.setCollisionShape(&sphere);
+				query_object.setWorldTransform(btTransform(btQuaternion::getIdentity(), from));
+
+				_PhysicsQuery::OverlapCallback callback;
+				world->contactTest(&query_object, callback);
+				if (callback.object)
+				{
+					object		= callback.object;
+					fraction	= 0.0f;
+					position	= callback.position;
+					normal		= callback.normal;
+				}
+			}
+
+			// Bodies keep their RigidBody component as their user pointer
+			m_hit[i]			= object ? 1 : 0;
+			m_hit_fraction[i]	= fraction;
+			m_hit_position[i]	= ToVector3(position);
+			m_hit_normal[i]		= ToVector3(normal);
+			m_hit_body[i]		= object ? static_cast<RigidBody*>(object->getUserPointer()) : nullptr;
+		}
+	}
+
+	uint32_t PhysicsQuery::Add(const PhysicsQuery_Type type, const Vector3& from, const Vector3& to, const float radius)
+	{
+		m_type.emplace_back(type);
+		m_from.emplace_back(from);
+		m_to.emplace_back(to);
+		m_radius.emplace_back(radius);
+
+		// Results are sized along with the queries, so that ranges of them can be written concurrently
+		m_hit.emplace_back(0);
+		m_hit_fraction.emplace_back(1.0f);
+		m_hit_position.emplace_back(to);
+		m_hit_normal.emplace_back(Vector3::Zero);
+		m_hit_body.emplace_back(nullptr);
+
+		return GetCount() - 1;
+	}
+}
@@ -0,0 +1,93 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <vector>
+#include "../Core/EngineDefs.h"
+#include "../Math/Vector3.h"
+//=============================
+
+class btCollisionWorld;
+
+namespace Spartan
+{
+	class Entity;
+	class RigidBody;
+
+	enum PhysicsQuery_Type : uint32_t
+	{
+		PhysicsQuery_Ray,		// closest hit along a segment
+		PhysicsQuery_Sweep,		// closest hit of a sphere that moves along a segment
+		PhysicsQuery_Overlap	// a body that a sphere touches
+	};
+
+	// A batch of queries against the physics world, they are submitted together (Physics::Query) and split across the worker threads.
+	// Queries and results are parallel arrays, result i belongs to query i. A batch can be kept and executed again every frame.
+	class SPARTAN_CLASS PhysicsQuery
+	{
+	public:
+		PhysicsQuery() = default;
+		~PhysicsQuery() = default;
+
+		// Queries, they return the index of their result
+		uint32_t AddRay(const Math::Vector3& from, const Math::Vector3& to);
+		uint32_t AddSweep(const Math::Vector3& from, const Math::Vector3& to, float radius);
+		uint32_t AddOverlap(const Math::Vector3& center, float radius);
+		uint32_t GetCount() const { return static_cast<uint32_t>(m_type.size()); }
+		void Clear();
+
+		// Results
+		bool IsHit(uint32_t index) const;
+		float GetHitFraction(uint32_t index) const;						// along the segment, 0 for overlaps
+		Math::Vector3 GetHitPosition(uint32_t index) const;
+		Math::Vector3 GetHitNormal(uint32_t index) const;
+		RigidBody* GetHitBody(uint32_t index) const;
+		Entity* GetHitEntity(uint32_t index) const;
+
+		// Results, as arrays
+		const auto& GetHits() const				{ return m_hit; }
+		const auto& GetHitFractions() const		{ return m_hit_fraction; }
+		const auto& GetHitPositions() const		{ return m_hit_position; }
+		const auto& GetHitNormals() const		{ return m_hit_normal; }
+		const auto& GetHitBodies() const		{ return m_hit_body; }
+
+		// Executes the queries in [start, end), the world is only read so ranges can be executed concurrently
+		void Execute(btCollisionWorld* world, uint32_t start, uint32_t end);
+
+	private:
+		uint32_t Add(PhysicsQuery_Type type, const Math::Vector3& from, const Math::Vector3& to, float radius);
+
+		// Queries
+		std::vector<PhysicsQuery_Type> m_type;
+		std::vector<Math::Vector3> m_from;
+		std::vector<Math::Vector3> m_to;
+		std::vector<float> m_radius;
+
+		// Results
+		std::vector<uint8_t> m_hit;
+		std::vector<float> m_hit_fraction;
+		std::vector<Math::Vector3> m_hit_position;
+		std::vector<Math::Vector3> m_hit_normal;
+		std::vector<RigidBody*> m_hit_body;
+	};
+}
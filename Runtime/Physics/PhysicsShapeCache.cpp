@@ -0,0 +1,555 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ============================================================
+#include "PhysicsShapeCache.h"
+#include "BulletPhysicsHelper.h"
+#include "../Core/Context.h"
+#include "../Core/FileSystem.h"
+#include "../Core/Hash.h"
+#include "../Math/MathHelper.h"
+#include "../IO/FileStream.h"
+#include "../Rendering/Mesh.h"
+#include "../Rendering/Model.h"
+#include "../Resource/ResourceCache.h"
+#include "../World/Components/Renderable.h"
+#pragma warning(push, 0) // Hide warnings which belong to Bullet
+#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btShapeHull.h>
+#include <BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
+#include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
+#include <LinearMath/btConvexHullComputer.h>
+#pragma warning(pop)
+//=======================================================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Spartan::Math;
+//=============================
+
+namespace Spartan
+{
+	struct PhysicsShape_Data
+	{
+		~PhysicsShape_Data()
+		{
+			delete triangles;
+			delete mesh;
+
+			if (bvh_buffer)
+			{
+				bvh->~btOptimizedBvh();
+				btAlignedFree(bvh_buffer);
+			}
+		}
+
+		PhysicsShape_Type type	= PhysicsShape_Hull;
+		uint64_t content_hash	= 0; // of the geometry and the settings it was built with
+
+		// Hulls (one, or many for a decomposition)
+		vector<vector<Vector3>> hulls;
+
+		// Triangles, the mesh interface references the positions and indices, the BVH is kept serialized as well (it's what goes to disk)
+		vector<Vector3> positions;
+		vector<uint32_t> indices;
+		vector<std::byte> bvh_serialized;
+		btTriangleIndexVertexArray* mesh	= nullptr;
+		btBvhTriangleMeshShape* triangles	= nullptr;
+		btOptimizedBvh* bvh					= nullptr; // lives in bvh_buffer, when it was loaded
+		void* bvh_buffer					= nullptr;
+	};
+}
+
+namespace _PhysicsShapeCache
+{
+	using namespace Spartan;
+
+	static const uint32_t file_version			= 1;
+	static const char* file_extension			= ".shape";
+	static const uint32_t decomposition_depth	= 5;		// up to 32 hulls
+	static const float decomposition_concavity	= 0.05f;	// a split has to cut away this much of its hull's volume to be kept
+
+	// Drops the entries that nobody uses anymore, once the map has doubled in size since it was last pruned
+	template<typename Map, typename IsExpired>
+	static void prune(Map& entries, size_t* size_pruned, IsExpired is_expired)
+	{
+		if (entries.size() < Max(*size_pruned * 2, static_cast<size_t>(64)))
+			return;
+
+		for (auto it = entries.begin(); it != entries.end();)
+		{
+			it = is_expired(it->second) ? entries.erase(it) : next(it);
+		}
+		*size_pruned = entries.size();
+	}
+
+	// Computes the convex hull of the points, returns its volume
+	static float compute_hull(const vector<Vector3>& points, vector<Vector3>* hull_points)
+	{
+		hull_points->clear();
+		if (points.size() < 4)
+		{
+			*hull_points = points;
+			return 0.0f;
+		}
+
+		btConvexHullComputer hull;
+		hull.compute(&points[0].x, static_cast<int>(sizeof(Vector3)), static_cast<int>(points.size()), 0.0f, 0.0f);
+
+		hull_points->reserve(hull.vertices.size());
+		btVector3 center(0.0f, 0.0f, 0.0f);
+		for (int i = 0; i < hull.vertices.size(); i++)
+		{
+			hull_points->emplace_back(ToVector3(hull.vertices[i]));
+			center += hull.vertices[i];
+		}
+		center /= static_cast<btScalar>(Max(hull.vertices.size(), 1));
+
+		// Sum the tetrahedra that the faces (fanned out) make with the center
+		float volume = 0.0f;
+		for (int i = 0; i < hull.faces.size(); i++)
+		{
+			const auto edge_first	= &hull.edges[hull.faces[i]];
+			const auto& a			= hull.vertices[edge_first->getSourceVertex()] - center;
+			for (auto edge = edge_first->getNextEdgeOfFace(); edge->getTargetVertex() != edge_first->getSourceVertex(); edge = edge->getNextEdgeOfFace())
+			{
+				const auto& b = hull.vertices[edge->getSourceVertex()] - center;
+				const auto& c = hull.vertices[edge->getTargetVertex()] - center;
+				volume += btFabs(a.dot(b.cross(c))) / 6.0f;
+			}
+		}
+
+		return volume;
+	}
+
+	// Reduces a hull to a few dozen points (it accounts for the collision margin)
+	static void simplify_hull(vector<Vector3>* points)
+	{
+		if (points->size() < 4)
+			return;
+
+		btConvexHullShape shape(&(*points)[0].x, static_cast<int>(points->size()), static_cast<int>(sizeof(Vector3)));
+		btShapeHull shape_hull(&shape);
+		if (!shape_hull.buildHull(shape.getMargin()))
+			return;
+
+		// Small hulls are already as simple as they get
+		if (static_cast<size_t>(shape_hull.numVertices()) >= points->size())
+			return;
+
+		points->clear();
+		for (int i = 0; i < shape_hull.numVertices(); i++)
+		{
+			points->emplace_back(ToVector3(shape_hull.getVertexPointer()[i]));
+		}
+	}
+
+	// Splits a triangle soup by an axis aligned plane, the triangles that cross it are clipped (and fanned back into triangles)
+	static void split_triangles(const vector<Vector3>& triangles, const uint32_t axis, const float split, vector<Vector3>* below, vector<Vector3>* above)
+	{
+		vector<Vector3>* sides[2] = { below, above };
+		for (size_t i = 0; i + 2 < triangles.size(); i += 3)
+		{
+			Vector3 polygons[2][4];
+			uint32_t polygon_sizes[2] = { 0, 0 };
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				const auto& a			= triangles[i + j];
+				const auto& b			= triangles[i + (j + 1) % 3];
+				const auto distance_a	= (&a.x)[axis] - split;
+				const auto distance_b	= (&b.x)[axis] - split;
+				const auto side_a		= distance_a < 0.0f ? 0 : 1;
+
+				polygons[side_a][polygon_sizes[side_a]++] = a;
+				if (side_a != (distance_b < 0.0f ? 0 : 1))
+				{
+					const auto point = a + (b - a) * (distance_a / (distance_a - distance_b));
+					polygons[0][polygon_sizes[0]++] = point;
+					polygons[1][polygon_sizes[1]++] = point;
+				}
+			}
+
+			for (uint32_t side = 0; side < 2; side++)
+			{
+				for (uint32_t j = 2; j < polygon_sizes[side]; j++)
+				{
+					sides[side]->emplace_back(polygons[side][0]);
+					sides[side]->emplace_back(polygons[side][j - 1]);
+					sides[side]->emplace_back(polygons[side][j]);
+				}
+			}
+		}
+	}
+
+	// Hierarchical approximate convex decomposition, a part is cut in two (across the longest axis of its bounds) for
+	// as long as the hulls of the halves leave out enough of the empty space that the hull of the whole part covers.
+	static void decompose(const vector<Vector3>& triangles, const vector<Vector3>& hull, const float hull_volume, const uint32_t depth, vector<vector<Vector3>>* hulls)
+	{
+		const auto emit = [&hull, hulls]() { if (!hull.empty()) hulls->emplace_back(hull); };
+
+		if (depth == decomposition_depth || hull_volume <= 0.0f)
+		{
+			emit();
+			return;
+		}
+
+		// Cut through the middle of the longest axis of the part's bounds
+		Vector3 min = Vector3::Infinity;
+		Vector3 max = Vector3::InfinityNeg;
+		for (const auto& point : hull)
+		{
+			min = Vector3(Min(min.x, point.x), Min(min.y, point.y), Min(min.z, point.z));
+			max = Vector3(Max(max.x, point.x), Max(max.y, point.y), Max(max.z, point.z));
+		}
+		const auto extent	= max - min;
+		const uint32_t axis	= (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+		const auto split	= ((&min.x)[axis] + (&max.x)[axis]) * 0.5f;
+
+		vector<Vector3> triangles_halves[2];
+		split_triangles(triangles, axis, split, &triangles_halves[0], &triangles_halves[1]);
+
+		vector<Vector3> hull_halves[2];
+		float volume_halves[2];
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			volume_halves[i] = compute_hull(triangles_halves[i], &hull_halves[i]);
+		}
+
+		// Not concave enough to be worth more hulls
+		if (triangles_halves[0].empty() || triangles_halves[1].empty() || volume_halves[0] + volume_halves[1] > hull_volume * (1.0f - decomposition_concavity))
+		{
+			emit();
+			return;
+		}
+
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			decompose(triangles_halves[i], hull_halves[i], volume_halves[i], depth + 1, hulls);
+		}
+	}
+
+	static void build(PhysicsShape_Data* data, const bool simplify)
+	{
+		if (data->type == PhysicsShape_Triangles)
+		{
+			// The BVH is built by the shape, it's serialized so that loads can skip building it
+			data->mesh		= new btTriangleIndexVertexArray(
+				static_cast<int>(data->indices.size() / 3),
+				reinterpret_cast<int*>(data->indices.data()),
+				static_cast<int>(3 * sizeof(uint32_t)),
+				static_cast<int>(data->positions.size()),
+				&data->positions[0].x,
+				static_cast<int>(sizeof(Vector3))
+			);
+			data->triangles	= new btBvhTriangleMeshShape(data->mesh, true, true);
+
+			const auto bvh	= data->triangles->getOptimizedBvh();
+			const auto size	= bvh->calculateSerializeBufferSize();
+			const auto buffer = btAlignedAlloc(size, 16);
+			bvh->serializeInPlace(buffer, size, false);
+			data->bvh_serialized.resize(size);
+			memcpy(data->bvh_serialized.data(), buffer, size);
+			btAlignedFree(buffer);
+			return;
+		}
+
+		// The hull of the whole mesh
+		vector<Vector3> hull;
+		const auto volume = compute_hull(data->positions, &hull);
+
+		if (data->type == PhysicsShape_Hull)
+		{
+			data->hulls.emplace_back(hull);
+		}
+		else if (data->type == PhysicsShape_Decomposition)
+		{
+			vector<Vector3> triangles;
+			triangles.reserve(data->indices.size());
+			for (const auto index : data->indices)
+			{
+				triangles.emplace_back(data->positions[index]);
+			}
+
+			decompose(triangles, hull, volume, 0, &data->hulls);
+		}
+
+		if (simplify)
+		{
+			for (auto& points : data->hulls)
+			{
+				simplify_hull(&points);
+			}
+		}
+
+		// Only the triangle shapes need the geometry after building
+		data->positions.clear();
+		data->positions.shrink_to_fit();
+		data->indices.clear();
+		data->indices.shrink_to_fit();
+	}
+
+	static bool save(const string& file_path, const PhysicsShape_Data& data)
+	{
+		auto file = FileStream(file_path, FileStream_Write);
+		if (!file.IsOpen())
+			return false;
+
+		file.Write(file_version);
+		file.Write(static_cast<uint32_t>(data.type));
+		file.Write(static_cast<uint32_t>(data.hulls.size()));
+		for (const auto& hull : data.hulls)
+		{
+			file.Write(hull);
+		}
+		file.Write(data.positions);
+		file.Write(data.indices);
+		file.Write(data.bvh_serialized);
+
+		return true;
+	}
+
+	static bool load(const string& file_path, PhysicsShape_Data* data)
+	{
+		auto file = FileStream(file_path, FileStream_Read);
+		if (!file.IsOpen() || file.ReadAs<uint32_t>() != file_version || file.ReadAs<uint32_t>() != data->type)
+			return false;
+
+		data->hulls.resize(file.ReadAs<uint32_t>());
+		for (auto& hull : data->hulls)
+		{
+			file.Read(&hull);
+		}
+		file.Read(&data->positions);
+		file.Read(&data->indices);
+		file.Read(&data->bvh_serialized);
+
+		if (data->type != PhysicsShape_Triangles)
+			return !data->hulls.empty();
+
+		if (data->positions.empty() || data->indices.empty() || data->bvh_serialized.empty())
+			return false;
+
+		// The BVH is used in place, from a copy that's aligned the way Bullet wants it
+		const auto size		= static_cast<unsigned int>(data->bvh_serialized.size());
+		data->bvh_buffer	= btAlignedAlloc(size, 16);
+		memcpy(data->bvh_buffer, data->bvh_serialized.data(), size);
+		data->bvh			= btOptimizedBvh::deSerializeInPlace(data->bvh_buffer, size, false);
+		if (!data->bvh)
+		{
+			btAlignedFree(data->bvh_buffer);
+			data->bvh_buffer = nullptr;
+			return false;
+		}
+
+		data->mesh		= new btTriangleIndexVertexArray(
+			static_cast<int>(data->indices.size() / 3),
+			reinterpret_cast<int*>(data->indices.data()),
+			static_cast<int>(3 * sizeof(uint32_t)),
+			static_cast<int>(data->positions.size()),
+			&data->positions[0].x,
+			static_cast<int>(sizeof(Vector3))
+		);
+		data->triangles	= new btBvhTriangleMeshShape(data->mesh, true, false);
+		data->triangles->setOptimizedBvh(data->bvh);
+
+		return true;
+	}
+}
+
+namespace Spartan
+{
+	PhysicsShapeCache::PhysicsShapeCache(Context* context)
+	{
+		m_context = context;
+	}
+
+	shared_ptr<btCollisionShape> PhysicsShapeCache::Acquire(Renderable* renderable, const PhysicsShape_Type type, const bool simplify, const Vector3& scale)
+	{
+		const auto data = AcquireData(renderable, type, simplify);
+		if (!data)
+			return nullptr;
+
+		// Shared by the colliders that use the same geometry at the same scale
+		const uint64_t key_data[2] = { data->content_hash, Hash::Compute(&scale, sizeof(Vector3)) };
+		const auto key = Hash::Compute(key_data, sizeof(key_data));
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			const auto it = m_shapes.find(key);
+			if (it != m_shapes.end())
+			{
+				if (auto shape = it->second.lock())
+					return shape;
+			}
+		}
+
+		// Created outside of the lock, it's cheap compared to the data, so two threads that race here just create one each
+		shared_ptr<btCollisionShape> shape;
+		if (type == PhysicsShape_Hull)
+		{
+			const auto& points	= data->hulls.front();
+			const auto hull		= new btConvexHullShape(&points[0].x, static_cast<int>(points.size()), static_cast<int>(sizeof(Vector3)));
+			hull->setLocalScaling(ToBtVector3(scale));
+			if (simplify)
+			{
+				hull->initializePolyhedralFeatures();
+			}
+			shape = shared_ptr<btCollisionShape>(hull);
+		}
+		else if (type == PhysicsShape_Decomposition)
+		{
+			const auto compound = new btCompoundShape(true, static_cast<int>(data->hulls.size()));
+			for (const auto& points : data->hulls)
+			{
+				const auto hull = new btConvexHullShape(&points[0].x, static_cast<int>(points.size()), static_cast<int>(sizeof(Vector3)));
+				if (simplify)
+				{
+					hull->initializePolyhedralFeatures();
+				}
+				compound->addChildShape(btTransform::getIdentity(), hull);
+			}
+			compound->setLocalScaling(ToBtVector3(scale));
+
+			// The compound doesn't own its children
+			shape = shared_ptr<btCollisionShape>(compound, [](btCollisionShape* shape)
+			{
+				const auto compound = static_cast<btCompoundShape*>(shape);
+				for (int i = 0; i < compound->getNumChildShapes(); i++)
+				{
+					delete compound->getChildShape(i);
+				}
+				delete compound;
+			});
+		}
+		else if (type == PhysicsShape_Triangles)
+		{
+			// Every scale shares the same (unscaled) BVH
+			shape = shared_ptr<btCollisionShape>(new btScaledBvhTriangleMeshShape(data->triangles, ToBtVector3(scale)), [data](btCollisionShape* shape) { delete shape; });
+		}
+
+		lock_guard<mutex> lock(m_mutex);
+		auto& entry = m_shapes[key];
+		if (auto shape_existing = entry.lock())
+			return shape_existing;
+
+		entry = shape;
+		_PhysicsShapeCache::prune(m_shapes, &m_shapes_size_pruned, [](const weak_ptr<btCollisionShape>& shape) { return shape.expired(); });
+		return shape;
+	}
+
+	shared_ptr<PhysicsShape_Data> PhysicsShapeCache::AcquireData(Renderable* renderable, const PhysicsShape_Type type, const bool simplify)
+	{
+		const auto& model = renderable ? renderable->GeometryModel() : nullptr;
+		if (!model || !model->GetMesh() || renderable->GeometryIndexCount() == 0 || renderable->GeometryVertexCount() == 0)
+			return nullptr;
+
+		const auto index_offset		= renderable->GeometryIndexOffset();
+		const auto index_count		= renderable->GeometryIndexCount();
+		const auto vertex_offset	= renderable->GeometryVertexOffset();
+		const auto vertex_count		= renderable->GeometryVertexCount();
+
+		// Read straight from the model's mesh, it's only copied if the shape has to be built
+		auto& vertices	= model->GetMesh()->Vertices_Get();
+		auto& indices	= model->GetMesh()->Indices_Get();
+		if (index_offset + index_count > indices.size() || vertex_offset + vertex_count > vertices.size())
+		{
+			LOG_ERROR("Invalid geometry range");
+			return nullptr;
+		}
+
+		// Data is addressed by what it's built from, so it can't go stale and it's shared by identical meshes (in memory and on disk)
+		const uint64_t settings = (static_cast<uint64_t>(type) << 1) | (simplify ? 1 : 0);
+		auto content_hash = Hash::Compute(&settings, sizeof(settings), _PhysicsShapeCache::file_version);
+		content_hash = Hash::Compute(&vertices[vertex_offset], vertex_count * sizeof(RHI_Vertex_PosTexNorTan), content_hash);
+		content_hash = Hash::Compute(&indices[index_offset], index_count * sizeof(uint32_t), content_hash);
+
+		// Already there, or being loaded/built by another thread
+		promise<shared_ptr<PhysicsShape_Data>> pending;
+		{
+			unique_lock<mutex> lock(m_mutex);
+			auto& entry = m_data[content_hash];
+			if (auto data = entry.data.lock())
+				return data;
+
+			if (entry.pending.valid())
+			{
+				const auto future = entry.pending;
+				lock.unlock();
+				return future.get();
+			}
+
+			entry.pending = pending.get_future().share();
+		}
+
+		const auto file_path = GetFilePath(content_hash);
+		auto data			= make_shared<PhysicsShape_Data>();
+		data->type			= type;
+		data->content_hash	= content_hash;
+		if (!FileSystem::FileExists(file_path) || !_PhysicsShapeCache::load(file_path, data.get()))
+		{
+			data				= make_shared<PhysicsShape_Data>();
+			data->type			= type;
+			data->content_hash	= content_hash;
+
+			data->positions.reserve(vertex_count);
+			for (uint32_t i = 0; i < vertex_count; i++)
+			{
+				const auto& position = vertices[vertex_offset + i].pos;
+				data->positions.emplace_back(position[0], position[1], position[2]);
+			}
+			data->indices.assign(indices.begin() + index_offset, indices.begin() + index_offset + index_count);
+
+			_PhysicsShapeCache::build(data.get(), simplify);
+
+			if (!_PhysicsShapeCache::save(file_path, *data))
+			{
+				LOG_WARNING("Failed to save \"%s\", the shape will be built again next time", file_path.c_str());
+			}
+		}
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			auto& entry		= m_data[content_hash];
+			entry.data		= data;
+			entry.pending	= {};
+			_PhysicsShapeCache::prune(m_data, &m_data_size_pruned, [](const Data_Entry& entry) { return entry.data.expired() && !entry.pending.valid(); });
+		}
+		pending.set_value(data);
+
+		return data;
+	}
+
+	string PhysicsShapeCache::GetFilePath(const uint64_t content_hash) const
+	{
+		const auto directory = m_context->GetSubsystem<ResourceCache>()->GetProjectDirectory() + "ShapeCache//";
+		if (!FileSystem::DirectoryExists(directory))
+		{
+			FileSystem::CreateDirectory_(directory);
+		}
+
+		char name[17];
+		snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(content_hash));
+		return directory + name + _PhysicsShapeCache::file_extension;
+	}
+}
@@ -0,0 +1,77 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =================
+#include <memory>
+#include <mutex>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include "../Math/Vector3.h"
+//============================
+
+class btCollisionShape;
+
+namespace Spartan
+{
+	class Context;
+	class Renderable;
+	struct PhysicsShape_Data;
+
+	enum PhysicsShape_Type : uint32_t
+	{
+		PhysicsShape_Hull,			// a single convex hull around the mesh
+		PhysicsShape_Decomposition,	// a compound of convex hulls that follows the concave parts of the mesh
+		PhysicsShape_Triangles		// the triangles themselves in a BVH, for static bodies only
+	};
+
+	// Collision shapes for the geometry of renderables, shared by every collider that asks for the same sub-mesh at the same scale.
+	// Building them (hulls, decompositions, BVHs) is the expensive part, so the results are also kept on disk, addressed
+	// by a hash of the geometry, and later loads (of any model that contains the same mesh) read them back instead.
+	class PhysicsShapeCache
+	{
+	public:
+		PhysicsShapeCache(Context* context);
+		~PhysicsShapeCache() = default;
+
+		// Returns nullptr if the renderable has no geometry. Simplification (hulls only) reduces the points to a few dozen.
+		std::shared_ptr<btCollisionShape> Acquire(Renderable* renderable, PhysicsShape_Type type, bool simplify, const Math::Vector3& scale);
+
+	private:
+		std::shared_ptr<PhysicsShape_Data> AcquireData(Renderable* renderable, PhysicsShape_Type type, bool simplify);
+		std::string GetFilePath(uint64_t content_hash) const;
+
+		// Keyed by content hash, the data is loaded or built outside of the lock, whoever asks for it meanwhile waits on it
+		struct Data_Entry
+		{
+			std::weak_ptr<PhysicsShape_Data> data;
+			std::shared_future<std::shared_ptr<PhysicsShape_Data>> pending;
+		};
+		std::unordered_map<uint64_t, Data_Entry> m_data;
+		std::unordered_map<uint64_t, std::weak_ptr<btCollisionShape>> m_shapes;
+		size_t m_data_size_pruned	= 0;
+		size_t m_shapes_size_pruned	= 0;
+		std::mutex m_mutex;
+		Context* m_context;
+	};
+}
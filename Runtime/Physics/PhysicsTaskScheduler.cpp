@@ -0,0 +1,105 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "PhysicsTaskScheduler.h"
+#include "../Threading/Threading.h"
+#include "../Math/MathHelper.h"
+//===================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Spartan::Math;
+//=============================
+
+namespace Spartan
+{
+	PhysicsTaskScheduler::PhysicsTaskScheduler(Threading* threading) : btITaskScheduler("Spartan")
+	{
+		m_threading		= threading;
+		m_thread_count	= static_cast<int>(threading->GetThreadCount()) + 1; // plus one for the thread that steps the world
+	}
+
+	void PhysicsTaskScheduler::parallelFor(const int begin, const int end, const int grain_size, const btIParallelForBody& body)
+	{
+		const auto chunk_size	= GetChunkSize(begin, end, grain_size);
+		const auto chunk_count	= static_cast<uint32_t>((end - begin + chunk_size - 1) / chunk_size);
+
+		// Not worth waking up the workers for
+		if (chunk_count <= 1)
+		{
+			body.forLoop(begin, end);
+			return;
+		}
+
+		m_threading->ForEach([&body, begin, end, chunk_size](const uint32_t i)
+		{
+			const auto chunk_begin = begin + static_cast<int>(i) * chunk_size;
+			body.forLoop(chunk_begin, Min(chunk_begin + chunk_size, end));
+		},
+		chunk_count);
+	}
+
+	btScalar PhysicsTaskScheduler::parallelSum(const int begin, const int end, const int grain_size, const btIParallelSumBody& body)
+	{
+		const auto chunk_size	= GetChunkSize(begin, end, grain_size);
+		const auto chunk_count	= static_cast<uint32_t>((end - begin + chunk_size - 1) / chunk_size);
+
+		if (chunk_count <= 1)
+			return body.sumLoop(begin, end);
+
+		// Every chunk writes its own sum, they are added up (in order, so the result doesn't depend on scheduling) afterwards
+		vector<btScalar> sums(chunk_count, btScalar(0));
+		m_threading->ForEach([&body, &sums, begin, end, chunk_size](const uint32_t i)
+		{
+			const auto chunk_begin = begin + static_cast<int>(i) * chunk_size;
+			sums[i] = body.sumLoop(chunk_begin, Min(chunk_begin + chunk_size, end));
+		},
+		chunk_count);
+
+		btScalar sum = btScalar(0);
+		for (const auto value : sums)
+		{
+			sum += value;
+		}
+		return sum;
+	}
+
+	bool PhysicsTaskScheduler::IsSupported(Threading* threading)
+	{
+		// Bullet only runs its loops in parallel when it's built with BT_THREADSAFE (see the Bullet project in premake.lua)
+#if BT_THREADSAFE
+		return threading && threading->GetThreadCount() != 0 && threading->GetThreadCount() < BT_MAX_THREAD_COUNT;
+#else
+		return false;
+#endif
+	}
+
+	int PhysicsTaskScheduler::GetChunkSize(const int begin, const int end, const int grain_size) const
+	{
+		// Bullet's grain size is the smallest batch that is worth a task, batches are made larger than that
+		// when the range is big, so that each thread gets a few of them and scheduling stays cheap.
+		const auto range			= Max(end - begin, 0);
+		const auto chunks_max		= m_thread_count * 4;
+		const auto chunk_size_min	= (range + chunks_max - 1) / chunks_max;
+		return Max(Max(grain_size, chunk_size_min), 1);
+	}
+}
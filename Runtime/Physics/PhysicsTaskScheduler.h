@@ -0,0 +1,59 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ===================================================
+#pragma warning(push, 0) // Hide warnings which belong to Bullet
+#include <LinearMath/btThreads.h>
+#pragma warning(pop)
+//==============================================================
+
+namespace Spartan
+{
+	class Threading;
+
+	// Runs Bullet's parallel loops (collision dispatch, island solving, integration) on the engine's worker threads.
+	// Bullet identifies threads by an index below BT_MAX_THREAD_COUNT, so it can only be used when the pool fits in that
+	// (and when Bullet is built with BT_THREADSAFE, which it is, otherwise its loops never reach the scheduler).
+	class PhysicsTaskScheduler : public btITaskScheduler
+	{
+	public:
+		PhysicsTaskScheduler(Threading* threading);
+		~PhysicsTaskScheduler() = default;
+
+		//= btITaskScheduler =====================================================================================
+		int getMaxNumThreads() const override { return m_thread_count; }
+		int getNumThreads() const override { return m_thread_count; }
+		void setNumThreads(int thread_count) override {} // the pool belongs to the engine, it's not resized for physics
+		void parallelFor(int begin, int end, int grain_size, const btIParallelForBody& body) override;
+		btScalar parallelSum(int begin, int end, int grain_size, const btIParallelSumBody& body) override;
+		//========================================================================================================
+
+		static bool IsSupported(Threading* threading);
+
+	private:
+		int GetChunkSize(int begin, int end, int grain_size) const;
+
+		Threading* m_threading;
+		int m_thread_count;
+	};
+}
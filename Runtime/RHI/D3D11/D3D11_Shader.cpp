@@ -48,22 +48,8 @@ namespace Spartan
         safe_release(static_cast<ID3D11ComputeShader*>(m_resource_compute));
 	}
 
-	template <typename T>
-	void* RHI_Shader::_Compile(const Shader_Type type, const string& shader)
+	bool RHI_Shader::_CompileBytecode(const Shader_Type type, const string& shader, vector<std::byte>* bytecode)
 	{
-		if (!m_rhi_device)
-		{
-			LOG_ERROR_INVALID_INTERNALS();
-			return nullptr;
-		}
-
-		auto d3d11_device = m_rhi_device->GetContextRhi()->device;
-		if (!d3d11_device)
-		{
-			LOG_ERROR_INVALID_INTERNALS();
-			return nullptr;
-		}
-
 		// Compile flags
 		uint32_t compile_flags = D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_OPTIMIZATION_LEVEL3;
 		#ifdef DEBUG
@@ -157,45 +143,79 @@ namespace Spartan
 			{
 				LOG_ERROR("An error occurred when trying to load and compile \"%s\"", shader_name.c_str());
 			}
+
+			safe_release(shader_blob);
+			return false;
+		}
+
+		// Copy the bytecode out
+		const auto data = static_cast<const std::byte*>(shader_blob->GetBufferPointer());
+		bytecode->assign(data, data + shader_blob->GetBufferSize());
+
+		safe_release(shader_blob);
+		return true;
+	}
+
+	template <typename T>
+	void* RHI_Shader::_CreateShader(const Shader_Type type, const vector<std::byte>& bytecode)
+	{
+		if (!m_rhi_device)
+		{
+			LOG_ERROR_INVALID_INTERNALS();
+			return nullptr;
+		}
+
+		auto d3d11_device = m_rhi_device->GetContextRhi()->device;
+		if (!d3d11_device)
+		{
+			LOG_ERROR_INVALID_INTERNALS();
+			return nullptr;
 		}
 
 		// Create shader
 		void* shader_view = nullptr;
-		if (shader_blob)
+		if (type == Shader_Vertex)
 		{
-			if (type == Shader_Vertex)
+			const auto result = d3d11_device->CreateVertexShader(bytecode.data(), bytecode.size(), nullptr, reinterpret_cast<ID3D11VertexShader**>(&shader_view));
+			if (FAILED(result))
 			{
-				if (FAILED(d3d11_device->CreateVertexShader(shader_blob->GetBufferPointer(), shader_blob->GetBufferSize(), nullptr, reinterpret_cast<ID3D11VertexShader**>(&shader_view))))
+                LOG_ERROR("Failed to create vertex shader, %s", D3D11_Common::dxgi_error_to_string(result));
+			}
+
+			// Create input layout, it validates against the shader's input signature so it needs the bytecode as a blob
+			if (RHI_Vertex_Type_To_Enum<T>() != RHI_Vertex_Type_Unknown)
+			{
+				ID3DBlob* shader_blob = nullptr;
+				if (SUCCEEDED(D3DCreateBlob(bytecode.size(), &shader_blob)))
 				{
-                    LOG_ERROR("Failed to create vertex shader, %s", D3D11_Common::dxgi_error_to_string(result));
+					memcpy(shader_blob->GetBufferPointer(), bytecode.data(), bytecode.size());
 				}
 
-				// Create input layout
-				if (RHI_Vertex_Type_To_Enum<T>() != RHI_Vertex_Type_Unknown)
+				if (!shader_blob || !m_input_layout->Create<T>(shader_blob))
 				{
-					if (!m_input_layout->Create<T>(shader_blob))
-					{
-						LOG_ERROR("Failed to create input layout for %s", FileSystem::GetFileNameFromFilePath(m_file_path).c_str());
-					}
+					LOG_ERROR("Failed to create input layout for %s", FileSystem::GetFileNameFromFilePath(m_file_path).c_str());
 				}
+
+				safe_release(shader_blob);
 			}
-			else if (type == Shader_Pixel)
+		}
+		else if (type == Shader_Pixel)
+		{
+			const auto result = d3d11_device->CreatePixelShader(bytecode.data(), bytecode.size(), nullptr, reinterpret_cast<ID3D11PixelShader**>(&shader_view));
+			if (FAILED(result))
 			{
-				if (FAILED(d3d11_device->CreatePixelShader(shader_blob->GetBufferPointer(), shader_blob->GetBufferSize(), nullptr, reinterpret_cast<ID3D11PixelShader**>(&shader_view))))
-				{
-					LOG_ERROR("Failed to create pixel shader, %s", D3D11_Common::dxgi_error_to_string(result));
-				}
+				LOG_ERROR("Failed to create pixel shader, %s", D3D11_Common::dxgi_error_to_string(result));
 			}
-            else if (type == Shader_Compute)
+		}
+        else if (type == Shader_Compute)
+        {
+            const auto result = d3d11_device->CreateComputeShader(bytecode.data(), bytecode.size(), nullptr, reinterpret_cast<ID3D11ComputeShader**>(&shader_view));
+            if (FAILED(result))
             {
-                if (FAILED(d3d11_device->CreateComputeShader(shader_blob->GetBufferPointer(), shader_blob->GetBufferSize(), nullptr, reinterpret_cast<ID3D11ComputeShader**>(&shader_view))))
-                {
-                    LOG_ERROR("Failed to create compute shader, %s", D3D11_Common::dxgi_error_to_string(result));
-                }
+                LOG_ERROR("Failed to create compute shader, %s", D3D11_Common::dxgi_error_to_string(result));
             }
-		}
+        }
 
-		safe_release(shader_blob);
 		return shader_view;
 	}
 }
@@ -57,14 +57,14 @@ namespace Spartan
 		const uint32_t array_size,
 		const RHI_Format format,
 		const UINT bind_flags,
-		std::vector<std::vector<std::byte>>& data,
+		const RHI_TextureMips& data,
 		const shared_ptr<RHI_Device>& rhi_device
 	)
 	{
 		D3D11_TEXTURE2D_DESC texture_desc	= {};
 		texture_desc.Width					= static_cast<UINT>(width);
 		texture_desc.Height					= static_cast<UINT>(height);
-		texture_desc.MipLevels				= data.empty() ? 1 : static_cast<UINT>(data.size());
+		texture_desc.MipLevels				= data.IsEmpty() ? 1 : static_cast<UINT>(data.GetCount());
 		texture_desc.ArraySize				= static_cast<UINT>(array_size);
 		texture_desc.Format					= d3d11_format[format];
 		texture_desc.SampleDesc.Count		= 1;
@@ -78,17 +78,17 @@ namespace Spartan
 		vector<D3D11_SUBRESOURCE_DATA> vec_subresource_data;
 		auto mip_width	= width;
 		auto mip_height = height;
-		for (uint32_t i = 0; i < static_cast<uint32_t>(data.size()); i++)
+		for (uint32_t i = 0; i < data.GetCount(); i++)
 		{
-			if (data[i].empty())
+			if (data.GetMip(i).empty())
 			{
 				LOG_ERROR("Mipmap %d has invalid data.", i);
 				return false;
 			}
 
 			auto& subresource_data				= vec_subresource_data.emplace_back(D3D11_SUBRESOURCE_DATA{});
-			subresource_data.pSysMem			= data[i].data();					// Data pointer		
-			subresource_data.SysMemPitch		= mip_width * channels * (bpc / 8);	// Line width in bytes
+			subresource_data.pSysMem			= data.GetMip(i).data();			// Data pointer		
+			subresource_data.SysMemPitch		= RHI_Texture::GetRowPitch(format, mip_width, channels, bpc);	// Line width in bytes (or a row of blocks)
 			subresource_data.SysMemSlicePitch	= 0;								// This is only used for 3D textures
 
 			// Compute size of next mip-map
@@ -152,7 +152,7 @@ namespace Spartan
 		return true;
 	}
 
-	inline bool CreateShaderResourceView(void* resource, void*& shader_resource_view, RHI_Format format, uint32_t array_size, std::vector<std::vector<std::byte>>& data, const shared_ptr<RHI_Device>& rhi_device)
+	inline bool CreateShaderResourceView(void* resource, void*& shader_resource_view, RHI_Format format, uint32_t array_size, const uint32_t mip_count, const shared_ptr<RHI_Device>& rhi_device)
 	{
 		// Describe
 		D3D11_SHADER_RESOURCE_VIEW_DESC shader_resource_view_desc	= {};
@@ -160,7 +160,7 @@ namespace Spartan
 		shader_resource_view_desc.ViewDimension						= (array_size == 1) ? D3D11_SRV_DIMENSION_TEXTURE2D : D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
 		shader_resource_view_desc.Texture2DArray.FirstArraySlice	= 0;
 		shader_resource_view_desc.Texture2DArray.MostDetailedMip	= 0;
-		shader_resource_view_desc.Texture2DArray.MipLevels			= data.empty() ? 1 : static_cast<UINT>(data.size());
+		shader_resource_view_desc.Texture2DArray.MipLevels			= mip_count == 0 ? 1 : static_cast<UINT>(mip_count);
 		shader_resource_view_desc.Texture2DArray.ArraySize			= array_size;
 
 		// Create
@@ -219,7 +219,7 @@ namespace Spartan
 			m_array_size,
 			format,
 			bind_flags,
-			m_data,
+			m_mips,
 			m_rhi_device
 		);
 
@@ -257,7 +257,7 @@ namespace Spartan
 				m_resource_texture,
 				format_srv,
 				m_array_size,
-				m_data,
+				m_mips.GetCount(),
 				m_rhi_device
 			);
 		}
@@ -283,7 +283,7 @@ namespace Spartan
 		uint32_t array_size,
 		uint32_t bpc,
 		RHI_Format format,
-		vector<vector<vector<std::byte>>>& data,
+		vector<RHI_TextureMips>& data,
 		const shared_ptr<RHI_Device>& rhi_device
 	)
 	{
@@ -297,11 +297,11 @@ namespace Spartan
 		vector<D3D11_TEXTURE2D_DESC> vec_texture_desc;
 		ID3D11Texture2D* texture						= nullptr;
 		ID3D11ShaderResourceView* shader_resource_view	= nullptr;
-		auto mip_levels = static_cast<UINT>(data[0].size());
+		auto mip_levels = static_cast<UINT>(data[0].GetCount());
 
 		for (const auto& side : data)
 		{
-			if (side.empty())
+			if (side.IsEmpty())
 			{
 				LOG_ERROR("A side contains invalid data.");
 				continue;
@@ -323,15 +323,16 @@ namespace Spartan
 
 			auto mip_width	= width;
 			auto mip_height = height;
-			for (const auto& mip : side)
+			for (uint32_t i = 0; i < side.GetCount(); i++)
 			{
+				const auto mip = side.GetMip(i);
 				if (mip.empty())
 				{
 					LOG_ERROR("A mip-map contains invalid data.");
 					continue;
 				}
 
-				auto row_bytes = mip_width * channels * (bpc / 8);
+				auto row_bytes = RHI_Texture::GetRowPitch(format, mip_width, channels, bpc);
 
 				// D3D11_SUBRESOURCE_DATA
 				auto & subresource_data				= vec_subresource_data.emplace_back(D3D11_SUBRESOURCE_DATA{});
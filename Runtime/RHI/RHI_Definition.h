@@ -46,11 +46,13 @@ namespace Spartan
 	class RHI_Texture2D;
 	class RHI_TextureCube;
 	class RHI_Shader;
+	class RHI_ShaderCache;
 	struct RHI_Vertex_Undefined;
 	struct RHI_Vertex_PosTex;
 	struct RHI_Vertex_PosCol;
 	struct RHI_Vertex_PosUvCol;
 	struct RHI_Vertex_PosTexNorTan;
+	struct RHI_Vertex_PosTexNorTan_Quantized;
 
 	enum RHI_Present_Mode : uint32_t
 	{
@@ -161,7 +163,16 @@ namespace Spartan
 		// RGBA
 		Format_R8G8B8A8_UNORM,
 		Format_R16G16B16A16_FLOAT,
-		Format_R32G32B32A32_FLOAT
+		Format_R32G32B32A32_FLOAT,
+		// Block compressed (4x4 blocks)
+		Format_BC1_UNORM,	// RGB, 8 bytes per block
+		Format_BC3_UNORM,	// RGBA, 16 bytes per block
+		Format_BC4_UNORM,	// R, 8 bytes per block
+		Format_BC5_UNORM,	// RG, 16 bytes per block
+		Format_BC7_UNORM,	// RGBA, 16 bytes per block
+		// Vertex attributes (last, as texture formats are serialized)
+		Format_R16G16B16A16_UNORM,
+		Format_R16G16B16A16_SNORM
 	};
 
 	enum RHI_Blend
@@ -75,7 +75,16 @@ static const DXGI_FORMAT d3d11_format[] =
     // RGBA
 	DXGI_FORMAT_R8G8B8A8_UNORM,
 	DXGI_FORMAT_R16G16B16A16_FLOAT,
-	DXGI_FORMAT_R32G32B32A32_FLOAT
+	DXGI_FORMAT_R32G32B32A32_FLOAT,
+    // Block compressed
+	DXGI_FORMAT_BC1_UNORM,
+	DXGI_FORMAT_BC3_UNORM,
+	DXGI_FORMAT_BC4_UNORM,
+	DXGI_FORMAT_BC5_UNORM,
+	DXGI_FORMAT_BC7_UNORM,
+	// Vertex attributes
+	DXGI_FORMAT_R16G16B16A16_UNORM,
+	DXGI_FORMAT_R16G16B16A16_SNORM
 };
 
 static const D3D11_TEXTURE_ADDRESS_MODE d3d11_sampler_address_mode[] =
@@ -180,7 +189,16 @@ static const VkFormat vulkan_format[] =
     // RGBA
 	VK_FORMAT_R8G8B8A8_UNORM,
 	VK_FORMAT_R16G16B16A16_SFLOAT,
-	VK_FORMAT_R32G32B32A32_SFLOAT
+	VK_FORMAT_R32G32B32A32_SFLOAT,
+    // Block compressed
+	VK_FORMAT_BC1_RGB_UNORM_BLOCK,
+	VK_FORMAT_BC3_UNORM_BLOCK,
+	VK_FORMAT_BC4_UNORM_BLOCK,
+	VK_FORMAT_BC5_UNORM_BLOCK,
+	VK_FORMAT_BC7_UNORM_BLOCK,
+	// Vertex attributes
+	VK_FORMAT_R16G16B16A16_UNORM,
+	VK_FORMAT_R16G16B16A16_SNORM
 };
 
 static const VkSamplerAddressMode vulkan_sampler_address_mode[] =
@@ -269,6 +287,7 @@ namespace Spartan
 		VkQueue queue_present						= nullptr;
 		VkQueue queue_copy							= nullptr;
 		VkDebugUtilsMessengerEXT callback_handle	= nullptr;
+		VkPipelineCache pipeline_cache				= nullptr; // owned by RHI_PipelineCache
 		QueueFamilyIndices indices;
         VkSurfaceFormatKHR surface_format;
 		
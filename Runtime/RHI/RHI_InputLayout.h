@@ -111,6 +111,16 @@ namespace Spartan
 				};
 			}
 
+			if (RHI_Vertex_Type_To_Enum<T>() == RHI_Vertex_Type_PositionTextureNormalTangentQuantized)
+			{
+				m_vertex_attributes =
+				{
+					{ "POSITION",	0, binding, Format_R16G16B16A16_UNORM,	offsetof(RHI_Vertex_PosTexNorTan_Quantized, pos) },
+					{ "TEXCOORD",	1, binding, Format_R16G16_FLOAT,		offsetof(RHI_Vertex_PosTexNorTan_Quantized, tex) },
+					{ "NORMAL",		2, binding, Format_R16G16B16A16_SNORM,	offsetof(RHI_Vertex_PosTexNorTan_Quantized, nor_tan) }
+				};
+			}
+
 			if (vertex_shader_blob && !m_vertex_attributes.empty())
 			{
 				return _CreateResource(vertex_shader_blob);
@@ -0,0 +1,121 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =================
+#include "RHI_PipelineCache.h"
+#include <cstring>
+#include "../Core/Hash.h"
+//============================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+	void RHI_PipelineState::ComputeHash()
+	{
+		const auto id = [](const Spartan_Object* object) { return object ? object->GetId() : 0; };
+
+		// The input layout isn't an object, its attributes describe it
+		uint64_t hash = 0;
+		if (input_layout)
+		{
+			for (const auto& attribute : input_layout->GetAttributeDescriptions())
+			{
+				const uint32_t values[4] = { attribute.location, attribute.binding, static_cast<uint32_t>(attribute.format), attribute.offset };
+				hash = Hash::Compute(values, sizeof(values), hash);
+			}
+		}
+
+		// Everything else goes into a flat array of plain values, hashed in one go
+		uint32_t key[20] =
+		{
+			id(shader_vertex),
+			id(shader_pixel),
+			id(rasterizer_state),
+			id(blend_state),
+			id(depth_stencil_state),
+			id(sampler),
+			id(constant_buffer),
+			id(vertex_buffer),
+			id(swap_chain),
+			static_cast<uint32_t>(primitive_topology)
+		};
+		memcpy(&key[10], &viewport.x,			sizeof(float));
+		memcpy(&key[11], &viewport.y,			sizeof(float));
+		memcpy(&key[12], &viewport.width,		sizeof(float));
+		memcpy(&key[13], &viewport.height,		sizeof(float));
+		memcpy(&key[14], &viewport.depth_min,	sizeof(float));
+		memcpy(&key[15], &viewport.depth_max,	sizeof(float));
+		memcpy(&key[16], &scissor.x,			sizeof(float));
+		memcpy(&key[17], &scissor.y,			sizeof(float));
+		memcpy(&key[18], &scissor.width,		sizeof(float));
+		memcpy(&key[19], &scissor.height,		sizeof(float));
+
+		hash	= Hash::Compute(key, sizeof(key), hash);
+		m_hash	= hash != 0 ? hash : 1;
+	}
+
+	const shared_ptr<RHI_Pipeline>& RHI_PipelineCache::GetPipeline(RHI_PipelineState& pipeline_state)
+	{
+		pipeline_state.ComputeHash();
+		const auto hash = pipeline_state.GetHash();
+		const auto mask = m_slot_count - 1;
+
+		// Existing pipeline, slots are written once (pipeline first, then hash) and never removed, so there is nothing to lock
+		for (uint32_t i = 0, index = static_cast<uint32_t>(hash) & mask; i < m_slot_count; i++, index = (index + 1) & mask)
+		{
+			const auto slot_hash = m_slots[index].hash.load(memory_order_acquire);
+			if (slot_hash == hash)
+				return *m_slots[index].pipeline.load(memory_order_relaxed);
+
+			if (slot_hash == 0)
+				break;
+		}
+
+		lock_guard<mutex> lock(m_mutex);
+
+		// Another thread may have created it, or the table was too full for it
+		auto it = m_cache.find(pipeline_state);
+		if (it == m_cache.end())
+		{
+			it = m_cache.emplace(pipeline_state, nullptr).first;
+			it->second = make_shared<RHI_Pipeline>(m_rhi_device, it->first); // the pipeline references the key
+
+			// Publish it, past half full probing gets long so the rest are only found under the lock
+			if (m_slots_used < m_slot_count / 2)
+			{
+				auto index = static_cast<uint32_t>(hash) & mask;
+				while (m_slots[index].hash.load(memory_order_relaxed) != 0)
+				{
+					index = (index + 1) & mask;
+				}
+
+				m_slots[index].pipeline.store(&it->second, memory_order_relaxed);
+				m_slots[index].hash.store(hash, memory_order_release);
+				m_slots_used++;
+			}
+		}
+
+		return it->second;
+	}
+}
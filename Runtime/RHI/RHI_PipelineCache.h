@@ -23,6 +23,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =====================
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <string>
 #include <unordered_map>
 #include "../Math/Rectangle.h"
 #include "RHI_Pipeline.h"
@@ -44,30 +47,8 @@ namespace Spartan
 	class RHI_PipelineState
 	{
 	public:
-		void ComputeHash()
-		{
-            if (!shader_vertex || !shader_vertex || !depth_stencil_state || !vertex_buffer || !sampler || !constant_buffer || !!swap_chain)
-                return;
-
-			// todo:: input layout, rasterizer state, blend state, swap chain, viewport, scissor
-			char buffer[1000];
-			sprintf_s
-			(
-				buffer,
-				"%d-%d-%d-%d-%d-%d-%d-%d",
-				shader_vertex->GetId(),
-				shader_pixel->GetId(),
-				depth_stencil_state->GetId(),
-				vertex_buffer->GetId(),
-				sampler->GetId(),
-				constant_buffer->GetId(),
-				swap_chain->GetId(),
-				static_cast<uint32_t>(primitive_topology)
-			);
-
-			const std::hash<std::string> hasher;
-			m_hash = static_cast<uint32_t>(hasher(buffer));
-		}
+		// Hashes every field (objects by their id, the input layout by its attributes), 0 is never a valid hash
+		void ComputeHash();
 
 		auto GetHash() const { return m_hash; }
 		bool operator==(const RHI_PipelineState& rhs) const { return GetHash() == rhs.GetHash(); }
@@ -87,7 +68,7 @@ namespace Spartan
 		Math::Rectangle scissor;
 
 	private:
-		uint32_t m_hash = 0;
+		uint64_t m_hash = 0;
 	};
 }
 
@@ -105,33 +86,34 @@ namespace std
 
 namespace Spartan
 {
+	// Pipelines are looked up by the hash of their state. Existing ones are found in an open addressed table of atomics
+	// without locking, creation is serialized. Where the API has them (Vulkan), what the driver compiled is kept
+	// on disk, so the pipelines of the next run are created without compiling.
 	class RHI_PipelineCache
 	{
 	public:
-		RHI_PipelineCache(const std::shared_ptr<RHI_Device>& rhi_device)
-		{
-			m_rhi_device = rhi_device;
-		}
+		RHI_PipelineCache(const std::shared_ptr<RHI_Device>& rhi_device, const std::string& file_path = "");
+		~RHI_PipelineCache();
 
-		auto& GetPipeline(RHI_PipelineState& pipeline_state)
-		{
-			if (pipeline_state.GetHash() == 0)
-			{
-				pipeline_state.ComputeHash();
-			}
-
-			// If no pipeline exists for this state, create one
-			if (m_cache.find(pipeline_state) == m_cache.end())
-			{
-				m_cache[pipeline_state]; // Create key first so we can pass a reference to each value
-				m_cache[pipeline_state] = std::make_shared<RHI_Pipeline>(m_rhi_device, m_cache.find(pipeline_state)->first);
-			}
-
-			return m_cache[pipeline_state];
-		}
+		const std::shared_ptr<RHI_Pipeline>& GetPipeline(RHI_PipelineState& pipeline_state);
+
+		// Writes the driver's pipeline cache to the file, the destructor calls it as well
+		bool Save();
 
 	private:
+		struct PipelineCache_Slot
+		{
+			std::atomic<uint64_t> hash = { 0 };
+			std::atomic<const std::shared_ptr<RHI_Pipeline>*> pipeline = { nullptr };
+		};
+
+		static const uint32_t m_slot_count = 1024; // power of two, filled up to half
+		PipelineCache_Slot m_slots[m_slot_count];
+		uint32_t m_slots_used = 0;
+
 		std::unordered_map<RHI_PipelineState, std::shared_ptr<RHI_Pipeline>> m_cache;
+		std::mutex m_mutex;
+		std::string m_file_path;
 		std::shared_ptr<RHI_Device> m_rhi_device;
 	};
 }
@@ -19,19 +19,40 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ======================
+//= INCLUDES =====================
 #include "RHI_Shader.h"
 #include "RHI_InputLayout.h"
+#include "RHI_Device.h"
 #include <spirv_hlsl.hpp>
 #include "../Core/Context.h"
-#include "../Threading/Threading.h"
 #include "../Core/FileSystem.h"
-//=================================
+#include "../Core/Hash.h"
+#include "../Rendering/Renderer.h"
+//================================
 
 //= NAMESPACES =====
 using namespace std;
 //==================
 
+namespace _RHI_Shader
+{
+	// Anything that changes the bytecode without changing the source, defines or target goes in here
+	static uint64_t compiler_hash()
+	{
+		#if defined(API_GRAPHICS_D3D11)
+		string compiler = "d3dcompiler";
+		#elif defined(API_GRAPHICS_VULKAN)
+		string compiler = "dxc_spirv";
+		#endif
+
+		#ifdef DEBUG
+		compiler += "_debug";
+		#endif
+
+		return Spartan::Hash::Compute(compiler);
+	}
+}
+
 namespace Spartan
 {
 	RHI_Shader::RHI_Shader(const shared_ptr<RHI_Device>& rhi_device)
@@ -110,12 +131,34 @@ namespace Spartan
 	}
 
 	template <typename T>
-	void RHI_Shader::CompileAsync(Context* context, const Shader_Type type, const string& shader)
+	void RHI_Shader::CompileAsync(Context* context, const Shader_Type type, const string& shader, const uint32_t priority)
 	{
-		context->GetSubsystem<Threading>()->AddTask([this, type, shader]()
+		context->GetSubsystem<Renderer>()->GetShaderCache()->Enqueue([this, type, shader]()
 		{
 			Compile<T>(type, shader);
-		});
+		}, priority, this);
+	}
+
+	template <typename T>
+	void* RHI_Shader::_Compile(const Shader_Type type, const string& shader)
+	{
+		// Compiled shaders are cached by everything that goes into them, so only what changed since the last run gets compiled
+		auto shader_cache	= m_rhi_device->GetContext()->GetSubsystem<Renderer>()->GetShaderCache();
+		const auto key		= shader_cache ? RHI_ShaderCache::ComputeKey(shader, m_defines, GetEntryPoint(), GetTargetProfile(), _RHI_Shader::compiler_hash()) : 0;
+
+		vector<std::byte> bytecode;
+		if (!shader_cache || !shader_cache->Load(key, &bytecode))
+		{
+			if (!_CompileBytecode(type, shader, &bytecode))
+				return nullptr;
+
+			if (shader_cache)
+			{
+				shader_cache->Store(key, bytecode);
+			}
+		}
+
+		return _CreateShader<T>(type, bytecode);
 	}
 
     string RHI_Shader::GetEntryPoint() const
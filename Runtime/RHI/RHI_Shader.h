@@ -28,6 +28,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 #include "RHI_Definition.h"
 #include "RHI_Vertex.h"
+#include "RHI_ShaderCache.h"
 #include "../Core/Spartan_Object.h"
 //=================================
 
@@ -84,12 +85,12 @@ namespace Spartan
 			Compile<RHI_Vertex_Undefined>(type, shader);
 		}
 
-        // Asynchronous compilation
+        // Asynchronous compilation, queued on the renderer's shader cache
 		template<typename T>
-		void CompileAsync(Context* context, const Shader_Type type, const std::string& shader);
-		void CompileAsync(Context* context, const Shader_Type type, const std::string& shader)
+		void CompileAsync(Context* context, const Shader_Type type, const std::string& shader, uint32_t priority = ShaderCache_Priority_Engine);
+		void CompileAsync(Context* context, const Shader_Type type, const std::string& shader, uint32_t priority = ShaderCache_Priority_Engine)
 		{
-			CompileAsync<RHI_Vertex_Undefined>(context, type, shader); 
+			CompileAsync<RHI_Vertex_Undefined>(context, type, shader, priority); 
 		}
 	
 		// Properties
@@ -119,6 +120,9 @@ namespace Spartan
 		template <typename T>
 		void* _Compile(Shader_Type type, const std::string& shader);
 		void* _Compile(const Shader_Type type, const std::string& shader) { return _Compile<RHI_Vertex_Undefined>(type, shader); }
+		bool _CompileBytecode(Shader_Type type, const std::string& shader, std::vector<std::byte>* bytecode);
+		template <typename T>
+		void* _CreateShader(Shader_Type type, const std::vector<std::byte>& bytecode);
 		void _Reflect(Shader_Type type, const uint32_t* ptr, uint32_t size);
 
 		std::string m_name;
@@ -136,12 +140,13 @@ namespace Spartan
 	};
 
 	//= Explicit template instantiation =============================================================================
-	template void RHI_Shader::CompileAsync<RHI_Vertex_Undefined>(Context*, const Shader_Type, const std::string&);
-	template void RHI_Shader::CompileAsync<RHI_Vertex_Pos>(Context*, const Shader_Type, const std::string&);
-	template void RHI_Shader::CompileAsync<RHI_Vertex_PosTex>(Context*, const Shader_Type, const std::string&);
-	template void RHI_Shader::CompileAsync<RHI_Vertex_PosCol>(Context*, const Shader_Type, const std::string&);
-	template void RHI_Shader::CompileAsync<RHI_Vertex_Pos2dTexCol8>(Context*, const Shader_Type, const std::string&);
-	template void RHI_Shader::CompileAsync<RHI_Vertex_PosTexNorTan>(Context*, const Shader_Type, const std::string&);
+	template void RHI_Shader::CompileAsync<RHI_Vertex_Undefined>(Context*, const Shader_Type, const std::string&, uint32_t);
+	template void RHI_Shader::CompileAsync<RHI_Vertex_Pos>(Context*, const Shader_Type, const std::string&, uint32_t);
+	template void RHI_Shader::CompileAsync<RHI_Vertex_PosTex>(Context*, const Shader_Type, const std::string&, uint32_t);
+	template void RHI_Shader::CompileAsync<RHI_Vertex_PosCol>(Context*, const Shader_Type, const std::string&, uint32_t);
+	template void RHI_Shader::CompileAsync<RHI_Vertex_Pos2dTexCol8>(Context*, const Shader_Type, const std::string&, uint32_t);
+	template void RHI_Shader::CompileAsync<RHI_Vertex_PosTexNorTan>(Context*, const Shader_Type, const std::string&, uint32_t);
+	template void RHI_Shader::CompileAsync<RHI_Vertex_PosTexNorTan_Quantized>(Context*, const Shader_Type, const std::string&, uint32_t);
 
 	template void* RHI_Shader::_Compile<RHI_Vertex_Undefined>(Shader_Type, const std::string&);
 	template void* RHI_Shader::_Compile<RHI_Vertex_Pos>(Shader_Type, const std::string&);
@@ -149,5 +154,14 @@ namespace Spartan
 	template void* RHI_Shader::_Compile<RHI_Vertex_PosCol>(Shader_Type, const std::string&);
 	template void* RHI_Shader::_Compile<RHI_Vertex_Pos2dTexCol8>(Shader_Type, const std::string&);
 	template void* RHI_Shader::_Compile<RHI_Vertex_PosTexNorTan>(Shader_Type, const std::string&);
+	template void* RHI_Shader::_Compile<RHI_Vertex_PosTexNorTan_Quantized>(Shader_Type, const std::string&);
+
+	template void* RHI_Shader::_CreateShader<RHI_Vertex_Undefined>(Shader_Type, const std::vector<std::byte>&);
+	template void* RHI_Shader::_CreateShader<RHI_Vertex_Pos>(Shader_Type, const std::vector<std::byte>&);
+	template void* RHI_Shader::_CreateShader<RHI_Vertex_PosTex>(Shader_Type, const std::vector<std::byte>&);
+	template void* RHI_Shader::_CreateShader<RHI_Vertex_PosCol>(Shader_Type, const std::vector<std::byte>&);
+	template void* RHI_Shader::_CreateShader<RHI_Vertex_Pos2dTexCol8>(Shader_Type, const std::vector<std::byte>&);
+	template void* RHI_Shader::_CreateShader<RHI_Vertex_PosTexNorTan>(Shader_Type, const std::vector<std::byte>&);
+	template void* RHI_Shader::_CreateShader<RHI_Vertex_PosTexNorTan_Quantized>(Shader_Type, const std::vector<std::byte>&);
 	//===============================================================================================================
 }
@@ -0,0 +1,261 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =======================
+#include "RHI_ShaderCache.h"
+#include <algorithm>
+#include "../Core/FileSystem.h"
+#include "../Core/Hash.h"
+#include "../IO/FileStream.h"
+#include "../Logging/Log.h"
+#include "../Resource/ImportCache.h"
+#include "../Threading/Threading.h"
+//==================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace _RHI_ShaderCache
+{
+	static const uint32_t file_version	= 1;
+	static const char* file_extension	= ".bytecode";
+
+	static uint64_t hash_combine(const string& value, const uint64_t seed)
+	{
+		// The size goes in as well, so that "ab" + "c" and "a" + "bc" hash differently
+		const uint64_t size = value.size();
+		return Spartan::Hash::Compute(value.data(), value.size(), Spartan::Hash::Compute(&size, sizeof(size), seed));
+	}
+}
+
+namespace Spartan
+{
+	RHI_ShaderCache::RHI_ShaderCache(const string& directory, Threading* threading)
+	{
+		m_directory	= directory;
+		m_threading	= threading;
+
+		// Leave threads for the rest of the engine, shaders are rarely what a frame waits for
+		if (m_threading)
+		{
+			m_workers_max = max(1u, m_threading->GetThreadCount() / 2);
+		}
+
+		if (!FileSystem::DirectoryExists(m_directory))
+		{
+			FileSystem::CreateDirectory_(m_directory);
+		}
+	}
+
+	RHI_ShaderCache::~RHI_ShaderCache()
+	{
+		// Drop whatever hasn't started, the running jobs reference shaders so they have to finish
+		unique_lock<mutex> lock(m_mutex);
+		m_jobs.clear();
+		m_condition.wait(lock, [this] { return m_workers == 0; });
+	}
+
+	uint64_t RHI_ShaderCache::ComputeKey(const string& shader, const map<string, string>& defines, const string& entry_point, const string& target_profile, const uint64_t compiler_hash)
+	{
+		uint64_t key = Hash::Compute(&_RHI_ShaderCache::file_version, sizeof(_RHI_ShaderCache::file_version), compiler_hash);
+
+		// Source
+		if (FileSystem::IsSupportedShaderFile(shader))
+		{
+			const auto content_hash = ImportCache::ComputeFileHash(shader);
+			if (content_hash == 0)
+				return 0;
+
+			key = Hash::Compute(&content_hash, sizeof(content_hash), key);
+
+			// Includes, sorted so that the same set of files always hashes the same way
+			auto includes = FileSystem::GetIncludedFiles(shader);
+			sort(includes.begin(), includes.end());
+			includes.erase(unique(includes.begin(), includes.end()), includes.end());
+			for (const auto& include : includes)
+			{
+				const auto include_hash = ImportCache::ComputeFileHash(include);
+				if (include_hash == 0)
+					return 0;
+
+				key = _RHI_ShaderCache::hash_combine(FileSystem::GetFileNameFromFilePath(include), key);
+				key = Hash::Compute(&include_hash, sizeof(include_hash), key);
+			}
+		}
+		else
+		{
+			key = _RHI_ShaderCache::hash_combine(shader, key);
+		}
+
+		// Defines (ordered by name already)
+		for (const auto& define : defines)
+		{
+			key = _RHI_ShaderCache::hash_combine(define.first, key);
+			key = _RHI_ShaderCache::hash_combine(define.second, key);
+		}
+
+		key = _RHI_ShaderCache::hash_combine(entry_point, key);
+		key = _RHI_ShaderCache::hash_combine(target_profile, key);
+
+		// 0 is reserved for failure
+		return key != 0 ? key : 1;
+	}
+
+	bool RHI_ShaderCache::Load(const uint64_t key, vector<std::byte>* bytecode) const
+	{
+		if (key == 0 || !bytecode)
+			return false;
+
+		const auto file_path = GetFilePath(key);
+		if (!FileSystem::FileExists(file_path))
+			return false;
+
+		auto file = FileStream(file_path, FileStream_Read);
+		if (!file.IsOpen() || file.ReadAs<uint32_t>() != _RHI_ShaderCache::file_version || file.ReadAs<uint64_t>() != key)
+			return false;
+
+		// The hash catches files that were cut short (or are still being written by another compilation)
+		const auto bytecode_hash = file.ReadAs<uint64_t>();
+		file.Read(bytecode);
+		if (bytecode->empty() || Hash::Compute(bytecode->data(), bytecode->size()) != bytecode_hash)
+		{
+			bytecode->clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool RHI_ShaderCache::Store(const uint64_t key, const vector<std::byte>& bytecode) const
+	{
+		if (key == 0 || bytecode.empty())
+			return false;
+
+		auto file = FileStream(GetFilePath(key), FileStream_Write);
+		if (!file.IsOpen())
+		{
+			LOG_ERROR("Failed to store shader bytecode in \"%s\"", m_directory.c_str());
+			return false;
+		}
+
+		file.Write(_RHI_ShaderCache::file_version);
+		file.Write(key);
+		file.Write(Hash::Compute(bytecode.data(), bytecode.size()));
+		file.Write(bytecode);
+
+		return true;
+	}
+
+	void RHI_ShaderCache::Enqueue(function<void()>&& job, const uint32_t priority, const void* owner)
+	{
+		if (!m_threading)
+		{
+			job();
+			return;
+		}
+
+		// Start a worker if there is room for one, otherwise the job waits for a running worker to pick it up
+		bool start_worker = false;
+		{
+			lock_guard<mutex> lock(m_mutex);
+
+			auto& entry		= m_jobs.emplace_back();
+			entry.function	= move(job);
+			entry.owner		= owner;
+			entry.priority	= priority;
+			entry.order		= m_job_order++;
+
+			if (m_workers < m_workers_max)
+			{
+				m_workers++;
+				start_worker = true;
+			}
+		}
+
+		if (start_worker)
+		{
+			m_threading->AddTask([this]() { Work(); });
+		}
+	}
+
+	void RHI_ShaderCache::Prioritize(const void* owner, const uint32_t priority)
+	{
+		if (!owner)
+			return;
+
+		lock_guard<mutex> lock(m_mutex);
+		for (auto& job : m_jobs)
+		{
+			if (job.owner == owner && job.priority < priority)
+			{
+				job.priority = priority;
+			}
+		}
+	}
+
+	void RHI_ShaderCache::Wait()
+	{
+		unique_lock<mutex> lock(m_mutex);
+		m_condition.wait(lock, [this] { return m_jobs.empty() && m_workers == 0; });
+	}
+
+	uint32_t RHI_ShaderCache::GetPendingCount()
+	{
+		lock_guard<mutex> lock(m_mutex);
+		return static_cast<uint32_t>(m_jobs.size());
+	}
+
+	void RHI_ShaderCache::Work()
+	{
+		while (true)
+		{
+			function<void()> job_function;
+			{
+				lock_guard<mutex> lock(m_mutex);
+				if (m_jobs.empty())
+				{
+					m_workers--;
+					m_condition.notify_all();
+					return;
+				}
+
+				// Highest priority first, then in the order they were queued
+				const auto job = min_element(m_jobs.begin(), m_jobs.end(), [](const ShaderCache_Job& a, const ShaderCache_Job& b)
+				{
+					return a.priority != b.priority ? a.priority > b.priority : a.order < b.order;
+				});
+
+				job_function = move(job->function);
+				m_jobs.erase(job);
+			}
+
+			job_function();
+		}
+	}
+
+	string RHI_ShaderCache::GetFilePath(const uint64_t key) const
+	{
+		char name[17];
+		snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+		return m_directory + name + _RHI_ShaderCache::file_extension;
+	}
+}
@@ -0,0 +1,97 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+#include "../Core/EngineDefs.h"
+//=============================
+
+namespace Spartan
+{
+	class Threading;
+
+	// Higher priorities are compiled first
+	enum ShaderCache_Priority : uint32_t
+	{
+		ShaderCache_Priority_Low,		// materials that aren't known to be visible
+		ShaderCache_Priority_Visible,	// materials of entities inside the view frustum
+		ShaderCache_Priority_Engine		// the renderer's own shaders, nothing renders without them
+	};
+
+	// Compiled shaders (bytecode) kept on disk, addressed by a hash of everything that goes into the compilation: the source
+	// and the files it includes, the defines, the entry point, the target profile and the compiler itself. Compilations are 
+	// also queued here, a few of them run in the background at a time and the ones with the highest priority go first.
+	class SPARTAN_CLASS RHI_ShaderCache
+	{
+	public:
+		RHI_ShaderCache(const std::string& directory, Threading* threading = nullptr); // without threading, jobs execute immediately
+		~RHI_ShaderCache();
+
+		// Shader can be a file path or the source itself, returns 0 if the source or any of its includes can't be read
+		static uint64_t ComputeKey(
+			const std::string& shader,
+			const std::map<std::string, std::string>& defines,
+			const std::string& entry_point,
+			const std::string& target_profile,
+			uint64_t compiler_hash = 0
+		);
+
+		// Returns false if there is no bytecode for the key or if it's corrupt
+		bool Load(uint64_t key, std::vector<std::byte>* bytecode) const;
+		bool Store(uint64_t key, const std::vector<std::byte>& bytecode) const;
+
+		// Background compilation, the owner is what the priority of a pending job can be raised by
+		void Enqueue(std::function<void()>&& job, uint32_t priority, const void* owner = nullptr);
+		void Prioritize(const void* owner, uint32_t priority);
+		void Wait();
+		uint32_t GetPendingCount();
+
+		const auto& GetDirectory() const { return m_directory; }
+
+	private:
+		struct ShaderCache_Job
+		{
+			std::function<void()> function;
+			const void* owner	= nullptr;
+			uint32_t priority	= 0;
+			uint64_t order		= 0;
+		};
+
+		void Work();
+		std::string GetFilePath(uint64_t key) const;
+
+		std::string m_directory;
+		Threading* m_threading;
+		std::vector<ShaderCache_Job> m_jobs;
+		uint64_t m_job_order		= 0;
+		uint32_t m_workers			= 0;
+		uint32_t m_workers_max		= 1;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+	};
+}
@@ -21,9 +21,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ================================
 #include "RHI_Texture.h"
+#include <cstring>
+#include "../Core/Hash.h"
 #include "../IO/FileStream.h"
 #include "../Rendering/Renderer.h"
 #include "../Resource/ResourceCache.h"
+#include "../Resource/ImportCache.h"
 #include "../Resource/Import/ImageImporter.h"
 //===========================================
 
@@ -31,6 +34,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 using namespace std;
 //==================
 
+namespace _RHI_Texture
+{
+	static const uint32_t magic		= 0x58545053; // "SPTX"
+	static const uint32_t version	= 1;
+
+	// Mips start at an aligned offset in the file, so the data is laid out exactly like RHI_TextureMips
+	static uint64_t align(const uint64_t offset) { return (offset + Spartan::RHI_TextureMips::alignment - 1) & ~(Spartan::RHI_TextureMips::alignment - 1); }
+}
+
 namespace Spartan
 {
 	RHI_Texture::RHI_Texture(Context* context) : IResource(context, Resource_Texture)
@@ -40,58 +52,57 @@ namespace Spartan
 
 	RHI_Texture::~RHI_Texture()
 	{
-		m_data.clear();
-		m_data.shrink_to_fit();
+		m_mips.Clear();
 	}
 
 	bool RHI_Texture::SaveToFile(const string& file_path)
 	{
-		// Check to see if the file already exists (if so, get the byte count)
-		uint32_t byte_count = 0;
+		lock_guard<mutex> lock(m_mutex_mips);
+		unique_ptr<FileStream> file;
+
+		// If the existing file has data but we hold none (it's freed once saved), 
+		// keep the file's data and only patch the properties that follow it.
+		if (m_mips.IsEmpty() && FileSystem::FileExists(file_path))
 		{
-			if (FileSystem::FileExists(file_path))
-			{
-				auto file = make_unique<FileStream>(file_path, FileStream_Read);
-				if (file->IsOpen())
-				{
-					file->Read(&byte_count);
-				}
-			}
-		}
+			file = make_unique<FileStream>(file_path, FileStream_Read | FileStream_Write);
+			if (!file->IsOpen())
+				return false;
 
-		auto append = true;
-		auto file = make_unique<FileStream>(file_path, FileStream_Write | FileStream_Append);
-		if (!file->IsOpen())
-			return false;
+			RHI_Format format	= Format_R8G8B8A8_UNORM;
+			uint32_t mip_count	= 0;
+			uint32_t version	= 0;
+			if (!ReadHeader(file.get(), &format, &mip_count, &version) || !ReadMips(file.get(), version, mip_count, nullptr))
+				return false;
 
-		// If the existing file has a byte count but we 
-		// hold no data, don't overwrite the file's bytes.
-		if (byte_count != 0 && m_data.empty())
-		{
-			file->Skip
-			(
-				sizeof(uint32_t) +	// byte count
-				sizeof(uint32_t) +	// mipmap count
-				byte_count			// bytes
-			);
+			file->Seek(file->GetPosition()); // switch from reading to writing
 		}
 		else
 		{
-			byte_count = GetByteCount();
+			file = make_unique<FileStream>(file_path, FileStream_Write);
+			if (!file->IsOpen())
+				return false;
+
+			// Write header
+			file->Write(_RHI_Texture::magic);
+			file->Write(_RHI_Texture::version);
+			file->Write(static_cast<uint32_t>(m_format));
+			file->Write(m_mips.GetCount());
+			file->Write(m_mips.GetSize());
+			for (uint32_t i = 0; i < m_mips.GetCount(); i++)
+			{
+				file->Write(m_mips.GetOffsets()[i]);
+				file->Write(m_mips.GetSizes()[i]);
+			}
 
-			// Write byte count
-			file->Write(byte_count);
-			// Write mipmap count
-			file->Write(static_cast<uint32_t>(m_data.size()));
 			// Write bytes
-			for (auto& mip : m_data)
+			while (file->GetPosition() != _RHI_Texture::align(file->GetPosition()))
 			{
-				file->Write(mip);
+				file->Write(std::byte{ 0 });
 			}
+			file->Write(m_mips.GetData(), m_mips.GetSize());
 
 			// The bytes have been saved, so we can now free some memory
-			m_data.clear();
-			m_data.shrink_to_fit();
+			m_mips.Clear();
 		}
 
 		// Write properties
@@ -103,6 +114,14 @@ namespace Spartan
 		file->Write(m_is_transparent);
 		file->Write(GetId());
 		file->Write(GetResourceFilePath());
+		file->Close();
+
+		// Now that the native file exists, the import that produced it can be cached
+		if (m_import_key != 0)
+		{
+			m_context->GetSubsystem<ResourceCache>()->GetImportCache()->Store(m_import_key, GetResourceFilePath(), { file_path });
+			m_import_key = 0;
+		}
 
 		return true;
 	}
@@ -116,8 +135,10 @@ namespace Spartan
 			return false;
 		}
 
-		m_data.clear();
-		m_data.shrink_to_fit();
+		{
+			lock_guard<mutex> lock(m_mutex_mips);
+			m_mips.Clear();
+		}
 		m_load_state = LoadState_Started;
 
 		// Load from disk
@@ -149,74 +170,108 @@ namespace Spartan
 		// Only clear texture bytes if that's an engine texture, if not, it's not serialized yet.
 		if (FileSystem::IsEngineTextureFile(file_path))
 		{
-			m_data.clear();
-			m_data.shrink_to_fit();
+			lock_guard<mutex> lock(m_mutex_mips);
+			m_mips.Clear();
 		}
 		m_load_state = LoadState_Completed;
 		return true;
 	}
 
-	vector<std::byte>* RHI_Texture::GetData(const uint32_t index)
+	vector<std::byte> RHI_Texture::CopyMip(const uint32_t index)
 	{
-		if (index >= m_data.size())
+		lock_guard<mutex> lock(m_mutex_mips);
+
+		const Span<const std::byte> mip = m_mips.GetMip(index);
+		if (!mip.empty())
+			return vector<std::byte>(mip.begin(), mip.end());
+
+		return LoadMipmap(index);
+	}
+
+	vector<std::byte> RHI_Texture::LoadMipmap(const uint32_t index)
+	{
+		vector<std::byte> data;
+
+		auto file = make_unique<FileStream>(GetResourceFilePathNative(), FileStream_Read);
+		if (!file->IsOpen())
 		{
-			LOG_WARNING("Index out of range");
-			return nullptr;
+			LOG_ERROR("Unable to retreive data");
+			return data;
 		}
 
-		return &m_data[index];
-	}
+		RHI_Format format	= Format_R8G8B8A8_UNORM;
+		uint32_t mip_count	= 0;
+		uint32_t version	= 0;
+		if (!ReadHeader(file.get(), &format, &mip_count, &version))
+			return data;
+
+		if (index >= mip_count)
+		{
+			LOG_ERROR("Invalid index");
+			return data;
+		}
+
+		// Files without a header, every mip is prefixed by its size
+		if (version == 0)
+		{
+			for (uint32_t i = 0; i <= index; i++)
+			{
+				file->Read(&data);
+			}
+
+			return data;
+		}
+
+		// Look up the mip in the offset table and read only that
+		file->ReadAs<uint64_t>(); // total size
+		uint64_t offset	= 0;
+		uint64_t size	= 0;
+		for (uint32_t i = 0; i < mip_count; i++)
+		{
+			const auto mip_offset	= file->ReadAs<uint64_t>();
+			const auto mip_size		= file->ReadAs<uint64_t>();
+			if (i == index)
+			{
+				offset	= mip_offset;
+				size	= mip_size;
+			}
+		}
 
-    vector<std::byte> RHI_Texture::GetMipmap(uint32_t index)
-    {
-        vector<std::byte> data;
-
-        // Use existing data, if it's there
-        if (index < m_data.size())
-        {
-            data = m_data[index];
-        }
-        // Else attempt to load the data
-        else
-        {
-            auto file = make_unique<FileStream>(GetResourceFilePathNative(), FileStream_Read);
-            if (file->IsOpen())
-            {
-                auto byte_count = file->ReadAs<uint32_t>();
-                auto mip_count  = file->ReadAs<uint32_t>();
-
-                if (index < mip_count)
-                {
-                    for (uint32_t i = 0; i <= index; i++)
-                    {
-                        file->Read(&data);
-                    }
-                }
-                else
-                {
-                    LOG_ERROR("Invalid index");
-                }
-                file->Close();
-            }
-            else
-            {
-                LOG_ERROR("Unable to retreive data");
-            }
-        }
-
-        return data;
-    }
+		file->Seek(_RHI_Texture::align(file->GetPosition()) + offset);
+		data.resize(size);
+		file->Read(data.data(), size);
+
+		return data;
+	}
 
     bool RHI_Texture::LoadFromFile_ForeignFormat(const string& file_path, const bool generate_mipmaps)
 	{
+		ResourceCache* resource_cache	= m_context->GetSubsystem<ResourceCache>().get();
+		ImportCache* import_cache		= resource_cache->GetImportCache();
+
+		// If the same file was imported before, with the same settings, restore the native file instead
+		const uint64_t import_key	= import_cache->ComputeKey(file_path, ComputeImportSettingsHash(generate_mipmaps));
+		const uint32_t id			= GetId();
+		m_import_key				= 0;
+		if (import_cache->Fetch(import_key, file_path) && LoadFromFile_NativeFormat(FileSystem::NativizeFilePath(file_path)))
+		{
+			// The native file carries the identity of the texture that produced it
+			SetId(id);
+			SetResourceFilePath(file_path);
+			return true;
+		}
+
 		// Load texture
-		ImageImporter* importer = m_context->GetSubsystem<ResourceCache>()->GetImageImporter();	
+		ImageImporter* importer = resource_cache->GetImageImporter();	
 		if (!importer->Load(file_path, this, generate_mipmaps))
 			return false;
 
 		// Set resource file path so it can be used by the resource cache
 		SetResourceFilePath(file_path);
 
+		// The import is cached once the native file is saved
+		m_import_key = import_key;
+
 		return true;
 	}
 
@@ -226,19 +281,15 @@ namespace Spartan
 		if (!file->IsOpen())
 			return false;
 
-		m_data.clear();
-		m_data.shrink_to_fit();
-
-		// Read byte and mipmap count
-		auto byte_count = file->ReadAs<uint32_t>();
-        auto mip_count  = file->ReadAs<uint32_t>();
+		// Read format and mipmap count
+		uint32_t mip_count	= 0;
+		uint32_t version	= 0;
+		if (!ReadHeader(file.get(), &m_format, &mip_count, &version))
+			return false;
 
 		// Read bytes
-		m_data.resize(mip_count);
-		for (auto& mip : m_data)
-		{
-			file->Read(&mip);
-		}
+		if (!ReadMips(file.get(), version, mip_count, &m_mips))
+			return false;
 
 		// Read properties
 		file->Read(&m_bpp);
@@ -253,6 +304,26 @@ namespace Spartan
 		return true;
 	}
 
+	uint64_t RHI_Texture::ComputeImportSettingsHash(const bool generate_mipmaps) const
+	{
+		// Everything that affects what the importer produces
+		uint32_t alpha_coverage_threshold = 0;
+		memcpy(&alpha_coverage_threshold, &m_alpha_coverage_threshold, sizeof(alpha_coverage_threshold));
+		const uint32_t settings[] =
+		{
+			_RHI_Texture::version,
+			static_cast<uint32_t>(generate_mipmaps),
+			static_cast<uint32_t>(m_compression),
+			static_cast<uint32_t>(m_is_normal_map),
+			static_cast<uint32_t>(m_is_single_channel),
+			static_cast<uint32_t>(m_is_srgb),
+			static_cast<uint32_t>(m_mip_filter),
+			alpha_coverage_threshold
+		};
+
+		return Hash::Compute(settings, sizeof(settings));
+	}
+
 	uint32_t RHI_Texture::GetChannelCountFromFormat(const RHI_Format format)
 	{
 		switch (format)
@@ -271,19 +342,129 @@ namespace Spartan
 			case Format_R8G8B8A8_UNORM:		return 4;
 			case Format_R16G16B16A16_FLOAT:	return 4;
 			case Format_R32G32B32A32_FLOAT:	return 4;
+			case Format_BC1_UNORM:			return 4;
+			case Format_BC3_UNORM:			return 4;
+			case Format_BC4_UNORM:			return 1;
+			case Format_BC5_UNORM:			return 2;
+			case Format_BC7_UNORM:			return 4;
+			case Format_R16G16B16A16_UNORM:	return 4;
+			case Format_R16G16B16A16_SNORM:	return 4;
 			default:						return 0;
 		}
 	}
 
-	uint32_t RHI_Texture::GetByteCount()
+	bool RHI_Texture::IsCompressedFormat(const RHI_Format format)
+	{
+		return format >= Format_BC1_UNORM && format <= Format_BC7_UNORM;
+	}
+
+	uint32_t RHI_Texture::GetRowPitch(const RHI_Format format, const uint32_t width, const uint32_t channels, const uint32_t bpc)
+	{
+		// Compressed formats are laid out in rows of 4x4 blocks
+		if (IsCompressedFormat(format))
+		{
+			const uint32_t block_size = (format == Format_BC1_UNORM || format == Format_BC4_UNORM) ? 8 : 16;
+			return ((width + 3) / 4) * block_size;
+		}
+
+		return width * channels * (bpc / 8);
+	}
+
+	uint64_t RHI_Texture::GetMipSize(const RHI_Format format, const uint32_t width, const uint32_t height, const uint32_t channels, const uint32_t bpc)
 	{
-		uint32_t byte_count = 0;
+		const uint32_t rows = IsCompressedFormat(format) ? (height + 3) / 4 : height;
+		return static_cast<uint64_t>(GetRowPitch(format, width, channels, bpc)) * rows;
+	}
 
-		for (auto& mip : m_data)
+	uint32_t RHI_Texture::GetMipCount(uint32_t width, uint32_t height)
+	{
+		uint32_t count = 1;
+		while (width > 1 || height > 1)
+		{
+			width	= width > 1 ? width / 2 : 1;
+			height	= height > 1 ? height / 2 : 1;
+			count++;
+		}
+
+		return count;
+	}
+
+	bool RHI_Texture::ReadHeader(FileStream* file, RHI_Format* format, uint32_t* mip_count, uint32_t* version)
+	{
+		// Files written before the header was introduced, start with the byte count and are always RGBA8
+		const auto first = file->ReadAs<uint32_t>();
+		if (first == _RHI_Texture::magic)
+		{
+			*version = file->ReadAs<uint32_t>();
+			if (*version != _RHI_Texture::version)
+			{
+				LOG_ERROR("Unsupported texture format version (%d)", *version);
+				return false;
+			}
+
+			*format = static_cast<RHI_Format>(file->ReadAs<uint32_t>());
+		}
+		else
 		{
-			byte_count += static_cast<uint32_t>(mip.size());
+			*version	= 0;
+			*format		= Format_R8G8B8A8_UNORM;
 		}
 
-		return byte_count;
+		*mip_count = file->ReadAs<uint32_t>();
+		return true;
+	}
+
+	bool RHI_Texture::ReadMips(FileStream* file, const uint32_t version, const uint32_t mip_count, RHI_TextureMips* mips)
+	{
+		// Files without a header, every mip is prefixed by its size
+		if (version == 0)
+		{
+			if (!mips)
+			{
+				for (uint32_t i = 0; i < mip_count; i++)
+				{
+					const auto mip_size = file->ReadAs<uint32_t>();
+					file->Seek(file->GetPosition() + mip_size);
+				}
+				return true;
+			}
+
+			vector<vector<std::byte>> data(mip_count);
+			for (auto& mip : data)
+			{
+				file->Read(&mip);
+			}
+			*mips = RHI_TextureMips(data);
+
+			return true;
+		}
+
+		// The offset table followed by all the mips in a single read
+		const auto size = file->ReadAs<uint64_t>();
+		vector<uint64_t> sizes(mip_count);
+		for (auto& mip_size : sizes)
+		{
+			file->ReadAs<uint64_t>(); // offset, it's implied by the sizes
+			mip_size = file->ReadAs<uint64_t>();
+		}
+
+		const auto position = _RHI_Texture::align(file->GetPosition());
+		if (!mips)
+		{
+			file->Seek(position + size);
+			return true;
+		}
+
+		mips->Allocate(sizes);
+		if (mips->GetSize() != size)
+		{
+			LOG_ERROR("Mip layout mismatch");
+			mips->Clear();
+			return false;
+		}
+
+		file->Seek(position);
+		file->Read(mips->GetData(), size);
+		return true;
 	}
 }
@@ -25,11 +25,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <memory>
 #include "RHI_Definition.h"
 #include "RHI_Viewport.h"
+#include "RHI_TextureMips.h"
 #include "../Resource/IResource.h"
 //================================
 
 namespace Spartan
 {
+	class FileStream;
+
 	enum RHI_Texture_Bind : uint16_t
 	{
 		RHI_Texture_Sampled			= 1 << 0,
@@ -37,6 +40,22 @@ namespace Spartan
 		RHI_Texture_DepthStencil	= 1 << 2,
 	};
 
+	// Block compression (BCn) that's applied, on the CPU, when importing a texture
+	enum RHI_Texture_Compression : uint8_t
+	{
+		RHI_Texture_Compression_None,
+		RHI_Texture_Compression_Fast,		// BC1 (opaque) or BC3 (transparent) for color
+		RHI_Texture_Compression_Quality		// BC7 for color
+	};
+
+	// Filter that's used to generate mipmaps when importing a texture
+	enum RHI_Texture_Mip_Filter : uint8_t
+	{
+		RHI_Texture_Mip_Filter_Box,
+		RHI_Texture_Mip_Filter_Kaiser,
+		RHI_Texture_Mip_Filter_Lanczos
+	};
+
 	class SPARTAN_CLASS RHI_Texture : public IResource
 	{
 	public:
@@ -72,13 +91,34 @@ namespace Spartan
 		auto GetFormat() const											{ return m_format; }
 		void SetFormat(const RHI_Format format)							{ m_format = format; }
 
-		// Data
-		const auto& GetData() const										{ return m_data; }		
-        void SetData(const std::vector<std::vector<std::byte>>& data)   { m_data = data; }
-        auto AddMipmap()                                                { return &m_data.emplace_back(std::vector<std::byte>()); }
-        bool HasMipmaps()                                               { return !m_data.empty();  }
-        std::vector<std::byte>* GetData(uint32_t mipmap_index);
-        std::vector<std::byte> GetMipmap(uint32_t index);
+		// Import options (normal maps are compressed to BC5 and renormalized per mip, grayscale single channel data to BC4)
+		auto GetCompression() const										{ return m_compression; }
+		void SetCompression(const RHI_Texture_Compression compression)	{ m_compression = compression; }
+		auto IsNormalMap() const										{ return m_is_normal_map; }
+		void SetNormalMap(const bool is_normal_map)						{ m_is_normal_map = is_normal_map; }
+		auto IsSingleChannel() const									{ return m_is_single_channel; }
+		void SetSingleChannel(const bool is_single_channel)				{ m_is_single_channel = is_single_channel; } // only the red channel is sampled (e.g. roughness)
+		auto GetMipFilter() const										{ return m_mip_filter; }
+		void SetMipFilter(const RHI_Texture_Mip_Filter filter)			{ m_mip_filter = filter; }
+		auto IsSrgb() const												{ return m_is_srgb; }
+		void SetSrgb(const bool is_srgb)								{ m_is_srgb = is_srgb; }
+		auto GetAlphaCoverageThreshold() const							{ return m_alpha_coverage_threshold; }
+		void SetAlphaCoverageThreshold(const float threshold)			{ m_alpha_coverage_threshold = threshold; } // mips keep the alpha test coverage of this threshold, 0 disables
+
+		// Format helpers
+		static bool IsCompressedFormat(RHI_Format format);
+		static uint32_t GetRowPitch(RHI_Format format, uint32_t width, uint32_t channels, uint32_t bpc);
+		static uint64_t GetMipSize(RHI_Format format, uint32_t width, uint32_t height, uint32_t channels, uint32_t bpc);
+		static uint32_t GetMipCount(uint32_t width, uint32_t height); // of a full chain, down to 1x1
+
+		// Data (empty once the texture has been uploaded and saved, see LoadMipmap())
+		auto& GetMips()													{ return m_mips; }
+		const auto& GetMips() const										{ return m_mips; }
+		void SetMips(RHI_TextureMips&& mips)							{ m_mips = std::move(mips); }
+		bool HasMipmaps() const											{ return !m_mips.IsEmpty(); }
+		Span<std::byte> GetMip(const uint32_t index)					{ return m_mips.GetMip(index); }
+		std::vector<std::byte> LoadMipmap(uint32_t index);				// reads a mip from the native file
+		std::vector<std::byte> CopyMip(uint32_t index);					// thread safe, from memory if it's still there, otherwise from the native file
 
 		// GPU resources
 		auto GetResource_Texture() const								{ return m_resource_texture; }
@@ -90,6 +130,7 @@ namespace Spartan
 	protected:
 		bool LoadFromFile_NativeFormat(const std::string& file_path);
 		bool LoadFromFile_ForeignFormat(const std::string& file_path, bool generate_mipmaps);
+		uint64_t ComputeImportSettingsHash(bool generate_mipmaps) const;
 		static uint32_t GetChannelCountFromFormat(RHI_Format format);
         virtual bool CreateResourceGpu() { LOG_ERROR("Call to empty virtual function"); return false; }
 
@@ -103,8 +144,16 @@ namespace Spartan
 		RHI_Format m_format		= Format_R8G8B8A8_UNORM;
 		uint16_t m_bind_flags	= 0;
 		bool m_generate_mipmaps_when_loading = false;
+		RHI_Texture_Compression m_compression = RHI_Texture_Compression_None;
+		bool m_is_normal_map	= false;
+		bool m_is_single_channel = false;
+		bool m_is_srgb			= false;
+		float m_alpha_coverage_threshold = 0.0f;
+		RHI_Texture_Mip_Filter m_mip_filter = RHI_Texture_Mip_Filter_Kaiser;
 		RHI_Viewport m_viewport;
-		std::vector<std::vector<std::byte>> m_data;
+		RHI_TextureMips m_mips;
+		std::mutex m_mutex_mips; // held while the mips are saved or freed, so that workers copying them don't see them go away
+		uint64_t m_import_key	= 0; // set while an import is waiting for its native file, to be cached
 		
 		// Dependencies
 		std::shared_ptr<RHI_Device> m_rhi_device;
@@ -121,6 +170,7 @@ namespace Spartan
 		static std::mutex m_mutex;
 
 	private:
-		uint32_t GetByteCount();
+		static bool ReadHeader(FileStream* file, RHI_Format* format, uint32_t* mip_count, uint32_t* version);
+		static bool ReadMips(FileStream* file, uint32_t version, uint32_t mip_count, RHI_TextureMips* mips);
 	};
 }
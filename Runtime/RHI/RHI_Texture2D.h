@@ -40,7 +40,7 @@ namespace Spartan
 			m_viewport		= RHI_Viewport(0, 0, static_cast<float>(width), static_cast<float>(height));
 			m_channels		= GetChannelCountFromFormat(format);
 			m_format		= format;		
-			m_data			= data;
+			m_mips			= RHI_TextureMips(data);
 			m_bind_flags	= RHI_Texture_Sampled;
 
 			RHI_Texture2D::CreateResourceGpu();
@@ -56,7 +56,7 @@ namespace Spartan
 			m_channels		= GetChannelCountFromFormat(format);
 			m_format		= format;
 			m_bind_flags	= RHI_Texture_Sampled;
-			m_data.emplace_back(data);
+			m_mips			= RHI_TextureMips(std::vector<std::vector<std::byte>>{ data });
 
 			RHI_Texture2D::CreateResourceGpu();
 		}
@@ -33,14 +33,14 @@ namespace Spartan
 		RHI_TextureCube(Context* context) : RHI_Texture(context) { m_resource_type = Resource_TextureCube; }
 
 		// Creates a cubemap. 6 textures containing mip-levels have to be provided
-		RHI_TextureCube(Context* context, const uint32_t width, const uint32_t height, const RHI_Format format, const std::vector<std::vector<std::vector<std::byte>>>& data) : RHI_Texture(context)
+		RHI_TextureCube(Context* context, const uint32_t width, const uint32_t height, const RHI_Format format, std::vector<RHI_TextureMips>&& data) : RHI_Texture(context)
 		{
 			m_width			= width;
 			m_height		= height;
 			m_viewport		= RHI_Viewport(0, 0, static_cast<float>(width), static_cast<float>(height));
 			m_channels		= GetChannelCountFromFormat(format);
 			m_format		= format;
-			m_data_cube		= data;
+			m_data_cube		= std::move(data);
 			m_array_size	= 6;
 			m_bind_flags	= RHI_Texture_Sampled;
 
@@ -67,6 +67,6 @@ namespace Spartan
 		bool CreateResourceGpu() override;
 
 	private:
-		std::vector<std::vector<std::vector<std::byte>>> m_data_cube;
+		std::vector<RHI_TextureMips> m_data_cube;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,118 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===============
+#include "RHI_TextureMips.h"
+#include <new>
+#include <cstring>
+//==========================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+	RHI_TextureMips::RHI_TextureMips(const vector<vector<std::byte>>& mips)
+	{
+		vector<uint64_t> sizes;
+		sizes.reserve(mips.size());
+		for (const auto& mip : mips)
+		{
+			sizes.emplace_back(static_cast<uint64_t>(mip.size()));
+		}
+
+		Allocate(sizes);
+
+		for (uint32_t i = 0; i < GetCount(); i++)
+		{
+			if (!mips[i].empty())
+			{
+				memcpy(GetMip(i).data(), mips[i].data(), mips[i].size());
+			}
+		}
+	}
+
+	RHI_TextureMips::RHI_TextureMips(RHI_TextureMips&& other) noexcept
+	{
+		*this = move(other);
+	}
+
+	RHI_TextureMips& RHI_TextureMips::operator=(RHI_TextureMips&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Clear();
+			m_data		= other.m_data;
+			m_size		= other.m_size;
+			m_offsets	= move(other.m_offsets);
+			m_sizes		= move(other.m_sizes);
+
+			other.m_data = nullptr;
+			other.m_size = 0;
+			other.m_offsets.clear();
+			other.m_sizes.clear();
+		}
+
+		return *this;
+	}
+
+	void RHI_TextureMips::Allocate(const vector<uint64_t>& sizes)
+	{
+		Clear();
+
+		m_sizes = sizes;
+		m_offsets.reserve(sizes.size());
+		for (const auto size : sizes)
+		{
+			m_offsets.emplace_back(m_size);
+			m_size += (size + alignment - 1) & ~(alignment - 1);
+		}
+
+		if (m_size != 0)
+		{
+			m_data = static_cast<std::byte*>(::operator new(static_cast<size_t>(m_size), align_val_t(alignment)));
+
+			// Zero the padding, so saved files are deterministic
+			for (uint32_t i = 0; i < GetCount(); i++)
+			{
+				const uint64_t end		= m_offsets[i] + m_sizes[i];
+				const uint64_t padded	= (i + 1 < GetCount()) ? m_offsets[i + 1] : m_size;
+				memset(m_data + end, 0, static_cast<size_t>(padded - end));
+			}
+		}
+	}
+
+	void RHI_TextureMips::Clear()
+	{
+		if (m_data)
+		{
+			::operator delete(m_data, align_val_t(alignment));
+			m_data = nullptr;
+		}
+
+		m_size = 0;
+		m_offsets.clear();
+		m_offsets.shrink_to_fit();
+		m_sizes.clear();
+		m_sizes.shrink_to_fit();
+	}
+}
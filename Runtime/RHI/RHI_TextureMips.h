@@ -0,0 +1,70 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ====================
+#include <vector>
+#include <cstdint>
+#include "../Core/EngineDefs.h"
+#include "../Core/Span.h"
+//===============================
+
+namespace Spartan
+{
+	// The mips of a texture, in a single aligned allocation with an offset table.
+	// It's move-only, so importers hand their data over to the texture without copying it.
+	class SPARTAN_CLASS RHI_TextureMips
+	{
+	public:
+		static const uint64_t alignment = 64;
+
+		RHI_TextureMips() = default;
+		explicit RHI_TextureMips(const std::vector<std::vector<std::byte>>& mips);
+		~RHI_TextureMips() { Clear(); }
+
+		RHI_TextureMips(const RHI_TextureMips&)				= delete;
+		RHI_TextureMips& operator=(const RHI_TextureMips&)	= delete;
+		RHI_TextureMips(RHI_TextureMips&& other) noexcept;
+		RHI_TextureMips& operator=(RHI_TextureMips&& other) noexcept;
+
+		// Allocates (uninitialized) memory for mips of the given sizes, each one starting at an aligned offset
+		void Allocate(const std::vector<uint64_t>& sizes);
+		void Clear();
+
+		uint32_t GetCount() const							{ return static_cast<uint32_t>(m_sizes.size()); }
+		bool IsEmpty() const								{ return m_sizes.empty(); }
+		Span<std::byte> GetMip(uint32_t index)				{ return index < GetCount() ? Span<std::byte>(m_data + m_offsets[index], m_sizes[index]) : Span<std::byte>(); }
+		Span<const std::byte> GetMip(uint32_t index) const	{ return index < GetCount() ? Span<const std::byte>(m_data + m_offsets[index], m_sizes[index]) : Span<const std::byte>(); }
+
+		// The whole allocation (mips and the padding between them), this is what the native texture format stores
+		std::byte* GetData() const							{ return m_data; }
+		uint64_t GetSize() const							{ return m_size; }
+		const auto& GetOffsets() const						{ return m_offsets; }
+		const auto& GetSizes() const						{ return m_sizes; }
+
+	private:
+		std::byte* m_data = nullptr;
+		uint64_t m_size = 0;
+		std::vector<uint64_t> m_offsets;
+		std::vector<uint64_t> m_sizes;
+	};
+}
@@ -214,7 +214,7 @@ namespace Spartan
 		pipeline_info.basePipelineHandle			= nullptr;
 
 		auto pipeline = reinterpret_cast<VkPipeline*>(&m_pipeline);
-		if (vkCreateGraphicsPipelines(m_rhi_device->GetContextRhi()->device, nullptr, 1, &pipeline_info, nullptr, pipeline) != VK_SUCCESS) 
+		if (vkCreateGraphicsPipelines(m_rhi_device->GetContextRhi()->device, m_rhi_device->GetContextRhi()->pipeline_cache, 1, &pipeline_info, nullptr, pipeline) != VK_SUCCESS) 
 		{
 			LOG_ERROR("Failed to create graphics pipeline");
 		}
@@ -0,0 +1,146 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= IMPLEMENTATION ===============
+#include "../RHI_Implementation.h"
+#ifdef API_GRAPHICS_VULKAN
+//================================
+
+//= INCLUDES =====================
+#include "../RHI_PipelineCache.h"
+#include "../RHI_Device.h"
+#include "../../Core/FileSystem.h"
+#include "../../IO/FileStream.h"
+#include "../../Logging/Log.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace _Vulkan_PipelineCache
+{
+	static const uint32_t file_version = 1;
+
+	// A cache from another device or driver is useless, and some drivers don't handle it gracefully, so the header is checked first
+	static bool is_compatible(const VkPhysicalDevice device_physical, const vector<std::byte>& data)
+	{
+		const uint32_t header_size = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+		if (data.size() < header_size)
+			return false;
+
+		uint32_t header[4];
+		memcpy(header, data.data(), sizeof(header));
+
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(device_physical, &properties);
+
+		return
+			header[0] >= header_size										&&
+			header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE				&&
+			header[2] == properties.vendorID								&&
+			header[3] == properties.deviceID								&&
+			memcmp(data.data() + sizeof(header), properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+	}
+}
+
+namespace Spartan
+{
+	RHI_PipelineCache::RHI_PipelineCache(const shared_ptr<RHI_Device>& rhi_device, const string& file_path)
+	{
+		m_rhi_device	= rhi_device;
+		m_file_path		= file_path;
+
+		const auto rhi_context = m_rhi_device->GetContextRhi();
+
+		// Read what a previous run compiled
+		vector<std::byte> data;
+		if (!m_file_path.empty() && FileSystem::FileExists(m_file_path))
+		{
+			auto file = FileStream(m_file_path, FileStream_Read);
+			if (file.IsOpen() && file.ReadAs<uint32_t>() == _Vulkan_PipelineCache::file_version)
+			{
+				file.Read(&data);
+			}
+
+			if (!_Vulkan_PipelineCache::is_compatible(rhi_context->device_physical, data))
+			{
+				data.clear();
+			}
+		}
+
+		VkPipelineCacheCreateInfo create_info	= {};
+		create_info.sType						= VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		create_info.initialDataSize				= data.size();
+		create_info.pInitialData				= data.empty() ? nullptr : data.data();
+
+		if (vkCreatePipelineCache(rhi_context->device, &create_info, nullptr, &rhi_context->pipeline_cache) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to create pipeline cache");
+			rhi_context->pipeline_cache = nullptr;
+		}
+	}
+
+	RHI_PipelineCache::~RHI_PipelineCache()
+	{
+		Save();
+
+		// Pipelines that were created with it don't need it anymore
+		const auto rhi_context = m_rhi_device->GetContextRhi();
+		if (rhi_context->pipeline_cache)
+		{
+			vkDestroyPipelineCache(rhi_context->device, rhi_context->pipeline_cache, nullptr);
+			rhi_context->pipeline_cache = nullptr;
+		}
+	}
+
+	bool RHI_PipelineCache::Save()
+	{
+		const auto rhi_context = m_rhi_device->GetContextRhi();
+		if (m_file_path.empty() || !rhi_context->pipeline_cache)
+			return false;
+
+		size_t size = 0;
+		if (vkGetPipelineCacheData(rhi_context->device, rhi_context->pipeline_cache, &size, nullptr) != VK_SUCCESS || size == 0)
+			return false;
+
+		vector<std::byte> data(size);
+		if (vkGetPipelineCacheData(rhi_context->device, rhi_context->pipeline_cache, &size, data.data()) != VK_SUCCESS)
+		{
+			LOG_ERROR("Failed to get pipeline cache data");
+			return false;
+		}
+		data.resize(size);
+
+		auto file = FileStream(m_file_path, FileStream_Write);
+		if (!file.IsOpen())
+		{
+			LOG_ERROR("Failed to save pipeline cache to \"%s\"", m_file_path.c_str());
+			return false;
+		}
+
+		file.Write(_Vulkan_PipelineCache::file_version);
+		file.Write(data);
+
+		return true;
+	}
+}
+#endif
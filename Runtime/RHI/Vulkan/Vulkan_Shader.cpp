@@ -344,8 +344,7 @@ namespace Spartan
 		};
 	}
 	
-	template <typename T>
-	void* RHI_Shader::_Compile(const Shader_Type type, const string& shader)
+	bool RHI_Shader::_CompileBytecode(const Shader_Type type, const string& shader, vector<std::byte>* bytecode)
 	{
 		// Deduce some things
         const auto is_file	    = FileSystem::IsSupportedShaderFile(shader);
@@ -414,7 +413,7 @@ namespace Spartan
 			if (FAILED(result))
 			{
 				LOG_ERROR("Failed to create source buffer.");
-				return nullptr;
+				return false;
 			}
 		}
 
@@ -434,58 +433,65 @@ namespace Spartan
 					&compilation_result))
 			){
 				LOG_ERROR("Failed to compile %s", file_name.c_str());
-				return nullptr;
+				return false;
 			}
 
 			if (!DxShaderCompiler::ValidateOperationResult(compilation_result))
 			{
 				LOG_ERROR("Failed to compile %s", shader.c_str());
-				return nullptr;
+				return false;
 			}
 		}
 		
+		// Copy the SPIR-V out
+		CComPtr<IDxcBlob> shader_compiled = nullptr;
+        if (FAILED(compilation_result->GetResult(&shader_compiled)) || !shader_compiled)
+		{
+            LOG_ERROR("Failed to get shader buffer.");
+            return false;
+		}
+
+		const auto data = static_cast<const std::byte*>(shader_compiled->GetBufferPointer());
+		bytecode->assign(data, data + shader_compiled->GetBufferSize());
+
+		return true;
+	}
+
+	template <typename T>
+	void* RHI_Shader::_CreateShader(const Shader_Type type, const vector<std::byte>& bytecode)
+	{
 		// Create shader module
-		CComPtr<IDxcBlob> shader_compiled	= nullptr;
-		VkShaderModule shader_module		= nullptr;
-        if (SUCCEEDED(compilation_result->GetResult(&shader_compiled)))
-        {
-			VkShaderModuleCreateInfo create_info = {};
-			create_info.sType		= VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-			create_info.codeSize	= static_cast<size_t>(shader_compiled->GetBufferSize());
-			create_info.pCode		= reinterpret_cast<const uint32_t*>(shader_compiled->GetBufferPointer());
-	
-			if (vkCreateShaderModule(m_rhi_device->GetContextRhi()->device, &create_info, nullptr, &shader_module) == VK_SUCCESS)
-			{
-				// Reflect shader resources (so that descriptor sets can be created later)
-				_Reflect
-				(
-					type,
-					reinterpret_cast<uint32_t*>(shader_compiled->GetBufferPointer()),
-					static_cast<uint32_t>(shader_compiled->GetBufferSize() / 4)
-				);
+		VkShaderModuleCreateInfo create_info = {};
+		create_info.sType		= VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		create_info.codeSize	= bytecode.size();
+		create_info.pCode		= reinterpret_cast<const uint32_t*>(bytecode.data());
 
-				// Create input layout
-				if (RHI_Vertex_Type_To_Enum<T>() != RHI_Vertex_Type_Unknown)
-				{
-					if (!m_input_layout->Create<T>(nullptr))
-					{
-						LOG_ERROR("Failed to create input layout for %s", FileSystem::GetFileNameFromFilePath(shader).c_str());
-                        return nullptr;
-					}
-				}
-			}
-            else
-            {
-                LOG_ERROR("Failed to create shader module.");
-                return nullptr;
-            }
-		}	
-        else
+		VkShaderModule shader_module = nullptr;
+		if (vkCreateShaderModule(m_rhi_device->GetContextRhi()->device, &create_info, nullptr, &shader_module) != VK_SUCCESS)
 		{
-            LOG_ERROR("Failed to get shader buffer.");
+            LOG_ERROR("Failed to create shader module.");
             return nullptr;
 		}
 
+		// Reflect shader resources (so that descriptor sets can be created later)
+		_Reflect
+		(
+			type,
+			reinterpret_cast<const uint32_t*>(bytecode.data()),
+			static_cast<uint32_t>(bytecode.size() / 4)
+		);
+
+		// Create input layout
+		if (RHI_Vertex_Type_To_Enum<T>() != RHI_Vertex_Type_Unknown)
+		{
+			if (!m_input_layout->Create<T>(nullptr))
+			{
+				LOG_ERROR("Failed to create input layout for %s", FileSystem::GetFileNameFromFilePath(m_file_path).c_str());
+                vkDestroyShaderModule(m_rhi_device->GetContextRhi()->device, shader_module, nullptr);
+                return nullptr;
+			}
+		}
+
 		return static_cast<void*>(shader_module);
 	}		
 }
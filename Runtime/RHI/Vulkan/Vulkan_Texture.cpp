@@ -42,7 +42,7 @@ namespace Spartan
 
     RHI_Texture2D::~RHI_Texture2D()
     {
-        m_data.clear();
+        m_mips.Clear();
 
         auto vk_device = m_rhi_device->GetContextRhi()->device;
 
@@ -361,9 +361,9 @@ namespace Spartan
 		// Copy data to a buffer (if there are any)
 		VkBuffer staging_buffer = nullptr;
 		VkDeviceMemory staging_buffer_memory = nullptr;
-		if (!m_data.empty())
+		if (!m_mips.IsEmpty())
 		{
-			VkDeviceSize buffer_size = static_cast<uint64_t>(m_width) * static_cast<uint64_t>(m_height) * static_cast<uint64_t>(m_channels);
+			VkDeviceSize buffer_size = static_cast<uint64_t>(m_mips.GetMip(0).size());
 
 			// Create buffer
 			if (!Vulkan_Common::buffer::create(m_rhi_device, staging_buffer, staging_buffer_memory, buffer_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT))
@@ -372,7 +372,7 @@ namespace Spartan
 			// Copy to buffer
 			void* data = nullptr;
 			vkMapMemory(m_rhi_device->GetContextRhi()->device, staging_buffer_memory, 0, buffer_size, 0, &data);
-			memcpy(data, m_data.front().data(), static_cast<size_t>(buffer_size));
+			memcpy(data, m_mips.GetMip(0).data(), static_cast<size_t>(buffer_size));
 			vkUnmapMemory(m_rhi_device->GetContextRhi()->device, staging_buffer_memory);
 		}
 
@@ -471,7 +471,7 @@ namespace Spartan
 
 	RHI_TextureCube::~RHI_TextureCube()
 	{
-		m_data.clear();
+		m_mips.Clear();
         vkDestroyImageView(m_rhi_device->GetContextRhi()->device, reinterpret_cast<VkImageView>(m_resource_texture), nullptr);
 		vkDestroyImage(m_rhi_device->GetContextRhi()->device, reinterpret_cast<VkImage>(m_texture), nullptr);
 		Vulkan_Common::memory::free(m_rhi_device, m_texture_memory);
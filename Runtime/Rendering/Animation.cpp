@@ -19,13 +19,109 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =========
+//= INCLUDES ===============
 #include "Animation.h"
-//====================
+#include <cmath>
+#include "Skeleton.h"
+#include "../IO/FileStream.h"
+//==========================
 
-//= NAMESPACES =====
+//= NAMESPACES ================
 using namespace std;
-//==================
+using namespace Spartan::Math;
+//=============================
+
+namespace _Animation
+{
+	static const float tolerance_position	= 0.0001f;	// units
+	static const float tolerance_scale		= 0.0001f;
+	static const float tolerance_rotation	= 0.0000004f;	// 1 - |dot|, about 0.1 degrees
+	static const uint64_t rotation_max		= (1 << 20) - 1;
+	static const float sqrt2				= 1.41421356f;
+
+	static Quaternion nlerp(const Quaternion& a, Quaternion b, const float t)
+	{
+		if (a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w < 0.0f)
+		{
+			b = b * -1.0f;
+		}
+
+		return Quaternion(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t).Normalized();
+	}
+
+	// Keeps the keys that linear interpolation between the kept ones can't reproduce within the tolerance
+	template <typename T, typename Lerp, typename Error>
+	static void reduce(const vector<float>& times, const vector<T>& values, Lerp lerp, Error error, const float tolerance, vector<float>* times_kept, vector<T>* values_kept)
+	{
+		const auto count = static_cast<uint32_t>(times.size());
+		if (count == 0)
+			return;
+
+		times_kept->emplace_back(times[0]);
+		values_kept->emplace_back(values[0]);
+
+		uint32_t anchor = 0;
+		for (uint32_t i = 1; i + 1 < count; i++)
+		{
+			// Can every key after the anchor, up to this one, be dropped in favour of the next one
+			bool is_redundant		= true;
+			const float duration	= times[i + 1] - times[anchor];
+			for (uint32_t k = anchor + 1; k <= i && is_redundant; k++)
+			{
+				const float t	= duration > 0.0f ? (times[k] - times[anchor]) / duration : 0.0f;
+				is_redundant	= error(lerp(values[anchor], values[i + 1], t), values[k]) <= tolerance;
+			}
+
+			if (!is_redundant)
+			{
+				times_kept->emplace_back(times[i]);
+				values_kept->emplace_back(values[i]);
+				anchor = i;
+			}
+		}
+
+		if (count > 1)
+		{
+			times_kept->emplace_back(times[count - 1]);
+			values_kept->emplace_back(values[count - 1]);
+		}
+
+		// A value that never changes needs a single key
+		if (values_kept->size() == 2 && error((*values_kept)[0], (*values_kept)[1]) <= tolerance)
+		{
+			times_kept->pop_back();
+			values_kept->pop_back();
+		}
+	}
+
+	// Finds the key before the time (starting from the cursor) and how far the time is towards the next one
+	static uint32_t find_key(const vector<float>& times, const float time, uint32_t* cursor, float* t)
+	{
+		const auto count = static_cast<uint32_t>(times.size());
+
+		// Going backwards (looping), starts over
+		if (*cursor >= count || times[*cursor] > time)
+		{
+			*cursor = 0;
+		}
+
+		while (*cursor + 1 < count && times[*cursor + 1] <= time)
+		{
+			(*cursor)++;
+		}
+
+		const uint32_t key = *cursor;
+		if (key + 1 >= count)
+		{
+			*t = 0.0f;
+			return key;
+		}
+
+		const float duration	= times[key + 1] - times[key];
+		*t						= duration > 0.0f ? Clamp((time - times[key]) / duration, 0.0f, 1.0f) : 0.0f;
+		return key;
+	}
+}
 
 namespace Spartan
 {
@@ -41,11 +137,200 @@ namespace Spartan
 
 	bool Animation::LoadFromFile(const string& filePath)
 	{
+		auto file = make_unique<FileStream>(filePath, FileStream_Read);
+		if (!file->IsOpen())
+			return false;
+
+		Deserialize(file.get());
+		SetResourceFilePath(filePath);
 		return true;
 	}
 
 	bool Animation::SaveToFile(const string& filePath)
 	{
+		auto file = make_unique<FileStream>(filePath, FileStream_Write);
+		if (!file->IsOpen())
+			return false;
+
+		Serialize(file.get());
 		return true;
 	}
+
+	void Animation::AddChannel(const AnimationNode& node)
+	{
+		const double seconds_per_tick = m_ticksPerSec != 0 ? 1.0 / m_ticksPerSec : 0.0;
+
+		const auto lerp_vector	= [](const Vector3& a, const Vector3& b, const float t) { return a + (b - a) * t; };
+		const auto error_vector	= [](const Vector3& a, const Vector3& b) { return (a - b).Length(); };
+
+		AnimationTrack track;
+		track.node_name = node.name;
+
+		// Positions and scales
+		const auto add_vectors = [&](const vector<KeyVector>& keys, const float tolerance, vector<float>* times_kept, vector<Vector3>* values_kept)
+		{
+			vector<float> times(keys.size());
+			vector<Vector3> values(keys.size());
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				times[i]	= static_cast<float>(keys[i].time * seconds_per_tick);
+				values[i]	= keys[i].value;
+			}
+			_Animation::reduce(times, values, lerp_vector, error_vector, tolerance, times_kept, values_kept);
+		};
+		add_vectors(node.positionFrames, _Animation::tolerance_position, &track.position_times, &track.positions);
+		add_vectors(node.scaleFrames, _Animation::tolerance_scale, &track.scale_times, &track.scales);
+
+		// Rotations
+		{
+			vector<float> times(node.rotationFrames.size());
+			vector<Quaternion> values(node.rotationFrames.size());
+			for (size_t i = 0; i < node.rotationFrames.size(); i++)
+			{
+				times[i]	= static_cast<float>(node.rotationFrames[i].time * seconds_per_tick);
+				values[i]	= node.rotationFrames[i].value.Normalized();
+			}
+
+			const auto error = [](const Quaternion& a, const Quaternion& b) { return 1.0f - Abs(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w); };
+			vector<Quaternion> values_kept;
+			_Animation::reduce(times, values, _Animation::nlerp, error, _Animation::tolerance_rotation, &track.rotation_times, &values_kept);
+
+			track.rotations.reserve(values_kept.size());
+			for (const Quaternion& rotation : values_kept)
+			{
+				track.rotations.emplace_back(QuantizeRotation(rotation));
+			}
+		}
+
+		m_tracks.emplace_back(track);
+	}
+
+	void Animation::Sample(const float time, const int32_t* track_joints, AnimationCursor* cursors, AnimationPose* pose) const
+	{
+		for (uint32_t i = 0; i < static_cast<uint32_t>(m_tracks.size()); i++)
+		{
+			const int32_t joint = track_joints[i];
+			if (joint < 0)
+				continue;
+
+			const AnimationTrack& track	= m_tracks[i];
+			AnimationCursor& cursor		= cursors[i];
+			Vector3 position			= pose->GetPosition(joint);
+			Quaternion rotation			= pose->GetRotation(joint);
+			Vector3 scale				= pose->GetScale(joint);
+			float t						= 0.0f;
+
+			if (!track.positions.empty())
+			{
+				const uint32_t key	= _Animation::find_key(track.position_times, time, &cursor.position, &t);
+				const uint32_t next	= Min(key + 1, static_cast<uint32_t>(track.positions.size()) - 1);
+				position			= track.positions[key] + (track.positions[next] - track.positions[key]) * t;
+			}
+
+			if (!track.rotations.empty())
+			{
+				const uint32_t key	= _Animation::find_key(track.rotation_times, time, &cursor.rotation, &t);
+				const uint32_t next	= Min(key + 1, static_cast<uint32_t>(track.rotations.size()) - 1);
+				rotation			= _Animation::nlerp(DequantizeRotation(track.rotations[key]), DequantizeRotation(track.rotations[next]), t);
+			}
+
+			if (!track.scales.empty())
+			{
+				const uint32_t key	= _Animation::find_key(track.scale_times, time, &cursor.scale, &t);
+				const uint32_t next	= Min(key + 1, static_cast<uint32_t>(track.scales.size()) - 1);
+				scale				= track.scales[key] + (track.scales[next] - track.scales[key]) * t;
+			}
+
+			pose->SetJoint(joint, position, rotation, scale);
+		}
+	}
+
+	void Animation::Serialize(FileStream* stream) const
+	{
+		stream->Write(m_name);
+		stream->Write(m_duration);
+		stream->Write(m_ticksPerSec);
+		stream->Write(static_cast<uint32_t>(m_tracks.size()));
+		for (const AnimationTrack& track : m_tracks)
+		{
+			stream->Write(track.node_name);
+			stream->Write(track.position_times);
+			stream->Write(track.positions);
+			stream->Write(track.rotation_times);
+			stream->Write(track.rotations);
+			stream->Write(track.scale_times);
+			stream->Write(track.scales);
+		}
+	}
+
+	void Animation::Deserialize(FileStream* stream)
+	{
+		stream->Read(&m_name);
+		stream->Read(&m_duration);
+		stream->Read(&m_ticksPerSec);
+		m_tracks.resize(stream->ReadAs<uint32_t>());
+		for (AnimationTrack& track : m_tracks)
+		{
+			stream->Read(&track.node_name);
+			stream->Read(&track.position_times);
+			stream->Read(&track.positions);
+			stream->Read(&track.rotation_times);
+			stream->Read(&track.rotations);
+			stream->Read(&track.scale_times);
+			stream->Read(&track.scales);
+		}
+	}
+
+	uint64_t Animation::QuantizeRotation(const Quaternion& rotation)
+	{
+		const Quaternion normalized	= rotation.Normalized();
+		const float values[4]		= { normalized.x, normalized.y, normalized.z, normalized.w };
+
+		// The largest component is left out, the others are within +-1/sqrt(2)
+		uint32_t largest = 0;
+		for (uint32_t i = 1; i < 4; i++)
+		{
+			if (Abs(values[i]) > Abs(values[largest]))
+			{
+				largest = i;
+			}
+		}
+
+		// q and -q are the same rotation, so the largest component can be made positive and rebuilt from the others
+		const float sign	= values[largest] < 0.0f ? -1.0f : 1.0f;
+		uint64_t result		= largest;
+		uint32_t shift		= 2;
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			if (i == largest)
+				continue;
+
+			const float value = Clamp(values[i] * sign * _Animation::sqrt2, -1.0f, 1.0f);
+			result |= static_cast<uint64_t>((value * 0.5f + 0.5f) * _Animation::rotation_max + 0.5f) << shift;
+			shift += 20;
+		}
+
+		return result;
+	}
+
+	Quaternion Animation::DequantizeRotation(const uint64_t rotation)
+	{
+		const auto largest	= static_cast<uint32_t>(rotation & 3);
+		float values[4]		= {};
+		float sum			= 0.0f;
+		uint32_t shift		= 2;
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			if (i == largest)
+				continue;
+
+			const auto quantized	= static_cast<float>((rotation >> shift) & _Animation::rotation_max);
+			values[i]				= (quantized / _Animation::rotation_max * 2.0f - 1.0f) / _Animation::sqrt2;
+			sum						+= values[i] * values[i];
+			shift					+= 20;
+		}
+		values[largest] = sqrt(Max(0.0f, 1.0f - sum));
+
+		return Quaternion(values[0], values[1], values[2], values[3]);
+	}
 }
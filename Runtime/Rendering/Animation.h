@@ -28,6 +28,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace Spartan
 {
+    class FileStream;
+    class AnimationPose;
+
     struct AnimationVertexWeight
     {
         uint32_t vertexID;
@@ -61,6 +64,27 @@ namespace Spartan
         std::vector<KeyVector> scaleFrames;
     };
 
+    // The keys of a single node, in seconds. Keys that interpolating their neighbours reproduces are dropped, and
+    // rotations are quantized to 64 bits (the three smallest components at 20 bits each, plus the index of the largest).
+    struct AnimationTrack
+    {
+        std::string node_name;
+        std::vector<float> position_times;
+        std::vector<Math::Vector3> positions;
+        std::vector<float> rotation_times;
+        std::vector<uint64_t> rotations;
+        std::vector<float> scale_times;
+        std::vector<Math::Vector3> scales;
+    };
+
+    // Where sampling a track left off, playing forward only ever moves it by a few keys
+    struct AnimationCursor
+    {
+        uint32_t position   = 0;
+        uint32_t rotation   = 0;
+        uint32_t scale      = 0;
+    };
+
 	class SPARTAN_CLASS Animation : public IResource
 	{
 	public:
@@ -75,13 +99,31 @@ namespace Spartan
 		void SetName(const std::string& name)   { m_name = name; }
 		void SetDuration(double duration)       { m_duration = duration; }
 		void SetTicksPerSec(double ticksPerSec) { m_ticksPerSec = ticksPerSec; }
+		const auto& GetName() const             { return m_name; }
+		float GetLength() const                 { return m_ticksPerSec != 0 ? static_cast<float>(m_duration / m_ticksPerSec) : 0.0f; } // in seconds
+
+		// Compresses the keys of a node (their times are in ticks, so the ticks per second have to be set first)
+		void AddChannel(const AnimationNode& node);
+		const auto& GetTracks() const { return m_tracks; }
+
+		// Writes the transforms of the tracks that have a joint (track_joints holds a joint index per track, or -1) to the pose.
+		// There is a cursor per track, they are updated so that the next sample can start from them.
+		void Sample(float time, const int32_t* track_joints, AnimationCursor* cursors, AnimationPose* pose) const;
+
+		// Serialization
+		void Serialize(FileStream* stream) const;
+		void Deserialize(FileStream* stream);
+
+		// Rotation quantization
+		static uint64_t QuantizeRotation(const Math::Quaternion& rotation);
+		static Math::Quaternion DequantizeRotation(uint64_t rotation);
 
 	private:
 		std::string m_name;
 		double m_duration       = 0;
 		double m_ticksPerSec    = 0;
 
-		// Each channel controls a single node
-		std::vector<AnimationNode> m_channels;
+		// Each track controls a single node
+		std::vector<AnimationTrack> m_tracks;
 	};
 }
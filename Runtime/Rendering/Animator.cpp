@@ -0,0 +1,116 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ========================
+#include "Animator.h"
+#include <cmath>
+#include "../RHI/RHI_Vertex.h"
+#include "../Threading/Threading.h"
+//===================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+	Animator::Animator(const shared_ptr<Skeleton>& skeleton)
+	{
+		m_skeleton	= skeleton;
+		m_pose		= skeleton->GetBindPose();
+		m_pose_layer	= skeleton->GetBindPose();
+	}
+
+	uint32_t Animator::AddLayer(const shared_ptr<Animation>& animation, const float weight, const float speed, const bool loop)
+	{
+		Animator_Layer layer;
+		layer.animation	= animation;
+		layer.weight	= weight;
+		layer.speed		= speed;
+		layer.loop		= loop;
+
+		// Bind the tracks to joints by name, once
+		const auto& tracks = animation->GetTracks();
+		layer.track_joints.reserve(tracks.size());
+		for (const AnimationTrack& track : tracks)
+		{
+			layer.track_joints.emplace_back(m_skeleton->GetJointIndex(track.node_name));
+		}
+		layer.cursors.resize(tracks.size());
+
+		m_layers.emplace_back(layer);
+		return static_cast<uint32_t>(m_layers.size()) - 1;
+	}
+
+	void Animator::SetSkinnedGeometry(const vector<RHI_Vertex_PosTexNorTan>* vertices, const vector<Skinning_Weights>* weights)
+	{
+		if (vertices && weights && vertices->size() != weights->size())
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return;
+		}
+
+		m_vertices	= vertices;
+		m_weights	= weights;
+		m_vertices_skinned.resize(vertices ? vertices->size() : 0);
+	}
+
+	void Animator::Tick(const float delta_time)
+	{
+		// Sample and blend the layers, bottom to top
+		m_pose = m_skeleton->GetBindPose();
+		for (Animator_Layer& layer : m_layers)
+		{
+			const float length = layer.animation->GetLength();
+			layer.time += delta_time * layer.speed;
+			if (length > 0.0f)
+			{
+				layer.time = layer.loop ? fmod(fmod(layer.time, length) + length, length) : Math::Clamp(layer.time, 0.0f, length);
+			}
+
+			if (layer.weight <= 0.0f)
+				continue;
+
+			m_pose_layer = m_skeleton->GetBindPose();
+			layer.animation->Sample(layer.time, layer.track_joints.data(), layer.cursors.data(), &m_pose_layer);
+			m_pose.Blend(m_pose_layer, Math::Min(layer.weight, 1.0f));
+		}
+
+		// Matrices
+		m_skeleton->ComputeSkinningMatrices(m_pose, &m_matrices_local, &m_matrices_model, &m_matrices_skinning);
+
+		// Vertices
+		if (m_vertices && m_weights)
+		{
+			Skeleton::Skin(m_vertices->data(), m_weights->data(), static_cast<uint32_t>(m_vertices->size()), m_matrices_skinning.data(), m_vertices_skinned.data());
+		}
+	}
+
+	void Animator::Tick(Threading* threading, const vector<Animator*>& animators, const float delta_time)
+	{
+		threading->ForEach([&animators, delta_time](const uint32_t i)
+		{
+			animators[i]->Tick(delta_time);
+		},
+		static_cast<uint32_t>(animators.size()));
+	}
+}
@@ -0,0 +1,86 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <memory>
+#include "Skeleton.h"
+#include "Animation.h"
+//================================
+
+namespace Spartan
+{
+	class Threading;
+
+	struct Animator_Layer
+	{
+		std::shared_ptr<Animation> animation;
+		float time		= 0.0f;
+		float speed		= 1.0f;
+		float weight	= 1.0f; // how much the layer overrides the layers below it (the bottom one blends with the bind pose)
+		bool loop		= true;
+		std::vector<int32_t> track_joints;
+		std::vector<AnimationCursor> cursors;
+	};
+
+	// Plays animations on a skeleton: samples the layers, blends them and computes the skinning matrices. It needs nothing
+	// but the skeleton (no entities or renderer), and it can skin vertices on the CPU, so it also serves headless use.
+	class SPARTAN_CLASS Animator
+	{
+	public:
+		Animator(const std::shared_ptr<Skeleton>& skeleton);
+		~Animator() = default;
+
+		// Layers
+		uint32_t AddLayer(const std::shared_ptr<Animation>& animation, float weight = 1.0f, float speed = 1.0f, bool loop = true);
+		auto& GetLayer(const uint32_t index)	{ return m_layers[index]; }
+		auto GetLayerCount() const				{ return static_cast<uint32_t>(m_layers.size()); }
+
+		// Vertices to skin on the CPU when ticking, they have to outlive the animator
+		void SetSkinnedGeometry(const std::vector<RHI_Vertex_PosTexNorTan>* vertices, const std::vector<Skinning_Weights>* weights);
+
+		// Advances the layers by delta_time (seconds), and updates the pose, the matrices and the skinned vertices
+		void Tick(float delta_time);
+
+		// Ticks many animators, spread across the threads
+		static void Tick(Threading* threading, const std::vector<Animator*>& animators, float delta_time);
+
+		const auto& GetPose() const					{ return m_pose; }
+		const auto& GetJointMatrices() const		{ return m_matrices_model; }	// model space
+		const auto& GetSkinningMatrices() const		{ return m_matrices_skinning; }
+		const auto& GetSkinnedVertices() const		{ return m_vertices_skinned; }
+
+	private:
+		std::shared_ptr<Skeleton> m_skeleton;
+		std::vector<Animator_Layer> m_layers;
+		AnimationPose m_pose;
+		AnimationPose m_pose_layer;
+		std::vector<Math::Matrix> m_matrices_local;
+		std::vector<Math::Matrix> m_matrices_model;
+		std::vector<Math::Matrix> m_matrices_skinning;
+		const std::vector<RHI_Vertex_PosTexNorTan>* m_vertices	= nullptr;
+		const std::vector<Skinning_Weights>* m_weights			= nullptr;
+		std::vector<RHI_Vertex_PosTexNorTan> m_vertices_skinned;
+	};
+}
@@ -147,6 +147,7 @@ namespace Spartan
 		SetMultiplier(type, 1.0f);
 		AcquireShader();
 		UpdateResourceArray();
+		SetDirty(true);
 	}
 
 	void Material::SetTextureSlot(const TextureType type, const std::shared_ptr<RHI_Texture2D>& texture)
@@ -259,6 +260,7 @@ namespace Spartan
         }
 
         m_color_albedo = color;
+        SetDirty(true);
     }
 
     TextureType Material::TextureTypeFromString(const string& type)
@@ -75,6 +75,7 @@ namespace Spartan
 		std::string GetTexturePathByType(TextureType type);
 		std::vector<std::string> GetTexturePaths();
 		const auto& GetTexture(const TextureType type) { return HasTexture(type) ? m_textures[type] : m_texture_empty; }
+		const auto& GetTextures() const { return m_textures; }
 		//==============================================================================================================
 
 		//= SHADER ====================================================================
@@ -86,25 +87,25 @@ namespace Spartan
 
 		//= PROPERTIES ==========================================================================================
 		auto GetCullMode() const											{ return m_cull_mode; }
-		void SetCullMode(const RHI_Cull_Mode cull_mode)						{ m_cull_mode = cull_mode; }
+		void SetCullMode(const RHI_Cull_Mode cull_mode)						{ m_cull_mode = cull_mode; SetDirty(true); }
 
 		auto GetShadingMode() const											{ return m_shading_mode; }
-		void SetShadingMode(const ShadingMode shading_mode)					{ m_shading_mode = shading_mode; }
+		void SetShadingMode(const ShadingMode shading_mode)					{ m_shading_mode = shading_mode; SetDirty(true); }
 
 		const auto& GetColorAlbedo() const									{ return m_color_albedo; }
         void SetColorAlbedo(const Math::Vector4& color);
 		
 		const auto& GetTiling() const										{ return m_uv_tiling; }
-		void SetTiling(const Math::Vector2& tiling)							{ m_uv_tiling = tiling; }
+		void SetTiling(const Math::Vector2& tiling)							{ m_uv_tiling = tiling; SetDirty(true); }
 
 		const auto& GetOffset() const										{ return m_uv_offset; }
-		void SetOffset(const Math::Vector2& offset)							{ m_uv_offset = offset; }
+		void SetOffset(const Math::Vector2& offset)							{ m_uv_offset = offset; SetDirty(true); }
 
 		auto IsEditable() const { return m_is_editable; }
-		void SetIsEditable(const bool is_editable)							{ m_is_editable = is_editable; }
+		void SetIsEditable(const bool is_editable)							{ m_is_editable = is_editable; SetDirty(true); }
 
 		auto& GetMultiplier(const TextureType type)							{ return m_multipliers[type];}
-		void SetMultiplier(const TextureType type, const float multiplier)	{ m_multipliers[type] = multiplier; }
+		void SetMultiplier(const TextureType type, const float multiplier)	{ m_multipliers[type] = multiplier; SetDirty(true); }
 
 		static TextureType TextureTypeFromString(const std::string& type);
 		//=======================================================================================================
@@ -22,17 +22,23 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ================================
 #include "Model.h"
 #include "Mesh.h"
+#include "Animation.h"
 #include "Renderer.h"
 #include "../IO/FileStream.h"
+#include "../Core/Hash.h"
 #include "../Core/Stopwatch.h"
+#include "../Core/EventSystem.h"
 #include "../Resource/ResourceCache.h"
+#include "../Resource/ImportCache.h"
 #include "../Resource/Import/ModelImporter.h"
+#include "../World/World.h"
 #include "../World/Entity.h"
 #include "../World/Components/Transform.h"
 #include "../World/Components/Renderable.h"
 #include "../RHI/RHI_VertexBuffer.h"
 #include "../RHI/RHI_IndexBuffer.h"
 #include "../RHI/RHI_Texture2D.h"
+#include "Utilities/Quantization.h"
 //===========================================
 
 //= NAMESPACES ================
@@ -40,6 +46,28 @@ using namespace std;
 using namespace Spartan::Math;
 //=============================
 
+namespace _Model
+{
+	// Bump whenever the model importer changes what it produces, so that cached imports are redone
+	static const uint64_t import_version = 7;
+
+	// Native files start with these, files written before them start with the foreign file path (its length is never this large)
+	static const uint32_t file_magic	= 0x4C444D53; // "SMDL"
+	static const uint32_t file_version	= 1;
+
+	// Indices are local to each mesh, so most models can do with 16 bits. There is a single index buffer, so it's all or nothing.
+	static bool fits_16bit(const vector<uint32_t>& indices)
+	{
+		for (const uint32_t index : indices)
+		{
+			if (index > 0xffff)
+				return false;
+		}
+
+		return true;
+	}
+}
+
 namespace Spartan
 {
 	Model::Model(Context* context) : IResource(context, Resource_Model)
@@ -60,9 +88,17 @@ namespace Spartan
         m_vertex_buffer.reset();
         m_index_buffer.reset();
         m_mesh->Geometry_Clear();
+        m_lods.clear();
+        m_meshlets.clear();
+        m_skeleton.reset();
+        m_weights.clear();
+        m_animations.clear();
         m_aabb.Undefine();
         m_normalized_scale = 1.0f;
         m_is_animated = false;
+        m_vertex_quantization = false;
+        m_mesh_vertex_offsets.clear();
+        m_dequantization.clear();
     }
 
 	bool Model::LoadFromFile(const string& file_path)
@@ -79,15 +115,11 @@ namespace Spartan
         if (FileSystem::GetExtensionFromFilePath(file_path) == EXTENSION_MODEL)
         {
             // Deserialize
-            auto file = make_unique<FileStream>(file_path, FileStream_Read);
-            if (!file->IsOpen())
+            string foreign_file_path;
+            if (!GeometryLoad(file_path, &foreign_file_path))
                 return false;
 
-            SetResourceFilePath(file->ReadAs<string>());
-            file->Read(&m_normalized_scale);
-            file->Read(&m_mesh->Indices_Get());
-            file->Read(&m_mesh->Vertices_Get());
-
+            SetResourceFilePath(foreign_file_path);
             UpdateGeometry();
         }
         // Load foreign format
@@ -95,17 +127,30 @@ namespace Spartan
         {
             SetResourceFilePath(file_path);
 
-            if (m_resource_manager->GetModelImporter()->Load(this, file_path))
+            // If the same file was imported before, restore its native files and entities instead. The path is part of
+            // the key because the cached materials refer to their textures by path.
+            ImportCache* import_cache   = m_resource_manager->GetImportCache();
+            const uint64_t import_key   = import_cache->ComputeKey(file_path, Hash::Compute(GetResourceFilePath(), _Model::import_version));
+            vector<std::byte> hierarchy;
+            m_import_key                = 0;
+            if (import_cache->Fetch(import_key, file_path, &hierarchy) && LoadFromFile_Cached(hierarchy))
+            {
+                LOG_INFO("Restored \"%s\" from the import cache", FileSystem::GetFileNameFromFilePath(file_path).c_str());
+            }
+            else if (m_resource_manager->GetModelImporter()->Load(this, file_path))
             {
-                // Set the normalized scale to the root entity's transform
-                m_normalized_scale = GeometryComputeNormalizedScale();
-                m_root_entity.lock()->GetComponent<Transform>()->SetScale(m_normalized_scale);
-                m_root_entity.lock()->GetComponent<Transform>()->UpdateTransform();
+                // The import is cached once the native file is saved
+                m_import_key = import_key;
             }
             else
             {
                 return false;
             }
+
+            // Set the normalized scale to the root entity's transform
+            m_normalized_scale = GeometryComputeNormalizedScale();
+            m_root_entity.lock()->GetComponent<Transform>()->SetScale(m_normalized_scale);
+            m_root_entity.lock()->GetComponent<Transform>()->UpdateTransform();
         }
 
 		m_size = GeometryComputeMemoryUsage();
@@ -120,17 +165,94 @@ namespace Spartan
 		if (!file->IsOpen())
 			return false;
 
+		file->Write(_Model::file_magic);
+		file->Write(_Model::file_version);
 		file->Write(GetResourceFilePath());
 		file->Write(m_normalized_scale);
-		file->Write(m_mesh->Indices_Get());
+		file->Write(m_vertex_quantization);
+
+		// Indices
+		const auto& indices			= m_mesh->Indices_Get();
+		const bool indices_16bit	= _Model::fits_16bit(indices);
+		file->Write(indices_16bit);
+		if (indices_16bit)
+		{
+			file->Write(vector<uint16_t>(indices.begin(), indices.end()));
+		}
+		else
+		{
+			file->Write(indices);
+		}
+
+		// Vertices, they are quantized when uploaded so that the CPU copy stays exact
+		file->Write(m_mesh_vertex_offsets);
 		file->Write(m_mesh->Vertices_Get());
 
+		// Levels of detail
+		file->Write(static_cast<uint32_t>(m_lods.size()));
+		for (const auto& [index_offset, lods] : m_lods)
+		{
+			file->Write(index_offset);
+			file->Write(static_cast<uint32_t>(lods.size()));
+			for (const Model_Lod& lod : lods)
+			{
+				file->Write(lod.index_offset);
+				file->Write(lod.index_count);
+				file->Write(lod.error);
+			}
+		}
+
+		// Meshlets
+		file->Write(static_cast<uint32_t>(m_meshlets.size()));
+		for (const auto& [index_offset, meshlets] : m_meshlets)
+		{
+			file->Write(index_offset);
+			file->Write(static_cast<uint32_t>(meshlets.size()));
+			for (const Model_Meshlet& meshlet : meshlets)
+			{
+				file->Write(meshlet.index_offset);
+				file->Write(meshlet.index_count);
+				file->Write(meshlet.center);
+				file->Write(meshlet.radius);
+				file->Write(meshlet.cone_axis);
+				file->Write(meshlet.cone_cutoff);
+			}
+		}
+
+		// Skinning
+		file->Write(m_skeleton != nullptr);
+		if (m_skeleton)
+		{
+			m_skeleton->Serialize(file.get());
+			file->Write(static_cast<uint32_t>(m_weights.size()));
+			file->Write(reinterpret_cast<const std::byte*>(m_weights.data()), m_weights.size() * sizeof(Skinning_Weights));
+			file->Write(static_cast<uint32_t>(m_animations.size()));
+			for (const auto& animation : m_animations)
+			{
+				animation->Serialize(file.get());
+			}
+		}
+
         file->Close();
 
+        // Now that the native file exists, the import that produced it can be cached, along with its materials, textures and entities
+        if (m_import_key != 0)
+        {
+            vector<string> artifacts = { file_path };
+            vector<string> dependencies;
+            vector<std::byte> hierarchy;
+            auto stream = make_unique<FileStream>(&hierarchy);
+            SaveHierarchy(stream.get(), &artifacts, &dependencies);
+            stream->Close();
+
+            m_resource_manager->GetImportCache()->Store(m_import_key, GetResourceFilePath(), artifacts, dependencies, hierarchy);
+            m_import_key = 0;
+        }
+
 		return true;
 	}
 
-	void Model::AppendGeometry(const vector<uint32_t>& indices, const vector<RHI_Vertex_PosTexNorTan>& vertices, uint32_t* index_offset, uint32_t* vertex_offset) const
+	void Model::AppendGeometry(const vector<uint32_t>& indices, const vector<RHI_Vertex_PosTexNorTan>& vertices, uint32_t* index_offset, uint32_t* vertex_offset)
 	{
 		if (indices.empty() || vertices.empty())
 		{
@@ -139,8 +261,73 @@ namespace Spartan
 		}
 
 		// Append indices and vertices to the main mesh
+		uint32_t mesh_vertex_offset = 0;
 		m_mesh->Indices_Append(indices, index_offset);
-		m_mesh->Vertices_Append(vertices, vertex_offset);
+		m_mesh->Vertices_Append(vertices, &mesh_vertex_offset);
+		m_mesh_vertex_offsets.emplace_back(mesh_vertex_offset);
+
+		if (vertex_offset)
+		{
+			*vertex_offset = mesh_vertex_offset;
+		}
+	}
+
+	const Matrix& Model::GetDequantization(const uint32_t vertex_offset) const
+	{
+		const auto it = m_dequantization.find(vertex_offset);
+		return it != m_dequantization.end() ? it->second : Matrix::Identity;
+	}
+
+	void Model::AppendWeights(const uint32_t vertex_offset, const vector<Skinning_Weights>& weights)
+	{
+		// Vertices that have no weights (those of meshes that are not skinned) are left as they are
+		if (m_weights.size() < vertex_offset + weights.size())
+		{
+			m_weights.resize(vertex_offset + weights.size());
+		}
+
+		copy(weights.begin(), weights.end(), m_weights.begin() + vertex_offset);
+	}
+
+	void Model::AppendLod(const uint32_t index_offset, const vector<uint32_t>& indices, const float error)
+	{
+		if (indices.empty())
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return;
+		}
+
+		Model_Lod lod;
+		lod.index_count	= static_cast<uint32_t>(indices.size());
+		lod.error		= error;
+		m_mesh->Indices_Append(indices, &lod.index_offset);
+		m_lods[index_offset].emplace_back(lod);
+	}
+
+	const vector<Model_Lod>& Model::GetLods(const uint32_t index_offset) const
+	{
+		static const vector<Model_Lod> empty;
+
+		const auto it = m_lods.find(index_offset);
+		return it != m_lods.end() ? it->second : empty;
+	}
+
+	void Model::AppendMeshlets(const uint32_t index_offset, const vector<Model_Meshlet>& meshlets)
+	{
+		auto& meshlets_mesh = m_meshlets[index_offset];
+		for (Model_Meshlet meshlet : meshlets)
+		{
+			meshlet.index_offset += index_offset;
+			meshlets_mesh.emplace_back(meshlet);
+		}
+	}
+
+	const vector<Model_Meshlet>& Model::GetMeshlets(const uint32_t index_offset) const
+	{
+		static const vector<Model_Meshlet> empty;
+
+		const auto it = m_meshlets.find(index_offset);
+		return it != m_meshlets.end() ? it->second : empty;
 	}
 
 	void Model::GetGeometry(const uint32_t index_offset, const uint32_t index_count, const uint32_t vertex_offset, const uint32_t vertex_count, vector<uint32_t>* indices, vector<RHI_Vertex_PosTexNorTan>* vertices) const
@@ -156,6 +343,11 @@ namespace Spartan
 			return;
 		}
 
+		if (m_skeleton)
+		{
+			m_weights.resize(m_mesh->Vertices_Count());
+		}
+
 		GeometryCreateBuffers();
 		m_normalized_scale	= GeometryComputeNormalizedScale();
 		m_aabb				= BoundingBox(m_mesh->Vertices_Get());
@@ -186,23 +378,307 @@ namespace Spartan
 			return;
 		}
 
+		// If the texture is not cached, we have to load it (setting it to the material caches it)
+		const auto texture = AcquireTexture(texture_type, file_path);
+		if (texture->GetLoadState() == LoadState_Idle)
+		{
+			texture->LoadFromFile(file_path);
+		}
+
+		// Set the texture to the provided material
+		material->SetTextureSlot(texture_type, texture);
+	}
+
+	shared_ptr<RHI_Texture2D> Model::AcquireTexture(const TextureType texture_type, const string& file_path) const
+	{
 		// Try to get the texture
 		const auto tex_name = FileSystem::GetFileNameNoExtensionFromFilePath(file_path);
 		if (auto texture = m_context->GetSubsystem<ResourceCache>()->GetByName<RHI_Texture2D>(tex_name))
+			return texture;
+
+		// Create it, with the settings of its type
+		auto generate_mipmaps = true;
+		auto texture = make_shared<RHI_Texture2D>(m_context, generate_mipmaps);
+		ApplyTextureSettings(texture.get(), texture_type);
+		return texture;
+	}
+
+	void Model::ApplyTextureSettings(RHI_Texture* texture, const TextureType texture_type, const bool merge)
+	{
+		const bool is_normal_map		= texture_type == TextureType_Normal;
+		const bool is_single_channel	= texture_type == TextureType_Roughness || texture_type == TextureType_Metallic || texture_type == TextureType_Height || texture_type == TextureType_Occlusion;
+		const bool is_srgb				= texture_type == TextureType_Albedo || texture_type == TextureType_Emission;
+		const float alpha_threshold		= texture_type == TextureType_Albedo ? 0.6f : 0.0f; // GBuffer.hlsl discards albedo alpha at or below 0.6
+
+		// A file that is used as several types is a single texture, so lossy settings only apply if every type allows them
+		texture->SetCompression(RHI_Texture_Compression_Quality);
+		texture->SetNormalMap(is_normal_map && (!merge || texture->IsNormalMap()));
+		texture->SetSingleChannel(is_single_channel && (!merge || texture->IsSingleChannel()));
+		texture->SetSrgb(is_srgb || (merge && texture->IsSrgb()));
+		texture->SetAlphaCoverageThreshold(merge ? Max(alpha_threshold, texture->GetAlphaCoverageThreshold()) : alpha_threshold);
+	}
+
+	bool Model::LoadFromFile_Cached(const vector<std::byte>& hierarchy)
+	{
+		// Geometry, from the restored native file (the foreign file path it holds is the one this model already has)
+		string foreign_file_path;
+		if (!GeometryLoad(GetResourceFilePathNative(), &foreign_file_path) || m_mesh->Indices_Count() == 0 || m_mesh->Vertices_Count() == 0)
+		{
+			m_mesh->Geometry_Clear();
+			m_mesh_vertex_offsets.clear();
+			m_lods.clear();
+			m_meshlets.clear();
+			m_skeleton.reset();
+			m_weights.clear();
+			m_animations.clear();
+			return false;
+		}
+		UpdateGeometry();
+
+		// Entities
+		return LoadHierarchy(hierarchy);
+	}
+
+	void Model::SaveHierarchy(FileStream* stream, vector<string>* artifacts, vector<string>* dependencies) const
+	{
+		const auto add_unique = [](vector<string>* paths, const string& path)
 		{
-			material->SetTextureSlot(texture_type, texture);
+			if (!path.empty() && find(paths->begin(), paths->end(), path) == paths->end())
+			{
+				paths->emplace_back(path);
+			}
+		};
+
+		// Flatten the entities, parents always precede their children
+		vector<pair<Transform*, int>> nodes;
+		if (const auto root = m_root_entity.lock())
+		{
+			nodes.emplace_back(root->GetTransform_PtrRaw(), -1);
+		}
+		for (uint32_t i = 0; i < static_cast<uint32_t>(nodes.size()); i++)
+		{
+			for (Transform* child : nodes[i].first->GetChildren())
+			{
+				nodes.emplace_back(child, static_cast<int>(i));
+			}
+		}
+
+		stream->Write(static_cast<uint32_t>(nodes.size()));
+		for (const auto& [transform, parent_index] : nodes)
+		{
+			Entity* entity = transform->GetEntity_PtrRaw();
+			stream->Write(entity->GetName());
+			stream->Write(parent_index);
+			stream->Write(entity->IsActive());
+			stream->Write(transform->GetPositionLocal());
+			stream->Write(transform->GetRotationLocal());
+			stream->Write(transform->GetScaleLocal());
+
+			const auto renderable		= entity->GetComponent<Renderable>();
+			const bool has_geometry		= renderable && renderable->GeometryModel().get() == this;
+			stream->Write(has_geometry);
+			if (!has_geometry)
+				continue;
+
+			stream->Write(renderable->GeometryIndexOffset());
+			stream->Write(renderable->GeometryIndexCount());
+			stream->Write(renderable->GeometryVertexOffset());
+			stream->Write(renderable->GeometryVertexCount());
+
+			// The material, its textures, and the foreign files they were imported from
+			const auto& material = renderable->GetMaterial();
+			stream->Write(material ? material->GetResourceFilePathNative() : "");
+			if (!material)
+				continue;
+
+			add_unique(artifacts, material->GetResourceFilePathNative());
+			for (const auto& texture : material->GetTextures())
+			{
+				if (!texture.second)
+					continue;
+
+				add_unique(artifacts, texture.second->GetResourceFilePathNative());
+				add_unique(dependencies, texture.second->GetResourceFilePath());
+			}
+		}
+	}
+
+	bool Model::LoadHierarchy(const vector<std::byte>& hierarchy)
+	{
+		if (hierarchy.empty())
+			return false;
+
+		auto stream = make_unique<FileStream>(hierarchy.data(), hierarchy.size());
+
+		const auto entity_count = stream->ReadAs<uint32_t>();
+		if (entity_count == 0)
+			return false;
+
+		// Can run on a worker, keep the world from ticking until the entities are in place
+		World* world = m_context->GetSubsystem<World>().get();
+		const auto world_lock = world->Lock();
+
+		vector<shared_ptr<Entity>> entities;
+		entities.reserve(entity_count);
+		for (uint32_t i = 0; i < entity_count; i++)
+		{
+			// Entity
+			const auto name			= stream->ReadAs<string>();
+			const auto parent_index	= stream->ReadAs<int>();
+			const auto is_active	= stream->ReadAs<bool>();
+			shared_ptr<Entity> entity = world->EntityCreate(false);
+			entity->SetName(name);
+
+			// Transform
+			Vector3 position;
+			Quaternion rotation;
+			Vector3 scale;
+			stream->Read(&position);
+			stream->Read(&rotation);
+			stream->Read(&scale);
+			Transform* transform = entity->GetTransform_PtrRaw();
+			if (parent_index >= 0 && parent_index < static_cast<int>(i))
+			{
+				transform->SetParent(entities[parent_index]->GetTransform_PtrRaw());
+			}
+			transform->SetPositionLocal(position);
+			transform->SetRotationLocal(rotation);
+			transform->SetScaleLocal(scale);
+
+			// Renderable
+			if (stream->ReadAs<bool>())
+			{
+				const auto index_offset		= stream->ReadAs<uint32_t>();
+				const auto index_count		= stream->ReadAs<uint32_t>();
+				const auto vertex_offset	= stream->ReadAs<uint32_t>();
+				const auto vertex_count		= stream->ReadAs<uint32_t>();
+				const auto material_path	= stream->ReadAs<string>();
+
+				vector<uint32_t> indices;
+				vector<RHI_Vertex_PosTexNorTan> vertices;
+				GetGeometry(index_offset, index_count, vertex_offset, vertex_count, &indices, &vertices);
+
+				auto renderable = entity->AddComponent<Renderable>();
+				renderable->GeometrySet(name, index_offset, index_count, vertex_offset, vertex_count, BoundingBox(vertices), this);
+
+				if (!material_path.empty())
+				{
+					if (auto material = m_resource_manager->Load<Material>(material_path))
+					{
+						renderable->SetMaterial(material);
+					}
+				}
+			}
+
+			entity->SetActive(is_active);
+			entities.emplace_back(entity);
+		}
+
+		SetRootEntity(entities.front());
+
+		return true;
+	}
+
+	bool Model::GeometryLoad(const string& file_path, string* foreign_file_path)
+	{
+		auto file = make_unique<FileStream>(file_path, FileStream_Read);
+		if (!file->IsOpen())
+			return false;
+
+		m_mesh_vertex_offsets.clear();
+		m_lods.clear();
+		m_meshlets.clear();
+		m_skeleton.reset();
+		m_weights.clear();
+		m_animations.clear();
+
+		// Files written before the header existed only have the geometry
+		if (file->ReadAs<uint32_t>() != _Model::file_magic)
+		{
+			file->Seek(0);
+			file->Read(foreign_file_path);
+			file->Read(&m_normalized_scale);
+			file->Read(&m_mesh->Indices_Get());
+			file->Read(&m_mesh->Vertices_Get());
+			m_is_animated = false;
+			return true;
+		}
+
+		const auto version = file->ReadAs<uint32_t>();
+		if (version != _Model::file_version)
+		{
+			LOG_ERROR("\"%s\" has an unsupported version (%d)", file_path.c_str(), version);
+			return false;
+		}
+
+		file->Read(foreign_file_path);
+		file->Read(&m_normalized_scale);
+		file->Read(&m_vertex_quantization);
+
+		// Indices
+		if (file->ReadAs<bool>())
+		{
+			vector<uint16_t> indices;
+			file->Read(&indices);
+			m_mesh->Indices_Get().assign(indices.begin(), indices.end());
 		}
-		// If we didn't get a texture, it's not cached, hence we have to load it and cache it now
 		else
 		{
-			// Load texture
-			auto generate_mipmaps = true;
-            texture = make_shared<RHI_Texture2D>(m_context, generate_mipmaps);
-			texture->LoadFromFile(file_path);
+			file->Read(&m_mesh->Indices_Get());
+		}
 
-			// Set the texture to the provided material
-			material->SetTextureSlot(texture_type, texture);
+		// Vertices
+		file->Read(&m_mesh_vertex_offsets);
+		file->Read(&m_mesh->Vertices_Get());
+
+		// Levels of detail
+		for (uint32_t i = 0, mesh_count = file->ReadAs<uint32_t>(); i < mesh_count; i++)
+		{
+			const auto index_offset	= file->ReadAs<uint32_t>();
+			auto& lods				= m_lods[index_offset];
+			lods.resize(file->ReadAs<uint32_t>());
+			for (Model_Lod& lod : lods)
+			{
+				file->Read(&lod.index_offset);
+				file->Read(&lod.index_count);
+				file->Read(&lod.error);
+			}
 		}
+
+		// Meshlets
+		for (uint32_t i = 0, mesh_count = file->ReadAs<uint32_t>(); i < mesh_count; i++)
+		{
+			const auto index_offset	= file->ReadAs<uint32_t>();
+			auto& meshlets			= m_meshlets[index_offset];
+			meshlets.resize(file->ReadAs<uint32_t>());
+			for (Model_Meshlet& meshlet : meshlets)
+			{
+				file->Read(&meshlet.index_offset);
+				file->Read(&meshlet.index_count);
+				file->Read(&meshlet.center);
+				file->Read(&meshlet.radius);
+				file->Read(&meshlet.cone_axis);
+				file->Read(&meshlet.cone_cutoff);
+			}
+		}
+
+		// Skinning
+		if (file->ReadAs<bool>())
+		{
+			m_skeleton = make_shared<Skeleton>();
+			m_skeleton->Deserialize(file.get());
+			m_weights.resize(file->ReadAs<uint32_t>());
+			file->Read(reinterpret_cast<std::byte*>(m_weights.data()), m_weights.size() * sizeof(Skinning_Weights));
+			m_animations.resize(file->ReadAs<uint32_t>());
+			for (auto& animation : m_animations)
+			{
+				animation = make_shared<Animation>(m_context);
+				animation->Deserialize(file.get());
+			}
+		}
+		m_is_animated = m_skeleton != nullptr;
+
+		return true;
 	}
 
 	bool Model::GeometryCreateBuffers()
@@ -216,7 +692,8 @@ namespace Spartan
 		if (!indices.empty())
 		{
 			m_index_buffer = make_shared<RHI_IndexBuffer>(m_rhi_device);
-			if (!m_index_buffer->Create(indices))
+			const bool created = _Model::fits_16bit(indices) ? m_index_buffer->Create(vector<uint16_t>(indices.begin(), indices.end())) : m_index_buffer->Create(indices);
+			if (!created)
 			{
 				LOG_ERROR("Failed to create index buffer for \"%s\".", GetResourceName().c_str());
 				success = false;
@@ -230,8 +707,34 @@ namespace Spartan
 
 		if (!vertices.empty())
 		{
+			bool created = false;
 			m_vertex_buffer = make_shared<RHI_VertexBuffer>(m_rhi_device);
-			if (!m_vertex_buffer->Create(vertices))
+			m_dequantization.clear();
+			if (m_vertex_quantization)
+			{
+				// Every mesh is quantized in its own bounds (geometry without recorded meshes is treated as a single one)
+				vector<RHI_Vertex_PosTexNorTan_Quantized> vertices_quantized(vertices.size());
+				const vector<uint32_t> mesh_vertex_offsets = m_mesh_vertex_offsets.empty() ? vector<uint32_t>{ 0 } : m_mesh_vertex_offsets;
+				for (size_t i = 0; i < mesh_vertex_offsets.size(); i++)
+				{
+					const uint32_t vertex_offset	= mesh_vertex_offsets[i];
+					const uint32_t vertex_end		= i + 1 < mesh_vertex_offsets.size() ? mesh_vertex_offsets[i + 1] : static_cast<uint32_t>(vertices.size());
+					const Span<const RHI_Vertex_PosTexNorTan> mesh_vertices(vertices.data() + vertex_offset, vertex_end - vertex_offset);
+
+					Vector3 offset;
+					float scale;
+					Utility::Quantization::ComputeBounds(mesh_vertices, &offset, &scale);
+					Utility::Quantization::Quantize(mesh_vertices, offset, scale, vertices_quantized.data() + vertex_offset);
+					m_dequantization[vertex_offset] = Utility::Quantization::ComputeDequantization(offset, scale);
+				}
+				created = m_vertex_buffer->Create(vertices_quantized);
+			}
+			else
+			{
+				created = m_vertex_buffer->Create(vertices);
+			}
+
+			if (!created)
 			{
 				LOG_ERROR("Failed to create vertex buffer for \"%s\".", GetResourceName().c_str());
 				success = false;
@@ -24,10 +24,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <memory>
 #include <vector>
+#include <map>
 #include "Material.h"
+#include "Skeleton.h"
 #include "../RHI/RHI_Definition.h"
 #include "../Resource/IResource.h"
 #include "../Math/BoundingBox.h"
+#include "../Math/Matrix.h"
 //================================
 
 namespace Spartan
@@ -35,8 +38,29 @@ namespace Spartan
 	class ResourceCache;
 	class Entity;
 	class Mesh;
+	class FileStream;
+	class Animation;
 	namespace Math{ class BoundingBox; }
 
+	// A simplified version of a mesh, its indices are stored after the mesh's and reference the same vertices
+	struct Model_Lod
+	{
+		uint32_t index_offset	= 0;
+		uint32_t index_count	= 0;
+		float error				= 0.0f; // object space distance from the full detail mesh
+	};
+
+	// A small cluster of a mesh's triangles (a contiguous range of its indices), with the data needed to cull it on its own
+	struct Model_Meshlet
+	{
+		uint32_t index_offset	= 0;
+		uint32_t index_count	= 0;
+		Math::Vector3 center	= Math::Vector3::Zero;	// bounding sphere, in object space
+		float radius			= 0.0f;
+		Math::Vector3 cone_axis	= Math::Vector3::Zero;	// normal cone, the meshlet faces away when dot(center - eye, cone_axis) >= cone_cutoff * distance(center, eye) + radius
+		float cone_cutoff		= 1.0f;
+	};
+
 	class SPARTAN_CLASS Model : public IResource, public std::enable_shared_from_this<Model>
 	{
 	public:
@@ -56,7 +80,7 @@ namespace Spartan
             const std::vector<RHI_Vertex_PosTexNorTan>& vertices,
             uint32_t* index_offset  = nullptr,
             uint32_t* vertex_offset = nullptr
-        ) const;
+        );
         void GetGeometry(
             uint32_t index_offset,
             uint32_t index_count,
@@ -66,13 +90,38 @@ namespace Spartan
             std::vector<RHI_Vertex_PosTexNorTan>* vertices
         ) const;
         void UpdateGeometry();
+
+        // Levels of detail, of the mesh that starts at index_offset (ordered from finest to coarsest)
+        void AppendLod(uint32_t index_offset, const std::vector<uint32_t>& indices, float error);
+        const std::vector<Model_Lod>& GetLods(uint32_t index_offset) const;
+
+        // Meshlets, of the full detail mesh that starts at index_offset (their index offsets are relative to it when appending)
+        void AppendMeshlets(uint32_t index_offset, const std::vector<Model_Meshlet>& meshlets);
+        const std::vector<Model_Meshlet>& GetMeshlets(uint32_t index_offset) const;
         const auto& GetAabb() const { return m_aabb; }
         const auto& GetMesh() const { return m_mesh; }
 
+        // Vertex quantization, the GPU vertices store 16 bit positions, half precision uvs and octahedral normals/tangents.
+        // The CPU vertices (and the native file) stay in floats, quantized positions are mapped back to object space by the
+        // dequantization matrix of the mesh they belong to (each mesh is quantized in its own bounds).
+        void SetVertexQuantization(const bool vertex_quantization)  { m_vertex_quantization = vertex_quantization; }
+        auto GetVertexQuantization() const                          { return m_vertex_quantization; }
+        const Math::Matrix& GetDequantization(uint32_t vertex_offset) const;
+
+        // Skinning, the skeleton that the vertices are bound to (their weights run parallel to them) and the animations that move it
+        void SetSkeleton(const std::shared_ptr<Skeleton>& skeleton)         { m_skeleton = skeleton; }
+        const auto& GetSkeleton() const                                     { return m_skeleton; }
+        void AppendWeights(uint32_t vertex_offset, const std::vector<Skinning_Weights>& weights);
+        const auto& GetWeights() const                                      { return m_weights; }
+        void AddAnimation(const std::shared_ptr<Animation>& animation)      { m_animations.emplace_back(animation); }
+        const auto& GetAnimations() const                                   { return m_animations; }
+
 		// Add resources to the model
         void SetRootEntity(const std::shared_ptr<Entity>& entity) { m_root_entity = entity; }
 		void AddMaterial(std::shared_ptr<Material>& material, const std::shared_ptr<Entity>& entity);
 		void AddTexture(std::shared_ptr<Material>& material, TextureType texture_type, const std::string& file_path);
+		std::shared_ptr<RHI_Texture2D> AcquireTexture(TextureType texture_type, const std::string& file_path) const; // cached, or new and set up for the type but not loaded yet
+		static void ApplyTextureSettings(RHI_Texture* texture, TextureType texture_type, bool merge = false); // merging keeps settings that suit the types the texture already has
 
         // Misc
 		auto IsAnimated() const						{ return m_is_animated; }
@@ -82,7 +131,13 @@ namespace Spartan
 		auto GetSharedPtr()							{ return shared_from_this(); }
 
 	private:
+		// Import cache
+		bool LoadFromFile_Cached(const std::vector<std::byte>& hierarchy);
+		void SaveHierarchy(FileStream* stream, std::vector<std::string>* artifacts, std::vector<std::string>* dependencies) const;
+		bool LoadHierarchy(const std::vector<std::byte>& hierarchy);
+
 		// Geometry
+		bool GeometryLoad(const std::string& file_path, std::string* foreign_file_path);
 		bool GeometryCreateBuffers();
 		float GeometryComputeNormalizedScale() const;
 		uint32_t GeometryComputeMemoryUsage() const;
@@ -92,9 +147,18 @@ namespace Spartan
 		std::shared_ptr<RHI_VertexBuffer> m_vertex_buffer;
 		std::shared_ptr<RHI_IndexBuffer> m_index_buffer;
 		std::shared_ptr<Mesh> m_mesh;
+		std::map<uint32_t, std::vector<Model_Lod>> m_lods;
+		std::map<uint32_t, std::vector<Model_Meshlet>> m_meshlets;
+		std::shared_ptr<Skeleton> m_skeleton;
+		std::vector<Skinning_Weights> m_weights;
+		std::vector<std::shared_ptr<Animation>> m_animations;
 		Math::BoundingBox m_aabb;
 		float m_normalized_scale	= 1.0f;
 		bool m_is_animated			= false;
+		bool m_vertex_quantization	= false;
+		std::vector<uint32_t> m_mesh_vertex_offsets;			// where the vertices of each appended mesh start
+		std::map<uint32_t, Math::Matrix> m_dequantization;	// per mesh, keyed by vertex offset
+		uint64_t m_import_key		= 0; // set while an import is waiting for its native file, to be cached
 
         // Dependencies
 		ResourceCache* m_resource_manager;
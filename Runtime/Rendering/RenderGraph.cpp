@@ -0,0 +1,497 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===============
+#include "RenderGraph.h"
+#include <algorithm>
+#include "../Core/Hash.h"
+#include "../Logging/Log.h"
+#include "../Math/MathHelper.h"
+//==========================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace _RenderGraph
+{
+    // Frames that a pooled texture can go unused for before it's released
+    static const uint64_t pool_lifetime = 30;
+
+    static uint64_t bytes_per_pixel(const Spartan::RHI_Format format)
+    {
+        using namespace Spartan;
+
+        switch (format)
+        {
+            case Format_R8_UNORM:               return 1;
+            case Format_R16_UINT:               return 2;
+            case Format_R16_FLOAT:              return 2;
+            case Format_R8G8_UNORM:             return 2;
+            case Format_R32G32_FLOAT:           return 8;
+            case Format_R32G32B32_FLOAT:        return 12;
+            case Format_R16G16B16A16_FLOAT:     return 8;
+            case Format_R16G16B16A16_UNORM:     return 8;
+            case Format_R16G16B16A16_SNORM:     return 8;
+            case Format_R32G32B32A32_FLOAT:     return 16;
+            default:                            return 4; // the rest are 32 bit or block compressed (which are never render targets)
+        }
+    }
+}
+
+namespace Spartan
+{
+    RenderGraph::RenderGraph(CreateTexture_Function create_texture)
+    {
+        m_create_texture = move(create_texture);
+    }
+
+    void RenderGraph::Reset()
+    {
+        // The compilation is kept, the next declaration is likely to be the same
+        m_passes.clear();
+        m_textures.clear();
+        m_signature.clear();
+    }
+
+    uint32_t RenderGraph::AddPass(const char* name, function<void()>&& execute, const bool side_effects /*= false*/)
+    {
+        RenderGraph_Pass& pass  = m_passes.emplace_back();
+        pass.name               = name;
+        pass.execute            = move(execute);
+        pass.side_effects       = side_effects;
+
+        Signature(1, side_effects);
+        return static_cast<uint32_t>(m_passes.size() - 1);
+    }
+
+    uint32_t RenderGraph::CreateTexture(const char* name, const RenderGraph_Texture_Desc& desc, shared_ptr<RHI_Texture>* slot /*= nullptr*/)
+    {
+        RenderGraph_Texture& texture    = m_textures.emplace_back();
+        texture.name                    = name;
+        texture.desc                    = desc;
+        texture.slot                    = slot;
+        texture.group                   = static_cast<uint32_t>(m_textures.size() - 1);
+
+        Signature(2, (static_cast<uint64_t>(desc.width) << 32) | desc.height, desc.format);
+        return texture.group;
+    }
+
+    uint32_t RenderGraph::ImportTexture(const char* name, shared_ptr<RHI_Texture>* slot /*= nullptr*/)
+    {
+        RenderGraph_Texture& texture    = m_textures.emplace_back();
+        texture.name                    = name;
+        texture.slot                    = slot;
+        texture.group                   = static_cast<uint32_t>(m_textures.size() - 1);
+        texture.imported                = true;
+
+        Signature(3);
+        return texture.group;
+    }
+
+    void RenderGraph::Read(const uint32_t pass, const uint32_t texture)
+    {
+        if (!IsValid(pass, texture))
+            return;
+
+        m_passes[pass].accesses.emplace_back(RenderGraph_Access{ texture, false });
+        Signature(4, pass, texture);
+    }
+
+    void RenderGraph::Write(const uint32_t pass, const uint32_t texture)
+    {
+        if (!IsValid(pass, texture))
+            return;
+
+        m_passes[pass].accesses.emplace_back(RenderGraph_Access{ texture, true });
+        Signature(5, pass, texture);
+    }
+
+    void RenderGraph::Exchange(const uint32_t pass, const uint32_t texture_a, const uint32_t texture_b)
+    {
+        if (!IsValid(pass, texture_a) || !IsValid(pass, texture_b))
+            return;
+
+        if (m_textures[texture_a].imported != m_textures[texture_b].imported)
+        {
+            LOG_ERROR("\"%s\" can't swap an imported texture with a transient one", m_passes[pass].name);
+            return;
+        }
+
+        Write(pass, texture_a);
+        Write(pass, texture_b);
+        m_textures[GetGroup(texture_a)].group = GetGroup(texture_b);
+        Signature(6, texture_a, texture_b);
+    }
+
+    bool RenderGraph::Compile()
+    {
+        // Nothing changed since the last compilation
+        const uint64_t hash = Hash::Compute(m_signature.data(), m_signature.size() * sizeof(uint64_t));
+        if (hash == m_compiled_hash)
+            return true;
+
+        m_compiled_hash         = 0;
+        m_physical_pool_dirty   = true;
+        const auto pass_count   = static_cast<uint32_t>(m_passes.size());
+        const auto tex_count    = static_cast<uint32_t>(m_textures.size());
+
+        // Dependencies, a pass needs the last pass that wrote what it reads or writes (a write might not cover all of it)
+        vector<vector<uint32_t>> needs(pass_count);
+        {
+            vector<uint32_t> writer_last(tex_count, g_render_graph_invalid);
+            for (uint32_t pass = 0; pass < pass_count; pass++)
+            {
+                for (const RenderGraph_Access& access : m_passes[pass].accesses)
+                {
+                    const uint32_t writer = writer_last[access.texture];
+                    if (writer == g_render_graph_invalid)
+                    {
+                        if (!access.write && !m_textures[access.texture].imported)
+                        {
+                            LOG_ERROR("\"%s\" reads \"%s\" before any pass writes it", m_passes[pass].name, m_textures[access.texture].name);
+                            return false;
+                        }
+                    }
+                    else if (writer != pass)
+                    {
+                        needs[pass].emplace_back(writer);
+                    }
+
+                    if (access.write)
+                    {
+                        writer_last[access.texture] = pass;
+                    }
+                }
+            }
+        }
+
+        // Culling, walk back from the passes that have an effect outside of the graph (dependencies always point back)
+        vector<bool> alive(pass_count, false);
+        for (int i = static_cast<int>(pass_count) - 1; i >= 0; i--)
+        {
+            const RenderGraph_Pass& pass = m_passes[i];
+
+            alive[i] = alive[i] || pass.side_effects;
+            for (const RenderGraph_Access& access : pass.accesses)
+            {
+                alive[i] = alive[i] || (access.write && m_textures[access.texture].imported);
+            }
+
+            if (!alive[i])
+                continue;
+
+            for (const uint32_t needed : needs[i])
+            {
+                alive[needed] = true;
+            }
+        }
+
+        m_order.clear();
+        for (uint32_t pass = 0; pass < pass_count; pass++)
+        {
+            if (alive[pass])
+            {
+                m_order.emplace_back(pass);
+            }
+        }
+
+        // Lifetimes, as positions in the execution order
+        vector<uint32_t> first(tex_count, g_render_graph_invalid);
+        vector<uint32_t> last(tex_count, 0);
+        for (uint32_t position = 0; position < static_cast<uint32_t>(m_order.size()); position++)
+        {
+            for (const RenderGraph_Access& access : m_passes[m_order[position]].accesses)
+            {
+                first[access.texture]   = Math::Min(first[access.texture], position);
+                last[access.texture]    = Math::Max(last[access.texture], position);
+            }
+        }
+
+        // Swapped textures end up in each other's slots, so they all have to live as long as their group does
+        for (uint32_t texture = 0; texture < tex_count; texture++)
+        {
+            if (first[texture] == g_render_graph_invalid)
+                continue;
+
+            const uint32_t group    = GetGroup(texture);
+            first[group]            = Math::Min(first[group], first[texture]);
+            last[group]             = Math::Max(last[group], last[texture]);
+        }
+        for (uint32_t texture = 0; texture < tex_count; texture++)
+        {
+            if (first[texture] == g_render_graph_invalid)
+                continue;
+
+            const uint32_t group    = GetGroup(texture);
+            first[texture]          = first[group];
+            last[texture]           = last[group];
+        }
+
+        // Aliasing, transient textures in the order they come alive take the first matching physical texture that's free by then
+        vector<uint32_t> transients;
+        for (uint32_t texture = 0; texture < tex_count; texture++)
+        {
+            if (!m_textures[texture].imported && first[texture] != g_render_graph_invalid)
+            {
+                transients.emplace_back(texture);
+            }
+        }
+        stable_sort(transients.begin(), transients.end(), [&first](const uint32_t a, const uint32_t b) { return first[a] < first[b]; });
+
+        m_physical.clear();
+        m_texture_physical.assign(tex_count, g_render_graph_invalid);
+        vector<uint32_t> physical_last;
+        vector<bool> aliased(tex_count, false);
+        for (const uint32_t texture : transients)
+        {
+            const RenderGraph_Texture_Desc& desc = m_textures[texture].desc;
+
+            uint32_t physical = g_render_graph_invalid;
+            for (uint32_t i = 0; i < static_cast<uint32_t>(m_physical.size()); i++)
+            {
+                if (m_physical[i] == desc && physical_last[i] < first[texture])
+                {
+                    physical = i;
+                    break;
+                }
+            }
+
+            if (physical == g_render_graph_invalid)
+            {
+                physical = static_cast<uint32_t>(m_physical.size());
+                m_physical.emplace_back(desc);
+                physical_last.emplace_back(last[texture]);
+            }
+            else
+            {
+                physical_last[physical] = last[texture];
+                aliased[texture]        = true;
+            }
+
+            m_texture_physical[texture] = physical;
+        }
+
+        // Barriers, from the previous use of each texture to the next one
+        m_barriers.assign(pass_count, vector<RenderGraph_Barrier>());
+        {
+            enum State : uint8_t { State_Unused, State_Read, State_Written };
+            vector<State> state(tex_count, State_Unused);
+            vector<uint32_t> state_pass(tex_count, g_render_graph_invalid);
+
+            for (const uint32_t pass : m_order)
+            {
+                for (const RenderGraph_Access& access : m_passes[pass].accesses)
+                {
+                    const uint32_t texture = access.texture;
+
+                    // Within a pass, the pass takes care of it
+                    if (state_pass[texture] == pass)
+                    {
+                        state[texture] = access.write ? State_Written : state[texture];
+                        continue;
+                    }
+
+                    if (state[texture] == State_Unused && aliased[texture])
+                    {
+                        m_barriers[pass].emplace_back(RenderGraph_Barrier{ texture, RenderGraph_Barrier_Aliasing });
+                    }
+                    else if (state[texture] == State_Written)
+                    {
+                        m_barriers[pass].emplace_back(RenderGraph_Barrier{ texture, access.write ? RenderGraph_Barrier_Write_After_Write : RenderGraph_Barrier_Read_After_Write });
+                    }
+                    else if (state[texture] == State_Read && access.write)
+                    {
+                        m_barriers[pass].emplace_back(RenderGraph_Barrier{ texture, RenderGraph_Barrier_Write_After_Read });
+                    }
+
+                    state[texture]      = access.write ? State_Written : State_Read;
+                    state_pass[texture] = pass;
+                }
+            }
+        }
+
+        // Recompiling is rare (resolution changes, passes toggled), so it's a good time to report what aliasing saves
+        const auto transient_count = static_cast<uint32_t>(count_if(m_texture_physical.begin(), m_texture_physical.end(), [](const uint32_t physical) { return physical != g_render_graph_invalid; }));
+        LOG_INFO("%d transient render targets share %d textures, %.1f MB instead of %.1f MB",
+            transient_count,
+            GetPhysicalCount(),
+            GetMemoryUsage() / 1000.0f / 1000.0f,
+            GetMemoryUsageUnaliased() / 1000.0f / 1000.0f
+        );
+
+        m_compiled_hash = hash;
+        return true;
+    }
+
+    uint64_t RenderGraph::GetMemoryUsage() const
+    {
+        uint64_t size = 0;
+        for (const RenderGraph_Texture_Desc& desc : m_physical)
+        {
+            size += static_cast<uint64_t>(desc.width) * desc.height * _RenderGraph::bytes_per_pixel(desc.format);
+        }
+
+        return size;
+    }
+
+    uint64_t RenderGraph::GetMemoryUsageUnaliased() const
+    {
+        uint64_t size = 0;
+        for (uint32_t texture = 0; texture < static_cast<uint32_t>(m_textures.size()); texture++)
+        {
+            if (GetPhysicalIndex(texture) == g_render_graph_invalid)
+                continue;
+
+            const RenderGraph_Texture_Desc& desc = m_textures[texture].desc;
+            size += static_cast<uint64_t>(desc.width) * desc.height * _RenderGraph::bytes_per_pixel(desc.format);
+        }
+
+        return size;
+    }
+
+    void RenderGraph::Execute(const function<void(const vector<RenderGraph_Barrier>&)>& barriers /*= nullptr*/)
+    {
+        if (m_compiled_hash == 0 || m_barriers.size() != m_passes.size() || m_texture_physical.size() != m_textures.size())
+        {
+            LOG_ERROR("The graph has to be compiled before it's executed");
+            return;
+        }
+
+        m_frame++;
+        AcquireTextures();
+
+        // Point the slots of the transient textures to their pooled textures (passes might have swapped them last frame)
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_textures.size()); i++)
+        {
+            RenderGraph_Texture& texture = m_textures[i];
+            if (texture.imported || !texture.slot)
+                continue;
+
+            const uint32_t physical = m_texture_physical[i];
+            *texture.slot = physical != g_render_graph_invalid ? m_pool[m_physical_pool[physical]].texture : nullptr;
+        }
+
+        for (const uint32_t pass : m_order)
+        {
+            if (barriers && !m_barriers[pass].empty())
+            {
+                barriers(m_barriers[pass]);
+            }
+
+            if (m_passes[pass].execute)
+            {
+                m_passes[pass].execute();
+            }
+        }
+
+        // Release the pooled textures that went unused for a while (e.g. after a resolution change or a disabled effect)
+        const auto pool_size = m_pool.size();
+        m_pool.erase(remove_if(m_pool.begin(), m_pool.end(), [this](const Pool_Entry& entry) { return entry.frame + _RenderGraph::pool_lifetime < m_frame; }), m_pool.end());
+        m_physical_pool_dirty = m_physical_pool_dirty || m_pool.size() != pool_size;
+    }
+
+    void RenderGraph::ReleaseTextures()
+    {
+        for (RenderGraph_Texture& texture : m_textures)
+        {
+            if (!texture.imported && texture.slot)
+            {
+                *texture.slot = nullptr;
+            }
+        }
+
+        m_pool.clear();
+        m_physical_pool.clear();
+        m_physical_pool_dirty = true;
+    }
+
+    bool RenderGraph::IsValid(const uint32_t pass, const uint32_t texture) const
+    {
+        if (pass >= m_passes.size() || texture >= m_textures.size())
+        {
+            LOG_ERROR("Invalid pass or texture");
+            return false;
+        }
+
+        return true;
+    }
+
+    void RenderGraph::Signature(const uint64_t a, const uint64_t b /*= 0*/, const uint64_t c /*= 0*/)
+    {
+        m_signature.emplace_back(a);
+        m_signature.emplace_back(b);
+        m_signature.emplace_back(c);
+    }
+
+    uint32_t RenderGraph::GetGroup(uint32_t texture)
+    {
+        while (m_textures[texture].group != texture)
+        {
+            // Path halving, keeps the chains short
+            m_textures[texture].group   = m_textures[m_textures[texture].group].group;
+            texture                     = m_textures[texture].group;
+        }
+
+        return texture;
+    }
+
+    void RenderGraph::AcquireTextures()
+    {
+        // Map the physical textures of the compiled graph to pooled ones (only after a compilation or a pool change)
+        if (m_physical_pool_dirty)
+        {
+            m_physical_pool.assign(m_physical.size(), g_render_graph_invalid);
+            vector<bool> claimed(m_pool.size(), false);
+
+            for (uint32_t physical = 0; physical < static_cast<uint32_t>(m_physical.size()); physical++)
+            {
+                const RenderGraph_Texture_Desc& desc = m_physical[physical];
+
+                for (uint32_t entry = 0; entry < static_cast<uint32_t>(m_pool.size()); entry++)
+                {
+                    if (!claimed[entry] && m_pool[entry].desc == desc)
+                    {
+                        m_physical_pool[physical]   = entry;
+                        claimed[entry]              = true;
+                        break;
+                    }
+                }
+
+                if (m_physical_pool[physical] == g_render_graph_invalid)
+                {
+                    Pool_Entry& entry           = m_pool.emplace_back();
+                    entry.desc                  = desc;
+                    entry.texture               = m_create_texture ? m_create_texture(desc) : nullptr;
+                    m_physical_pool[physical]   = static_cast<uint32_t>(m_pool.size() - 1);
+                    claimed.emplace_back(true);
+                }
+            }
+
+            m_physical_pool_dirty = false;
+        }
+
+        for (const uint32_t entry : m_physical_pool)
+        {
+            m_pool[entry].frame = m_frame;
+        }
+    }
+}
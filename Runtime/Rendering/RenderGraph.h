@@ -0,0 +1,149 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ====================
+#include <memory>
+#include <vector>
+#include <functional>
+#include "../Core/EngineDefs.h"
+#include "../RHI/RHI_Definition.h"
+//===============================
+
+namespace Spartan
+{
+    static const uint32_t g_render_graph_invalid = static_cast<uint32_t>(-1);
+
+    // Textures with equal descriptions can share memory, as long as their lifetimes don't overlap
+    struct RenderGraph_Texture_Desc
+    {
+        bool operator==(const RenderGraph_Texture_Desc& rhs) const { return width == rhs.width && height == rhs.height && format == rhs.format; }
+
+        uint32_t width      = 0;
+        uint32_t height     = 0;
+        RHI_Format format   = Format_R8G8B8A8_UNORM;
+    };
+
+    enum RenderGraph_Barrier_Type
+    {
+        RenderGraph_Barrier_Read_After_Write,   // was rendered to, is now sampled
+        RenderGraph_Barrier_Write_After_Read,   // was sampled, is now rendered to
+        RenderGraph_Barrier_Write_After_Write,
+        RenderGraph_Barrier_Aliasing            // first use of memory that an earlier texture was using
+    };
+
+    struct RenderGraph_Barrier
+    {
+        uint32_t texture;
+        RenderGraph_Barrier_Type type;
+    };
+
+    struct RenderGraph_Access
+    {
+        uint32_t texture;
+        bool write;
+    };
+
+    struct RenderGraph_Pass
+    {
+        const char* name = nullptr;
+        std::function<void()> execute;
+        std::vector<RenderGraph_Access> accesses;
+        bool side_effects = false; // does work the graph can't see (e.g. shadow maps), so it's never culled
+    };
+
+    struct RenderGraph_Texture
+    {
+        const char* name = nullptr;
+        RenderGraph_Texture_Desc desc;
+        std::shared_ptr<RHI_Texture>* slot = nullptr;   // where the passes look the texture up
+        uint32_t group  = 0;                            // textures that a pass swaps share a lifetime
+        bool imported   = false;                        // owned by the caller and kept across frames
+    };
+
+    // A frame's passes and the render targets they read and write. It's declared every frame and only recompiled
+    // when the declaration changes. Compiling culls the passes nothing depends on, works out when each transient
+    // texture is first and last used and packs textures with matching descriptions into as few pooled textures
+    // as their lifetimes allow. Passes run in the order they were added (it's what decides which write a read
+    // sees), barriers are worked out for the transitions between them. Compiling doesn't touch the GPU.
+    class SPARTAN_CLASS RenderGraph
+    {
+    public:
+        typedef std::function<std::shared_ptr<RHI_Texture>(const RenderGraph_Texture_Desc&)> CreateTexture_Function;
+
+        RenderGraph(CreateTexture_Function create_texture = nullptr);
+        ~RenderGraph() = default;
+
+        // Declaration
+        void Reset();
+        uint32_t AddPass(const char* name, std::function<void()>&& execute, bool side_effects = false);
+        uint32_t CreateTexture(const char* name, const RenderGraph_Texture_Desc& desc, std::shared_ptr<RHI_Texture>* slot = nullptr);
+        uint32_t ImportTexture(const char* name, std::shared_ptr<RHI_Texture>* slot = nullptr);
+        void Read(uint32_t pass, uint32_t texture);
+        void Write(uint32_t pass, uint32_t texture);
+        void Exchange(uint32_t pass, uint32_t texture_a, uint32_t texture_b); // the pass writes both and swaps their slots
+
+        // Compilation
+        bool Compile();
+        const auto& GetOrder() const                            { return m_order; }
+        const auto& GetBarriers(const uint32_t pass) const      { return m_barriers[pass]; }
+        uint32_t GetPhysicalIndex(const uint32_t texture) const { return texture < m_texture_physical.size() ? m_texture_physical[texture] : g_render_graph_invalid; }
+        auto GetPhysicalCount() const                           { return static_cast<uint32_t>(m_physical.size()); }
+        uint64_t GetMemoryUsage() const;            // of the pooled textures the compiled graph needs
+        uint64_t GetMemoryUsageUnaliased() const;   // if every transient texture the compiled graph needs had its own memory
+
+        // Execution
+        void Execute(const std::function<void(const std::vector<RenderGraph_Barrier>&)>& barriers = nullptr);
+        void ReleaseTextures();
+
+    private:
+        bool IsValid(uint32_t pass, uint32_t texture) const;
+        void Signature(uint64_t a, uint64_t b = 0, uint64_t c = 0);
+        uint32_t GetGroup(uint32_t texture);
+        void AcquireTextures();
+
+        // Declaration
+        std::vector<RenderGraph_Pass> m_passes;
+        std::vector<RenderGraph_Texture> m_textures;
+        std::vector<uint64_t> m_signature;
+
+        // Compilation
+        std::vector<uint32_t> m_order;
+        std::vector<std::vector<RenderGraph_Barrier>> m_barriers;
+        std::vector<uint32_t> m_texture_physical;
+        std::vector<RenderGraph_Texture_Desc> m_physical;
+        uint64_t m_compiled_hash = 0;
+
+        // Pool
+        struct Pool_Entry
+        {
+            RenderGraph_Texture_Desc desc;
+            std::shared_ptr<RHI_Texture> texture;
+            uint64_t frame = 0;
+        };
+        std::vector<Pool_Entry> m_pool;
+        std::vector<uint32_t> m_physical_pool;
+        bool m_physical_pool_dirty = true;
+        uint64_t m_frame = 0;
+        CreateTexture_Function m_create_texture;
+    };
+}
@@ -22,6 +22,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ==============================
 #include "Renderer.h"
 #include "Model.h"
+#include "RenderGraph.h"
 #include "Font/Font.h"
 #include "Utilities/Sampling.h"
 #include "Gizmos/Grid.h"
@@ -30,6 +31,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Resource/ResourceCache.h"
 #include "../Core/Engine.h"
 #include "../Core/Timer.h"
+#include "../Threading/Threading.h"
 #include "../World/Entity.h"
 #include "../World/Components/Transform.h"
 #include "../World/Components/Renderable.h"
@@ -37,6 +39,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../World/Components/Light.h"
 #include "../RHI/RHI_Device.h"
 #include "../RHI/RHI_PipelineCache.h"
+#include "../RHI/RHI_ShaderCache.h"
 #include "../RHI/RHI_ConstantBuffer.h"
 #include "../RHI/RHI_CommandList.h"
 #include "../RHI/RHI_Texture2D.h"
@@ -62,6 +65,7 @@ namespace Spartan
 		m_flags		|= Render_MotionBlur;
 		m_flags		|= Render_AntiAliasing_TAA;
         m_flags     |= Render_SSR;
+        m_flags     |= Render_MeshletCulling;
 		//m_flags	|= Render_PostProcess_FXAA;                 // Disabled by default: TAA is superior.
 		//m_flags	|= Render_PostProcess_Sharpening;		    // Disabled by default: TAA's blurring is taken core of with an always on sharpen pass specifically for it.
 		//m_flags	|= Render_PostProcess_Dithering;			// Disabled by default: It's only needed in very dark scenes to fix smooth color gradients.
@@ -79,16 +83,22 @@ namespace Spartan
         m_options[Option_Value_Bloom_Intensity]         = 0.005f;
         m_options[Option_Value_Motion_Blur_Intensity]   = 0.01f;
         m_options[Option_Value_Ssao_Scale]              = 1.0f;
+        m_options[Option_Value_Lod_Error]               = 1.0f;
+        m_options[Option_Value_Lod_Shadow_Bias]         = 4.0f;
 
 		// Subscribe to events
-		SUBSCRIBE_TO_EVENT(Event_World_Resolve_Complete,    EVENT_HANDLER_VARIANT(RenderablesAcquire));
+		SUBSCRIBE_TO_EVENT(Event_World_Resolve_Complete,    EVENT_HANDLER_DATA(RenderablesAcquire));
         SUBSCRIBE_TO_EVENT(Event_World_Unload,              EVENT_HANDLER(ClearEntities));
 	}
 
 	Renderer::~Renderer()
 	{
 		// Unsubscribe from events
-		UNSUBSCRIBE_FROM_EVENT(Event_World_Resolve_Complete, EVENT_HANDLER_VARIANT(RenderablesAcquire));
+		UNSUBSCRIBE_FROM_EVENT(Event_World_Resolve_Complete);
+        UNSUBSCRIBE_FROM_EVENT(Event_World_Unload);
+
+        // Let the compilations that are running finish, they reference the shaders
+        m_shader_cache = nullptr;
 
 		m_entities.clear();
 		m_camera = nullptr;
@@ -133,8 +143,11 @@ namespace Spartan
             }
         }
 
-        // Create pipeline cache
-        m_pipeline_cache = make_shared<RHI_PipelineCache>(m_rhi_device);
+        // Create shader cache (compiled shaders persist across runs, compilations run in the background)
+        m_shader_cache = make_unique<RHI_ShaderCache>(m_resource_cache->GetProjectDirectory() + "ShaderCache//", m_context->GetSubsystem<Threading>().get());
+
+        // Create pipeline cache (what the driver compiles persists next to the shaders)
+        m_pipeline_cache = make_shared<RHI_PipelineCache>(m_rhi_device, m_shader_cache->GetDirectory() + "pipelines.cache");
 
         // Create command list
         m_cmd_list = make_shared<RHI_CommandList>(m_rhi_device, m_profiler);
@@ -146,6 +159,12 @@ namespace Spartan
 		// Line buffer
 		m_vertex_buffer_lines = make_shared<RHI_VertexBuffer>(m_rhi_device);
 
+        // Render graph (transient render targets come from its pool)
+        m_render_graph = make_unique<RenderGraph>([this](const RenderGraph_Texture_Desc& desc)
+        {
+            return static_pointer_cast<RHI_Texture>(make_shared<RHI_Texture2D>(m_context, desc.width, desc.height, desc.format));
+        });
+
         CreateConstantBuffers();
 		CreateShaders();
 		CreateDepthStencilStates();
@@ -438,7 +457,7 @@ namespace Spartan
         return m_buffer_light_gpu->Unmap();
     }
 
-	void Renderer::RenderablesAcquire(const Variant& entities_variant)
+	void Renderer::RenderablesAcquire(const EventData& entities_data)
 	{
 		TIME_BLOCK_START_CPU(m_profiler);
 
@@ -446,7 +465,7 @@ namespace Spartan
 		m_entities.clear();
 		m_camera = nullptr;
 
-		vector<shared_ptr<Entity>> entities = entities_variant.Get<vector<shared_ptr<Entity>>>();
+		const auto& entities = entities_data.Get<vector<shared_ptr<Entity>>>();
 		for (const auto& entity : entities)
 		{
 			if (!entity || !entity->IsActive())
@@ -524,6 +543,15 @@ namespace Spartan
 		return m_rasterizer_cull_back_solid;
 	}
 
+    float Renderer::GetLodProjectionScale() const
+    {
+        // Object space errors, divided by their distance from the camera, times this, are in pixels
+        if (m_camera->GetProjectionType() != Projection_Perspective)
+            return 0.0f;
+
+        return m_resolution.y / (2.0f * tan(m_camera->GetFovVerticalRad() * 0.5f));
+    }
+
     void* Renderer::GetEnvironmentTexture_GpuResource()
     {
         if (const shared_ptr<RHI_Texture>& environment_texture = GetEnvironmentTexture())
@@ -554,11 +582,8 @@ namespace Spartan
 
         if (option == Option_Value_Ssao_Scale)
         {
+            // The render graph picks the new size up on the next frame
             value = Clamp(value, 0.25f, 1.0f);
-            uint32_t width  = static_cast<uint32_t>(m_resolution.x * value);
-            uint32_t height = static_cast<uint32_t>(m_resolution.y * value);
-            m_render_targets[RenderTarget_Ssao_Raw] = make_unique<RHI_Texture2D>(m_context, width, height, m_render_targets[RenderTarget_Ssao_Raw]->GetFormat());
-            m_render_targets[RenderTarget_Ssao_Blurred] = make_unique<RHI_Texture2D>(m_context, width, height, m_render_targets[RenderTarget_Ssao_Raw]->GetFormat());
         }
 
         m_options[option] = value;
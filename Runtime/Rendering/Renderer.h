@@ -46,10 +46,11 @@ namespace Spartan
 	class Light;
 	class ResourceCache;
 	class Font;
-	class Variant;
+	class EventData;
 	class Grid;
 	class Transform_Gizmo;
 	class Profiler;
+	class RenderGraph;
 	namespace Math
 	{
 		class BoundingBox;
@@ -76,7 +77,8 @@ namespace Spartan
 		Render_MotionBlur			    = 1 << 15,
 		Render_Sharpening_LumaSharpen	= 1 << 16,
 		Render_ChromaticAberration	    = 1 << 17,
-		Render_Dithering			    = 1 << 18
+		Render_Dithering			    = 1 << 18,
+		Render_MeshletCulling		    = 1 << 19
 	};
 
     enum Renderer_ToneMapping_Type
@@ -118,7 +120,9 @@ namespace Spartan
 	enum Renderer_Shader_Type
 	{
 		Shader_Gbuffer_V,
+		Shader_Gbuffer_Quantized_V,
 		Shader_Depth_V,
+		Shader_Depth_Quantized_V,
 		Shader_Quad_V,
 		Shader_Texture_P,
 		Shader_Fxaa_P,
@@ -201,7 +205,9 @@ namespace Spartan
         Option_Value_Sharpen_Strength,
         Option_Value_Sharpen_Clamp,           // Limits maximum amount of sharpening a pixel receives - Algorithm's default: 0.035f
         Option_Value_Motion_Blur_Intensity,
-        Option_Value_Ssao_Scale
+        Option_Value_Ssao_Scale,
+        Option_Value_Lod_Error,               // The screen space error (in pixels) that a level of detail is allowed to have
+        Option_Value_Lod_Shadow_Bias          // Multiplies the allowed error for shadow maps, where detail is lost to filtering anyway
     };
 
 	class SPARTAN_CLASS Renderer : public ISubsystem
@@ -246,6 +252,7 @@ namespace Spartan
 		const auto& GetRhiDevice()		const { return m_rhi_device; }
         const auto& GetSwapChain()      const { return m_swap_chain; }
 		const auto& GetPipelineCache()	const { return m_pipeline_cache; }
+        auto GetShaderCache()           const { return m_shader_cache.get(); }
 		const auto& GetCmdList()		const { return m_cmd_list; }
 		//================================================================
 
@@ -338,16 +345,19 @@ namespace Spartan
         bool UpdateFrameBuffer();
         bool UpdateUberBuffer();
         bool UpdateLightBuffer(const std::vector<Entity*>& entities);
-        void RenderablesAcquire(const Variant& renderables);
+        void RenderablesAcquire(const EventData& entities_data);
         void RenderablesSort(std::vector<Entity*>* renderables);
         std::shared_ptr<RHI_RasterizerState>& GetRasterizerState(RHI_Cull_Mode cull_mode, RHI_Fill_Mode fill_mode);
+        float GetLodProjectionScale() const;
         void* GetEnvironmentTexture_GpuResource();
         void ClearEntities() { m_entities.clear(); }
+        void RenderGraphBuild();
         //=========================================================================================================
 
         //= RENDER TEXTURES ================================================================
-        std::map<Renderer_RenderTarget_Type, std::shared_ptr<RHI_Texture>> m_render_targets;
+        std::map<Renderer_RenderTarget_Type, std::shared_ptr<RHI_Texture>> m_render_targets;   // slots, the render graph points the transient ones to pooled textures
         std::vector<std::shared_ptr<RHI_Texture>> m_render_tex_bloom;
+        std::unique_ptr<RenderGraph> m_render_graph;
         //==================================================================================
 
         //= STANDARD TEXTURES =====================================
@@ -440,6 +450,7 @@ namespace Spartan
 		std::shared_ptr<RHI_Device> m_rhi_device;
         std::shared_ptr<RHI_SwapChain> m_swap_chain;
 		std::shared_ptr<RHI_PipelineCache> m_pipeline_cache;
+        std::unique_ptr<RHI_ShaderCache> m_shader_cache;
 		//==================================================
                                                                                   
 		//= ENTITIES/COMPONENTS ==================================================
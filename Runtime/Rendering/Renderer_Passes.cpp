@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Renderer.h"
 #include "Material.h"
 #include "Model.h"
+#include "RenderGraph.h"
 #include "Font/Font.h"
 #include "../Profiling/Profiler.h"
 #include "../Resource/IResource.h"
@@ -96,27 +97,215 @@ namespace Spartan
         m_cmd_list->Submit();
         return;
 #endif
-		Pass_LightDepth();
-		Pass_GBuffer();
-		Pass_Ssao();
-        Pass_Ssr();
-        Pass_Light();
-        Pass_Composition();
-		Pass_PostProcess();
-        Pass_Lines(m_render_targets[RenderTarget_Composition_Ldr]);
-        Pass_Gizmos(m_render_targets[RenderTarget_Composition_Ldr]);
-		Pass_DebugBuffer(m_render_targets[RenderTarget_Composition_Ldr]);
-		Pass_PerformanceMetrics(m_render_targets[RenderTarget_Composition_Ldr]);
+        // Declare the frame, compile it (only happens when the declaration changes) and run it
+        RenderGraphBuild();
+        if (m_render_graph->Compile())
+        {
+            m_render_graph->Execute([this](const vector<RenderGraph_Barrier>& barriers)
+            {
+                // D3D11 tracks hazards on its own, but a texture that's still bound as an input can't be rendered to
+                for (const RenderGraph_Barrier& barrier : barriers)
+                {
+                    if (barrier.type == RenderGraph_Barrier_Write_After_Read || barrier.type == RenderGraph_Barrier_Aliasing)
+                    {
+                        m_cmd_list->ClearTextures();
+                        break;
+                    }
+                }
+            });
+        }
 
 		m_cmd_list->End();
 		m_cmd_list->Submit();
 	}
 
+    void Renderer::RenderGraphBuild()
+    {
+        RenderGraph& graph = *m_render_graph;
+        graph.Reset();
+
+        const auto width        = static_cast<uint32_t>(m_resolution.x);
+        const auto height       = static_cast<uint32_t>(m_resolution.y);
+        const auto ssao_width   = static_cast<uint32_t>(width * m_options[Option_Value_Ssao_Scale]);
+        const auto ssao_height  = static_cast<uint32_t>(height * m_options[Option_Value_Ssao_Scale]);
+        const bool ssao         = IsFlagSet(Render_SSAO);
+        const bool ssr          = IsFlagSet(Render_SSR);
+        const bool volumetric   = IsFlagSet(Render_VolumetricLighting);
+        const bool taa          = IsFlagSet(Render_AntiAliasing_TAA);
+        const bool motion_blur  = IsFlagSet(Render_MotionBlur);
+        const bool bloom        = IsFlagSet(Render_Bloom);
+
+        // G-Buffer
+        const uint32_t tex_albedo   = graph.CreateTexture("Gbuffer_Albedo",     { width, height, Format_R8G8B8A8_UNORM },     &m_render_targets[RenderTarget_Gbuffer_Albedo]);
+        const uint32_t tex_normal   = graph.CreateTexture("Gbuffer_Normal",     { width, height, Format_R16G16B16A16_FLOAT }, &m_render_targets[RenderTarget_Gbuffer_Normal]); // At Format_R8G8B8A8_UNORM, normals have noticeable banding
+        const uint32_t tex_material = graph.CreateTexture("Gbuffer_Material",   { width, height, Format_R8G8B8A8_UNORM },     &m_render_targets[RenderTarget_Gbuffer_Material]);
+        const uint32_t tex_velocity = graph.CreateTexture("Gbuffer_Velocity",   { width, height, Format_R16G16_FLOAT },       &m_render_targets[RenderTarget_Gbuffer_Velocity]);
+        const uint32_t tex_depth    = graph.CreateTexture("Gbuffer_Depth",      { width, height, Format_D32_FLOAT },          &m_render_targets[RenderTarget_Gbuffer_Depth]);
+
+        // Light
+        const uint32_t tex_diffuse              = graph.CreateTexture("Light_Diffuse",              { width, height, Format_R16G16B16A16_FLOAT }, &m_render_targets[RenderTarget_Light_Diffuse]);
+        const uint32_t tex_specular             = graph.CreateTexture("Light_Specular",             { width, height, Format_R16G16B16A16_FLOAT }, &m_render_targets[RenderTarget_Light_Specular]);
+        const uint32_t tex_volumetric           = graph.CreateTexture("Light_Volumetric",           { width, height, Format_R16G16B16A16_FLOAT }, &m_render_targets[RenderTarget_Light_Volumetric]);
+        const uint32_t tex_volumetric_blurred   = graph.CreateTexture("Light_Volumetric_Blurred",   { width, height, Format_R16G16B16A16_FLOAT }, &m_render_targets[RenderTarget_Light_Volumetric_Blurred]);
+
+        // Composition
+        const uint32_t tex_hdr      = graph.CreateTexture("Composition_Hdr",    { width, height, Format_R32G32B32A32_FLOAT }, &m_render_targets[RenderTarget_Composition_Hdr]);
+        const uint32_t tex_hdr_2    = graph.CreateTexture("Composition_Hdr_2",  { width, height, Format_R32G32B32A32_FLOAT }, &m_render_targets[RenderTarget_Composition_Hdr_2]);
+
+        // SSAO
+        const uint32_t tex_ssao_raw     = graph.CreateTexture("Ssao_Raw",       { ssao_width, ssao_height, Format_R8_UNORM }, &m_render_targets[RenderTarget_Ssao_Raw]);
+        const uint32_t tex_ssao_blurred = graph.CreateTexture("Ssao_Blurred",   { ssao_width, ssao_height, Format_R8_UNORM }, &m_render_targets[RenderTarget_Ssao_Blurred]);
+        const uint32_t tex_ssao         = graph.CreateTexture("Ssao",           { width, height, Format_R8_UNORM },           &m_render_targets[RenderTarget_Ssao]); // Upscaled
+
+        // SSR
+        const uint32_t tex_ssr          = graph.CreateTexture("Ssr",            { width, height, Format_R16G16B16A16_FLOAT }, &m_render_targets[RenderTarget_Ssr]);
+        const uint32_t tex_ssr_blurred  = graph.CreateTexture("Ssr_Blurred",    { width, height, Format_R16G16B16A16_FLOAT }, &m_render_targets[RenderTarget_Ssr_Blurred]);
+
+        // Bloom, as many textures as required to scale down to or below 16px (in any dimension)
+        uint32_t bloom_count = 1;
+        for (uint32_t bloom_width = width / 2, bloom_height = height / 2; bloom_width > 16 && bloom_height > 16; bloom_width /= 2, bloom_height /= 2)
+        {
+            bloom_count++;
+        }
+        m_render_tex_bloom.resize(bloom_count);
+        vector<uint32_t> tex_bloom(bloom_count);
+        for (uint32_t i = 0; i < bloom_count; i++)
+        {
+            tex_bloom[i] = graph.CreateTexture("Bloom", { (width / 2) >> i, (height / 2) >> i, Format_R16G16B16A16_FLOAT }, &m_render_tex_bloom[i]);
+        }
+
+        // Textures that outlive the frame
+        const uint32_t tex_brdf_lut     = graph.ImportTexture("Brdf_Specular_Lut",          &m_render_targets[RenderTarget_Brdf_Specular_Lut]);
+        const uint32_t tex_history      = graph.ImportTexture("Composition_Hdr_History",    &m_render_targets[RenderTarget_Composition_Hdr_History]);
+        const uint32_t tex_history_2    = graph.ImportTexture("Composition_Hdr_History_2",  &m_render_targets[RenderTarget_Composition_Hdr_History_2]);
+        const uint32_t tex_frame        = graph.ImportTexture("Composition_Ldr",            &m_render_targets[RenderTarget_Composition_Ldr]);
+        const uint32_t tex_frame_2      = graph.ImportTexture("Composition_Ldr_2",          &m_render_targets[RenderTarget_Composition_Ldr_2]);
+
+        // Passes, what they read and write decides what runs and how long each texture lives
+        graph.AddPass("LightDepth", [this]() { Pass_LightDepth(); }, true); // renders to the shadow maps of the lights
+
+        {
+            const uint32_t pass = graph.AddPass("GBuffer", [this]() { Pass_GBuffer(); });
+            graph.Write(pass, tex_albedo);
+            graph.Write(pass, tex_normal);
+            graph.Write(pass, tex_material);
+            graph.Write(pass, tex_velocity);
+            graph.Write(pass, tex_depth);
+        }
+
+        {
+            const uint32_t pass = graph.AddPass("Ssao", [this]() { Pass_Ssao(); });
+            graph.Read(pass, tex_depth);
+            graph.Read(pass, tex_normal);
+            graph.Exchange(pass, tex_ssao_raw, tex_ssao_blurred);
+            graph.Exchange(pass, tex_ssao_blurred, tex_ssao);
+        }
+
+        {
+            const uint32_t pass = graph.AddPass("Ssr", [this]() { Pass_Ssr(); });
+            graph.Read(pass, tex_normal);
+            graph.Read(pass, tex_depth);
+            graph.Read(pass, tex_material);
+            graph.Read(pass, tex_frame_2); // previous frame
+            graph.Exchange(pass, tex_ssr, tex_ssr_blurred);
+        }
+
+        {
+            const uint32_t pass = graph.AddPass("Light", [this]() { Pass_Light(); });
+            graph.Read(pass, tex_normal);
+            graph.Read(pass, tex_material);
+            graph.Read(pass, tex_depth);
+            if (ssao) graph.Read(pass, tex_ssao);
+            graph.Write(pass, tex_diffuse);
+            graph.Write(pass, tex_specular);
+            graph.Write(pass, tex_volumetric);
+            if (volumetric) graph.Exchange(pass, tex_volumetric, tex_volumetric_blurred);
+        }
+
+        {
+            const uint32_t pass = graph.AddPass("Composition", [this]() { Pass_Composition(); });
+            graph.Read(pass, tex_albedo);
+            graph.Read(pass, tex_normal);
+            graph.Read(pass, tex_depth);
+            graph.Read(pass, tex_material);
+            graph.Read(pass, tex_diffuse);
+            graph.Read(pass, tex_specular);
+            graph.Read(pass, tex_brdf_lut);
+            if (volumetric) graph.Read(pass, tex_volumetric_blurred);
+            if (ssr)        graph.Read(pass, tex_ssr_blurred);
+            if (ssao)       graph.Read(pass, tex_ssao);
+            graph.Write(pass, tex_hdr);
+        }
+
+        {
+            const uint32_t pass = graph.AddPass("PostProcess", [this]() { Pass_PostProcess(); });
+            graph.Read(pass, tex_hdr);
+            if (taa || motion_blur)
+            {
+                graph.Read(pass, tex_velocity);
+                graph.Read(pass, tex_depth);
+            }
+            if (taa)
+            {
+                graph.Write(pass, tex_history);
+                graph.Write(pass, tex_history_2);
+            }
+            if (taa || motion_blur || bloom)
+            {
+                graph.Exchange(pass, tex_hdr, tex_hdr_2);
+            }
+            if (bloom)
+            {
+                for (const uint32_t texture : tex_bloom)
+                {
+                    graph.Write(pass, texture);
+                }
+            }
+            graph.Write(pass, tex_frame);
+            graph.Write(pass, tex_frame_2);
+        }
+
+        {
+            const uint32_t pass = graph.AddPass("Lines", [this]() { Pass_Lines(m_render_targets[RenderTarget_Composition_Ldr]); });
+            graph.Read(pass, tex_depth);
+            graph.Write(pass, tex_frame);
+        }
+
+        graph.Write(graph.AddPass("Gizmos", [this]() { Pass_Gizmos(m_render_targets[RenderTarget_Composition_Ldr]); }), tex_frame);
+
+        {
+            const uint32_t pass = graph.AddPass("DebugBuffer", [this]() { Pass_DebugBuffer(m_render_targets[RenderTarget_Composition_Ldr]); });
+
+            uint32_t tex_debug = g_render_graph_invalid;
+            if (m_debug_buffer == Renderer_Buffer_Albedo)                               tex_debug = tex_albedo;
+            if (m_debug_buffer == Renderer_Buffer_Normal)                               tex_debug = tex_normal;
+            if (m_debug_buffer == Renderer_Buffer_Material)                             tex_debug = tex_material;
+            if (m_debug_buffer == Renderer_Buffer_Diffuse)                              tex_debug = tex_diffuse;
+            if (m_debug_buffer == Renderer_Buffer_Specular)                             tex_debug = tex_specular;
+            if (m_debug_buffer == Renderer_Buffer_Velocity)                             tex_debug = tex_velocity;
+            if (m_debug_buffer == Renderer_Buffer_Depth)                                tex_debug = tex_depth;
+            if (m_debug_buffer == Renderer_Buffer_SSAO && ssao)                         tex_debug = tex_ssao;
+            if (m_debug_buffer == Renderer_Buffer_SSR && ssr)                           tex_debug = tex_ssr_blurred;
+            if (m_debug_buffer == Renderer_Buffer_Bloom && bloom)                       tex_debug = tex_bloom.front();
+            if (m_debug_buffer == Renderer_Buffer_VolumetricLighting && volumetric)     tex_debug = tex_volumetric_blurred;
+            if (m_debug_buffer == Renderer_Buffer_Shadows)                              tex_debug = tex_diffuse;
+
+            if (tex_debug != g_render_graph_invalid)
+            {
+                graph.Read(pass, tex_debug);
+            }
+            graph.Write(pass, tex_frame);
+        }
+
+        graph.Write(graph.AddPass("PerformanceMetrics", [this]() { Pass_PerformanceMetrics(m_render_targets[RenderTarget_Composition_Ldr]); }), tex_frame);
+    }
+
 	void Renderer::Pass_LightDepth()
 	{
-		// Acquire shader
-		const auto& shader_depth = m_shaders[Shader_Depth_V];
-		if (!shader_depth->IsCompiled())
+		// Acquire shaders
+		const auto& shader_depth			= m_shaders[Shader_Depth_V];
+		const auto& shader_depth_quantized	= m_shaders[Shader_Depth_Quantized_V];
+		if (!shader_depth->IsCompiled() || !shader_depth_quantized->IsCompiled())
 			return;
 
         // Get opaque entities
@@ -168,7 +357,13 @@ namespace Spartan
             }
 
 			// Tracking
-			uint32_t currently_bound_geometry = 0;
+			uint32_t currently_bound_geometry	= 0;
+			bool currently_bound_quantized		= false;
+
+            // Levels of detail are picked as seen from the camera, but shadows can afford to be coarser
+            const Vector3 lod_eye_position  = m_camera->GetTransform()->GetPosition();
+            const float lod_scale           = GetLodProjectionScale();
+            const float lod_error           = m_options[Option_Value_Lod_Error] * m_options[Option_Value_Lod_Shadow_Bias];
 
 			for (uint32_t i = 0; i < shadow_map->GetArraySize(); i++)
 			{
@@ -211,16 +406,29 @@ namespace Spartan
 					// Bind geometry
 					if (currently_bound_geometry != model->GetId())
 					{
+						// Quantized vertices need a matching input layout
+						if (currently_bound_quantized != model->GetVertexQuantization())
+						{
+							const auto& shader = model->GetVertexQuantization() ? shader_depth_quantized : shader_depth;
+							m_cmd_list->SetShaderVertex(shader);
+							m_cmd_list->SetInputLayout(shader->GetInputLayout());
+							currently_bound_quantized = model->GetVertexQuantization();
+						}
+
 						m_cmd_list->SetBufferIndex(model->GetIndexBuffer());
 						m_cmd_list->SetBufferVertex(model->GetVertexBuffer());
 						currently_bound_geometry = model->GetId();
 					}
 
-                    // Update uber buffer with cascade transform
-                    m_buffer_uber_cpu.transform = entity->GetTransform_PtrRaw()->GetMatrix() * view_projection;
+                    // Update uber buffer with cascade transform (quantized positions are mapped back to object space first)
+                    m_buffer_uber_cpu.transform = model->GetDequantization(renderable->GeometryVertexOffset()) * entity->GetTransform_PtrRaw()->GetMatrix() * view_projection;
                     UpdateUberBuffer(); // only updates if needed
 
-					m_cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
+                    uint32_t index_offset;
+                    uint32_t index_count;
+                    renderable->GeometryLod(lod_eye_position, lod_scale, lod_error, &index_offset, &index_count);
+
+					m_cmd_list->DrawIndexed(index_count, index_offset, renderable->GeometryVertexOffset());
                     m_cmd_list->Submit();
 				}
 				m_cmd_list->End(); // end of cascade
@@ -259,8 +467,9 @@ namespace Spartan
 			return;
 		}
 
-		const auto& shader_gbuffer = m_shaders[Shader_Gbuffer_V];
-        if (!shader_gbuffer->IsCompiled())
+		const auto& shader_gbuffer              = m_shaders[Shader_Gbuffer_V];
+		const auto& shader_gbuffer_quantized    = m_shaders[Shader_Gbuffer_Quantized_V];
+        if (!shader_gbuffer->IsCompiled() || !shader_gbuffer_quantized->IsCompiled())
             return;
 
         // Pack render targets
@@ -276,8 +485,18 @@ namespace Spartan
 		uint32_t currently_bound_geometry	= 0;
 		uint32_t currently_bound_shader		= 0;
 		uint32_t currently_bound_material	= 0;
+		bool currently_bound_quantized		= false;
+
+        // Level of detail
+        const Vector3 lod_eye_position  = m_camera->GetTransform()->GetPosition();
+        const float lod_scale           = GetLodProjectionScale();
+        const float lod_error           = m_options[Option_Value_Lod_Error];
 
-        auto draw_entity = [this, &currently_bound_geometry, &currently_bound_shader, &currently_bound_material](Entity* entity)
+        // Meshlets, the index ranges of the visible ones
+        const bool meshlet_culling = IsFlagSet(Render_MeshletCulling);
+        vector<pair<uint32_t, uint32_t>> meshlet_ranges;
+
+        auto draw_entity = [this, &shader_gbuffer, &shader_gbuffer_quantized, &currently_bound_geometry, &currently_bound_shader, &currently_bound_material, &currently_bound_quantized, &lod_eye_position, lod_scale, lod_error, meshlet_culling, &meshlet_ranges](Entity* entity)
         {
             // Get renderable
             const auto& renderable = entity->GetRenderable_PtrRaw();
@@ -293,9 +512,15 @@ namespace Spartan
             const auto& shader  = material->GetShader();
             const auto& model   = renderable->GeometryModel();
 
-            // Validate shader
+            // Validate shader, a visible material's shader moves to the front of the compilation queue
             if (!shader || !shader->IsCompiled())
+            {
+                if (shader && m_camera->IsInViewFrustrum(renderable))
+                {
+                    m_shader_cache->Prioritize(shader.get(), ShaderCache_Priority_Visible);
+                }
                 return;
+            }
 
             // Validate geometry
             if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
@@ -311,6 +536,15 @@ namespace Spartan
             // Bind geometry
             if (currently_bound_geometry != model->GetId())
             {
+                // Quantized vertices need a matching input layout
+                if (currently_bound_quantized != model->GetVertexQuantization())
+                {
+                    const auto& shader_vertex = model->GetVertexQuantization() ? shader_gbuffer_quantized : shader_gbuffer;
+                    m_cmd_list->SetShaderVertex(shader_vertex);
+                    m_cmd_list->SetInputLayout(shader_vertex->GetInputLayout());
+                    currently_bound_quantized = model->GetVertexQuantization();
+                }
+
                 m_cmd_list->SetBufferIndex(model->GetIndexBuffer());
                 m_cmd_list->SetBufferVertex(model->GetVertexBuffer());
                 currently_bound_geometry = model->GetId();
@@ -342,11 +576,11 @@ namespace Spartan
                 currently_bound_material = material->GetId();
             }
 
-            // Update uber buffer with entity transform
+            // Update uber buffer with entity transform (quantized positions are mapped back to object space first)
             if (Transform* transform = entity->GetTransform_PtrRaw())
             {
-                m_buffer_uber_cpu.transform     = transform->GetMatrix();
-                m_buffer_uber_cpu.wvp_current   = transform->GetMatrix() * m_buffer_frame_cpu.view_projection;
+                m_buffer_uber_cpu.transform     = model->GetDequantization(renderable->GeometryVertexOffset()) * transform->GetMatrix();
+                m_buffer_uber_cpu.wvp_current   = m_buffer_uber_cpu.transform * m_buffer_frame_cpu.view_projection;
                 m_buffer_uber_cpu.wvp_previous  = transform->GetWvpLastFrame();
                 transform->SetWvpLastFrame(m_buffer_uber_cpu.wvp_current);
             }
@@ -355,7 +589,22 @@ namespace Spartan
             UpdateUberBuffer();
 
             // Render	
-            m_cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
+            uint32_t index_offset;
+            uint32_t index_count;
+            renderable->GeometryLod(lod_eye_position, lod_scale, lod_error, &index_offset, &index_count);
+
+            // At full detail, large meshes only draw their visible meshlets
+            if (meshlet_culling && index_offset == renderable->GeometryIndexOffset() && renderable->GeometryMeshlets(m_camera->GetFrustrum(), lod_eye_position, &meshlet_ranges))
+            {
+                for (const auto& [range_offset, range_count] : meshlet_ranges)
+                {
+                    m_cmd_list->DrawIndexed(range_count, range_offset, renderable->GeometryVertexOffset());
+                }
+            }
+            else
+            {
+                m_cmd_list->DrawIndexed(index_count, index_offset, renderable->GeometryVertexOffset());
+            }
             m_profiler->m_renderer_meshes_rendered++;
 
             m_cmd_list->Submit();
@@ -592,7 +841,7 @@ namespace Spartan
                             m_render_targets[RenderTarget_Gbuffer_Normal]->GetResource_Texture(),
                             m_render_targets[RenderTarget_Gbuffer_Material]->GetResource_Texture(),
                             m_render_targets[RenderTarget_Gbuffer_Depth]->GetResource_Texture(),
-                            m_render_targets[RenderTarget_Ssao]->GetResource_Texture(),
+                            (m_flags & Render_SSAO) ? m_render_targets[RenderTarget_Ssao]->GetResource_Texture() : m_tex_white->GetResource_Texture(),
                             light->GetCastShadows() ? (light->GetLightType() == LightType_Directional   ? shadow_map->GetResource_Texture() : nullptr) : nullptr,
                             light->GetCastShadows() ? (light->GetLightType() == LightType_Point         ? shadow_map->GetResource_Texture() : nullptr) : nullptr,
                             light->GetCastShadows() ? (light->GetLightType() == LightType_Spot          ? shadow_map->GetResource_Texture() : nullptr) : nullptr
@@ -653,10 +902,10 @@ namespace Spartan
             m_render_targets[RenderTarget_Light_Diffuse]->GetResource_Texture(),
             m_render_targets[RenderTarget_Light_Specular]->GetResource_Texture(),
             (m_flags & Render_VolumetricLighting) ? m_render_targets[RenderTarget_Light_Volumetric_Blurred]->GetResource_Texture() : m_tex_black->GetResource_Texture(),
-            m_render_targets[RenderTarget_Ssr_Blurred]->GetResource_Texture(),
+            (m_flags & Render_SSR) ? m_render_targets[RenderTarget_Ssr_Blurred]->GetResource_Texture() : m_tex_black->GetResource_Texture(),
             GetEnvironmentTexture_GpuResource(),
             m_render_targets[RenderTarget_Brdf_Specular_Lut]->GetResource_Texture(),
-            m_render_targets[RenderTarget_Ssao]->GetResource_Texture()
+            (m_flags & Render_SSAO) ? m_render_targets[RenderTarget_Ssao]->GetResource_Texture() : m_tex_white->GetResource_Texture()
 		};
 
 		// Setup command list
@@ -1700,19 +1949,19 @@ namespace Spartan
 
         if (m_debug_buffer == Renderer_Buffer_SSR)
         {
-            texture     = m_render_targets[RenderTarget_Ssr_Blurred];
+            texture     = m_flags & Render_SSR ? m_render_targets[RenderTarget_Ssr_Blurred] : m_tex_black;
             shader_type = Shader_DebugChannelRgbGammaCorrect_P;
         }
 
         if (m_debug_buffer == Renderer_Buffer_Bloom)
         {
-            texture     = m_render_tex_bloom.front();
+            texture     = m_flags & Render_Bloom ? m_render_tex_bloom.front() : m_tex_black;
             shader_type = Shader_DebugChannelRgbGammaCorrect_P;
         }
 
         if (m_debug_buffer == Renderer_Buffer_VolumetricLighting)
         {
-            texture     = m_render_targets[RenderTarget_Light_Volumetric_Blurred];
+            texture     = m_flags & Render_VolumetricLighting ? m_render_targets[RenderTarget_Light_Volumetric_Blurred] : m_tex_black;
             shader_type = Shader_DebugChannelRgbGammaCorrect_P;
         }
 
@@ -21,6 +21,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =========================
 #include "Renderer.h"
+#include "RenderGraph.h"
 #include "Font/Font.h"
 #include "../Resource/ResourceCache.h"
 #include "../RHI/RHI_Texture2D.h"
@@ -98,58 +99,19 @@ namespace Spartan
         m_quad = Math::Rectangle(0, 0, m_resolution.x, m_resolution.y);
         m_quad.CreateBuffers(this);
 
-        // G-Buffer
-        m_render_targets[RenderTarget_Gbuffer_Albedo]   = make_shared<RHI_Texture2D>(m_context, width, height, Format_R8G8B8A8_UNORM);
-        m_render_targets[RenderTarget_Gbuffer_Normal]   = make_shared<RHI_Texture2D>(m_context, width, height, Format_R16G16B16A16_FLOAT); // At Texture_Format_R8G8B8A8_UNORM, normals have noticeable banding
-        m_render_targets[RenderTarget_Gbuffer_Material] = make_shared<RHI_Texture2D>(m_context, width, height, Format_R8G8B8A8_UNORM);
-        m_render_targets[RenderTarget_Gbuffer_Velocity] = make_shared<RHI_Texture2D>(m_context, width, height, Format_R16G16_FLOAT);
-        m_render_targets[RenderTarget_Gbuffer_Depth]    = make_shared<RHI_Texture2D>(m_context, width, height, Format_D32_FLOAT);
-
-        // Light
-        m_render_targets[RenderTarget_Light_Diffuse]            = make_unique<RHI_Texture2D>(m_context, width, height, Format_R16G16B16A16_FLOAT);
-        m_render_targets[RenderTarget_Light_Specular]           = make_unique<RHI_Texture2D>(m_context, width, height, Format_R16G16B16A16_FLOAT);
-        m_render_targets[RenderTarget_Light_Volumetric]         = make_unique<RHI_Texture2D>(m_context, width, height, Format_R16G16B16A16_FLOAT);
-        m_render_targets[RenderTarget_Light_Volumetric_Blurred] = make_unique<RHI_Texture2D>(m_context, width, height, Format_R16G16B16A16_FLOAT);
+        // Transient render targets (G-Buffer, lighting, SSAO, SSR, bloom etc.) are declared every frame by the render graph,
+        // which gives them memory from its pool for as long as the passes need them. Drop what was pooled for the old resolution.
+        m_render_graph->ReleaseTextures();
 
         // BRDF Specular Lut
         m_render_targets[RenderTarget_Brdf_Specular_Lut] = make_unique<RHI_Texture2D>(m_context, 400, 400, Format_R8G8_UNORM);
         m_brdf_specular_lut_rendered = false;
 
-        // Composition
-        m_render_targets[RenderTarget_Composition_Hdr]              = make_unique<RHI_Texture2D>(m_context, width, height, Format_R32G32B32A32_FLOAT);
+        // Composition, these outlive the frame
         m_render_targets[RenderTarget_Composition_Ldr]              = make_unique<RHI_Texture2D>(m_context, width, height, Format_R16G16B16A16_FLOAT);
-        m_render_targets[RenderTarget_Composition_Hdr_2]            = make_unique<RHI_Texture2D>(m_context, width, height, m_render_targets[RenderTarget_Composition_Hdr]->GetFormat()); // Used for Post-Processing   
-        m_render_targets[RenderTarget_Composition_Hdr_History]      = make_unique<RHI_Texture2D>(m_context, width, height, m_render_targets[RenderTarget_Composition_Hdr]->GetFormat()); // Used by TAA and SSR
-        m_render_targets[RenderTarget_Composition_Hdr_History_2]    = make_unique<RHI_Texture2D>(m_context, width, height, m_render_targets[RenderTarget_Composition_Hdr]->GetFormat()); // Used by TAA
-        m_render_targets[RenderTarget_Composition_Ldr_2]            = make_unique<RHI_Texture2D>(m_context, width, height, m_render_targets[RenderTarget_Composition_Ldr]->GetFormat()); // Used for Post-Processing   
-
-        // SSAO
-        float ssao_scale                                = m_options[Option_Value_Ssao_Scale];
-        m_render_targets[RenderTarget_Ssao_Raw]         = make_unique<RHI_Texture2D>(m_context, width * ssao_scale, height * ssao_scale, Format_R8_UNORM);                                       // Raw
-        m_render_targets[RenderTarget_Ssao_Blurred]     = make_unique<RHI_Texture2D>(m_context, width * ssao_scale, height * ssao_scale, m_render_targets[RenderTarget_Ssao_Raw]->GetFormat());  // Blurred
-        m_render_targets[RenderTarget_Ssao]             = make_unique<RHI_Texture2D>(m_context, width, height, m_render_targets[RenderTarget_Ssao_Raw]->GetFormat());                            // Upscaled
-
-        // SSR
-        m_render_targets[RenderTarget_Ssr]          = make_shared<RHI_Texture2D>(m_context, width, height, Format_R16G16B16A16_FLOAT);
-        m_render_targets[RenderTarget_Ssr_Blurred]  = make_shared<RHI_Texture2D>(m_context, width, height, m_render_targets[RenderTarget_Ssr]->GetFormat());
-
-        // Bloom
-        {
-            // Create as many bloom textures as required to scale down to or below 16px (in any dimension)
-            m_render_tex_bloom.clear();
-            m_render_tex_bloom.emplace_back(make_unique<RHI_Texture2D>(m_context, width / 2, height / 2, Format_R16G16B16A16_FLOAT));
-            while (m_render_tex_bloom.back()->GetWidth() > 16 && m_render_tex_bloom.back()->GetHeight() > 16)
-            {
-                m_render_tex_bloom.emplace_back(
-                    make_unique<RHI_Texture2D>(
-                        m_context,
-                        m_render_tex_bloom.back()->GetWidth() / 2,
-                        m_render_tex_bloom.back()->GetHeight() / 2,
-                        Format_R16G16B16A16_FLOAT
-                        )
-                );
-            }
-        }
+        m_render_targets[RenderTarget_Composition_Ldr_2]            = make_unique<RHI_Texture2D>(m_context, width, height, m_render_targets[RenderTarget_Composition_Ldr]->GetFormat()); // Used for Post-Processing and by SSR (next frame)
+        m_render_targets[RenderTarget_Composition_Hdr_History]      = make_unique<RHI_Texture2D>(m_context, width, height, Format_R32G32B32A32_FLOAT); // Used by TAA
+        m_render_targets[RenderTarget_Composition_Hdr_History_2]    = make_unique<RHI_Texture2D>(m_context, width, height, m_render_targets[RenderTarget_Composition_Hdr_History]->GetFormat()); // Used by TAA
     }
 
     void Renderer::CreateShaders()
@@ -165,10 +127,19 @@ namespace Spartan
         m_shaders[Shader_Depth_V] = make_shared<RHI_Shader>(m_rhi_device);
         m_shaders[Shader_Depth_V]->CompileAsync<RHI_Vertex_Pos>(m_context, Shader_Vertex, dir_shaders + "Depth.hlsl");
 
+        // Depth - Quantized vertices, the position comes first so the shader is the same
+        m_shaders[Shader_Depth_Quantized_V] = make_shared<RHI_Shader>(m_rhi_device);
+        m_shaders[Shader_Depth_Quantized_V]->CompileAsync<RHI_Vertex_PosTexNorTan_Quantized>(m_context, Shader_Vertex, dir_shaders + "Depth.hlsl");
+
         // G-Buffer
         m_shaders[Shader_Gbuffer_V] = make_shared<RHI_Shader>(m_rhi_device);
         m_shaders[Shader_Gbuffer_V]->CompileAsync<RHI_Vertex_PosTexNorTan>(m_context, Shader_Vertex, dir_shaders + "GBuffer.hlsl");
 
+        // G-Buffer - Quantized vertices
+        m_shaders[Shader_Gbuffer_Quantized_V] = make_shared<RHI_Shader>(m_rhi_device);
+        m_shaders[Shader_Gbuffer_Quantized_V]->AddDefine("VERTEX_QUANTIZED");
+        m_shaders[Shader_Gbuffer_Quantized_V]->CompileAsync<RHI_Vertex_PosTexNorTan_Quantized>(m_context, Shader_Vertex, dir_shaders + "GBuffer.hlsl");
+
         // BRDF - Specular Lut
         m_shaders[Shader_BrdfSpecularLut] = make_shared<RHI_Shader>(m_rhi_device);
         m_shaders[Shader_BrdfSpecularLut]->AddDefine("BRDF_ENV_SPECULAR_LUT");
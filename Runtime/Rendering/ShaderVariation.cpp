@@ -29,15 +29,16 @@ using namespace std;
 
 namespace Spartan
 {
-	vector<shared_ptr<ShaderVariation>> ShaderVariation::m_variations;
+	unordered_map<unsigned long, shared_ptr<ShaderVariation>> ShaderVariation::m_variations;
+	mutex ShaderVariation::m_variations_mutex;
 
 	const shared_ptr<ShaderVariation>& ShaderVariation::GetMatchingShader(const unsigned long flags)
 	{
-		for (const auto& shader : m_variations)
-		{
-			if (shader->GetShaderFlags() == flags)
-				return shader;
-		}
+		lock_guard<mutex> lock(m_variations_mutex);
+
+		const auto it = m_variations.find(flags);
+		if (it != m_variations.end())
+			return it->second;
 
 		static shared_ptr<ShaderVariation> empty;
 		return empty;
@@ -53,11 +54,12 @@ namespace Spartan
 	{
 		m_flags = shader_flags;
 
-		// Load and compile the pixel shader
+		// Load and compile the pixel shader, the renderer raises the priority once a material that uses it is visible
 		AddDefinesBasedOnMaterial();
-		CompileAsync(m_context, Shader_Pixel, file_path);
+		CompileAsync(m_context, Shader_Pixel, file_path, ShaderCache_Priority_Low);
 
-		m_variations.emplace_back(shared_from_this());
+		lock_guard<mutex> lock(m_variations_mutex);
+		m_variations[m_flags] = shared_from_this();
 	}
 
 	void ShaderVariation::AddDefinesBasedOnMaterial()
@@ -23,7 +23,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =====================
 #include <memory>
-#include <vector>
+#include <mutex>
+#include <unordered_map>
 #include "../RHI/RHI_Definition.h"
 #include "../RHI/RHI_Shader.h"
 //================================
@@ -60,7 +61,7 @@ namespace Spartan
 		bool HasEmissionTexture() const			{ return m_flags & Variation_Emission; }
 		bool HasMaskTexture() const				{ return m_flags & Variation_Mask; }
 
-		// Variation cache
+		// Variation cache, addressed by the flags
 		static const std::shared_ptr<ShaderVariation>& GetMatchingShader(unsigned long flags);
 
 	private:
@@ -68,6 +69,7 @@ namespace Spartan
 		
 		Context* m_context;
 		unsigned long m_flags;	
-		static std::vector<std::shared_ptr<ShaderVariation>> m_variations;
+		static std::unordered_map<unsigned long, std::shared_ptr<ShaderVariation>> m_variations;
+		static std::mutex m_variations_mutex;
 	};
 }
@@ -0,0 +1,372 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ====================
+#include "Skeleton.h"
+#include <cmath>
+#include <xmmintrin.h>
+#include "../RHI/RHI_Vertex.h"
+#include "../IO/FileStream.h"
+#include "../Logging/Log.h"
+//===============================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Spartan::Math;
+//=============================
+
+namespace _Skeleton
+{
+	// Storage is column-major, so a column of the product is the sum of the columns of a, weighted by the column of b
+	static void multiply(const Matrix& a, const Matrix& b, Matrix* result)
+	{
+		const float* a_data	= a.Data();
+		const float* b_data	= b.Data();
+		float* result_data	= &result->m00;
+
+		const __m128 a0 = _mm_loadu_ps(a_data + 0);
+		const __m128 a1 = _mm_loadu_ps(a_data + 4);
+		const __m128 a2 = _mm_loadu_ps(a_data + 8);
+		const __m128 a3 = _mm_loadu_ps(a_data + 12);
+
+		for (uint32_t j = 0; j < 4; j++)
+		{
+			const float* b_column = b_data + j * 4;
+			__m128 column = _mm_mul_ps(a0, _mm_set1_ps(b_column[0]));
+			column = _mm_add_ps(column, _mm_mul_ps(a1, _mm_set1_ps(b_column[1])));
+			column = _mm_add_ps(column, _mm_mul_ps(a2, _mm_set1_ps(b_column[2])));
+			column = _mm_add_ps(column, _mm_mul_ps(a3, _mm_set1_ps(b_column[3])));
+			_mm_storeu_ps(result_data + j * 4, column);
+		}
+	}
+}
+
+namespace Spartan
+{
+	void AnimationPose::Resize(const uint32_t joint_count)
+	{
+		// Padding joints (and new ones) are identities
+		const uint32_t padded_count = (joint_count + 3) & ~3u;
+		for (auto& component : m_position)	component.resize(padded_count, 0.0f);
+		for (auto& component : m_rotation)	component.resize(padded_count, 0.0f);
+		for (auto& component : m_scale)		component.resize(padded_count, 1.0f);
+		for (uint32_t i = m_joint_count; i < padded_count; i++)
+		{
+			m_rotation[3][i] = 1.0f;
+		}
+
+		m_joint_count = joint_count;
+	}
+
+	void AnimationPose::SetJoint(const uint32_t joint, const Vector3& position, const Quaternion& rotation, const Vector3& scale)
+	{
+		m_position[0][joint]	= position.x;
+		m_position[1][joint]	= position.y;
+		m_position[2][joint]	= position.z;
+		m_rotation[0][joint]	= rotation.x;
+		m_rotation[1][joint]	= rotation.y;
+		m_rotation[2][joint]	= rotation.z;
+		m_rotation[3][joint]	= rotation.w;
+		m_scale[0][joint]		= scale.x;
+		m_scale[1][joint]		= scale.y;
+		m_scale[2][joint]		= scale.z;
+	}
+
+	void AnimationPose::Blend(const AnimationPose& other, const float weight)
+	{
+		if (other.m_joint_count != m_joint_count)
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return;
+		}
+
+		const auto padded_count	= static_cast<uint32_t>(m_rotation[0].size());
+		const __m128 w			= _mm_set1_ps(weight);
+		const __m128 sign_mask	= _mm_set1_ps(-0.0f);
+
+		// Positions and scales are interpolated linearly
+		const auto lerp = [padded_count, w](vector<float>& a, const vector<float>& b)
+		{
+			for (uint32_t i = 0; i < padded_count; i += 4)
+			{
+				const __m128 value = _mm_loadu_ps(&a[i]);
+				_mm_storeu_ps(&a[i], _mm_add_ps(value, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&b[i]), value), w)));
+			}
+		};
+
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			lerp(m_position[c], other.m_position[c]);
+			lerp(m_scale[c], other.m_scale[c]);
+		}
+
+		// Rotations are interpolated linearly and normalized, after flipping the other rotation to the same hemisphere
+		for (uint32_t i = 0; i < padded_count; i += 4)
+		{
+			__m128 a[4];
+			__m128 b[4];
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				a[c] = _mm_loadu_ps(&m_rotation[c][i]);
+				b[c] = _mm_loadu_ps(&other.m_rotation[c][i]);
+			}
+
+			__m128 dot = _mm_mul_ps(a[0], b[0]);
+			dot = _mm_add_ps(dot, _mm_mul_ps(a[1], b[1]));
+			dot = _mm_add_ps(dot, _mm_mul_ps(a[2], b[2]));
+			dot = _mm_add_ps(dot, _mm_mul_ps(a[3], b[3]));
+			const __m128 sign = _mm_and_ps(dot, sign_mask);
+
+			__m128 length_squared = _mm_setzero_ps();
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				a[c] = _mm_add_ps(a[c], _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(b[c], sign), a[c]), w));
+				length_squared = _mm_add_ps(length_squared, _mm_mul_ps(a[c], a[c]));
+			}
+
+			const __m128 length_inverse = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(length_squared));
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				_mm_storeu_ps(&m_rotation[c][i], _mm_mul_ps(a[c], length_inverse));
+			}
+		}
+	}
+
+	void AnimationPose::ComputeMatrices(vector<Matrix>* matrices) const
+	{
+		const auto padded_count = static_cast<uint32_t>(m_rotation[0].size());
+		matrices->resize(padded_count);
+
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 two = _mm_set1_ps(2.0f);
+
+		for (uint32_t i = 0; i < padded_count; i += 4)
+		{
+			const __m128 x = _mm_loadu_ps(&m_rotation[0][i]);
+			const __m128 y = _mm_loadu_ps(&m_rotation[1][i]);
+			const __m128 z = _mm_loadu_ps(&m_rotation[2][i]);
+			const __m128 w = _mm_loadu_ps(&m_rotation[3][i]);
+
+			const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+			const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+			const __m128 xw = _mm_mul_ps(x, w), yw = _mm_mul_ps(y, w), zw = _mm_mul_ps(z, w);
+
+			const __m128 scale_x = _mm_loadu_ps(&m_scale[0][i]);
+			const __m128 scale_y = _mm_loadu_ps(&m_scale[1][i]);
+			const __m128 scale_z = _mm_loadu_ps(&m_scale[2][i]);
+
+			// The same terms as Matrix(translation, rotation, scale), each register holds one element of 4 matrices
+			__m128 column_0[4] =
+			{
+				_mm_mul_ps(scale_x, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)))),	// m00
+				_mm_mul_ps(scale_y, _mm_mul_ps(two, _mm_sub_ps(xy, zw))),					// m10
+				_mm_mul_ps(scale_z, _mm_mul_ps(two, _mm_add_ps(xz, yw))),					// m20
+				_mm_loadu_ps(&m_position[0][i])											// m30
+			};
+			__m128 column_1[4] =
+			{
+				_mm_mul_ps(scale_x, _mm_mul_ps(two, _mm_add_ps(xy, zw))),					// m01
+				_mm_mul_ps(scale_y, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(zz, xx)))),	// m11
+				_mm_mul_ps(scale_z, _mm_mul_ps(two, _mm_sub_ps(yz, xw))),					// m21
+				_mm_loadu_ps(&m_position[1][i])											// m31
+			};
+			__m128 column_2[4] =
+			{
+				_mm_mul_ps(scale_x, _mm_mul_ps(two, _mm_sub_ps(xz, yw))),					// m02
+				_mm_mul_ps(scale_y, _mm_mul_ps(two, _mm_add_ps(yz, xw))),					// m12
+				_mm_mul_ps(scale_z, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, xx)))),	// m22
+				_mm_loadu_ps(&m_position[2][i])											// m32
+			};
+
+			// Transposing turns the 4 registers of an element into the 4 elements of a column, per matrix
+			_MM_TRANSPOSE4_PS(column_0[0], column_0[1], column_0[2], column_0[3]);
+			_MM_TRANSPOSE4_PS(column_1[0], column_1[1], column_1[2], column_1[3]);
+			_MM_TRANSPOSE4_PS(column_2[0], column_2[1], column_2[2], column_2[3]);
+
+			const __m128 column_3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+			for (uint32_t j = 0; j < 4; j++)
+			{
+				float* data = &(*matrices)[i + j].m00;
+				_mm_storeu_ps(data + 0,		column_0[j]);
+				_mm_storeu_ps(data + 4,		column_1[j]);
+				_mm_storeu_ps(data + 8,		column_2[j]);
+				_mm_storeu_ps(data + 12,	column_3);
+			}
+		}
+	}
+
+	uint32_t Skeleton::AddJoint(const string& name, const int32_t parent, const Matrix& bind_local)
+	{
+		const auto index = static_cast<uint32_t>(m_joints.size());
+		if (parent >= static_cast<int32_t>(index))
+		{
+			LOG_ERROR("The parent of \"%s\" has to be added first", name.c_str());
+		}
+
+		Skeleton_Joint joint;
+		joint.name		= name;
+		joint.parent	= parent < static_cast<int32_t>(index) ? parent : -1;
+		m_joints.emplace_back(joint);
+		m_joint_indices[name] = index;
+
+		m_bind_pose.Resize(index + 1);
+		m_bind_pose.SetJoint(index, bind_local.GetTranslation(), bind_local.GetRotation(), bind_local.GetScale());
+
+		return index;
+	}
+
+	int32_t Skeleton::GetJointIndex(const string& name) const
+	{
+		const auto it = m_joint_indices.find(name);
+		return it != m_joint_indices.end() ? static_cast<int32_t>(it->second) : -1;
+	}
+
+	void Skeleton::ComputeSkinningMatrices(const AnimationPose& pose, vector<Matrix>* scratch, vector<Matrix>* model, vector<Matrix>* skinning) const
+	{
+		const auto joint_count = GetJointCount();
+		if (pose.GetJointCount() != joint_count)
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return;
+		}
+
+		// Local transforms, 4 joints at a time
+		pose.ComputeMatrices(scratch);
+
+		// Model space transforms, parents come first so they are always ready
+		model->resize(joint_count);
+		skinning->resize(joint_count);
+		for (uint32_t i = 0; i < joint_count; i++)
+		{
+			const int32_t parent = m_joints[i].parent;
+			if (parent < 0)
+			{
+				(*model)[i] = (*scratch)[i];
+			}
+			else
+			{
+				_Skeleton::multiply((*scratch)[i], (*model)[parent], &(*model)[i]);
+			}
+
+			_Skeleton::multiply(m_joints[i].inverse_bind, (*model)[i], &(*skinning)[i]);
+		}
+	}
+
+	void Skeleton::Skin(const RHI_Vertex_PosTexNorTan* vertices, const Skinning_Weights* weights, const uint32_t vertex_count, const Matrix* skinning, RHI_Vertex_PosTexNorTan* vertices_skinned)
+	{
+		for (uint32_t i = 0; i < vertex_count; i++)
+		{
+			const RHI_Vertex_PosTexNorTan& vertex	= vertices[i];
+			const Skinning_Weights& weight			= weights[i];
+			RHI_Vertex_PosTexNorTan& vertex_skinned	= vertices_skinned[i];
+
+			if (weight.weights[0] + weight.weights[1] + weight.weights[2] + weight.weights[3] == 0.0f)
+			{
+				vertex_skinned = vertex;
+				continue;
+			}
+
+			// Weighted sum of the matrices, a column at a time
+			__m128 column[4] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+			for (uint32_t k = 0; k < 4; k++)
+			{
+				if (weight.weights[k] == 0.0f)
+					continue;
+
+				const float* data	= skinning[weight.joints[k]].Data();
+				const __m128 w		= _mm_set1_ps(weight.weights[k]);
+				for (uint32_t j = 0; j < 4; j++)
+				{
+					column[j] = _mm_add_ps(column[j], _mm_mul_ps(_mm_loadu_ps(data + j * 4), w));
+				}
+			}
+
+			// Rows, so that a vector is transformed by scaling and adding them
+			_MM_TRANSPOSE4_PS(column[0], column[1], column[2], column[3]);
+			const __m128* row = column;
+
+			const auto transform = [row](const float* v, const bool is_point)
+			{
+				__m128 result = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v[0]), row[0]), _mm_mul_ps(_mm_set1_ps(v[1]), row[1]));
+				result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(v[2]), row[2]));
+				return is_point ? _mm_add_ps(result, row[3]) : result;
+			};
+
+			const auto store = [](const __m128 value, float* v, const bool normalize)
+			{
+				float result[4];
+				_mm_storeu_ps(result, value);
+				const float length_squared	= result[0] * result[0] + result[1] * result[1] + result[2] * result[2];
+				const float scale			= (normalize && length_squared > 0.0f) ? 1.0f / sqrt(length_squared) : 1.0f;
+				v[0] = result[0] * scale;
+				v[1] = result[1] * scale;
+				v[2] = result[2] * scale;
+			};
+
+			store(transform(vertex.pos, true), vertex_skinned.pos, false);
+			store(transform(vertex.nor, false), vertex_skinned.nor, true);
+			store(transform(vertex.tan, false), vertex_skinned.tan, true);
+			vertex_skinned.tex[0] = vertex.tex[0];
+			vertex_skinned.tex[1] = vertex.tex[1];
+		}
+	}
+
+	void Skeleton::Serialize(FileStream* stream) const
+	{
+		stream->Write(GetJointCount());
+		for (uint32_t i = 0; i < GetJointCount(); i++)
+		{
+			const Skeleton_Joint& joint = m_joints[i];
+			stream->Write(joint.name);
+			stream->Write(joint.parent);
+			stream->Write(reinterpret_cast<const std::byte*>(joint.inverse_bind.Data()), sizeof(Matrix));
+			stream->Write(m_bind_pose.GetPosition(i));
+			stream->Write(m_bind_pose.GetRotation(i));
+			stream->Write(m_bind_pose.GetScale(i));
+		}
+	}
+
+	void Skeleton::Deserialize(FileStream* stream)
+	{
+		m_joints.clear();
+		m_joint_indices.clear();
+		m_bind_pose = AnimationPose();
+
+		const auto joint_count = stream->ReadAs<uint32_t>();
+		for (uint32_t i = 0; i < joint_count; i++)
+		{
+			const auto name		= stream->ReadAs<string>();
+			const auto parent	= stream->ReadAs<int>();
+			Matrix inverse_bind;
+			stream->Read(reinterpret_cast<std::byte*>(&inverse_bind.m00), sizeof(Matrix));
+			Vector3 position;
+			Quaternion rotation;
+			Vector3 scale;
+			stream->Read(&position);
+			stream->Read(&rotation);
+			stream->Read(&scale);
+
+			AddJoint(name, parent, Matrix(position, rotation, scale));
+			SetInverseBind(i, inverse_bind);
+		}
+	}
+}
@@ -0,0 +1,110 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include "../Core/EngineDefs.h"
+#include "../Math/Matrix.h"
+//================================
+
+namespace Spartan
+{
+	class FileStream;
+	struct RHI_Vertex_PosTexNorTan;
+
+	// The local transforms of a skeleton's joints. Each component has an array of its own (padded to a multiple of 4),
+	// so that poses can be blended and turned into matrices 4 joints at a time.
+	class SPARTAN_CLASS AnimationPose
+	{
+	public:
+		void Resize(uint32_t joint_count);
+		void SetJoint(uint32_t joint, const Math::Vector3& position, const Math::Quaternion& rotation, const Math::Vector3& scale);
+		Math::Vector3 GetPosition(uint32_t joint) const		{ return Math::Vector3(m_position[0][joint], m_position[1][joint], m_position[2][joint]); }
+		Math::Quaternion GetRotation(uint32_t joint) const	{ return Math::Quaternion(m_rotation[0][joint], m_rotation[1][joint], m_rotation[2][joint], m_rotation[3][joint]); }
+		Math::Vector3 GetScale(uint32_t joint) const		{ return Math::Vector3(m_scale[0][joint], m_scale[1][joint], m_scale[2][joint]); }
+
+		// Moves this pose towards the other one by weight (0 keeps this pose), rotations take the shortest path
+		void Blend(const AnimationPose& other, float weight);
+
+		// Local matrices of every joint (the vector is resized to the padded joint count)
+		void ComputeMatrices(std::vector<Math::Matrix>* matrices) const;
+
+		auto GetJointCount() const { return m_joint_count; }
+
+	private:
+		uint32_t m_joint_count = 0;
+		std::vector<float> m_position[3];
+		std::vector<float> m_rotation[4];
+		std::vector<float> m_scale[3];
+	};
+
+	struct Skeleton_Joint
+	{
+		std::string name;
+		int32_t parent				= -1; // always lower than the joint's own index
+		Math::Matrix inverse_bind	= Math::Matrix::Identity; // from the space of the meshes to the space of the joint
+	};
+
+	// The joints that influence a vertex, vertices whose weights add up to zero are not skinned
+	struct Skinning_Weights
+	{
+		uint16_t joints[4]	= { 0, 0, 0, 0 };
+		float weights[4]	= { 0.0f, 0.0f, 0.0f, 0.0f };
+	};
+
+	class SPARTAN_CLASS Skeleton
+	{
+	public:
+		// Parents have to be added before their children, the bind pose is the joint's transform relative to its parent
+		uint32_t AddJoint(const std::string& name, int32_t parent, const Math::Matrix& bind_local);
+		void SetInverseBind(uint32_t joint, const Math::Matrix& inverse_bind) { m_joints[joint].inverse_bind = inverse_bind; }
+		int32_t GetJointIndex(const std::string& name) const;
+		const auto& GetJoints() const	{ return m_joints; }
+		auto GetJointCount() const		{ return static_cast<uint32_t>(m_joints.size()); }
+		const auto& GetBindPose() const	{ return m_bind_pose; }
+
+		// Model space transforms of the joints (the scratch vector holds their local matrices), and the matrices that skin vertices with them
+		void ComputeSkinningMatrices(const AnimationPose& pose, std::vector<Math::Matrix>* scratch, std::vector<Math::Matrix>* model, std::vector<Math::Matrix>* skinning) const;
+
+		// Transforms vertices by the weighted sum of their skinning matrices, positions as points, normals and tangents as directions
+		static void Skin(
+			const RHI_Vertex_PosTexNorTan* vertices,
+			const Skinning_Weights* weights,
+			uint32_t vertex_count,
+			const Math::Matrix* skinning,
+			RHI_Vertex_PosTexNorTan* vertices_skinned
+		);
+
+		// Serialization
+		void Serialize(FileStream* stream) const;
+		void Deserialize(FileStream* stream);
+
+	private:
+		std::vector<Skeleton_Joint> m_joints;
+		std::unordered_map<std::string, uint32_t> m_joint_indices;
+		AnimationPose m_bind_pose;
+	};
+}
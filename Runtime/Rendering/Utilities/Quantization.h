@@ -0,0 +1,162 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES ========================
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include "../../Core/Span.h"
+#include "../../RHI/RHI_Vertex.h"
+#include "../../Math/Matrix.h"
+#include "../../Math/MathHelper.h"
+//===================================
+
+// Conversions from RHI_Vertex_PosTexNorTan to RHI_Vertex_PosTexNorTan_Quantized, done when the vertices are uploaded.
+// Positions are stored relative to a cube (an offset and a uniform scale, one per mesh so the precision isn't spread
+// over the whole model) so that dequantizing them is a matrix which can be folded into the world matrix, without skewing
+// the normals that go through it as well.
+namespace Spartan::Utility::Quantization
+{
+	static uint16_t FloatToHalf(const float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		const uint32_t sign		= (bits >> 16) & 0x8000;
+		const int32_t exponent	= static_cast<int32_t>((bits >> 23) & 0xff) - 127 + 15;
+		uint32_t mantissa		= bits & 0x7fffff;
+
+		// Infinity and NaN
+		if (((bits >> 23) & 0xff) == 0xff)
+			return static_cast<uint16_t>(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+
+		// Overflow
+		if (exponent >= 31)
+			return static_cast<uint16_t>(sign | 0x7c00);
+
+		// Subnormal, or zero
+		if (exponent <= 0)
+		{
+			if (exponent < -10)
+				return static_cast<uint16_t>(sign);
+
+			mantissa |= 0x800000;
+			const uint32_t shift		= static_cast<uint32_t>(14 - exponent);
+			const uint32_t remainder	= mantissa & ((1u << shift) - 1);
+			const uint32_t halfway		= 1u << (shift - 1);
+			uint32_t half				= mantissa >> shift;
+			if (remainder > halfway || (remainder == halfway && (half & 1)))
+			{
+				half++;
+			}
+			return static_cast<uint16_t>(sign | half);
+		}
+
+		// Round to nearest even, a carry into the exponent is still correct
+		uint32_t half				= sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+		const uint32_t remainder	= mantissa & 0x1fff;
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+		{
+			half++;
+		}
+		return static_cast<uint16_t>(half);
+	}
+
+	static int16_t FloatToSnorm(const float value)
+	{
+		return static_cast<int16_t>(round(Math::Clamp(value, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	static void OctahedralEncode(const float* direction, int16_t* encoded)
+	{
+		const float length = fabs(direction[0]) + fabs(direction[1]) + fabs(direction[2]);
+		if (length == 0.0f)
+		{
+			encoded[0] = encoded[1] = 0;
+			return;
+		}
+
+		float x = direction[0] / length;
+		float y = direction[1] / length;
+
+		// Fold the lower hemisphere over the diagonals
+		if (direction[2] < 0.0f)
+		{
+			const float x_folded = (1.0f - fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			y = (1.0f - fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = x_folded;
+		}
+
+		encoded[0] = FloatToSnorm(x);
+		encoded[1] = FloatToSnorm(y);
+	}
+
+	// The cube that the positions are quantized in
+	static void ComputeBounds(const Span<const RHI_Vertex_PosTexNorTan>& vertices, Math::Vector3* offset, float* scale)
+	{
+		Math::Vector3 position_min = Math::Vector3::Infinity;
+		Math::Vector3 position_max = Math::Vector3::InfinityNeg;
+		for (const auto& vertex : vertices)
+		{
+			position_min = Math::Vector3(Math::Min(position_min.x, vertex.pos[0]), Math::Min(position_min.y, vertex.pos[1]), Math::Min(position_min.z, vertex.pos[2]));
+			position_max = Math::Vector3(Math::Max(position_max.x, vertex.pos[0]), Math::Max(position_max.y, vertex.pos[1]), Math::Max(position_max.z, vertex.pos[2]));
+		}
+
+		const Math::Vector3 size = position_max - position_min;
+		*offset	= vertices.empty() ? Math::Vector3::Zero : position_min;
+		*scale	= vertices.empty() ? 1.0f : Math::Max3(size.x, size.y, size.z);
+		*scale	= *scale > 0.0f ? *scale : 1.0f;
+	}
+
+	// Transforms quantized positions (as the GPU reads them, 0 to 1) back to object space
+	static Math::Matrix ComputeDequantization(const Math::Vector3& offset, const float scale)
+	{
+		return Math::Matrix::CreateScale(scale) * Math::Matrix::CreateTranslation(offset);
+	}
+
+	// Writes as many quantized vertices as there are vertices
+	static void Quantize(const Span<const RHI_Vertex_PosTexNorTan>& vertices, const Math::Vector3& offset, const float scale, RHI_Vertex_PosTexNorTan_Quantized* vertices_quantized)
+	{
+		const float scale_inv		= 1.0f / scale;
+		const float offset_array[3]	= { offset.x, offset.y, offset.z };
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			const auto& vertex	= vertices[i];
+			auto& quantized		= vertices_quantized[i];
+
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				quantized.pos[j] = static_cast<uint16_t>(round(Math::Saturate((vertex.pos[j] - offset_array[j]) * scale_inv) * 65535.0f));
+			}
+			quantized.pos[3] = 65535;
+
+			quantized.tex[0] = FloatToHalf(vertex.tex[0]);
+			quantized.tex[1] = FloatToHalf(vertex.tex[1]);
+
+			OctahedralEncode(vertex.nor, &quantized.nor_tan[0]);
+			OctahedralEncode(vertex.tan, &quantized.nor_tan[2]);
+		}
+	}
+}
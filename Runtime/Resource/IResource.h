@@ -101,6 +101,10 @@ namespace Spartan
 		virtual uint32_t GetMemoryUsage()   { return static_cast<uint32_t>(sizeof(*this)); }
 		LoadState GetLoadState() const      { return m_load_state; }
 
+		// Dirty resources differ from their native file and have to be saved
+		bool IsDirty() const                { return m_is_dirty; }
+		void SetDirty(const bool dirty)     { m_is_dirty = dirty; }
+
 		// IO
 		virtual bool SaveToFile(const std::string& file_path)	{ return true; }
 		virtual bool LoadFromFile(const std::string& file_path)	{ return true; }
@@ -113,6 +117,7 @@ namespace Spartan
 		Resource_Type m_resource_type	= Resource_Unknown;
 		LoadState m_load_state			= LoadState_Idle;
 		Context* m_context				= nullptr;
+		bool m_is_dirty					= true;
 
 	private:
 		std::string m_resource_name;
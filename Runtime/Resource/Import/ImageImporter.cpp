@@ -29,6 +29,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../Core/Settings.h"
 #include "../../Math/MathHelper.h"
 #include "../../RHI/RHI_Texture2D.h"
+#include "TextureCompressor.h"
+#include "MipGenerator.h"
 //====================================
 
 //= NAMESPACES =====
@@ -38,23 +40,6 @@ using namespace std;
 namespace _ImagImporter
 {
 	static FREE_IMAGE_FILTER rescale_filter = FILTER_LANCZOS3;
-
-	// A struct that rescaling threads will work with
-	struct RescaleJob
-	{
-		uint32_t width		    = 0;
-		uint32_t height		    = 0;
-		uint32_t channels	    = 0;
-		vector<std::byte>* data	= nullptr;
-		bool done			    = false;
-
-		RescaleJob(const uint32_t width, const uint32_t height, const uint32_t channels)
-		{
-			this->width		= width;
-			this->height	= height;
-			this->channels	= channels;
-		}
-	};
 }
 
 namespace Spartan
@@ -143,18 +128,40 @@ namespace Spartan
 		const unsigned int image_width	= FreeImage_GetWidth(bitmap);
 		const unsigned int image_height = FreeImage_GetHeight(bitmap);
 
-		// Fill RGBA vector with the data from the FIBITMAP
-		const auto mip = texture->AddMipmap();
-		GetBitsFromFibitmap(mip, bitmap, image_width, image_height, image_channels);
+		// Allocate all the mips at once, and fill the first one with the data from the FIBITMAP
+		vector<uint64_t> mip_sizes;
+		const uint32_t mip_count = generate_mipmaps ? RHI_Texture::GetMipCount(image_width, image_height) : 1;
+		for (uint32_t i = 0, width = image_width, height = image_height; i < mip_count; i++)
+		{
+			mip_sizes.emplace_back(RHI_Texture::GetMipSize(image_format, width, height, image_channels, image_bytes_per_channel));
+			width	= Math::Max(width / 2, static_cast<uint32_t>(1));
+			height	= Math::Max(height / 2, static_cast<uint32_t>(1));
+		}
+		RHI_TextureMips mips;
+		mips.Allocate(mip_sizes);
+		GetBitsFromFibitmap(mips.GetMip(0), bitmap, image_width, image_height, image_channels);
+
+		// Free memory 
+		FreeImage_Unload(bitmap);
 
 		// If the texture supports mipmaps, generate them
 		if (generate_mipmaps)
 		{
-			GenerateMipmaps(bitmap, texture, image_width, image_height, image_channels);
+			if (!MipGenerator::Generate(m_context->GetSubsystem<Threading>().get(), texture, &mips, image_width, image_height, image_channels, image_bytes_per_channel))
+			{
+				LOG_ERROR("Failed to generate mipmaps");
+			}
 		}
 
-		// Free memory 
-		FreeImage_Unload(bitmap);
+		// Block compress (if requested)
+		const RHI_Format compressed_format = ComputeCompressedFormat(texture, image_format, image_width, image_height, image_is_transparent, image_is_grayscale);
+		if (compressed_format != image_format)
+		{
+			CompressMipmaps(texture, &mips, image_width, image_height, compressed_format);
+		}
+
+		// Hand the data over to the texture
+		texture->SetMips(move(mips));
 
 		// Fill RHI_Texture with image properties
 		texture->SetBpp(image_bpp);
@@ -163,95 +170,83 @@ namespace Spartan
 		texture->SetHeight(image_height);
 		texture->SetChannels(image_channels);
 		texture->SetTransparency(image_is_transparent);
-		texture->SetFormat(image_format);
+		texture->SetFormat(compressed_format);
 		texture->SetGrayscale(image_is_grayscale);
 
 		return true;
 	}
 
-	bool ImageImporter::GetBitsFromFibitmap(vector<std::byte>* data, FIBITMAP* bitmap, const uint32_t width, const uint32_t height, const uint32_t channels)
+	bool ImageImporter::GetBitsFromFibitmap(const Span<std::byte>& data, FIBITMAP* bitmap, const uint32_t width, const uint32_t height, const uint32_t channels)
 	{
-		if (!data || width == 0 || height == 0 || channels == 0)
+		if (data.empty() || width == 0 || height == 0 || channels == 0)
 		{
 			LOG_ERROR_INVALID_PARAMETER();
 			return false;
 		}
 
-		// Compute expected data size and reserve enough memory
-		const auto size = width * height * channels * ComputeBitsPerChannel(bitmap);
-		if (size != data->size())
+		// Compute expected data size
+		const auto size = static_cast<size_t>(width) * height * channels * ComputeBitsPerChannel(bitmap);
+		if (size != data.size())
 		{
-			data->clear();
-			data->reserve(size);
-			data->resize(size);
+			LOG_ERROR("Size mismatch, expected %d bytes but the bitmap has %d", data.size(), size);
+			return false;
 		}
 
-		// Copy the data over to our vector
+		// Copy the data over
 		const auto bits = FreeImage_GetBits(bitmap);
-		memcpy(&(*data)[0], bits, size);
+		memcpy(data.data(), bits, size);
 
 		return true;
 	}
 
-	void ImageImporter::GenerateMipmaps(FIBITMAP* bitmap, RHI_Texture* texture, uint32_t width, uint32_t height, uint32_t channels)
+	RHI_Format ImageImporter::ComputeCompressedFormat(RHI_Texture* texture, const RHI_Format format, const uint32_t width, const uint32_t height, const bool transparent, const bool grayscale) const
 	{
-		if (!texture)
-		{
-			LOG_ERROR_INVALID_PARAMETER();
-			return;
-		}
-	
-		// Create a RescaleJob for every mip that we need
-		vector<_ImagImporter::RescaleJob> jobs;
-		while (width > 1 || height > 1)
-		{
-			width	= Math::Max(width / 2, static_cast<uint32_t>(1));
-			height	= Math::Max(height / 2, static_cast<uint32_t>(1));
-			jobs.emplace_back(width, height, channels);
-			
-			// Resize the RHI_Texture vector accordingly
-			const auto size = width * height * channels;
-			auto mip		= texture->AddMipmap();
-			mip->reserve(size);
-			mip->resize(size);
-		}
+		const auto compression = texture->GetCompression();
+		if (compression == RHI_Texture_Compression_None)
+			return format;
 
-		// Pass data pointers (now that the RHI_Texture mip vector has been constructed)
-		for (uint32_t i = 0; i < jobs.size(); i++)
+		// Only 8-bit RGBA images are compressed, and the top mip has to consist of whole blocks
+		if (format != Format_R8G8B8A8_UNORM || width % 4 != 0 || height % 4 != 0)
 		{
-			// reminder: i + 1 because the 0 mip is the default image size
-			jobs[i].data = texture->GetData(i + 1);
+			LOG_WARNING("Texture can't be compressed (%dx%d), it will remain uncompressed", width, height);
+			return format;
 		}
 
-		// Parallelize mipmap generation using multiple threads (because FreeImage_Rescale() using FILTER_LANCZOS3 is expensive)
-		auto threading = m_context->GetSubsystem<Threading>();
-		for (auto& job : jobs)
+		// BC4 only keeps the red channel, so it's reserved for data that is sampled that way (grayscale albedo still needs all of them)
+		if (grayscale && !transparent && texture->IsSingleChannel())	return Format_BC4_UNORM;
+		if (texture->IsNormalMap())										return Format_BC5_UNORM;
+		if (compression == RHI_Texture_Compression_Quality) return Format_BC7_UNORM;
+
+		return transparent ? Format_BC3_UNORM : Format_BC1_UNORM;
+	}
+
+	void ImageImporter::CompressMipmaps(RHI_Texture* texture, RHI_TextureMips* mips, const uint32_t width, const uint32_t height, const RHI_Format format)
+	{
+		auto threading		= m_context->GetSubsystem<Threading>();
+		const bool quality	= texture->GetCompression() == RHI_Texture_Compression_Quality;
+
+		vector<uint64_t> sizes;
+		for (uint32_t i = 0, mip_width = width, mip_height = height; i < mips->GetCount(); i++)
 		{
-			threading->AddTask([this, &job, &bitmap]()
-			{
-				const auto bitmap_scaled = FreeImage_Rescale(bitmap, job.width, job.height, _ImagImporter::rescale_filter);
-				if (!GetBitsFromFibitmap(job.data, bitmap_scaled, job.width, job.height, job.channels))
-				{
-					LOG_ERROR("Failed to create mip level %dx%d", job.width, job.height);
-				}
-				FreeImage_Unload(bitmap_scaled);
-				job.done = true;
-			});
+			sizes.emplace_back(RHI_Texture::GetMipSize(format, mip_width, mip_height, 4, 8));
+			mip_width	= Math::Max(mip_width / 2, static_cast<uint32_t>(1));
+			mip_height	= Math::Max(mip_height / 2, static_cast<uint32_t>(1));
 		}
 
-		// Wait until all mipmaps have been generated
-		auto ready = false;
-		while (!ready)
+		RHI_TextureMips compressed;
+		compressed.Allocate(sizes);
+		for (uint32_t i = 0, mip_width = width, mip_height = height; i < mips->GetCount(); i++)
 		{
-			ready = true;
-			for (const auto& job : jobs)
+			if (!TextureCompressor::Compress(threading.get(), mips->GetMip(i), mip_width, mip_height, format, quality, compressed.GetMip(i)))
 			{
-				if (!job.done)
-				{
-					ready = false;
-				}
+				LOG_ERROR("Failed to compress mip level %dx%d", mip_width, mip_height);
 			}
+
+			mip_width	= Math::Max(mip_width / 2, static_cast<uint32_t>(1));
+			mip_height	= Math::Max(mip_height / 2, static_cast<uint32_t>(1));
 		}
+
+		*mips = move(compressed);
 	}
 
 	uint32_t ImageImporter::ComputeChannelCount(FIBITMAP* bitmap) const
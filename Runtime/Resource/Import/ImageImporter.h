@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <string>
 #include "../../Core/EngineDefs.h"
 #include "../../RHI/RHI_Definition.h"
+#include "../../Core/Span.h"
 //===================================
 
 struct FIBITMAP;
@@ -33,6 +34,7 @@ struct FIBITMAP;
 namespace Spartan
 {
 	class Context;
+	class RHI_TextureMips;
 
 	class SPARTAN_CLASS ImageImporter
 	{
@@ -43,12 +45,13 @@ namespace Spartan
 		bool Load(const std::string& file_path, RHI_Texture* texture, bool generate_mipmaps = true);
 
 	private:	
-		bool GetBitsFromFibitmap(std::vector<std::byte>* data, FIBITMAP* bitmap, uint32_t width, uint32_t height, uint32_t channels);
-		void GenerateMipmaps(FIBITMAP* bitmap, RHI_Texture* texture, uint32_t width, uint32_t height, uint32_t channels);
+		bool GetBitsFromFibitmap(const Span<std::byte>& data, FIBITMAP* bitmap, uint32_t width, uint32_t height, uint32_t channels);
 
 		uint32_t ComputeChannelCount(FIBITMAP* bitmap) const;
 		uint32_t ComputeBitsPerChannel(FIBITMAP* bitmap) const;
 		RHI_Format ComputeTextureFormat(uint32_t bytes_per_channel, uint32_t channels) const;
+		RHI_Format ComputeCompressedFormat(RHI_Texture* texture, RHI_Format format, uint32_t width, uint32_t height, bool transparent, bool grayscale) const;
+		void CompressMipmaps(RHI_Texture* texture, RHI_TextureMips* mips, uint32_t width, uint32_t height, RHI_Format format);
 		FIBITMAP* ApplyBitmapCorrections(FIBITMAP* bitmap) const;
 		FIBITMAP* _FreeImage_ConvertTo32Bits(FIBITMAP* bitmap) const;
 		FIBITMAP* _FreeImage_Rescale(FIBITMAP* bitmap, uint32_t width, uint32_t height) const;
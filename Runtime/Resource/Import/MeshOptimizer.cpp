@@ -0,0 +1,423 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ======================
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cstring>
+#include "../../Core/Hash.h"
+#include "../../Math/Vector3.h"
+#include "../../RHI/RHI_Vertex.h"
+#include "../../Logging/Log.h"
+//=================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Spartan::Math;
+//=============================
+
+namespace _MeshOptimizer
+{
+	static const uint32_t invalid_index = 0xffffffff;
+
+	// Tipsify's next fanning vertex, when none of the candidates is usable (a hard cluster boundary)
+	static int64_t skip_dead_end(const vector<uint32_t>& live, vector<uint32_t>* dead_end, uint32_t* cursor)
+	{
+		// Recently used vertices first, they might still be in the cache
+		while (!dead_end->empty())
+		{
+			const uint32_t vertex = dead_end->back();
+			dead_end->pop_back();
+			if (live[vertex] > 0)
+				return vertex;
+		}
+
+		// Then in input order
+		while (*cursor < static_cast<uint32_t>(live.size()))
+		{
+			if (live[*cursor] > 0)
+				return *cursor;
+
+			(*cursor)++;
+		}
+
+		return -1;
+	}
+
+	static Vector3 position(const Spartan::RHI_Vertex_PosTexNorTan& vertex)
+	{
+		return Vector3(vertex.pos[0], vertex.pos[1], vertex.pos[2]);
+	}
+}
+
+namespace Spartan
+{
+	void MeshOptimizer::Optimize(vector<uint32_t>* indices, vector<RHI_Vertex_PosTexNorTan>* vertices, MeshOptimizer_Statistics* statistics_before /*= nullptr*/, MeshOptimizer_Statistics* statistics_after /*= nullptr*/)
+	{
+		if (!indices || !vertices || indices->empty() || vertices->empty() || indices->size() % 3 != 0)
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return;
+		}
+
+		const auto vertex_count = static_cast<uint32_t>(vertices->size());
+		for (const uint32_t index : *indices)
+		{
+			if (index >= vertex_count)
+			{
+				LOG_ERROR("Index %d is out of range, the mesh won't be optimized", index);
+				return;
+			}
+		}
+
+		if (statistics_before)
+		{
+			*statistics_before = Analyze(*indices, vertex_count);
+		}
+
+		WeldVertices(indices, vertices);
+
+		vector<uint32_t> cluster_offsets;
+		OptimizeVertexCache(indices, static_cast<uint32_t>(vertices->size()), &cluster_offsets);
+		OptimizeOverdraw(indices, *vertices, cluster_offsets);
+		OptimizeVertexFetch(indices, vertices);
+
+		if (statistics_after)
+		{
+			*statistics_after = Analyze(*indices, static_cast<uint32_t>(vertices->size()));
+		}
+	}
+
+	void MeshOptimizer::WeldVertices(vector<uint32_t>* indices, vector<RHI_Vertex_PosTexNorTan>* vertices)
+	{
+		const auto vertex_count = static_cast<uint32_t>(vertices->size());
+
+		// Open addressing hash table, at most half full
+		uint32_t table_size = 1;
+		while (table_size < vertex_count * 2)
+		{
+			table_size <<= 1;
+		}
+		const uint32_t table_mask = table_size - 1;
+		vector<uint32_t> table(table_size, _MeshOptimizer::invalid_index);
+
+		vector<RHI_Vertex_PosTexNorTan> vertices_unique;
+		vertices_unique.reserve(vertex_count);
+		vector<uint32_t> remap(vertex_count);
+		for (uint32_t i = 0; i < vertex_count; i++)
+		{
+			const auto& vertex = (*vertices)[i];
+			auto slot = static_cast<uint32_t>(Hash::Compute(&vertex, sizeof(vertex))) & table_mask;
+			while (table[slot] != _MeshOptimizer::invalid_index && memcmp(&vertices_unique[table[slot]], &vertex, sizeof(vertex)) != 0)
+			{
+				slot = (slot + 1) & table_mask;
+			}
+
+			if (table[slot] == _MeshOptimizer::invalid_index)
+			{
+				table[slot] = static_cast<uint32_t>(vertices_unique.size());
+				vertices_unique.emplace_back(vertex);
+			}
+
+			remap[i] = table[slot];
+		}
+
+		if (vertices_unique.size() == vertices->size())
+			return;
+
+		for (auto& index : *indices)
+		{
+			index = remap[index];
+		}
+		*vertices = move(vertices_unique);
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(vector<uint32_t>* indices, const uint32_t vertex_count, vector<uint32_t>* cluster_offsets /*= nullptr*/)
+	{
+		const auto triangle_count = static_cast<uint32_t>(indices->size() / 3);
+		if (triangle_count == 0 || vertex_count == 0)
+			return;
+
+		// Triangles that use each vertex, and how many of them are yet to be emitted (live)
+		vector<uint32_t> live(vertex_count, 0);
+		for (const uint32_t index : *indices)
+		{
+			live[index]++;
+		}
+
+		vector<uint32_t> adjacency_offsets(vertex_count + 1, 0);
+		for (uint32_t i = 0; i < vertex_count; i++)
+		{
+			adjacency_offsets[i + 1] = adjacency_offsets[i] + live[i];
+		}
+
+		vector<uint32_t> adjacency(indices->size());
+		{
+			vector<uint32_t> cursors(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+			for (uint32_t i = 0; i < static_cast<uint32_t>(indices->size()); i++)
+			{
+				adjacency[cursors[(*indices)[i]]++] = i / 3;
+			}
+		}
+
+		// Tipsify, fan around a vertex and move on to the neighbour that's still in the cache 
+		// and whose remaining triangles are least likely to push it out of the cache
+		vector<uint32_t> cache_time(vertex_count, 0);
+		vector<bool> emitted(triangle_count, false);
+		vector<uint32_t> dead_end;
+		vector<uint32_t> candidates;
+		vector<uint32_t> output;
+		dead_end.reserve(indices->size());
+		output.reserve(indices->size());
+		uint32_t time	= cache_size + 1;
+		uint32_t cursor	= 0;
+		int64_t fanning	= _MeshOptimizer::skip_dead_end(live, &dead_end, &cursor);
+
+		if (cluster_offsets)
+		{
+			cluster_offsets->assign(1, 0);
+		}
+
+		while (fanning >= 0)
+		{
+			candidates.clear();
+			for (uint32_t i = adjacency_offsets[fanning]; i < adjacency_offsets[fanning + 1]; i++)
+			{
+				const uint32_t triangle = adjacency[i];
+				if (emitted[triangle])
+					continue;
+
+				for (uint32_t j = 0; j < 3; j++)
+				{
+					const uint32_t vertex = (*indices)[triangle * 3 + j];
+					output.emplace_back(vertex);
+					dead_end.emplace_back(vertex);
+					candidates.emplace_back(vertex);
+					live[vertex]--;
+
+					if (time - cache_time[vertex] > cache_size)
+					{
+						cache_time[vertex] = time++;
+					}
+				}
+				emitted[triangle] = true;
+			}
+
+			// Pick the candidate that has been in the cache the longest, while it will still be there after its triangles are emitted
+			int64_t next	= -1;
+			int64_t best	= -1;
+			for (const uint32_t vertex : candidates)
+			{
+				if (live[vertex] == 0)
+					continue;
+
+				int64_t priority = 0;
+				if (time - cache_time[vertex] + 2 * live[vertex] <= cache_size)
+				{
+					priority = time - cache_time[vertex];
+				}
+
+				if (priority > best)
+				{
+					best = priority;
+					next = vertex;
+				}
+			}
+
+			if (next == -1)
+			{
+				next = _MeshOptimizer::skip_dead_end(live, &dead_end, &cursor);
+
+				if (cluster_offsets && next != -1 && output.size() != cluster_offsets->back())
+				{
+					cluster_offsets->emplace_back(static_cast<uint32_t>(output.size()));
+				}
+			}
+
+			fanning = next;
+		}
+
+		*indices = move(output);
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(vector<uint32_t>* indices, const vector<RHI_Vertex_PosTexNorTan>& vertices, const vector<uint32_t>& cluster_offsets, const float threshold /*= 1.05f*/)
+	{
+		const auto index_count = static_cast<uint32_t>(indices->size());
+		if (cluster_offsets.empty() || index_count == 0)
+			return;
+
+		// Split the clusters further, wherever the cache is warm enough that starting over (after reordering) costs little
+		vector<uint32_t> clusters;
+		vector<uint32_t> cache_time(vertices.size(), 0);
+		uint32_t time = cache_size + 1;
+		const auto cache_misses = [&](const uint32_t index)
+		{
+			const uint32_t vertex = (*indices)[index];
+			if (time - cache_time[vertex] > cache_size)
+			{
+				cache_time[vertex] = time++;
+				return 1u;
+			}
+			return 0u;
+		};
+
+		for (uint32_t i = 0; i < static_cast<uint32_t>(cluster_offsets.size()); i++)
+		{
+			const uint32_t start	= cluster_offsets[i];
+			const uint32_t end		= i + 1 < static_cast<uint32_t>(cluster_offsets.size()) ? cluster_offsets[i + 1] : index_count;
+
+			// Cache misses of the whole cluster, from a cold cache
+			time += cache_size + 1;
+			uint32_t misses = 0;
+			for (uint32_t j = start; j < end; j++)
+			{
+				misses += cache_misses(j);
+			}
+			const float cluster_acmr = static_cast<float>(misses) / ((end - start) / 3);
+
+			time += cache_size + 1;
+			misses = 0;
+			uint32_t triangles = 0;
+			clusters.emplace_back(start);
+			for (uint32_t j = start; j < end; j += 3)
+			{
+				misses += cache_misses(j) + cache_misses(j + 1) + cache_misses(j + 2);
+				triangles++;
+
+				if (j + 3 < end && static_cast<float>(misses) / triangles <= threshold * cluster_acmr)
+				{
+					clusters.emplace_back(j + 3);
+					time += cache_size + 1;
+					misses		= 0;
+					triangles	= 0;
+				}
+			}
+		}
+
+		// Area weighted centroid and normal, of each cluster and of the mesh
+		const auto cluster_count = static_cast<uint32_t>(clusters.size());
+		vector<Vector3> cluster_centroids(cluster_count, Vector3::Zero);
+		vector<Vector3> cluster_normals(cluster_count, Vector3::Zero);
+		Vector3 mesh_centroid	= Vector3::Zero;
+		float mesh_area			= 0.0f;
+		for (uint32_t i = 0; i < cluster_count; i++)
+		{
+			const uint32_t start	= clusters[i];
+			const uint32_t end		= i + 1 < cluster_count ? clusters[i + 1] : index_count;
+
+			float cluster_area = 0.0f;
+			for (uint32_t j = start; j < end; j += 3)
+			{
+				const Vector3 p0		= _MeshOptimizer::position(vertices[(*indices)[j]]);
+				const Vector3 p1		= _MeshOptimizer::position(vertices[(*indices)[j + 1]]);
+				const Vector3 p2		= _MeshOptimizer::position(vertices[(*indices)[j + 2]]);
+				const Vector3 normal	= Vector3::Cross(p1 - p0, p2 - p0); // length is twice the area
+				const float area		= normal.Length() * 0.5f;
+
+				cluster_centroids[i]	+= (p0 + p1 + p2) * (area / 3.0f);
+				cluster_normals[i]		+= normal;
+				cluster_area			+= area;
+			}
+
+			mesh_centroid	+= cluster_centroids[i];
+			mesh_area		+= cluster_area;
+
+			if (cluster_area > 0.0f)
+			{
+				cluster_centroids[i] = cluster_centroids[i] / cluster_area;
+			}
+		}
+		if (mesh_area > 0.0f)
+		{
+			mesh_centroid = mesh_centroid / mesh_area;
+		}
+
+		// Draw the clusters that face away from the centre first, they are the most likely to occlude the rest
+		vector<float> sort_keys(cluster_count);
+		vector<uint32_t> order(cluster_count);
+		for (uint32_t i = 0; i < cluster_count; i++)
+		{
+			const float length	= cluster_normals[i].Length();
+			sort_keys[i]		= length > 0.0f ? Vector3::Dot(cluster_centroids[i] - mesh_centroid, cluster_normals[i] / length) : 0.0f;
+			order[i]			= i;
+		}
+		stable_sort(order.begin(), order.end(), [&sort_keys](const uint32_t a, const uint32_t b) { return sort_keys[a] > sort_keys[b]; });
+
+		vector<uint32_t> output;
+		output.reserve(index_count);
+		for (const uint32_t cluster : order)
+		{
+			const uint32_t start	= clusters[cluster];
+			const uint32_t end		= cluster + 1 < cluster_count ? clusters[cluster + 1] : index_count;
+			output.insert(output.end(), indices->begin() + start, indices->begin() + end);
+		}
+		*indices = move(output);
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(vector<uint32_t>* indices, vector<RHI_Vertex_PosTexNorTan>* vertices)
+	{
+		// Vertices in the order the indices first reference them, so fetching them is mostly sequential
+		vector<uint32_t> remap(vertices->size(), _MeshOptimizer::invalid_index);
+		vector<RHI_Vertex_PosTexNorTan> vertices_ordered;
+		vertices_ordered.reserve(vertices->size());
+		for (auto& index : *indices)
+		{
+			if (remap[index] == _MeshOptimizer::invalid_index)
+			{
+				remap[index] = static_cast<uint32_t>(vertices_ordered.size());
+				vertices_ordered.emplace_back((*vertices)[index]);
+			}
+
+			index = remap[index];
+		}
+
+		*vertices = move(vertices_ordered);
+	}
+
+	MeshOptimizer_Statistics MeshOptimizer::Analyze(const vector<uint32_t>& indices, const uint32_t vertex_count)
+	{
+		MeshOptimizer_Statistics statistics;
+		statistics.triangle_count = static_cast<uint32_t>(indices.size() / 3);
+
+		vector<uint32_t> cache_time(vertex_count, 0);
+		vector<bool> referenced(vertex_count, false);
+		uint32_t time = cache_size + 1;
+		for (const uint32_t index : indices)
+		{
+			if (index >= vertex_count)
+				continue;
+
+			if (!referenced[index])
+			{
+				referenced[index] = true;
+				statistics.vertex_count++;
+			}
+
+			if (time - cache_time[index] > cache_size)
+			{
+				cache_time[index] = time++;
+				statistics.cache_misses++;
+			}
+		}
+
+		return statistics;
+	}
+}
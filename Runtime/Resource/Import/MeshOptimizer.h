@@ -0,0 +1,76 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <cstdint>
+#include "../../Core/EngineDefs.h"
+//================================
+
+namespace Spartan
+{
+	struct RHI_Vertex_PosTexNorTan;
+
+	// Post-transform vertex cache efficiency of an index buffer, measured by simulating a FIFO cache
+	struct MeshOptimizer_Statistics
+	{
+		uint32_t triangle_count	= 0;
+		uint32_t vertex_count	= 0; // referenced vertices
+		uint32_t cache_misses	= 0;
+
+		float GetAcmr() const { return triangle_count	? static_cast<float>(cache_misses) / triangle_count	: 0.0f; } // average cache misses per triangle (0.5 - 3)
+		float GetAtvr() const { return vertex_count		? static_cast<float>(cache_misses) / vertex_count	: 0.0f; } // average transforms per vertex (1 is ideal)
+
+		void Accumulate(const MeshOptimizer_Statistics& other)
+		{
+			triangle_count	+= other.triangle_count;
+			vertex_count	+= other.vertex_count;
+			cache_misses	+= other.cache_misses;
+		}
+	};
+
+	// Optimizes a triangle list (indices are local to its vertices) for the GPU:
+	// - Welding, merges vertices that are bitwise identical.
+	// - Vertex cache, reorders triangles with Tipsify (Sander et al. 2007).
+	// - Overdraw, reorders the clusters Tipsify produces so that outward facing ones are drawn first.
+	// - Vertex fetch, reorders vertices in the order they are first used and drops unreferenced ones.
+	class SPARTAN_CLASS MeshOptimizer
+	{
+	public:
+		static constexpr uint32_t cache_size = 16;
+
+		static void Optimize(
+			std::vector<uint32_t>* indices,
+			std::vector<RHI_Vertex_PosTexNorTan>* vertices,
+			MeshOptimizer_Statistics* statistics_before	= nullptr,
+			MeshOptimizer_Statistics* statistics_after	= nullptr
+		);
+
+		// Individual stages
+		static void WeldVertices(std::vector<uint32_t>* indices, std::vector<RHI_Vertex_PosTexNorTan>* vertices);
+		static void OptimizeVertexCache(std::vector<uint32_t>* indices, uint32_t vertex_count, std::vector<uint32_t>* cluster_offsets = nullptr);
+		static void OptimizeOverdraw(std::vector<uint32_t>* indices, const std::vector<RHI_Vertex_PosTexNorTan>& vertices, const std::vector<uint32_t>& cluster_offsets, float threshold = 1.05f);
+		static void OptimizeVertexFetch(std::vector<uint32_t>* indices, std::vector<RHI_Vertex_PosTexNorTan>* vertices);
+		static MeshOptimizer_Statistics Analyze(const std::vector<uint32_t>& indices, uint32_t vertex_count);
+	};
+}
@@ -0,0 +1,662 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ======================
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include "../../Core/Hash.h"
+#include "../../Math/Vector3.h"
+#include "../../RHI/RHI_Vertex.h"
+#include "../../Logging/Log.h"
+//=================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Spartan::Math;
+//=============================
+
+namespace _MeshSimplifier
+{
+	static const uint32_t invalid_index		= 0xffffffff;
+	static const double border_weight		= 10.0;		// how strongly borders resist moving away from themselves
+	static const double attribute_weight	= 0.001;	// cost of texture coordinate and normal differences, relative to (normalized) squared distances
+	static const float flip_threshold		= 0.2f;		// collapses that rotate a triangle by more than ~78 degrees are rejected
+
+	enum Vertex_Kind : uint8_t
+	{
+		Vertex_Manifold,	// collapses onto any neighbour
+		Vertex_Border,		// collapses onto a neighbour along the border
+		Vertex_Seam,		// collapses onto a neighbour along the seam, together with its sibling on the other side
+		Vertex_Locked		// doesn't collapse
+	};
+
+	// Sum of squared distances from a set of planes, weighted by their triangle areas
+	struct Quadric
+	{
+		double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+		double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+		double c = 0.0;
+		double weight = 0.0;
+
+		void AddPlane(const Vector3& normal, const float distance, const double plane_weight)
+		{
+			const double x = normal.x, y = normal.y, z = normal.z, d = distance;
+			a00 += plane_weight * x * x; a01 += plane_weight * x * y; a02 += plane_weight * x * z;
+			a11 += plane_weight * y * y; a12 += plane_weight * y * z; a22 += plane_weight * z * z;
+			b0	+= plane_weight * x * d; b1	+= plane_weight * y * d; b2	+= plane_weight * z * d;
+			c	+= plane_weight * d * d;
+		}
+
+		void Add(const Quadric& other)
+		{
+			a00 += other.a00; a01 += other.a01; a02 += other.a02; a11 += other.a11; a12 += other.a12; a22 += other.a22;
+			b0	+= other.b0; b1 += other.b1; b2 += other.b2;
+			c	+= other.c;
+			weight += other.weight;
+		}
+
+		// Mean squared distance of a point from the planes
+		double Error(const Vector3& point) const
+		{
+			const double x = point.x, y = point.y, z = point.z;
+			const double error =
+				x * (a00 * x + a01 * y + a02 * z) +
+				y * (a01 * x + a11 * y + a12 * z) +
+				z * (a02 * x + a12 * y + a22 * z) +
+				2.0 * (b0 * x + b1 * y + b2 * z) + c;
+
+			return weight > 0.0 ? max(error, 0.0) / weight : 0.0;
+		}
+	};
+
+	static uint64_t edge_key(const uint32_t a, const uint32_t b)
+	{
+		return (static_cast<uint64_t>(a) << 32) | b;
+	}
+
+	static double attribute_distance(const Spartan::RHI_Vertex_PosTexNorTan& a, const Spartan::RHI_Vertex_PosTexNorTan& b)
+	{
+		double distance = 0.0;
+		for (uint32_t i = 0; i < 2; i++) { const double d = a.tex[i] - b.tex[i]; distance += d * d; }
+		for (uint32_t i = 0; i < 3; i++) { const double d = a.nor[i] - b.nor[i]; distance += d * d; }
+		return distance;
+	}
+
+	// Simplifies progressively, saving a level of detail each time one of the (descending) targets is reached, or when the mesh can't be simplified any further
+	static void simplify(const vector<uint32_t>& indices, const vector<Spartan::RHI_Vertex_PosTexNorTan>& vertices, const vector<uint32_t>& target_index_counts, const float max_error, vector<Spartan::MeshSimplifier_Lod>* lods)
+	{
+		const auto vertex_count = static_cast<uint32_t>(vertices.size());
+
+		// Positions, normalized to the unit cube so that errors don't depend on the mesh's scale
+		Vector3 position_min = Vector3::Infinity;
+		Vector3 position_max = Vector3::InfinityNeg;
+		for (const auto& vertex : vertices)
+		{
+			position_min = Vector3(min(position_min.x, vertex.pos[0]), min(position_min.y, vertex.pos[1]), min(position_min.z, vertex.pos[2]));
+			position_max = Vector3(max(position_max.x, vertex.pos[0]), max(position_max.y, vertex.pos[1]), max(position_max.z, vertex.pos[2]));
+		}
+		const Vector3 size		= position_max - position_min;
+		const float extent		= max(max(size.x, size.y), size.z);
+		const float extent_inv	= extent > 0.0f ? 1.0f / extent : 1.0f;
+		vector<Vector3> positions(vertex_count);
+		for (uint32_t i = 0; i < vertex_count; i++)
+		{
+			positions[i] = (Vector3(vertices[i].pos[0], vertices[i].pos[1], vertices[i].pos[2]) - position_min) * extent_inv;
+		}
+
+		// Vertices that share a position (seams) are remapped to the first of them, all the topology is built on top of that
+		vector<uint32_t> position_remap(vertex_count);
+		{
+			uint32_t table_size = 1;
+			while (table_size < vertex_count * 2)
+			{
+				table_size <<= 1;
+			}
+			const uint32_t table_mask = table_size - 1;
+			vector<uint32_t> table(table_size, invalid_index);
+
+			for (uint32_t i = 0; i < vertex_count; i++)
+			{
+				const auto& position = vertices[i].pos;
+				auto slot = static_cast<uint32_t>(Spartan::Hash::Compute(position, sizeof(position))) & table_mask;
+				while (table[slot] != invalid_index && memcmp(vertices[table[slot]].pos, position, sizeof(position)) != 0)
+				{
+					slot = (slot + 1) & table_mask;
+				}
+
+				if (table[slot] == invalid_index)
+				{
+					table[slot] = i;
+				}
+
+				position_remap[i] = table[slot];
+			}
+		}
+
+		// Drop triangles which are degenerate to begin with
+		vector<uint32_t> result;
+		result.reserve(indices.size());
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const uint32_t a = position_remap[indices[i + 0]];
+			const uint32_t b = position_remap[indices[i + 1]];
+			const uint32_t c = position_remap[indices[i + 2]];
+			if (a != b && b != c && c != a)
+			{
+				result.insert(result.end(), { indices[i + 0], indices[i + 1], indices[i + 2] });
+			}
+		}
+
+		// Quadrics, per position
+		vector<Quadric> quadrics(vertex_count);
+		{
+			unordered_set<uint64_t> edges;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				edges.insert(edge_key(position_remap[result[i + 0]], position_remap[result[i + 1]]));
+				edges.insert(edge_key(position_remap[result[i + 1]], position_remap[result[i + 2]]));
+				edges.insert(edge_key(position_remap[result[i + 2]], position_remap[result[i + 0]]));
+			}
+
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				const uint32_t triangle[3]	= { position_remap[result[i + 0]], position_remap[result[i + 1]], position_remap[result[i + 2]] };
+				Vector3 normal				= Vector3::Cross(positions[triangle[1]] - positions[triangle[0]], positions[triangle[2]] - positions[triangle[0]]);
+				const float length			= normal.Length();
+				if (length == 0.0f)
+					continue;
+
+				normal = normal / length;
+				const float distance	= -Vector3::Dot(normal, positions[triangle[0]]);
+				const double area		= length * 0.5;
+				for (const uint32_t vertex : triangle)
+				{
+					quadrics[vertex].AddPlane(normal, distance, area);
+					quadrics[vertex].weight += area;
+				}
+
+				// Borders get a plane which is perpendicular to the triangle, so that moving away from them costs
+				for (uint32_t edge = 0; edge < 3; edge++)
+				{
+					const uint32_t a = triangle[edge];
+					const uint32_t b = triangle[(edge + 1) % 3];
+					if (edges.count(edge_key(b, a)))
+						continue;
+
+					const Vector3 direction = positions[b] - positions[a];
+					Vector3 border_normal	= Vector3::Cross(direction, normal);
+					const float border_length = border_normal.Length();
+					if (border_length == 0.0f)
+						continue;
+
+					border_normal = border_normal / border_length;
+					const float border_distance = -Vector3::Dot(border_normal, positions[a]);
+					const double border_plane_weight = border_weight * direction.LengthSquared();
+					quadrics[a].AddPlane(border_normal, border_distance, border_plane_weight);
+					quadrics[b].AddPlane(border_normal, border_distance, border_plane_weight);
+				}
+			}
+		}
+
+		const double error_limit = static_cast<double>(max_error) * extent_inv * static_cast<double>(max_error) * extent_inv;
+		double error_max = 0.0;
+
+		vector<uint8_t> kinds(vertex_count);
+		vector<uint32_t> siblings(vertex_count);
+		vector<uint32_t> open_neighbours(vertex_count * 2);
+		vector<uint32_t> open_counts(vertex_count);
+		vector<uint32_t> group_counts(vertex_count);
+		vector<uint32_t> border_counts(vertex_count);
+		vector<uint8_t> non_manifold(vertex_count);
+		vector<uint8_t> referenced(vertex_count);
+		vector<uint32_t> adjacency_offsets(vertex_count + 1);
+		vector<uint32_t> adjacency;
+		vector<uint32_t> collapse_targets(vertex_count);
+		vector<double> collapse_costs(vertex_count);
+		vector<uint32_t> collapse_order;
+		vector<uint32_t> remap(vertex_count);
+		vector<uint8_t> touched(vertex_count);
+		vector<uint32_t> marks(vertex_count, 0);
+		uint32_t mark = 0;
+
+		// Collapse in passes, each pass collapses the cheapest edges which don't affect each other
+		uint32_t target_index = 0;
+		while (target_index < static_cast<uint32_t>(target_index_counts.size()))
+		{
+			// Save a level once its target is reached
+			const uint32_t target_index_count = target_index_counts[target_index];
+			if (result.size() <= target_index_count)
+			{
+				lods->push_back({ result, static_cast<float>(sqrt(error_max)) * extent });
+				target_index++;
+				continue;
+			}
+
+			const auto triangle_count = static_cast<uint32_t>(result.size() / 3);
+
+			// Topology
+			unordered_map<uint64_t, uint32_t> edges_position;
+			unordered_set<uint64_t> edges_index;
+			edges_position.reserve(result.size());
+			edges_index.reserve(result.size());
+			fill(referenced.begin(), referenced.end(), static_cast<uint8_t>(0));
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (uint32_t edge = 0; edge < 3; edge++)
+				{
+					const uint32_t a = result[i + edge];
+					const uint32_t b = result[i + (edge + 1) % 3];
+					edges_position[edge_key(position_remap[a], position_remap[b])]++;
+					edges_index.insert(edge_key(a, b));
+					referenced[a] = 1;
+				}
+			}
+
+			// Classify vertices
+			fill(group_counts.begin(), group_counts.end(), 0u);
+			fill(border_counts.begin(), border_counts.end(), 0u);
+			fill(open_counts.begin(), open_counts.end(), 0u);
+			fill(non_manifold.begin(), non_manifold.end(), static_cast<uint8_t>(0));
+			fill(siblings.begin(), siblings.end(), invalid_index);
+			for (uint32_t i = 0; i < vertex_count; i++)
+			{
+				if (!referenced[i])
+					continue;
+
+				// Remember the other vertex at this position, in case it's a seam
+				const uint32_t position = position_remap[i];
+				if (group_counts[position]++ == 0)
+				{
+					siblings[position] = i;
+				}
+				else
+				{
+					siblings[i]						= siblings[position];
+					siblings[siblings[position]]	= i;
+				}
+			}
+			for (const auto& [key, count] : edges_position)
+			{
+				const auto a = static_cast<uint32_t>(key >> 32);
+				const auto b = static_cast<uint32_t>(key & 0xffffffff);
+				if (count > 1)
+				{
+					non_manifold[a] = non_manifold[b] = 1;
+				}
+				else if (!edges_position.count(edge_key(b, a)))
+				{
+					border_counts[a]++;
+					border_counts[b]++;
+				}
+			}
+			for (const uint64_t key : edges_index)
+			{
+				const auto a = static_cast<uint32_t>(key >> 32);
+				const auto b = static_cast<uint32_t>(key & 0xffffffff);
+				if (edges_index.count(edge_key(b, a)))
+					continue;
+
+				// An edge without a twin (in index space) is either a border or a seam
+				if (open_counts[a] < 2) open_neighbours[a * 2 + open_counts[a]] = b;
+				if (open_counts[b] < 2) open_neighbours[b * 2 + open_counts[b]] = a;
+				open_counts[a]++;
+				open_counts[b]++;
+			}
+			for (uint32_t i = 0; i < vertex_count; i++)
+			{
+				const uint32_t position = position_remap[i];
+				if (!referenced[i] || non_manifold[position])
+				{
+					kinds[i] = Vertex_Locked;
+				}
+				else if (group_counts[position] == 1)
+				{
+					kinds[i] = border_counts[position] == 0 ? Vertex_Manifold : border_counts[position] == 2 ? Vertex_Border : Vertex_Locked;
+				}
+				else
+				{
+					kinds[i] = (group_counts[position] == 2 && border_counts[position] == 0 && open_counts[i] == 2) ? Vertex_Seam : Vertex_Locked;
+				}
+			}
+			for (uint32_t i = 0; i < vertex_count; i++)
+			{
+				if (kinds[i] == Vertex_Seam && kinds[siblings[i]] != Vertex_Seam)
+				{
+					kinds[i] = kinds[siblings[i]] = Vertex_Locked;
+				}
+			}
+
+			// Triangles around each position
+			fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0u);
+			for (const uint32_t index : result)
+			{
+				adjacency_offsets[position_remap[index] + 1]++;
+			}
+			for (uint32_t i = 0; i < vertex_count; i++)
+			{
+				adjacency_offsets[i + 1] += adjacency_offsets[i];
+			}
+			adjacency.resize(result.size());
+			{
+				vector<uint32_t> cursors(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+				for (uint32_t i = 0; i < static_cast<uint32_t>(result.size()); i++)
+				{
+					adjacency[cursors[position_remap[result[i]]]++] = i / 3;
+				}
+			}
+
+			// The vertex at the other end of a seam edge, on the sibling's side
+			const auto seam_target = [&](const uint32_t vertex, const uint32_t target)
+			{
+				const uint32_t sibling = siblings[vertex];
+				for (uint32_t i = 0; i < 2; i++)
+				{
+					const uint32_t neighbour = open_neighbours[sibling * 2 + i];
+					if (position_remap[neighbour] == position_remap[target])
+						return neighbour;
+				}
+				return invalid_index;
+			};
+
+			// The cheapest collapse of each vertex
+			fill(collapse_targets.begin(), collapse_targets.end(), invalid_index);
+			fill(collapse_costs.begin(), collapse_costs.end(), numeric_limits<double>::max());
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (uint32_t edge = 0; edge < 6; edge++)
+				{
+					const uint32_t vertex	= result[i + edge % 3];
+					const uint32_t target	= result[i + (edge % 3 + (edge < 3 ? 1 : 2)) % 3];
+					const uint32_t kind		= kinds[vertex];
+					const uint32_t position_vertex = position_remap[vertex];
+					const uint32_t position_target = position_remap[target];
+
+					if (kind == Vertex_Locked)
+						continue;
+
+					if (kind == Vertex_Border && (edges_position.count(edge_key(position_vertex, position_target)) + edges_position.count(edge_key(position_target, position_vertex))) != 1)
+						continue;
+
+					double cost_attributes = attribute_distance(vertices[vertex], vertices[target]);
+					if (kind == Vertex_Seam)
+					{
+						if (open_neighbours[vertex * 2] != target && open_neighbours[vertex * 2 + 1] != target)
+							continue;
+
+						const uint32_t sibling_target = seam_target(vertex, target);
+						if (sibling_target == invalid_index)
+							continue;
+
+						cost_attributes += attribute_distance(vertices[siblings[vertex]], vertices[sibling_target]);
+					}
+
+					const double cost = quadrics[position_vertex].Error(positions[position_target]) + attribute_weight * cost_attributes;
+					if (cost < collapse_costs[vertex])
+					{
+						collapse_costs[vertex]		= cost;
+						collapse_targets[vertex]	= target;
+					}
+				}
+			}
+
+			collapse_order.clear();
+			for (uint32_t i = 0; i < vertex_count; i++)
+			{
+				// Seams are collapsed through the sibling with the lower index
+				if (collapse_targets[i] != invalid_index && (kinds[i] != Vertex_Seam || i < siblings[i]))
+				{
+					collapse_order.emplace_back(i);
+				}
+			}
+			sort(collapse_order.begin(), collapse_order.end(), [&collapse_costs](const uint32_t a, const uint32_t b) { return collapse_costs[a] < collapse_costs[b]; });
+			if (collapse_order.empty())
+			{
+				lods->push_back({ result, static_cast<float>(sqrt(error_max)) * extent });
+				break;
+			}
+
+			// Only the cheapest collapses (about as many as needed to reach the target) are considered, a pass can run out of
+			// independent cheap collapses and it shouldn't make up for that with expensive ones, the next pass will have new cheap ones.
+			const uint32_t collapse_goal	= max((triangle_count - target_index_count / 3) / 2, 1u);
+			const double cost_limit			= collapse_costs[collapse_order[min(collapse_goal, static_cast<uint32_t>(collapse_order.size())) - 1]] * 1.5 + numeric_limits<float>::epsilon();
+
+			// Collapse
+			for (uint32_t i = 0; i < vertex_count; i++)
+			{
+				remap[i] = i;
+			}
+			fill(touched.begin(), touched.end(), static_cast<uint8_t>(0));
+			uint32_t triangles_removed	= 0;
+			uint32_t collapse_count		= 0;
+			for (const uint32_t vertex : collapse_order)
+			{
+				if (triangle_count - triangles_removed <= target_index_count / 3)
+					break;
+
+				if (collapse_costs[vertex] > cost_limit && collapse_count > 0)
+					break;
+
+				const uint32_t target			= collapse_targets[vertex];
+				const uint32_t position_vertex	= position_remap[vertex];
+				const uint32_t position_target	= position_remap[target];
+				if (touched[position_vertex] || touched[position_target])
+					continue;
+
+				const double error = quadrics[position_vertex].Error(positions[position_target]);
+				if (error > error_limit)
+					continue;
+
+				// The triangles that the collapse removes and the ones it moves
+				uint32_t removed	= 0;
+				bool flipped		= false;
+				for (uint32_t j = adjacency_offsets[position_vertex]; j < adjacency_offsets[position_vertex + 1] && !flipped; j++)
+				{
+					const uint32_t* triangle = &result[adjacency[j] * 3];
+					uint32_t corners[3];
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						corners[k] = position_remap[triangle[k]];
+					}
+
+					if (corners[0] == position_target || corners[1] == position_target || corners[2] == position_target)
+					{
+						removed++;
+						continue;
+					}
+
+					const Vector3 normal_before = Vector3::Cross(positions[corners[1]] - positions[corners[0]], positions[corners[2]] - positions[corners[0]]);
+					for (uint32_t& corner : corners)
+					{
+						corner = corner == position_vertex ? position_target : corner;
+					}
+					const Vector3 normal_after = Vector3::Cross(positions[corners[1]] - positions[corners[0]], positions[corners[2]] - positions[corners[0]]);
+
+					const float length_before	= normal_before.Length();
+					const float length_after	= normal_after.Length();
+					if (length_before > 0.0f)
+					{
+						flipped = length_after == 0.0f || Vector3::Dot(normal_before, normal_after) < flip_threshold * length_before * length_after;
+					}
+				}
+				if (flipped || removed == 0)
+					continue;
+
+				// Link condition, the edge's endpoints may only share the neighbours of the triangles being removed,
+				// otherwise the collapse would fold the surface onto itself.
+				mark += 2;
+				for (uint32_t j = adjacency_offsets[position_vertex]; j < adjacency_offsets[position_vertex + 1]; j++)
+				{
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						marks[position_remap[result[adjacency[j] * 3 + k]]] = mark;
+					}
+				}
+				uint32_t shared = 0;
+				for (uint32_t j = adjacency_offsets[position_target]; j < adjacency_offsets[position_target + 1]; j++)
+				{
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						const uint32_t neighbour = position_remap[result[adjacency[j] * 3 + k]];
+						if (neighbour != position_vertex && neighbour != position_target && marks[neighbour] == mark)
+						{
+							marks[neighbour] = mark + 1;
+							shared++;
+						}
+					}
+				}
+				if (shared != removed)
+					continue;
+
+				// Collapse
+				remap[vertex] = target;
+				if (kinds[vertex] == Vertex_Seam)
+				{
+					remap[siblings[vertex]] = seam_target(vertex, target);
+				}
+				quadrics[position_target].Add(quadrics[position_vertex]);
+				error_max			= max(error_max, error);
+				triangles_removed	+= removed;
+				collapse_count++;
+
+				// Everything around the collapse waits for the next pass, as its cost and validity have changed
+				touched[position_target] = 1;
+				for (uint32_t j = adjacency_offsets[position_vertex]; j < adjacency_offsets[position_vertex + 1]; j++)
+				{
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						touched[position_remap[result[adjacency[j] * 3 + k]]] = 1;
+					}
+				}
+			}
+
+			if (collapse_count == 0)
+			{
+				lods->push_back({ result, static_cast<float>(sqrt(error_max)) * extent });
+				break;
+			}
+
+			// Apply the collapses and drop the triangles that they made degenerate
+			size_t write = 0;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				const uint32_t a = remap[result[i + 0]];
+				const uint32_t b = remap[result[i + 1]];
+				const uint32_t c = remap[result[i + 2]];
+				if (position_remap[a] != position_remap[b] && position_remap[b] != position_remap[c] && position_remap[c] != position_remap[a])
+				{
+					result[write++] = a;
+					result[write++] = b;
+					result[write++] = c;
+				}
+			}
+			result.resize(write);
+		}
+	}
+
+	static bool validate(const vector<uint32_t>& indices, const vector<Spartan::RHI_Vertex_PosTexNorTan>& vertices)
+	{
+		if (indices.empty() || indices.size() % 3 != 0 || vertices.empty())
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return false;
+		}
+
+		for (const uint32_t index : indices)
+		{
+			if (index >= static_cast<uint32_t>(vertices.size()))
+			{
+				LOG_ERROR("Index %d is out of range, the mesh won't be simplified", index);
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+namespace Spartan
+{
+	float MeshSimplifier::Simplify(const vector<uint32_t>& indices, const vector<RHI_Vertex_PosTexNorTan>& vertices, const uint32_t target_index_count, const float max_error, vector<uint32_t>* indices_simplified)
+	{
+		if (!indices_simplified)
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return 0.0f;
+		}
+
+		*indices_simplified = indices;
+		if (!_MeshSimplifier::validate(indices, vertices))
+			return 0.0f;
+
+		vector<MeshSimplifier_Lod> lods;
+		_MeshSimplifier::simplify(indices, vertices, { target_index_count }, max_error, &lods);
+		if (lods.empty())
+			return 0.0f;
+
+		*indices_simplified = move(lods.front().indices);
+		return lods.front().error;
+	}
+
+	vector<MeshSimplifier_Lod> MeshSimplifier::GenerateLods(const vector<uint32_t>& indices, const vector<RHI_Vertex_PosTexNorTan>& vertices, const uint32_t lod_count_max /*= 4*/, const uint32_t triangle_count_min /*= 64*/)
+	{
+		vector<MeshSimplifier_Lod> lods;
+		if (!_MeshSimplifier::validate(indices, vertices))
+			return lods;
+
+		// Each level halves the triangles of the previous one
+		vector<uint32_t> target_index_counts;
+		auto index_count = static_cast<uint32_t>(indices.size());
+		while (target_index_counts.size() < lod_count_max && (index_count / 6) >= triangle_count_min)
+		{
+			index_count = (index_count / 6) * 3;
+			target_index_counts.emplace_back(index_count);
+		}
+		if (target_index_counts.empty())
+			return lods;
+
+		// The levels are simplified progressively, one from the other, while the quadrics keep accumulating
+		// so that the error of each level is still measured against the full detail mesh.
+		_MeshSimplifier::simplify(indices, vertices, target_index_counts, numeric_limits<float>::max(), &lods);
+
+		// Drop the levels that simplification stalled on, what's left of them is mostly locked seams or borders
+		auto index_count_previous = static_cast<uint32_t>(indices.size());
+		for (uint32_t i = 0; i < static_cast<uint32_t>(lods.size()); i++)
+		{
+			if (lods[i].indices.empty() || lods[i].indices.size() > index_count_previous * 9 / 10)
+			{
+				lods.resize(i);
+				break;
+			}
+
+			index_count_previous = static_cast<uint32_t>(lods[i].indices.size());
+			MeshOptimizer::OptimizeVertexCache(&lods[i].indices, static_cast<uint32_t>(vertices.size()));
+		}
+
+		return lods;
+	}
+}
@@ -0,0 +1,68 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <cstdint>
+#include "../../Core/EngineDefs.h"
+//================================
+
+namespace Spartan
+{
+	struct RHI_Vertex_PosTexNorTan;
+
+	// A simplified version of a triangle list, it references the same vertices
+	struct MeshSimplifier_Lod
+	{
+		std::vector<uint32_t> indices;
+		float error = 0.0f; // object space distance from the original surface
+	};
+
+	// Simplifies triangle lists with quadric error metrics (Garland & Heckbert 1997). Collapses happen along existing edges and onto
+	// existing vertices (half edge collapses), so no vertices are created and every level of detail can share the original vertex buffer.
+	// - Borders only collapse along themselves, so that meshes don't shrink away from their holes.
+	// - UV/normal seams collapse in pairs, so that they don't tear, vertices where more than two attribute sets meet stay where they are.
+	// - Texture coordinates and normals add to the cost of a collapse, so that the ones that preserve shading happen first.
+	class SPARTAN_CLASS MeshSimplifier
+	{
+	public:
+		// Returns the error of the simplified mesh. If reaching the target would exceed max_error (object space distance), simplification stops short of it.
+		static float Simplify(
+			const std::vector<uint32_t>& indices,
+			const std::vector<RHI_Vertex_PosTexNorTan>& vertices,
+			uint32_t target_index_count,
+			float max_error,
+			std::vector<uint32_t>* indices_simplified
+		);
+
+		// A chain of levels of detail, each with roughly half the triangles of the previous one and optimized for the vertex cache.
+		// The chain ends early when a mesh is too small, or when it can't be simplified any further.
+		static std::vector<MeshSimplifier_Lod> GenerateLods(
+			const std::vector<uint32_t>& indices,
+			const std::vector<RHI_Vertex_PosTexNorTan>& vertices,
+			uint32_t lod_count_max		= 4,
+			uint32_t triangle_count_min	= 64
+		);
+	};
+}
@@ -0,0 +1,169 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+//= INCLUDES ======================
+#include "MeshletBuilder.h"
+#include <cmath>
+#include "../../Math/Vector3.h"
+#include "../../RHI/RHI_Vertex.h"
+#include "../../Rendering/Model.h"
+//=================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Spartan::Math;
+//=============================
+
+namespace _MeshletBuilder
+{
+	static const float cone_spread_min = 0.1f; // meshlets whose normals are further apart than ~84 degrees from the axis never face away as a whole
+
+	static Vector3 position(const Spartan::RHI_Vertex_PosTexNorTan& vertex)
+	{
+		return Vector3(vertex.pos[0], vertex.pos[1], vertex.pos[2]);
+	}
+}
+
+namespace Spartan
+{
+	void MeshletBuilder::Build(const vector<uint32_t>& indices, const vector<RHI_Vertex_PosTexNorTan>& vertices, vector<Model_Meshlet>* meshlets)
+	{
+		meshlets->clear();
+		if (indices.empty() || vertices.empty())
+			return;
+
+		// The meshlet that each vertex was last added to, so that shared vertices are only counted once
+		vector<uint32_t> vertex_meshlet(vertices.size(), 0xffffffff);
+
+		Model_Meshlet meshlet;
+		uint32_t vertex_count = 0;
+		const auto finish = [&indices, &vertices, &meshlets, &meshlet, &vertex_count]()
+		{
+			if (meshlet.index_count == 0)
+				return;
+
+			ComputeBounds(indices, vertices, &meshlet);
+			meshlets->emplace_back(meshlet);
+
+			meshlet.index_offset	+= meshlet.index_count;
+			meshlet.index_count		= 0;
+			vertex_count			= 0;
+		};
+
+		// The vertices a triangle would add to the current meshlet
+		const auto count_new_vertices = [&indices, &vertex_meshlet, &meshlets](const uint32_t i)
+		{
+			const auto meshlet_index	= static_cast<uint32_t>(meshlets->size());
+			const uint32_t a			= indices[i + 0];
+			const uint32_t b			= indices[i + 1];
+			const uint32_t c			= indices[i + 2];
+			return
+				static_cast<uint32_t>(vertex_meshlet[a] != meshlet_index) +
+				static_cast<uint32_t>(vertex_meshlet[b] != meshlet_index && b != a) +
+				static_cast<uint32_t>(vertex_meshlet[c] != meshlet_index && c != a && c != b);
+		};
+
+		for (uint32_t i = 0; i + 2 < static_cast<uint32_t>(indices.size()); i += 3)
+		{
+			// Start a new meshlet if this one is full
+			uint32_t vertex_count_new = count_new_vertices(i);
+			if (vertex_count + vertex_count_new > vertex_count_max || meshlet.index_count / 3 >= triangle_count_max)
+			{
+				finish();
+				vertex_count_new = count_new_vertices(i);
+			}
+
+			const auto meshlet_index = static_cast<uint32_t>(meshlets->size());
+			vertex_meshlet[indices[i + 0]] = meshlet_index;
+			vertex_meshlet[indices[i + 1]] = meshlet_index;
+			vertex_meshlet[indices[i + 2]] = meshlet_index;
+			vertex_count		+= vertex_count_new;
+			meshlet.index_count	+= 3;
+		}
+
+		finish();
+	}
+
+	void MeshletBuilder::ComputeBounds(const vector<uint32_t>& indices, const vector<RHI_Vertex_PosTexNorTan>& vertices, Model_Meshlet* meshlet)
+	{
+		const uint32_t index_start	= meshlet->index_offset;
+		const uint32_t index_end	= meshlet->index_offset + meshlet->index_count;
+
+		// Bounding sphere, centered on the bounding box
+		Vector3 min = Vector3::Infinity;
+		Vector3 max = Vector3::InfinityNeg;
+		for (uint32_t i = index_start; i < index_end; i++)
+		{
+			const Vector3 position = _MeshletBuilder::position(vertices[indices[i]]);
+			min = Vector3(Min(min.x, position.x), Min(min.y, position.y), Min(min.z, position.z));
+			max = Vector3(Max(max.x, position.x), Max(max.y, position.y), Max(max.z, position.z));
+		}
+
+		meshlet->center	= (min + max) * 0.5f;
+		meshlet->radius	= 0.0f;
+		for (uint32_t i = index_start; i < index_end; i++)
+		{
+			meshlet->radius = Max(meshlet->radius, Vector3::Distance(meshlet->center, _MeshletBuilder::position(vertices[indices[i]])));
+		}
+
+		// Normal cone, the average of the triangle normals and the cosine of the angle (to the axis) beyond which all of them face away.
+		// Triangles are clockwise in a left handed system, so these normals point towards the front face.
+		Vector3 normal_sum = Vector3::Zero;
+		for (uint32_t i = index_start; i + 2 < index_end; i += 3)
+		{
+			const Vector3 p0		= _MeshletBuilder::position(vertices[indices[i + 0]]);
+			const Vector3 normal	= Vector3::Cross(_MeshletBuilder::position(vertices[indices[i + 1]]) - p0, _MeshletBuilder::position(vertices[indices[i + 2]]) - p0);
+			const float length		= normal.Length();
+			if (length > 0.0f)
+			{
+				normal_sum += normal / length;
+			}
+		}
+
+		// A cutoff of 1 never culls
+		meshlet->cone_axis		= Vector3::Zero;
+		meshlet->cone_cutoff	= 1.0f;
+
+		const float normal_sum_length = normal_sum.Length();
+		if (normal_sum_length <= 0.0f)
+			return;
+
+		const Vector3 axis	= normal_sum / normal_sum_length;
+		float dot_min		= 1.0f;
+		for (uint32_t i = index_start; i + 2 < index_end; i += 3)
+		{
+			const Vector3 p0		= _MeshletBuilder::position(vertices[indices[i + 0]]);
+			const Vector3 normal	= Vector3::Cross(_MeshletBuilder::position(vertices[indices[i + 1]]) - p0, _MeshletBuilder::position(vertices[indices[i + 2]]) - p0);
+			const float length		= normal.Length();
+			if (length > 0.0f)
+			{
+				dot_min = Min(dot_min, Vector3::Dot(normal / length, axis));
+			}
+		}
+
+		if (dot_min <= _MeshletBuilder::cone_spread_min)
+			return;
+
+		meshlet->cone_axis		= axis;
+		meshlet->cone_cutoff	= sqrt(1.0f - dot_min * dot_min);
+	}
+}
@@ -0,0 +1,59 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+//= INCLUDES =====================
+#include <vector>
+#include <cstdint>
+#include "../../Core/EngineDefs.h"
+//================================
+
+namespace Spartan
+{
+	struct RHI_Vertex_PosTexNorTan;
+	struct Model_Meshlet;
+
+	// Splits triangle lists into meshlets (small clusters of triangles) with the data needed to cull them individually.
+	// Triangles are taken in the order they come in, so a meshlet is a contiguous range of the indices, and an index buffer
+	// that has been optimized for the vertex cache (which keeps neighbouring triangles together) makes for compact meshlets.
+	class SPARTAN_CLASS MeshletBuilder
+	{
+	public:
+		static constexpr uint32_t vertex_count_max		= 64;
+		static constexpr uint32_t triangle_count_max	= 124;
+
+		// The index offsets of the meshlets are relative to the start of indices
+		static void Build(
+			const std::vector<uint32_t>& indices,
+			const std::vector<RHI_Vertex_PosTexNorTan>& vertices,
+			std::vector<Model_Meshlet>* meshlets
+		);
+
+		// Computes the bounding sphere and the normal cone of a range of indices
+		static void ComputeBounds(
+			const std::vector<uint32_t>& indices,
+			const std::vector<RHI_Vertex_PosTexNorTan>& vertices,
+			Model_Meshlet* meshlet
+		);
+	};
+}
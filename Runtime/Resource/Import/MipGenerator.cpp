@@ -0,0 +1,462 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =========================
+#include "MipGenerator.h"
+#include <vector>
+#include <mutex>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <xmmintrin.h>
+#include "../../Threading/Threading.h"
+#include "../../RHI/RHI_Texture.h"
+#include "../../RHI/RHI_TextureMips.h"
+#include "../../Math/MathHelper.h"
+//====================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan;
+using namespace Spartan::Math;
+//============================
+
+namespace _MipGenerator
+{
+	static const float gamma = 2.2f; // same as the renderer's default, so degamma() in the shaders is the inverse
+
+	// For every destination pixel, tap_count source indices (clamped to the edge) and normalized weights
+	struct FilterTable
+	{
+		uint32_t tap_count = 0;
+		vector<uint32_t> indices;
+		vector<float> weights;
+	};
+
+	static float Sinc(float x)
+	{
+		if (fabs(x) < 1e-4f)
+			return 1.0f;
+
+		x *= PI;
+		return sin(x) / x;
+	}
+
+	static float Bessel0(const float x)
+	{
+		// Power series, converges quickly for the small arguments we use
+		float sum	= 1.0f;
+		float term	= 1.0f;
+		for (uint32_t i = 1; i < 32; i++)
+		{
+			term	*= (x * 0.5f / i) * (x * 0.5f / i);
+			sum		+= term;
+			if (term < sum * 1e-7f)
+				break;
+		}
+		return sum;
+	}
+
+	// Radius in destination pixels
+	static float GetRadius(const RHI_Texture_Mip_Filter filter)
+	{
+		switch (filter)
+		{
+			case RHI_Texture_Mip_Filter_Box:		return 0.5f;
+			case RHI_Texture_Mip_Filter_Kaiser:		return 3.0f;
+			case RHI_Texture_Mip_Filter_Lanczos:	return 3.0f;
+			default:								return 0.5f;
+		}
+	}
+
+	static float Evaluate(const RHI_Texture_Mip_Filter filter, const float x)
+	{
+		const float radius = GetRadius(filter);
+		if (fabs(x) > radius)
+			return 0.0f;
+
+		if (filter == RHI_Texture_Mip_Filter_Kaiser)
+		{
+			static const float alpha = 4.0f;
+			const float t = x / radius;
+			return Sinc(x) * Bessel0(alpha * sqrt(1.0f - t * t)) / Bessel0(alpha);
+		}
+
+		if (filter == RHI_Texture_Mip_Filter_Lanczos)
+			return Sinc(x) * Sinc(x / radius);
+
+		return 1.0f;
+	}
+
+	static FilterTable BuildTable(const RHI_Texture_Mip_Filter filter, const uint32_t source_size, const uint32_t destination_size)
+	{
+		const float scale	= static_cast<float>(source_size) / static_cast<float>(destination_size);
+		const float radius	= GetRadius(filter) * scale; // in source pixels
+
+		FilterTable table;
+		table.tap_count = static_cast<uint32_t>(ceil(radius * 2.0f)) + 1;
+		table.indices.resize(static_cast<size_t>(destination_size) * table.tap_count);
+		table.weights.resize(static_cast<size_t>(destination_size) * table.tap_count);
+
+		for (uint32_t i = 0; i < destination_size; i++)
+		{
+			const float center	= (i + 0.5f) * scale;
+			const int first		= static_cast<int>(floor(center - radius));
+			const size_t offset	= static_cast<size_t>(i) * table.tap_count;
+
+			float sum = 0.0f;
+			for (uint32_t k = 0; k < table.tap_count; k++)
+			{
+				const int j					= first + static_cast<int>(k);
+				const float weight			= Evaluate(filter, (j + 0.5f - center) / scale);
+				table.indices[offset + k]	= static_cast<uint32_t>(Clamp(j, 0, static_cast<int>(source_size) - 1));
+				table.weights[offset + k]	= weight;
+				sum							+= weight;
+			}
+
+			if (sum != 0.0f)
+			{
+				for (uint32_t k = 0; k < table.tap_count; k++) { table.weights[offset + k] /= sum; }
+			}
+		}
+
+		return table;
+	}
+
+	// Filters a row horizontally (pixels are gathered, so four channels go through a single SSE register)
+	static void FilterRow(const FilterTable& table, const float* source, float* destination, const uint32_t width, const uint32_t channels)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			const uint32_t* indices	= &table.indices[static_cast<size_t>(x) * table.tap_count];
+			const float* weights	= &table.weights[static_cast<size_t>(x) * table.tap_count];
+
+			if (channels == 4)
+			{
+				__m128 sum = _mm_setzero_ps();
+				for (uint32_t k = 0; k < table.tap_count; k++)
+				{
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(source + indices[k] * 4), _mm_set1_ps(weights[k])));
+				}
+				_mm_storeu_ps(destination + x * 4, sum);
+			}
+			else
+			{
+				for (uint32_t c = 0; c < channels; c++)
+				{
+					float sum = 0.0f;
+					for (uint32_t k = 0; k < table.tap_count; k++) { sum += source[indices[k] * channels + c] * weights[k]; }
+					destination[x * channels + c] = sum;
+				}
+			}
+		}
+	}
+
+	// Filters a row vertically, as a weighted sum of whole source rows (contiguous, so it vectorizes regardless of the channel count).
+	// The source rows are kept in a ring buffer, source row i is in slot i % ring_count.
+	static void FilterColumn(const FilterTable& table, const float* ring, const uint32_t ring_count, float* destination, const uint32_t y, const size_t row_size)
+	{
+		const uint32_t* indices	= &table.indices[static_cast<size_t>(y) * table.tap_count];
+		const float* weights	= &table.weights[static_cast<size_t>(y) * table.tap_count];
+
+		memset(destination, 0, row_size * sizeof(float));
+		for (uint32_t k = 0; k < table.tap_count; k++)
+		{
+			if (weights[k] == 0.0f)
+				continue;
+
+			const float* row	= ring + (indices[k] % ring_count) * row_size;
+			const __m128 weight	= _mm_set1_ps(weights[k]);
+
+			size_t i = 0;
+			for (; i + 4 <= row_size; i += 4)
+			{
+				_mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), _mm_mul_ps(_mm_loadu_ps(row + i), weight)));
+			}
+			for (; i < row_size; i++)
+			{
+				destination[i] += row[i] * weights[k];
+			}
+		}
+	}
+
+	// Decodes a row of the first mip to linear floats
+	static void DecodeRow(const std::byte* source, float* destination, const size_t count, const uint32_t channels, const uint32_t bpc, const bool srgb, const float* srgb_to_linear)
+	{
+		if (bpc == 32)
+		{
+			memcpy(destination, source, count * sizeof(float));
+			return;
+		}
+
+		const auto bytes = reinterpret_cast<const uint8_t*>(source);
+		for (size_t i = 0; i < count; i++)
+		{
+			const uint32_t channel	= i % channels;
+			destination[i]			= (srgb && channel < 3) ? srgb_to_linear[bytes[i]] : bytes[i] / 255.0f;
+		}
+	}
+
+	static void RenormalizeNormals(float* data, const size_t pixel_count, const uint32_t channels)
+	{
+		for (size_t i = 0; i < pixel_count; i++)
+		{
+			float* pixel	= data + i * channels;
+			const float x	= pixel[0] * 2.0f - 1.0f;
+			const float y	= pixel[1] * 2.0f - 1.0f;
+			const float z	= pixel[2] * 2.0f - 1.0f;
+			const float length = sqrt(x * x + y * y + z * z);
+			if (length > 0.0f)
+			{
+				pixel[0] = (x / length) * 0.5f + 0.5f;
+				pixel[1] = (y / length) * 0.5f + 0.5f;
+				pixel[2] = (z / length) * 0.5f + 0.5f;
+			}
+		}
+	}
+
+	static const uint32_t alpha_bin_count = 4096;
+
+	static void AccumulateAlpha(const float* data, const size_t pixel_count, const uint32_t channels, uint32_t* histogram)
+	{
+		for (size_t i = 0; i < pixel_count; i++)
+		{
+			const float alpha = Saturate(data[i * channels + 3]);
+			histogram[Min(static_cast<uint32_t>(alpha * alpha_bin_count), alpha_bin_count - 1)]++;
+		}
+	}
+
+	// Returns the alpha value above which the given fraction of pixels lies
+	static float FindAlphaQuantile(const vector<uint32_t>& histogram, const size_t pixel_count, const float coverage)
+	{
+		const auto target	= static_cast<size_t>(coverage * pixel_count);
+		size_t count		= 0;
+		for (uint32_t bin = alpha_bin_count; bin-- > 0;)
+		{
+			const size_t count_above = count;
+			count += histogram[bin];
+			if (count >= target)
+			{
+				// Include this bin only if that gets closer to the target
+				const bool include = (count - target) <= (target - count_above);
+				return static_cast<float>(include ? bin : bin + 1) / alpha_bin_count;
+			}
+		}
+
+		return 0.0f;
+	}
+
+	// Encodes a row of linear floats into a mip
+	static void EncodeRow(const float* source, std::byte* destination, const size_t count, const uint32_t channels, const uint32_t bpc, const bool srgb, const uint8_t* linear_to_srgb)
+	{
+		if (bpc == 32)
+		{
+			memcpy(destination, source, count * sizeof(float));
+			return;
+		}
+
+		auto bytes = reinterpret_cast<uint8_t*>(destination);
+		for (size_t i = 0; i < count; i++)
+		{
+			const uint32_t channel	= i % channels;
+			const float value		= Saturate(source[i]);
+			bytes[i]				= (srgb && channel < 3) ? linear_to_srgb[static_cast<uint32_t>(value * 4095.0f + 0.5f)] : static_cast<uint8_t>(value * 255.0f + 0.5f);
+		}
+	}
+
+	// Scales the alpha of an encoded mip (four channels), to preserve coverage
+	static void ScaleAlpha(const Span<std::byte>& mip, const size_t pixel_count, const uint32_t bpc, const float alpha_scale)
+	{
+		if (bpc == 32)
+		{
+			auto floats = reinterpret_cast<float*>(mip.data());
+			for (size_t i = 0; i < pixel_count; i++) { floats[i * 4 + 3] = Saturate(floats[i * 4 + 3] * alpha_scale); }
+			return;
+		}
+
+		auto bytes = reinterpret_cast<uint8_t*>(mip.data());
+		for (size_t i = 0; i < pixel_count; i++) { bytes[i * 4 + 3] = static_cast<uint8_t>(Saturate(bytes[i * 4 + 3] / 255.0f * alpha_scale) * 255.0f + 0.5f); }
+	}
+}
+
+namespace Spartan
+{
+	bool MipGenerator::Generate(Threading* threading, const RHI_Texture* texture, RHI_TextureMips* mips, uint32_t width, uint32_t height, const uint32_t channels, const uint32_t bpc)
+	{
+		if (!threading || !texture || !mips || mips->IsEmpty() || width == 0 || height == 0 || channels == 0 || (bpc != 8 && bpc != 32))
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return false;
+		}
+
+		const auto filter		= texture->GetMipFilter();
+		const bool srgb			= texture->IsSrgb() && bpc == 8;
+		const bool normal_map	= texture->IsNormalMap() && channels >= 3;
+		const float threshold	= channels == 4 ? texture->GetAlphaCoverageThreshold() : 0.0f;
+		const auto mip_0		= mips->GetMip(0).data();
+
+		// Conversion tables
+		float srgb_to_linear[256];
+		uint8_t linear_to_srgb[4096];
+		if (srgb)
+		{
+			for (uint32_t i = 0; i < 256; i++)	{ srgb_to_linear[i] = pow(i / 255.0f, _MipGenerator::gamma); }
+			for (uint32_t i = 0; i < 4096; i++)	{ linear_to_srgb[i] = static_cast<uint8_t>(pow(i / 4095.0f, 1.0f / _MipGenerator::gamma) * 255.0f + 0.5f); }
+		}
+
+		// Alpha test coverage of the first mip, which the rest should match
+		float coverage = 0.0f;
+		if (threshold > 0.0f)
+		{
+			const size_t pixel_count = static_cast<size_t>(width) * height;
+			size_t covered = 0;
+			for (size_t i = 0; i < pixel_count; i++)
+			{
+				const float alpha = (bpc == 32) ? reinterpret_cast<const float*>(mip_0)[i * 4 + 3] : static_cast<uint8_t>(mip_0[i * 4 + 3]) / 255.0f;
+				covered += alpha > threshold ? 1 : 0;
+			}
+			coverage = static_cast<float>(covered) / pixel_count;
+		}
+
+		// Every level is read from the previous mip and written to its own mip one row at a time, so no level is ever expanded as a whole.
+		// Each thread filters the source rows horizontally into a ring buffer, which holds the rows that its current output row needs.
+		// Alpha is scaled once the next level has been read from the mip, so that the chain itself stays unscaled.
+		uint32_t mip_index		= 0;
+		float alpha_scale		= 1.0f;
+		mutex histogram_mutex;
+		vector<uint32_t> histogram;
+		while ((width > 1 || height > 1) && mip_index + 1 < mips->GetCount())
+		{
+			const uint32_t mip_width	= Max(width / 2, static_cast<uint32_t>(1));
+			const uint32_t mip_height	= Max(height / 2, static_cast<uint32_t>(1));
+			const size_t source_row		= static_cast<size_t>(width) * channels;
+			const size_t row			= static_cast<size_t>(mip_width) * channels;
+			const size_t pixel_count	= static_cast<size_t>(mip_width) * mip_height;
+			const bool preserve_alpha	= threshold > 0.0f && coverage > 0.0f;
+
+			const auto source	= mips->GetMip(mip_index);
+			const auto mip		= mips->GetMip(mip_index + 1);
+			if (mip.size() != pixel_count * channels * (bpc / 8))
+			{
+				LOG_ERROR("Mip %d has an unexpected size", mip_index + 1);
+				return false;
+			}
+
+			const auto table_x			= _MipGenerator::BuildTable(filter, width, mip_width);
+			const auto table_y			= _MipGenerator::BuildTable(filter, height, mip_height);
+			const bool filter_x			= width != mip_width;
+			const bool filter_y			= height != mip_height;
+			const uint32_t ring_count	= filter_y ? table_y.tap_count : 1;
+			histogram.assign(preserve_alpha ? _MipGenerator::alpha_bin_count : 0, 0);
+
+			threading->Loop([&](uint32_t start, uint32_t end)
+			{
+				vector<float> decoded(source_row);
+				vector<float> ring(ring_count * row);
+				vector<uint32_t> ring_rows(ring_count, numeric_limits<uint32_t>::max()); // the source row in each slot
+				vector<float> output(filter_y ? row : 0);
+				vector<uint32_t> histogram_local(histogram.size(), 0);
+
+				// Decodes a source row and filters it horizontally into its slot, unless it's there already
+				const auto acquire_row = [&](const uint32_t y)
+				{
+					const uint32_t slot = y % ring_count;
+					if (ring_rows[slot] == y)
+						return &ring[slot * row];
+
+					_MipGenerator::DecodeRow(source.data() + y * source_row * (bpc / 8), decoded.data(), source_row, channels, bpc, srgb, srgb_to_linear);
+					if (filter_x)
+					{
+						_MipGenerator::FilterRow(table_x, decoded.data(), &ring[slot * row], mip_width, channels);
+					}
+					else
+					{
+						memcpy(&ring[slot * row], decoded.data(), row * sizeof(float));
+					}
+					ring_rows[slot] = y;
+					return &ring[slot * row];
+				};
+
+				for (uint32_t y = start; y < end; y++)
+				{
+					float* result = nullptr;
+					if (filter_y)
+					{
+						for (uint32_t k = 0; k < table_y.tap_count; k++)
+						{
+							acquire_row(table_y.indices[static_cast<size_t>(y) * table_y.tap_count + k]);
+						}
+						_MipGenerator::FilterColumn(table_y, ring.data(), ring_count, output.data(), y, row);
+						result = output.data();
+					}
+					else
+					{
+						result = acquire_row(y);
+					}
+
+					if (normal_map)
+					{
+						_MipGenerator::RenormalizeNormals(result, mip_width, channels);
+					}
+
+					if (preserve_alpha)
+					{
+						_MipGenerator::AccumulateAlpha(result, mip_width, channels, histogram_local.data());
+					}
+
+					_MipGenerator::EncodeRow(result, mip.data() + y * row * (bpc / 8), row, channels, bpc, srgb, linear_to_srgb);
+				}
+
+				if (preserve_alpha)
+				{
+					lock_guard<mutex> lock(histogram_mutex);
+					for (uint32_t i = 0; i < _MipGenerator::alpha_bin_count; i++) { histogram[i] += histogram_local[i]; }
+				}
+			}, mip_height);
+
+			// The source has been read, so it can be scaled now
+			if (alpha_scale != 1.0f)
+			{
+				_MipGenerator::ScaleAlpha(source, static_cast<size_t>(width) * height, bpc, alpha_scale);
+			}
+
+			// Scale alpha so that the same fraction of pixels passes the alpha test
+			alpha_scale = 1.0f;
+			if (preserve_alpha)
+			{
+				const float quantile	= _MipGenerator::FindAlphaQuantile(histogram, pixel_count, coverage);
+				alpha_scale				= quantile > 0.0f ? (threshold + 0.5f / 255.0f) / quantile : 1.0f; // half a step above, so 8-bit rounding doesn't land on the threshold
+			}
+
+			width	= mip_width;
+			height	= mip_height;
+			mip_index++;
+		}
+
+		// The last level isn't read by any other
+		if (alpha_scale != 1.0f)
+		{
+			_MipGenerator::ScaleAlpha(mips->GetMip(mip_index), static_cast<size_t>(width) * height, bpc, alpha_scale);
+		}
+
+		return true;
+	}
+}
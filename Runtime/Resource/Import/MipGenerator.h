@@ -0,0 +1,44 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <cstdint>
+#include "../../Core/EngineDefs.h"
+//================================
+
+namespace Spartan
+{
+	class Threading;
+	class RHI_Texture;
+	class RHI_TextureMips;
+
+	// Fills in the mip chain from the first mip (the import options are read from the texture). Every level is downsampled from the previous one 
+	// with a separable filter (box, Kaiser or Lanczos, see RHI_Texture::SetMipFilter), in linear space for sRGB 
+	// textures. Normal maps are renormalized per level and alpha test coverage can be preserved.
+	// Supports 8-bit and 32-bit float channels.
+	class SPARTAN_CLASS MipGenerator
+	{
+	public:
+		static bool Generate(Threading* threading, const RHI_Texture* texture, RHI_TextureMips* mips, uint32_t width, uint32_t height, uint32_t channels, uint32_t bpc);
+	};
+}
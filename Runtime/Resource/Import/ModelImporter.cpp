@@ -21,13 +21,19 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =================================
 #include "ModelImporter.h"
+#include <map>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/version.h>
 #include "AssimpHelper.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
 #include "../ProgressReport.h"
-#include "../../RHI/RHI_Texture.h"
+#include "../../RHI/RHI_Texture2D.h"
+#include "../../RHI/RHI_Vertex.h"
 #include "../../Core/Settings.h"
+#include "../../Threading/Threading.h"
 #include "../../Rendering/Model.h"
 #include "../../Rendering/Animation.h"
 #include "../../Rendering/Material.h"
@@ -43,6 +49,62 @@ using namespace Assimp;
 
 namespace Spartan
 {
+	// A mesh that a job has converted and optimized, it's added to the model once all jobs are done
+	struct ModelImporter_Mesh
+	{
+		vector<uint32_t> indices;
+		vector<RHI_Vertex_PosTexNorTan> vertices;
+		vector<MeshSimplifier_Lod> lods;
+		vector<Model_Meshlet> meshlets;
+		vector<Skinning_Weights> weights; // empty if the mesh is not skinned
+		BoundingBox aabb;
+		MeshOptimizer_Statistics statistics_before;
+		MeshOptimizer_Statistics statistics_after;
+		uint32_t index_offset	= 0;
+		uint32_t index_count	= 0;
+		uint32_t vertex_offset	= 0;
+		uint32_t vertex_count	= 0;
+	};
+
+	// A texture that a material uses, it's set to the material once all jobs are done (loading it is one of them)
+	struct ModelImporter_TextureSlot
+	{
+		shared_ptr<Material> material;
+		shared_ptr<RHI_Texture2D> texture;
+		TextureType type;
+		bool is_diffuse;
+		string file_path;
+	};
+
+	namespace _ModelImporter
+	{
+		static void set_texture(const ModelImporter_TextureSlot& slot)
+		{
+			slot.material->SetTextureSlot(slot.type, slot.texture);
+
+			if (slot.is_diffuse)
+			{
+				// FIX: materials that have a diffuse texture should not be tinted black/gray
+				slot.material->SetColorAlbedo(Vector4::One);
+			}
+
+			// Some models (or Assimp) pass a normal map as a height map
+			// auto textureType others pass a height map as a normal map, we try to fix that.
+			if (slot.type == TextureType_Normal || slot.type == TextureType_Height)
+			{
+				auto proper_type = slot.type;
+				proper_type = (proper_type == TextureType_Normal && slot.texture->GetGrayscale()) ? TextureType_Height : proper_type;
+				proper_type = (proper_type == TextureType_Height && !slot.texture->GetGrayscale()) ? TextureType_Normal : proper_type;
+
+				if (proper_type != slot.type)
+				{
+					slot.material->SetTextureSlot(slot.type, shared_ptr<RHI_Texture>());
+					slot.material->SetTextureSlot(proper_type, slot.texture);
+				}
+			}
+		}
+	}
+
 	ModelImporter::ModelImporter(Context* context)
 	{
 		m_context	= context;
@@ -98,7 +160,6 @@ namespace Spartan
             aiProcess_GenSmoothNormals |
             aiProcess_JoinIdenticalVertices |
             aiProcess_OptimizeMeshes |
-            aiProcess_ImproveCacheLocality |
             aiProcess_LimitBoneWeights |
             aiProcess_SplitLargeMeshes |
             aiProcess_Triangulate |
@@ -114,22 +175,132 @@ namespace Spartan
 		// Read the 3D model file from disk
 		if (const aiScene* scene = importer.ReadFile(file_path, importer_flags))
 		{
-			FIRE_EVENT(Event_World_Stop);
-
             params.scene            = scene;
             params.has_animation    = scene->mNumAnimations != 0;
 
+            // Skeleton, shared by all the skinned meshes
+            params.model->SetSkeleton(LoadSkeleton(params));
+            params.model->SetAnimated(params.model->GetSkeleton() != nullptr);
+
+            // Static geometry is stored quantized, animated geometry moves outside of its bounds so it stays at full precision
+            params.model->SetVertexQuantization(!params.has_animation && !params.model->GetSkeleton());
+
+            // Materials, one per Assimp material (the textures they use are gathered, so they can be loaded in parallel)
+            vector<shared_ptr<Material>> materials(scene->mNumMaterials);
+            vector<ModelImporter_TextureSlot> texture_slots;
+            for (uint32_t i = 0; i < scene->mNumMaterials; i++)
+            {
+                materials[i] = LoadMaterial(scene->mMaterials[i], params, &texture_slots);
+            }
+            params.materials = &materials;
+
+            // Textures, each file is loaded once, no matter how many materials use it (and not at all if it's already cached).
+            // A file is a single texture, so when it's used as more than one type, its import settings have to suit all of them.
+            vector<const ModelImporter_TextureSlot*> texture_loads;
+            {
+                map<string, shared_ptr<RHI_Texture2D>> textures;
+                for (auto& slot : texture_slots)
+                {
+                    auto& texture = textures[slot.file_path];
+                    if (!texture)
+                    {
+                        texture = params.model->AcquireTexture(slot.type, slot.file_path);
+                        if (texture->GetLoadState() == LoadState_Idle)
+                        {
+                            texture_loads.emplace_back(&slot);
+                        }
+                    }
+                    else if (texture->GetLoadState() == LoadState_Idle)
+                    {
+                        Model::ApplyTextureSettings(texture.get(), slot.type, true);
+                    }
+                    slot.texture = texture;
+                }
+            }
+
+            // Meshes, one per Assimp mesh (nodes that reference the same mesh share its geometry)
+            vector<ModelImporter_Mesh> meshes(scene->mNumMeshes);
+            params.meshes = &meshes;
+
+            // Update progress tracking
+            const auto texture_count    = static_cast<uint32_t>(texture_loads.size());
+            const auto mesh_count       = scene->mNumMeshes;
+            int node_count              = 0;
+            AssimpHelper::compute_node_count(scene->mRootNode, &node_count);
+            ProgressReport::Get().SetJobCount(g_progress_model_importer, static_cast<int>(texture_count + mesh_count) + node_count);
+            ProgressReport::Get().SetStatus(g_progress_model_importer, "Loading " + to_string(texture_count) + " textures and " + to_string(mesh_count) + " meshes");
+
+            // Load the textures and the meshes in parallel, textures go first as they tend to take the longest
+            const Skeleton* skeleton = params.model->GetSkeleton().get();
+            m_context->GetSubsystem<Threading>()->ForEach([this, &scene, &texture_loads, &meshes, texture_count, skeleton](const uint32_t i)
+            {
+                if (i < texture_count)
+                {
+                    // Save the native file here too, so that caching the texture later has nothing left to do
+                    const auto& slot = *texture_loads[i];
+                    if (slot.texture->LoadFromFile(slot.file_path) && slot.texture->SaveToFile(slot.texture->GetResourceFilePathNative()))
+                    {
+                        slot.texture->SetDirty(false);
+                    }
+                }
+                else
+                {
+                    LoadMesh(scene->mMeshes[i - texture_count], skeleton, &meshes[i - texture_count]);
+                }
+
+                ProgressReport::Get().IncrementJobsDone(g_progress_model_importer);
+            },
+            texture_count + mesh_count);
+
+            // This runs on a worker, keep the world from ticking until the model's entities are in place
+            const auto world_lock = m_world->Lock();
+
+            // Set the textures to the materials
+            for (const auto& slot : texture_slots)
+            {
+                _ModelImporter::set_texture(slot);
+            }
+
+            // Add the meshes to the model, in order
+            MeshOptimizer_Statistics statistics_before;
+            MeshOptimizer_Statistics statistics_after;
+            for (auto& mesh : meshes)
+            {
+                params.model->AppendGeometry(mesh.indices, mesh.vertices, &mesh.index_offset, &mesh.vertex_offset);
+
+                // Levels of detail, they share the mesh's vertices so only their indices are added
+                for (const auto& lod : mesh.lods)
+                {
+                    params.model->AppendLod(mesh.index_offset, lod.indices, lod.error);
+                }
+
+                if (!mesh.meshlets.empty())
+                {
+                    params.model->AppendMeshlets(mesh.index_offset, mesh.meshlets);
+                }
+
+                if (!mesh.weights.empty())
+                {
+                    params.model->AppendWeights(mesh.vertex_offset, mesh.weights);
+                }
+
+                statistics_before.Accumulate(mesh.statistics_before);
+                statistics_after.Accumulate(mesh.statistics_after);
+
+                // The model has its own copy now
+                mesh.indices    = vector<uint32_t>();
+                mesh.vertices   = vector<RHI_Vertex_PosTexNorTan>();
+                mesh.lods       = vector<MeshSimplifier_Lod>();
+                mesh.meshlets   = vector<Model_Meshlet>();
+                mesh.weights    = vector<Skinning_Weights>();
+            }
+
             // Create root entity to match Assimp's root node
             bool is_active = false;
             shared_ptr<Entity> new_entity = m_world->EntityCreate(is_active);
             new_entity->SetName(params.name); // Set custom name, which is more descriptive than "RootNode"
             params.model->SetRootEntity(new_entity);
 
-            // Update progress tracking
-            int job_count;
-            AssimpHelper::compute_node_count(scene->mRootNode, &job_count);
-            ProgressReport::Get().SetJobCount(g_progress_model_importer, job_count);
-
             // Parse all nodes, starting from the root node and continuing recursively
 			ParseNode(scene->mRootNode, params, nullptr, new_entity.get());
             // Parse animations
@@ -137,7 +308,11 @@ namespace Spartan
             // Update model geometry
 			model->UpdateGeometry();
 
-			FIRE_EVENT(Event_World_Start);
+            LOG_INFO("Optimized %d triangles, ACMR: %.3f -> %.3f, ATVR: %.3f -> %.3f",
+                statistics_after.triangle_count,
+                statistics_before.GetAcmr(), statistics_after.GetAcmr(),
+                statistics_before.GetAtvr(), statistics_after.GetAtvr()
+            );
 		}
 		else
 		{
@@ -200,8 +375,28 @@ namespace Spartan
             // Set entity name
             entity->SetName(_name);
 
-            // Process mesh
-            LoadMesh(assimp_mesh, entity, params);
+            // Add a renderable component to this entity, with the mesh's geometry
+            const auto& mesh = (*params.meshes)[assimp_node->mMeshes[i]];
+            auto renderable = entity->AddComponent<Renderable>();
+            renderable->GeometrySet(
+                entity->GetName(),
+                mesh.index_offset,
+                mesh.index_count,
+                mesh.vertex_offset,
+                mesh.vertex_count,
+                mesh.aabb,
+                params.model
+            );
+
+            // Material
+            if (assimp_mesh->mMaterialIndex < params.materials->size())
+            {
+                if (auto material = (*params.materials)[assimp_mesh->mMaterialIndex])
+                {
+                    params.model->AddMaterial(material, entity->GetPtrShared());
+                }
+            }
+
             entity->SetActive(true);
         }
     }
@@ -218,7 +413,7 @@ namespace Spartan
 			animation->SetDuration(assimp_animation->mDuration);
 			animation->SetTicksPerSec(assimp_animation->mTicksPerSecond != 0.0f ? assimp_animation->mTicksPerSecond : 25.0f);
 
-			// Animation channels
+			// Animation channels, they are compressed as they are added
 			for (uint32_t j = 0; j < static_cast<uint32_t>(assimp_animation->mNumChannels); j++)
 			{
 				const auto assimp_node_anim = assimp_animation->mChannels[j];
@@ -238,7 +433,7 @@ namespace Spartan
 				// Rotation keys
 				for (uint32_t k = 0; k < static_cast<uint32_t>(assimp_node_anim->mNumRotationKeys); k++)
 				{
-					const auto time = assimp_node_anim->mPositionKeys[k].mTime;
+					const auto time = assimp_node_anim->mRotationKeys[k].mTime;
 					const auto value = AssimpHelper::to_quaternion(assimp_node_anim->mRotationKeys[k].mValue);
 
 					animation_node.rotationFrames.emplace_back(KeyQuaternion{ time, value });
@@ -247,18 +442,63 @@ namespace Spartan
 				// Scaling keys
 				for (uint32_t k = 0; k < static_cast<uint32_t>(assimp_node_anim->mNumScalingKeys); k++)
 				{
-					const auto time = assimp_node_anim->mPositionKeys[k].mTime;
+					const auto time = assimp_node_anim->mScalingKeys[k].mTime;
 					const auto value = AssimpHelper::to_vector3(assimp_node_anim->mScalingKeys[k].mValue);
 
 					animation_node.scaleFrames.emplace_back(KeyVector{ time, value });
 				}
+
+				animation->AddChannel(animation_node);
 			}
+
+			params.model->AddAnimation(animation);
 		}
 	}
 
-	void ModelImporter::LoadMesh(aiMesh* assimp_mesh, Entity* entity_parent, const ModelParams& params)
+    shared_ptr<Skeleton> ModelImporter::LoadSkeleton(const ModelParams& params) const
+    {
+        bool has_bones = false;
+        for (uint32_t i = 0; i < params.scene->mNumMeshes; i++)
+        {
+            has_bones = has_bones || params.scene->mMeshes[i]->HasBones();
+        }
+
+        if (!has_bones)
+            return nullptr;
+
+        // Every node becomes a joint (depth first, so parents come before their children)
+        auto skeleton = make_shared<Skeleton>();
+        const function<void(const aiNode*, int32_t)> add_joints = [&skeleton, &add_joints](const aiNode* node, const int32_t parent)
+        {
+            const auto joint = static_cast<int32_t>(skeleton->AddJoint(node->mName.C_Str(), parent, AssimpHelper::ai_matrix4_x4_to_matrix(node->mTransformation)));
+            for (uint32_t i = 0; i < node->mNumChildren; i++)
+            {
+                add_joints(node->mChildren[i], joint);
+            }
+        };
+        add_joints(params.scene->mRootNode, -1);
+
+        // Bones are the joints that vertices are bound to, their offset takes vertices to the joint's space
+        for (uint32_t i = 0; i < params.scene->mNumMeshes; i++)
+        {
+            const aiMesh* assimp_mesh = params.scene->mMeshes[i];
+            for (uint32_t j = 0; j < assimp_mesh->mNumBones; j++)
+            {
+                const aiBone* bone = assimp_mesh->mBones[j];
+                const int32_t joint = skeleton->GetJointIndex(bone->mName.C_Str());
+                if (joint >= 0)
+                {
+                    skeleton->SetInverseBind(joint, AssimpHelper::ai_matrix4_x4_to_matrix(bone->mOffsetMatrix));
+                }
+            }
+        }
+
+        return skeleton;
+    }
+
+	void ModelImporter::LoadMesh(const aiMesh* assimp_mesh, const Skeleton* skeleton, ModelImporter_Mesh* mesh) const
 	{
-		if (!assimp_mesh || !entity_parent)
+		if (!assimp_mesh || !mesh)
 		{
 			LOG_ERROR_INVALID_PARAMETER();
 			return;
@@ -268,7 +508,8 @@ namespace Spartan
         const uint32_t index_count  = assimp_mesh->mNumFaces * 3;
 
 		// Vertices
-        vector<RHI_Vertex_PosTexNorTan> vertices = vector<RHI_Vertex_PosTexNorTan>(vertex_count);
+        auto& vertices = mesh->vertices;
+        vertices.resize(vertex_count);
 		{
 			for (uint32_t i = 0; i < vertex_count; i++)
 			{
@@ -310,7 +551,8 @@ namespace Spartan
 		}
 
 		// Indices
-		vector<uint32_t> indices = vector<uint32_t>(index_count);
+		auto& indices = mesh->indices;
+		indices.resize(index_count);
 		{
 			// Get indices by iterating through each face of the mesh.
 			for (uint32_t face_index = 0; face_index < assimp_mesh->mNumFaces; face_index++)
@@ -324,82 +566,88 @@ namespace Spartan
 			}
 		}
 
-		// Compute AABB (before doing move operation on vertices)
-		const auto aabb = BoundingBox(vertices);
-
-		// Add the mesh to the model
-		uint32_t index_offset;
-		uint32_t vertex_offset;
-        params.model->AppendGeometry(move(indices), move(vertices), &index_offset, &vertex_offset);
-
-		// Add a renderable component to this entity
-		auto renderable	= entity_parent->AddComponent<Renderable>();
-
-		// Set the geometry
-		renderable->GeometrySet(
-			entity_parent->GetName(),
-			index_offset,
-			static_cast<uint32_t>(indices.size()),
-			vertex_offset,
-			static_cast<uint32_t>(vertices.size()),
-			aabb,
-            params.model
-		);
-
-		// Material
-		if (params.scene->HasMaterials())
+		// Bones
+		LoadBones(assimp_mesh, skeleton, mesh);
+
+		// Optimize for the vertex cache, overdraw and vertex fetch (this also welds duplicate vertices)
+		if (mesh->weights.empty())
 		{
-			// Get aiMaterial
-			const auto assimp_material = params.scene->mMaterials[assimp_mesh->mMaterialIndex];
-			// Convert it and add it to the model
-            params.model->AddMaterial(LoadMaterial(assimp_material, params), entity_parent->GetPtrShared());
+			MeshOptimizer::Optimize(&indices, &vertices, &mesh->statistics_before, &mesh->statistics_after);
 		}
+		// Welding or reordering the vertices would separate them from their weights, so only the triangles of skinned meshes are reordered
+		else
+		{
+			mesh->statistics_before = MeshOptimizer::Analyze(indices, vertex_count);
+			MeshOptimizer::OptimizeVertexCache(&indices, vertex_count);
+			mesh->statistics_after	= MeshOptimizer::Analyze(indices, vertex_count);
+		}
+		mesh->index_count	= static_cast<uint32_t>(indices.size());
+		mesh->vertex_count	= static_cast<uint32_t>(vertices.size());
 
-		// Bones
-        LoadBones(assimp_mesh, params);
+		// Compute AABB
+		mesh->aabb = BoundingBox(vertices);
+
+		// Levels of detail
+		mesh->lods = MeshSimplifier::GenerateLods(indices, vertices);
+
+		// Meshlets, so that the parts of large meshes that can't be seen can be culled (small meshes are culled well enough as a whole).
+		// The bounds of skinned meshes move with their joints, so they don't have any.
+		if (indices.size() / 3 >= 8 * MeshletBuilder::triangle_count_max && mesh->weights.empty())
+		{
+			MeshletBuilder::Build(indices, vertices, &mesh->meshlets);
+		}
 	}
 
-    void ModelImporter::LoadBones(const aiMesh* assimp_mesh, const ModelParams& params)
+    void ModelImporter::LoadBones(const aiMesh* assimp_mesh, const Skeleton* skeleton, ModelImporter_Mesh* mesh) const
     {
-        // Maximum number of bones per mesh
-        // Must not be higher than same const in skinning shader
-        constexpr uint8_t MAX_BONES = 64;
-        // Maximum number of bones per vertex
-        constexpr uint8_t MAX_BONES_PER_VERTEX = 4;
-
-        //for (uint32_t i = 0; i < assimp_mesh->mNumBones; i++)
-        //{
-        //    uint32_t index = 0;
-
-        //    assert(assimp_mesh->mNumBones <= MAX_BONES);
-
-        //    string name = assimp_mesh->mBones[i]->mName.data;
-
-        //    if (boneMapping.find(name) == boneMapping.end())
-        //    {
-        //        // Bone not present, add new one
-        //        index = numBones;
-        //        numBones++;
-        //        BoneInfo bone;
-        //        boneInfo.push_back(bone);
-        //        boneInfo[index].offset = pMesh->mBones[i]->mOffsetMatrix;
-        //        boneMapping[name] = index;
-        //    }
-        //    else
-        //    {
-        //        index = boneMapping[name];
-        //    }
-
-        //    for (uint32_t j = 0; j < assimp_mesh->mBones[i]->mNumWeights; j++)
-        //    {
-        //        uint32_t vertexID = vertexOffset + pMesh->mBones[i]->mWeights[j].mVertexId;
-        //        Bones[vertexID].add(index, pMesh->mBones[i]->mWeights[j].mWeight);
-        //    }
-        //}
-        //boneTransforms.resize(numBones);
+        if (!skeleton || !assimp_mesh->HasBones())
+            return;
+
+        mesh->weights.resize(assimp_mesh->mNumVertices);
+        for (uint32_t i = 0; i < assimp_mesh->mNumBones; i++)
+        {
+            const aiBone* bone  = assimp_mesh->mBones[i];
+            const int32_t joint = skeleton->GetJointIndex(bone->mName.C_Str());
+            if (joint < 0)
+                continue;
+
+            for (uint32_t j = 0; j < bone->mNumWeights; j++)
+            {
+                const aiVertexWeight& vertex_weight = bone->mWeights[j];
+                if (vertex_weight.mVertexId >= assimp_mesh->mNumVertices)
+                    continue;
+
+                // Keep the 4 largest weights (aiProcess_LimitBoneWeights should have made sure there are no more)
+                Skinning_Weights& weights   = mesh->weights[vertex_weight.mVertexId];
+                uint32_t smallest           = 0;
+                for (uint32_t k = 1; k < 4; k++)
+                {
+                    smallest = weights.weights[k] < weights.weights[smallest] ? k : smallest;
+                }
+
+                if (vertex_weight.mWeight > weights.weights[smallest])
+                {
+                    weights.joints[smallest]    = static_cast<uint16_t>(joint);
+                    weights.weights[smallest]   = vertex_weight.mWeight;
+                }
+            }
+        }
+
+        // Weights have to add up to one
+        for (Skinning_Weights& weights : mesh->weights)
+        {
+            const float sum = weights.weights[0] + weights.weights[1] + weights.weights[2] + weights.weights[3];
+            if (sum > 0.0f)
+            {
+                for (float& weight : weights.weights)
+                {
+                    weight /= sum;
+                }
+            }
+        }
     }
 
-    shared_ptr<Material> ModelImporter::LoadMaterial(aiMaterial* assimp_material, const ModelParams& params)
+    shared_ptr<Material> ModelImporter::LoadMaterial(aiMaterial* assimp_material, const ModelParams& params, vector<ModelImporter_TextureSlot>* texture_slots) const
 	{
 		if (!assimp_material)
 		{
@@ -439,7 +687,7 @@ namespace Spartan
 		material->SetColorAlbedo(Vector4(color_diffuse.r, color_diffuse.g, color_diffuse.b, opacity.r));
 
 		// TEXTURES
-		const auto load_mat_tex = [&params, &assimp_material, &material](const aiTextureType type_assimp, const TextureType type_spartan)
+		const auto load_mat_tex = [&params, &assimp_material, &material, &texture_slots](const aiTextureType type_assimp, const TextureType type_spartan)
 		{
 			aiString texture_path;
 			if (assimp_material->GetTextureCount(type_assimp) > 0)
@@ -449,35 +697,8 @@ namespace Spartan
 					const auto deduced_path = AssimpHelper::texture_validate_path(texture_path.data, params.file_path);
 					if (FileSystem::IsSupportedImageFile(deduced_path))
 					{
-                        params.model->AddTexture(material, type_spartan, AssimpHelper::texture_validate_path(texture_path.data, params.file_path));
-
-						if (type_assimp == aiTextureType_DIFFUSE)
-						{
-							// FIX: materials that have a diffuse texture should not be tinted black/gray
-							material->SetColorAlbedo(Vector4::One);
-						}
-
-						// Some models (or Assimp) pass a normal map as a height map
-						// auto textureType others pass a height map as a normal map, we try to fix that.
-						if (type_spartan == TextureType_Normal || type_spartan == TextureType_Height)
-						{
-                            if (const auto texture = material->GetTexture(type_spartan))
-                            {
-                                auto proper_type = type_spartan;
-                                proper_type = (proper_type == TextureType_Normal && texture->GetGrayscale()) ? TextureType_Height : proper_type;
-                                proper_type = (proper_type == TextureType_Height && !texture->GetGrayscale()) ? TextureType_Normal : proper_type;
-
-                                if (proper_type != type_spartan)
-                                {
-                                    material->SetTextureSlot(type_spartan, shared_ptr<RHI_Texture>());
-                                    material->SetTextureSlot(proper_type, texture);
-                                }
-                            }
-                            else
-                            {
-                                LOG_ERROR("Failed to get texture");
-                            }
-						}
+						// The texture is loaded and set to the material later, see ModelImporter::Load()
+						texture_slots->push_back({ material, nullptr, type_spartan, type_assimp == aiTextureType_DIFFUSE, deduced_path });
 					}
 				}
 			}
@@ -489,7 +710,6 @@ namespace Spartan
 		load_mat_tex(aiTextureType_NORMALS,		TextureType_Normal);
 		load_mat_tex(aiTextureType_LIGHTMAP,	TextureType_Occlusion);
 		load_mat_tex(aiTextureType_EMISSIVE,	TextureType_Emission);
-		load_mat_tex(aiTextureType_LIGHTMAP,	TextureType_Occlusion);
 		load_mat_tex(aiTextureType_HEIGHT,		TextureType_Height);
 		load_mat_tex(aiTextureType_OPACITY,		TextureType_Mask);
 
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../Core/EngineDefs.h"
 #include <memory>
 #include <string>
+#include <vector>
 //================================
 
 struct aiNode;
@@ -39,6 +40,9 @@ namespace Spartan
 	class Entity;
 	class Model;
 	class World;
+	class Skeleton;
+	struct ModelImporter_Mesh;
+	struct ModelImporter_TextureSlot;
 
     struct ModelParams
     {
@@ -51,6 +55,8 @@ namespace Spartan
         Model* model;
         bool has_animation;
         const aiScene* scene;
+        const std::vector<ModelImporter_Mesh>* meshes;              // one per Assimp mesh, already added to the model
+        const std::vector<std::shared_ptr<Material>>* materials;    // one per Assimp material
     };
 
 	class SPARTAN_CLASS ModelImporter
@@ -67,10 +73,11 @@ namespace Spartan
         void ParseNodeMeshes(const aiNode* assimp_node, Entity* new_entity, const ModelParams& params);
         void ParseAnimations(const ModelParams& params);
 
-        // Loading
-		void LoadMesh(aiMesh* assimp_mesh, Entity* entity_parent, const ModelParams& params);
-        void LoadBones(const aiMesh* assimp_mesh, const ModelParams& params);
-		std::shared_ptr<Material> LoadMaterial(aiMaterial* assimp_material, const ModelParams& params);
+        // Loading (meshes are loaded by jobs, so they don't touch the model or the world)
+		void LoadMesh(const aiMesh* assimp_mesh, const Skeleton* skeleton, ModelImporter_Mesh* mesh) const;
+        void LoadBones(const aiMesh* assimp_mesh, const Skeleton* skeleton, ModelImporter_Mesh* mesh) const;
+        std::shared_ptr<Skeleton> LoadSkeleton(const ModelParams& params) const;
+		std::shared_ptr<Material> LoadMaterial(aiMaterial* assimp_material, const ModelParams& params, std::vector<ModelImporter_TextureSlot>* texture_slots) const;
 
         // Dependencies
 		Context* m_context;
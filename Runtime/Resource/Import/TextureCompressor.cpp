@@ -0,0 +1,533 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "TextureCompressor.h"
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+#include "../../Threading/Threading.h"
+#include "../../Logging/Log.h"
+//===================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace _TextureCompressor
+{
+	// A 4x4 block of RGBA8 pixels
+	struct Block
+	{
+		uint8_t pixels[16][4];
+	};
+
+	// Writes little endian bit fields into a block
+	struct BitWriter
+	{
+		BitWriter(uint8_t* data, const uint32_t size) : data(data) { memset(data, 0, size); }
+
+		void Write(uint32_t value, const uint32_t bit_count)
+		{
+			for (uint32_t i = 0; i < bit_count; i++, position++)
+			{
+				data[position >> 3] |= static_cast<uint8_t>(((value >> i) & 1) << (position & 7));
+			}
+		}
+
+		uint8_t* data;
+		uint32_t position = 0;
+	};
+
+	static int Clamp(const int value, const int min, const int max)	{ return value < min ? min : (value > max ? max : value); }
+	static int Round(const float value)									{ return static_cast<int>(floor(value + 0.5f)); }
+
+	// Principal axis of the block (over the first channel_count channels), endpoints are the pixels with the extreme projections
+	static void FitEndpoints(const Block& block, const uint32_t channel_count, float* endpoint_min, float* endpoint_max)
+	{
+		float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (const auto& pixel : block.pixels)
+		{
+			for (uint32_t c = 0; c < channel_count; c++) { mean[c] += pixel[c]; }
+		}
+		for (uint32_t c = 0; c < channel_count; c++) { mean[c] /= 16.0f; }
+
+		float covariance[4][4] = {};
+		for (const auto& pixel : block.pixels)
+		{
+			for (uint32_t i = 0; i < channel_count; i++)
+			{
+				for (uint32_t j = 0; j < channel_count; j++)
+				{
+					covariance[i][j] += (pixel[i] - mean[i]) * (pixel[j] - mean[j]);
+				}
+			}
+		}
+
+		// Power iteration
+		float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		for (uint32_t iteration = 0; iteration < 8; iteration++)
+		{
+			float result[4]	= { 0.0f, 0.0f, 0.0f, 0.0f };
+			float length	= 0.0f;
+			for (uint32_t i = 0; i < channel_count; i++)
+			{
+				for (uint32_t j = 0; j < channel_count; j++) { result[i] += covariance[i][j] * axis[j]; }
+				length = max(length, fabs(result[i]));
+			}
+
+			if (length < 1e-6f)
+				break;
+
+			for (uint32_t i = 0; i < channel_count; i++) { axis[i] = result[i] / length; }
+		}
+
+		float projection_min	= FLT_MAX;
+		float projection_max	= -FLT_MAX;
+		uint32_t index_min		= 0;
+		uint32_t index_max		= 0;
+		for (uint32_t p = 0; p < 16; p++)
+		{
+			float projection = 0.0f;
+			for (uint32_t c = 0; c < channel_count; c++) { projection += (block.pixels[p][c] - mean[c]) * axis[c]; }
+
+			if (projection < projection_min) { projection_min = projection; index_min = p; }
+			if (projection > projection_max) { projection_max = projection; index_max = p; }
+		}
+
+		for (uint32_t c = 0; c < channel_count; c++)
+		{
+			endpoint_min[c] = block.pixels[index_min][c];
+			endpoint_max[c] = block.pixels[index_max][c];
+		}
+	}
+
+	// Solves for the two endpoints that minimize the error of the given interpolation weights (weight of the first endpoint)
+	static bool LeastSquares(const Block& block, const uint32_t channel_count, const float* weights, float* endpoint_0, float* endpoint_1)
+	{
+		float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+		float ax[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float bx[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (uint32_t p = 0; p < 16; p++)
+		{
+			const float a = weights[p];
+			const float b = 1.0f - a;
+			aa += a * a; ab += a * b; bb += b * b;
+			for (uint32_t c = 0; c < channel_count; c++)
+			{
+				ax[c] += a * block.pixels[p][c];
+				bx[c] += b * block.pixels[p][c];
+			}
+		}
+
+		const float determinant = aa * bb - ab * ab;
+		if (fabs(determinant) < 1e-6f)
+			return false;
+
+		for (uint32_t c = 0; c < channel_count; c++)
+		{
+			endpoint_0[c] = static_cast<float>(Clamp(Round((ax[c] * bb - bx[c] * ab) / determinant), 0, 255));
+			endpoint_1[c] = static_cast<float>(Clamp(Round((bx[c] * aa - ax[c] * ab) / determinant), 0, 255));
+		}
+
+		return true;
+	}
+
+	//= BC1 ===========================================================================================
+	static uint16_t To565(const float* color)
+	{
+		const int r = Clamp(Round(color[0] * 31.0f / 255.0f), 0, 31);
+		const int g = Clamp(Round(color[1] * 63.0f / 255.0f), 0, 63);
+		const int b = Clamp(Round(color[2] * 31.0f / 255.0f), 0, 31);
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	static void From565(const uint16_t color, int* rgb)
+	{
+		const int r = (color >> 11) & 31;
+		const int g = (color >> 5) & 63;
+		const int b = color & 31;
+		rgb[0] = (r << 3) | (r >> 2);
+		rgb[1] = (g << 2) | (g >> 4);
+		rgb[2] = (b << 3) | (b >> 2);
+	}
+
+	// Encodes the block with the given endpoints (always in four color mode), returns the squared error
+	static uint32_t EncodeBC1(const Block& block, const float* endpoint_0, const float* endpoint_1, uint8_t* output, uint8_t* indices)
+	{
+		auto color_0 = To565(endpoint_0);
+		auto color_1 = To565(endpoint_1);
+		if (color_0 < color_1)
+		{
+			swap(color_0, color_1);
+		}
+
+		int palette[4][3];
+		From565(color_0, palette[0]);
+		From565(color_1, palette[1]);
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+
+		uint32_t error			= 0;
+		uint32_t index_bits		= 0;
+		for (uint32_t p = 0; p < 16; p++)
+		{
+			uint32_t best_error = UINT32_MAX;
+			uint32_t best_index = 0;
+
+			// Equal endpoints select the four color mode as well, so index 0 is always valid
+			const uint32_t palette_size = (color_0 == color_1) ? 1 : 4;
+			for (uint32_t i = 0; i < palette_size; i++)
+			{
+				uint32_t distance = 0;
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					const int delta = block.pixels[p][c] - palette[i][c];
+					distance += delta * delta;
+				}
+
+				if (distance < best_error)
+				{
+					best_error = distance;
+					best_index = i;
+				}
+			}
+
+			error			+= best_error;
+			indices[p]		= static_cast<uint8_t>(best_index);
+			index_bits		|= best_index << (p * 2);
+		}
+
+		memcpy(output + 0, &color_0, 2);
+		memcpy(output + 2, &color_1, 2);
+		memcpy(output + 4, &index_bits, 4);
+
+		return error;
+	}
+
+	static void CompressBC1(const Block& block, const bool quality, uint8_t* output)
+	{
+		float endpoint_0[4], endpoint_1[4];
+		FitEndpoints(block, 3, endpoint_1, endpoint_0);
+
+		uint8_t indices[16];
+		uint32_t error = EncodeBC1(block, endpoint_0, endpoint_1, output, indices);
+		if (!quality)
+			return;
+
+		// Refine the endpoints against the chosen indices, keep the result if it's better
+		static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+		for (uint32_t iteration = 0; iteration < 2 && error != 0; iteration++)
+		{
+			float pixel_weights[16];
+			for (uint32_t p = 0; p < 16; p++) { pixel_weights[p] = weights[indices[p]]; }
+
+			if (!LeastSquares(block, 3, pixel_weights, endpoint_0, endpoint_1))
+				break;
+
+			uint8_t refined[8];
+			uint8_t refined_indices[16];
+			const auto refined_error = EncodeBC1(block, endpoint_0, endpoint_1, refined, refined_indices);
+			if (refined_error >= error)
+				break;
+
+			error = refined_error;
+			memcpy(output, refined, 8);
+			memcpy(indices, refined_indices, 16);
+		}
+	}
+
+	//= BC4 ===========================================================================================
+	static uint32_t EncodeBC4(const uint8_t* values, const int value_0, const int value_1, uint8_t* output)
+	{
+		int palette[8];
+		palette[0] = value_0;
+		palette[1] = value_1;
+		if (value_0 > value_1)
+		{
+			for (int i = 2; i < 8; i++) { palette[i] = ((8 - i) * value_0 + (i - 1) * value_1) / 7; }
+		}
+		else
+		{
+			for (int i = 2; i < 6; i++) { palette[i] = ((6 - i) * value_0 + (i - 1) * value_1) / 5; }
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+
+		uint32_t error		= 0;
+		uint64_t index_bits	= 0;
+		for (uint32_t p = 0; p < 16; p++)
+		{
+			uint32_t best_error = UINT32_MAX;
+			uint64_t best_index = 0;
+			for (uint32_t i = 0; i < 8; i++)
+			{
+				const int delta		= values[p] - palette[i];
+				const auto distance	= static_cast<uint32_t>(delta * delta);
+				if (distance < best_error)
+				{
+					best_error = distance;
+					best_index = i;
+				}
+			}
+
+			error		+= best_error;
+			index_bits	|= best_index << (p * 3);
+		}
+
+		output[0] = static_cast<uint8_t>(value_0);
+		output[1] = static_cast<uint8_t>(value_1);
+		for (uint32_t i = 0; i < 6; i++) { output[2 + i] = static_cast<uint8_t>(index_bits >> (i * 8)); }
+
+		return error;
+	}
+
+	static void CompressBC4(const Block& block, const uint32_t channel, const bool quality, uint8_t* output)
+	{
+		uint8_t values[16];
+		int min = 255, max = 0;
+		int min_inner = 255, max_inner = 0; // excluding 0 and 255, which the six value mode gets for free
+		for (uint32_t p = 0; p < 16; p++)
+		{
+			values[p]	= block.pixels[p][channel];
+			min			= values[p] < min ? values[p] : min;
+			max			= values[p] > max ? values[p] : max;
+			if (values[p] != 0 && values[p] != 255)
+			{
+				min_inner = values[p] < min_inner ? values[p] : min_inner;
+				max_inner = values[p] > max_inner ? values[p] : max_inner;
+			}
+		}
+
+		// Eight value mode (value_0 > value_1), equal values fall back to the six value mode which encodes them exactly
+		const uint32_t error = (max > min) ? EncodeBC4(values, max, min, output) : EncodeBC4(values, min, max, output);
+		if (!quality || error == 0 || min_inner > max_inner)
+			return;
+
+		uint8_t six_value[8];
+		if (EncodeBC4(values, min_inner, max_inner, six_value) < error)
+		{
+			memcpy(output, six_value, 8);
+		}
+	}
+
+	//= BC7 (mode 6) ==================================================================================
+	static const int bc7_weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// Quantizes an endpoint to 7 bits per channel plus a shared p-bit, picking the p-bit with the lower error
+	static void QuantizeBC7(const float* endpoint, int* quantized, int* p_bit)
+	{
+		float best_error = FLT_MAX;
+		for (int p = 0; p < 2; p++)
+		{
+			int candidate[4];
+			float error = 0.0f;
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				candidate[c]		= Clamp(Round((endpoint[c] - p) / 2.0f), 0, 127);
+				const float delta	= ((candidate[c] << 1) | p) - endpoint[c];
+				error				+= delta * delta;
+			}
+
+			if (error < best_error)
+			{
+				best_error = error;
+				*p_bit = p;
+				memcpy(quantized, candidate, sizeof(candidate));
+			}
+		}
+	}
+
+	static uint32_t EncodeBC7(const Block& block, const float* endpoint_0, const float* endpoint_1, uint8_t* output, uint8_t* indices)
+	{
+		int quantized[2][4], p_bits[2];
+		QuantizeBC7(endpoint_0, quantized[0], &p_bits[0]);
+		QuantizeBC7(endpoint_1, quantized[1], &p_bits[1]);
+
+		int palette[16][4];
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			const int value_0 = (quantized[0][c] << 1) | p_bits[0];
+			const int value_1 = (quantized[1][c] << 1) | p_bits[1];
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				palette[i][c] = ((64 - bc7_weights[i]) * value_0 + bc7_weights[i] * value_1 + 32) >> 6;
+			}
+		}
+
+		uint32_t error = 0;
+		for (uint32_t p = 0; p < 16; p++)
+		{
+			uint32_t best_error = UINT32_MAX;
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				uint32_t distance = 0;
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					const int delta = block.pixels[p][c] - palette[i][c];
+					distance += delta * delta;
+				}
+
+				if (distance < best_error)
+				{
+					best_error = distance;
+					indices[p] = static_cast<uint8_t>(i);
+				}
+			}
+			error += best_error;
+		}
+
+		// The most significant bit of the first (anchor) index is implicit, so it has to be zero
+		const bool swap_endpoints = indices[0] >= 8;
+		const int first		= swap_endpoints ? 1 : 0;
+		const int second	= swap_endpoints ? 0 : 1;
+
+		BitWriter writer(output, 16);
+		writer.Write(1 << 6, 7); // mode 6
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			writer.Write(quantized[first][c], 7);
+			writer.Write(quantized[second][c], 7);
+		}
+		writer.Write(p_bits[first], 1);
+		writer.Write(p_bits[second], 1);
+		for (uint32_t p = 0; p < 16; p++)
+		{
+			const uint32_t index = swap_endpoints ? 15 - indices[p] : indices[p];
+			writer.Write(index, p == 0 ? 3 : 4);
+		}
+
+		return error;
+	}
+
+	static void CompressBC7(const Block& block, const bool quality, uint8_t* output)
+	{
+		float endpoint_0[4], endpoint_1[4];
+		FitEndpoints(block, 4, endpoint_0, endpoint_1);
+
+		uint8_t indices[16];
+		uint32_t error = EncodeBC7(block, endpoint_0, endpoint_1, output, indices);
+		if (!quality)
+			return;
+
+		// Refine the endpoints against the chosen indices (which are relative to the unswapped endpoints), keep the result if it's better
+		for (uint32_t iteration = 0; iteration < 2 && error != 0; iteration++)
+		{
+			float pixel_weights[16];
+			for (uint32_t p = 0; p < 16; p++) { pixel_weights[p] = 1.0f - bc7_weights[indices[p]] / 64.0f; }
+
+			if (!LeastSquares(block, 4, pixel_weights, endpoint_0, endpoint_1))
+				break;
+
+			uint8_t refined[16];
+			uint8_t refined_indices[16];
+			const auto refined_error = EncodeBC7(block, endpoint_0, endpoint_1, refined, refined_indices);
+			if (refined_error >= error)
+				break;
+
+			error = refined_error;
+			memcpy(output, refined, 16);
+			memcpy(indices, refined_indices, 16);
+		}
+	}
+}
+
+namespace Spartan
+{
+	bool TextureCompressor::Compress(Threading* threading, const Span<const std::byte>& rgba, const uint32_t width, const uint32_t height, const RHI_Format format, const bool quality, const Span<std::byte>& output)
+	{
+		const auto block_size	= GetBlockSize(format);
+		const uint32_t blocks_x	= (width + 3) / 4;
+		const uint32_t blocks_y	= (height + 3) / 4;
+		if (!threading || block_size == 0 || width == 0 || height == 0 || rgba.size() != static_cast<size_t>(width) * height * 4 || output.size() != static_cast<size_t>(blocks_x) * blocks_y * block_size)
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return false;
+		}
+
+		const auto source		= reinterpret_cast<const uint8_t*>(rgba.data());
+		const auto destination	= reinterpret_cast<uint8_t*>(output.data());
+		auto compress_rows = [&](uint32_t start, uint32_t end)
+		{
+			_TextureCompressor::Block block;
+			for (uint32_t block_y = start; block_y < end; block_y++)
+			{
+				for (uint32_t block_x = 0; block_x < blocks_x; block_x++)
+				{
+					// Gather (clamping to the edge, for mips that are smaller than a block)
+					for (uint32_t y = 0; y < 4; y++)
+					{
+						const auto source_y = min(block_y * 4 + y, height - 1);
+						for (uint32_t x = 0; x < 4; x++)
+						{
+							const auto source_x = min(block_x * 4 + x, width - 1);
+							memcpy(block.pixels[y * 4 + x], source + (static_cast<size_t>(source_y) * width + source_x) * 4, 4);
+						}
+					}
+
+					// Compress
+					auto block_output = destination + (static_cast<size_t>(block_y) * blocks_x + block_x) * block_size;
+					switch (format)
+					{
+						case Format_BC1_UNORM:
+							_TextureCompressor::CompressBC1(block, quality, block_output);
+							break;
+						case Format_BC3_UNORM:
+							_TextureCompressor::CompressBC4(block, 3, quality, block_output);
+							_TextureCompressor::CompressBC1(block, quality, block_output + 8);
+							break;
+						case Format_BC4_UNORM:
+							_TextureCompressor::CompressBC4(block, 0, quality, block_output);
+							break;
+						case Format_BC5_UNORM:
+							_TextureCompressor::CompressBC4(block, 0, quality, block_output);
+							_TextureCompressor::CompressBC4(block, 1, quality, block_output + 8);
+							break;
+						case Format_BC7_UNORM:
+							_TextureCompressor::CompressBC7(block, quality, block_output);
+							break;
+						default:
+							break;
+					}
+				}
+			}
+		};
+		threading->Loop(compress_rows, blocks_y);
+
+		return true;
+	}
+
+	uint32_t TextureCompressor::GetBlockSize(const RHI_Format format)
+	{
+		switch (format)
+		{
+			case Format_BC1_UNORM:	return 8;
+			case Format_BC4_UNORM:	return 8;
+			case Format_BC3_UNORM:	return 16;
+			case Format_BC5_UNORM:	return 16;
+			case Format_BC7_UNORM:	return 16;
+			default:				return 0;
+		}
+	}
+}
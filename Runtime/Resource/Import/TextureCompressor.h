@@ -0,0 +1,53 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ========================
+#include <vector>
+#include <cstdint>
+#include "../../Core/EngineDefs.h"
+#include "../../RHI/RHI_Definition.h"
+#include "../../Core/Span.h"
+//===================================
+
+namespace Spartan
+{
+	class Threading;
+
+	// CPU block compression of RGBA8 images into BC1/BC3/BC4/BC5/BC7 (mode 6).
+	// Rows of 4x4 blocks are compressed in parallel, partial blocks at the edges are padded by clamping.
+	class SPARTAN_CLASS TextureCompressor
+	{
+	public:
+		static bool Compress(
+			Threading* threading,
+			const Span<const std::byte>& rgba,
+			uint32_t width,
+			uint32_t height,
+			RHI_Format format,
+			bool quality,
+			const Span<std::byte>& output // sized by the caller, see RHI_Texture::GetMipSize()
+		);
+
+		static uint32_t GetBlockSize(RHI_Format format);
+	};
+}
@@ -0,0 +1,481 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ====================
+#include "ImportCache.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <set>
+#include "../Core/Hash.h"
+#include "../Core/FileSystem.h"
+#include "../IO/FileStream.h"
+#include "../Logging/Log.h"
+//===============================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace _ImportCache
+{
+	static const uint32_t magic					= 0x43495053; // "SPIC"
+	static const uint32_t version				= 1;
+	static const uint64_t chunk_size			= 1024 * 1024;
+	static const uint64_t seconds_per_day		= 86400;
+	static const char* extension_entry			= ".entry";
+	static const char* extension_blob			= ".blob";
+
+	struct Artifact
+	{
+		std::string path;
+		bool is_relative	= false; // to the directory of the foreign file, so the entry can be restored anywhere
+		uint64_t hash		= 0;
+		uint64_t size		= 0;
+	};
+
+	struct Dependency
+	{
+		std::string path;
+		uint64_t hash = 0;
+	};
+
+	struct Entry
+	{
+		uint64_t key		= 0;
+		uint64_t last_used	= 0;
+		std::vector<Artifact> artifacts;
+		std::vector<Dependency> dependencies;
+		std::vector<std::byte> metadata;
+	};
+
+	static uint64_t now()
+	{
+		return static_cast<uint64_t>(chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count());
+	}
+
+	static string to_hex(const uint64_t value)
+	{
+		static const char* digits = "0123456789abcdef";
+		string hex(16, '0');
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			hex[15 - i] = digits[(value >> (i * 4)) & 0xf];
+		}
+		return hex;
+	}
+
+	static bool read_file(const string& file_path, vector<std::byte>* data)
+	{
+		ifstream in(file_path, ios::in | ios::binary | ios::ate);
+		if (!in.good())
+			return false;
+
+		data->resize(static_cast<size_t>(in.tellg()));
+		in.seekg(0, ios::beg);
+		in.read(reinterpret_cast<char*>(data->data()), data->size());
+		return in.good() || in.eof();
+	}
+
+	static bool write_file(const string& file_path, const vector<std::byte>& data)
+	{
+		const auto directory = Spartan::FileSystem::GetDirectoryFromFilePath(file_path);
+		if (!directory.empty() && !Spartan::FileSystem::DirectoryExists(directory))
+		{
+			Spartan::FileSystem::CreateDirectory_(directory);
+		}
+
+		ofstream out(file_path, ios::out | ios::binary | ios::trunc);
+		if (!out.good())
+			return false;
+
+		out.write(reinterpret_cast<const char*>(data.data()), data.size());
+		return out.good();
+	}
+
+	static bool read_entry(const string& file_path, Entry* entry)
+	{
+		auto file = make_unique<Spartan::FileStream>(file_path, Spartan::FileStream_Read);
+		if (!file->IsOpen())
+			return false;
+
+		if (file->ReadAs<uint32_t>() != magic || file->ReadAs<uint32_t>() != version)
+			return false;
+
+		file->Read(&entry->key);
+		file->Read(&entry->last_used);
+
+		entry->artifacts.resize(file->ReadAs<uint32_t>());
+		for (auto& artifact : entry->artifacts)
+		{
+			file->Read(&artifact.path);
+			file->Read(&artifact.is_relative);
+			file->Read(&artifact.hash);
+			file->Read(&artifact.size);
+		}
+
+		entry->dependencies.resize(file->ReadAs<uint32_t>());
+		for (auto& dependency : entry->dependencies)
+		{
+			file->Read(&dependency.path);
+			file->Read(&dependency.hash);
+		}
+
+		file->Read(&entry->metadata);
+
+		return true;
+	}
+
+	static bool write_entry(const string& file_path, const Entry& entry)
+	{
+		auto file = make_unique<Spartan::FileStream>(file_path, Spartan::FileStream_Write);
+		if (!file->IsOpen())
+			return false;
+
+		file->Write(magic);
+		file->Write(version);
+		file->Write(entry.key);
+		file->Write(entry.last_used);
+
+		file->Write(static_cast<uint32_t>(entry.artifacts.size()));
+		for (const auto& artifact : entry.artifacts)
+		{
+			file->Write(artifact.path);
+			file->Write(artifact.is_relative);
+			file->Write(artifact.hash);
+			file->Write(artifact.size);
+		}
+
+		file->Write(static_cast<uint32_t>(entry.dependencies.size()));
+		for (const auto& dependency : entry.dependencies)
+		{
+			file->Write(dependency.path);
+			file->Write(dependency.hash);
+		}
+
+		file->Write(entry.metadata);
+
+		return true;
+	}
+
+	static bool is_entry(const string& file_path)	{ return Spartan::FileSystem::GetExtensionFromFilePath(file_path) == extension_entry; }
+	static bool is_blob(const string& file_path)	{ return Spartan::FileSystem::GetExtensionFromFilePath(file_path) == extension_blob; }
+}
+
+namespace Spartan
+{
+	ImportCache::ImportCache(const string& directory)
+	{
+		m_directory = directory;
+
+		if (!FileSystem::DirectoryExists(m_directory))
+		{
+			FileSystem::CreateDirectory_(m_directory);
+		}
+	}
+
+	uint64_t ImportCache::ComputeKey(const string& file_path, const uint64_t settings_hash) const
+	{
+		const uint64_t content_hash = ComputeFileHash(file_path);
+		if (content_hash == 0)
+			return 0;
+
+		return Hash::Compute(&settings_hash, sizeof(settings_hash), content_hash);
+	}
+
+	bool ImportCache::Fetch(const uint64_t key, const string& file_path, vector<std::byte>* metadata /*= nullptr*/)
+	{
+		if (key == 0)
+			return false;
+
+		lock_guard<mutex> guard(m_mutex);
+
+		const auto entry_path = GetEntryFilePath(key);
+		_ImportCache::Entry entry;
+		if (!FileSystem::FileExists(entry_path) || !_ImportCache::read_entry(entry_path, &entry) || entry.key != key)
+			return false;
+
+		// A dependency that changed makes the entry stale, one that's missing doesn't (the artifacts are all that's needed)
+		for (const auto& dependency : entry.dependencies)
+		{
+			if (FileSystem::FileExists(dependency.path) && ComputeFileHash(dependency.path) != dependency.hash)
+				return false;
+		}
+
+		// Restore the artifacts, verifying each blob against its hash
+		const auto directory = FileSystem::GetDirectoryFromFilePath(file_path);
+		vector<std::byte> data;
+		for (const auto& artifact : entry.artifacts)
+		{
+			const auto blob_path = GetBlobFilePath(artifact.hash);
+			if (!_ImportCache::read_file(blob_path, &data) || data.size() != artifact.size || Hash::Compute(data.data(), data.size()) != artifact.hash)
+			{
+				LOG_WARNING("Import cache entry for \"%s\" is corrupt, it will be re-imported", file_path.c_str());
+				FileSystem::DeleteFile_(entry_path);
+				if (FileSystem::FileExists(blob_path))
+				{
+					FileSystem::DeleteFile_(blob_path);
+				}
+				return false;
+			}
+
+			const auto artifact_path = artifact.is_relative ? directory + artifact.path : artifact.path;
+			if (!_ImportCache::write_file(artifact_path, data))
+			{
+				LOG_ERROR("Failed to restore \"%s\"", artifact_path.c_str());
+				return false;
+			}
+		}
+
+		// Keep track of usage, for garbage collection
+		entry.last_used = _ImportCache::now();
+		_ImportCache::write_entry(entry_path, entry);
+
+		if (metadata)
+		{
+			*metadata = move(entry.metadata);
+		}
+
+		return true;
+	}
+
+	bool ImportCache::Store(const uint64_t key, const string& file_path, const vector<string>& artifacts, const vector<string>& dependencies /*= {}*/, const vector<std::byte>& metadata /*= {}*/)
+	{
+		if (key == 0 || (artifacts.empty() && metadata.empty()))
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return false;
+		}
+
+		_ImportCache::Entry entry;
+		entry.key		= key;
+		entry.last_used	= _ImportCache::now();
+		entry.metadata	= metadata;
+
+		for (const auto& dependency : dependencies)
+		{
+			entry.dependencies.push_back({ dependency, ComputeFileHash(dependency) });
+		}
+
+		lock_guard<mutex> guard(m_mutex);
+
+		const auto directory = FileSystem::GetDirectoryFromFilePath(file_path);
+		vector<std::byte> data;
+		for (const auto& artifact_path : artifacts)
+		{
+			if (!_ImportCache::read_file(artifact_path, &data))
+			{
+				LOG_WARNING("Failed to read \"%s\", the import of \"%s\" won't be cached", artifact_path.c_str(), file_path.c_str());
+				return false;
+			}
+
+			_ImportCache::Artifact artifact;
+			artifact.is_relative	= !directory.empty() && artifact_path.compare(0, directory.size(), directory) == 0;
+			artifact.path			= artifact.is_relative ? artifact_path.substr(directory.size()) : artifact_path;
+			artifact.hash			= Hash::Compute(data.data(), data.size());
+			artifact.size			= data.size();
+
+			// Identical artifacts share a blob
+			const auto blob_path = GetBlobFilePath(artifact.hash);
+			if (!FileSystem::FileExists(blob_path) && !_ImportCache::write_file(blob_path, data))
+			{
+				LOG_ERROR("Failed to write \"%s\"", blob_path.c_str());
+				return false;
+			}
+
+			entry.artifacts.emplace_back(move(artifact));
+		}
+
+		return _ImportCache::write_entry(GetEntryFilePath(key), entry);
+	}
+
+	uint32_t ImportCache::Validate()
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		map<uint64_t, bool> blob_validity;
+		vector<std::byte> data;
+		uint32_t removed_count = 0;
+
+		for (const auto& file_path : FileSystem::GetFilesInDirectory(m_directory))
+		{
+			if (!_ImportCache::is_entry(file_path))
+				continue;
+
+			_ImportCache::Entry entry;
+			bool is_valid = _ImportCache::read_entry(file_path, &entry);
+			for (const auto& artifact : entry.artifacts)
+			{
+				if (!is_valid)
+					break;
+
+				// Blobs are shared by entries, so each one is only hashed once
+				auto it = blob_validity.find(artifact.hash);
+				if (it == blob_validity.end())
+				{
+					const auto blob_path	= GetBlobFilePath(artifact.hash);
+					const bool blob_valid	= _ImportCache::read_file(blob_path, &data) && Hash::Compute(data.data(), data.size()) == artifact.hash;
+					if (!blob_valid && FileSystem::FileExists(blob_path))
+					{
+						FileSystem::DeleteFile_(blob_path);
+					}
+					it = blob_validity.emplace(artifact.hash, blob_valid).first;
+				}
+
+				is_valid = it->second;
+			}
+
+			if (!is_valid)
+			{
+				FileSystem::DeleteFile_(file_path);
+				removed_count++;
+			}
+		}
+
+		if (removed_count != 0)
+		{
+			LOG_INFO("Removed %d invalid import cache entries", removed_count);
+		}
+
+		return removed_count;
+	}
+
+	void ImportCache::CollectGarbage(const uint64_t max_size /*= 4294967296*/, const uint32_t max_age_days /*= 30*/)
+	{
+		lock_guard<mutex> guard(m_mutex);
+
+		// Gather entries, most recently used first
+		vector<pair<string, _ImportCache::Entry>> entries;
+		vector<string> blob_paths;
+		for (const auto& file_path : FileSystem::GetFilesInDirectory(m_directory))
+		{
+			if (_ImportCache::is_blob(file_path))
+			{
+				blob_paths.emplace_back(file_path);
+			}
+			else if (_ImportCache::is_entry(file_path))
+			{
+				_ImportCache::Entry entry;
+				if (_ImportCache::read_entry(file_path, &entry))
+				{
+					entry.metadata.clear();
+					entries.emplace_back(file_path, move(entry));
+				}
+				else
+				{
+					FileSystem::DeleteFile_(file_path);
+				}
+			}
+		}
+		sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.second.last_used > b.second.last_used; });
+
+		// Keep entries while they are recent enough and their blobs fit in the budget
+		const uint64_t time_now	= _ImportCache::now();
+		const uint64_t max_age	= static_cast<uint64_t>(max_age_days) * _ImportCache::seconds_per_day;
+		set<uint64_t> referenced_blobs;
+		uint64_t size			= 0;
+		uint32_t evicted_count	= 0;
+		for (const auto& [entry_path, entry] : entries)
+		{
+			bool keep = time_now < entry.last_used + max_age;
+
+			uint64_t size_new = 0;
+			for (const auto& artifact : entry.artifacts)
+			{
+				if (referenced_blobs.find(artifact.hash) == referenced_blobs.end())
+				{
+					size_new += artifact.size;
+				}
+			}
+			keep = keep && size + size_new <= max_size;
+
+			if (keep)
+			{
+				size += size_new;
+				for (const auto& artifact : entry.artifacts)
+				{
+					referenced_blobs.insert(artifact.hash);
+				}
+			}
+			else
+			{
+				FileSystem::DeleteFile_(entry_path);
+				evicted_count++;
+			}
+		}
+
+		// Delete blobs that no entry references anymore
+		set<string> referenced_blob_names;
+		for (const auto hash : referenced_blobs)
+		{
+			referenced_blob_names.insert(FileSystem::GetFileNameFromFilePath(GetBlobFilePath(hash)));
+		}
+
+		uint32_t deleted_count = 0;
+		for (const auto& blob_path : blob_paths)
+		{
+			if (referenced_blob_names.find(FileSystem::GetFileNameFromFilePath(blob_path)) == referenced_blob_names.end())
+			{
+				FileSystem::DeleteFile_(blob_path);
+				deleted_count++;
+			}
+		}
+
+		if (evicted_count != 0 || deleted_count != 0)
+		{
+			LOG_INFO("Evicted %d import cache entries and %d blobs, %d MB are in use", evicted_count, deleted_count, static_cast<int>(size / (1024 * 1024)));
+		}
+	}
+
+	uint64_t ImportCache::ComputeFileHash(const string& file_path)
+	{
+		ifstream in(file_path, ios::in | ios::binary);
+		if (!in.good())
+			return 0;
+
+		// Hash in chunks, each chunk seeds the next, so large files are never fully in memory
+		vector<char> chunk(_ImportCache::chunk_size);
+		uint64_t hash = 0;
+		while (in)
+		{
+			in.read(chunk.data(), chunk.size());
+			const auto count = static_cast<uint64_t>(in.gcount());
+			if (count == 0)
+				break;
+
+			hash = Hash::Compute(chunk.data(), count, hash);
+		}
+
+		// Reserve 0 to signal failure
+		return hash != 0 ? hash : 1;
+	}
+
+	string ImportCache::GetEntryFilePath(const uint64_t key) const
+	{
+		return m_directory + _ImportCache::to_hex(key) + _ImportCache::extension_entry;
+	}
+
+	string ImportCache::GetBlobFilePath(const uint64_t hash) const
+	{
+		return m_directory + _ImportCache::to_hex(hash) + _ImportCache::extension_blob;
+	}
+}
@@ -0,0 +1,76 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==============
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../Core/EngineDefs.h"
+//=========================
+
+namespace Spartan
+{
+	// Keeps the native files that importing a foreign file produced (.texture, .model, .material), addressed by a 
+	// hash of the foreign file's contents plus the import settings. Artifacts are stored as blobs named after their 
+	// own content hash, so an artifact that's produced by many imports (a texture shared by models) is stored once.
+	class SPARTAN_CLASS ImportCache
+	{
+	public:
+		ImportCache(const std::string& directory);
+		~ImportCache() = default;
+
+		// Returns the key of a foreign file for the given import settings, 0 if the file can't be read
+		uint64_t ComputeKey(const std::string& file_path, uint64_t settings_hash) const;
+
+		// Restores the artifacts of an entry, returns false if there is no entry or if it's stale or corrupt
+		bool Fetch(uint64_t key, const std::string& file_path, std::vector<std::byte>* metadata = nullptr);
+
+		// Stores the artifacts of an import. Dependencies are other foreign files that the import read, 
+		// the entry is stale once any of them changes. Metadata is anything the importer needs to replay the import,
+		// an entry can consist of metadata alone (e.g. compiled script bytecode).
+		bool Store(
+			uint64_t key,
+			const std::string& file_path,
+			const std::vector<std::string>& artifacts,
+			const std::vector<std::string>& dependencies	= {},
+			const std::vector<std::byte>& metadata			= {}
+		);
+
+		// Hashes every blob and removes the entries that have missing or corrupt artifacts, returns how many were removed
+		uint32_t Validate();
+
+		// Removes the entries that weren't used for max_age_days, then the least recently used ones until
+		// the blobs fit in max_size, and finally deletes the blobs that no entry references
+		void CollectGarbage(uint64_t max_size = 4294967296, uint32_t max_age_days = 30);
+
+		const auto& GetDirectory() const { return m_directory; }
+		static uint64_t ComputeFileHash(const std::string& file_path); // 0 if the file can't be read
+
+	private:
+		std::string GetEntryFilePath(uint64_t key) const;
+		std::string GetBlobFilePath(uint64_t hash) const;
+
+		std::string m_directory;
+		std::mutex m_mutex;
+	};
+}
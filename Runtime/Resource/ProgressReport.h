@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Core/EngineDefs.h"
 #include <string>
 #include <map>
+#include <atomic>
 //=============================
 
 namespace Spartan
@@ -46,7 +47,7 @@ namespace Spartan
 		}
 
 		std::string status;
-		int jobsDone;
+		std::atomic<int> jobsDone; // incremented by import jobs, from any thread
 		int jobCount;
 		bool isLoading;
 	};
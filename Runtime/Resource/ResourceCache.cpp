@@ -22,6 +22,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ======================
 #include "ResourceCache.h"
 #include "ProgressReport.h"
+#include "ImportCache.h"
 #include "Import/ImageImporter.h"
 #include "Import/ModelImporter.h"
 #include "Import/FontImporter.h"
@@ -65,8 +66,10 @@ namespace Spartan
 
 	ResourceCache::~ResourceCache()
 	{
-		// Unsubscribe from event
-		UNSUBSCRIBE_FROM_EVENT(Event_World_Unload, EVENT_HANDLER(Clear));
+		// Unsubscribe from events
+		UNSUBSCRIBE_FROM_EVENT(Event_World_Save);
+		UNSUBSCRIBE_FROM_EVENT(Event_World_Load);
+		UNSUBSCRIBE_FROM_EVENT(Event_World_Unload);
 		Clear();
 	}
 
@@ -76,6 +79,11 @@ namespace Spartan
 		m_importer_image	= make_shared<ImageImporter>(m_context);
 		m_importer_model	= make_shared<ModelImporter>(m_context);
 		m_importer_font		= make_shared<FontImporter>(m_context);
+
+		// Import cache (foreign files that were imported before, are restored from it instead)
+		m_import_cache		= make_shared<ImportCache>(m_project_directory + "ImportCache//");
+		m_import_cache->CollectGarbage();
+
 		return true;
 	}
 
@@ -189,8 +197,14 @@ namespace Spartan
 				file->Write(resource->GetResourceFilePathNative());
 				// Save type
 				file->Write(static_cast<uint32_t>(resource->GetResourceType()));
-				// Save resource (to a dedicated file)
-				resource->SaveToFile(resource->GetResourceFilePathNative());
+				// Save resource (to a dedicated file), only if it changed since it was last saved or loaded
+				if (resource->IsDirty() || !FileSystem::FileExists(resource->GetResourceFilePathNative()))
+				{
+					if (resource->SaveToFile(resource->GetResourceFilePathNative()))
+					{
+						resource->SetDirty(false);
+					}
+				}
 
 				// Update progress
 				ProgressReport::Get().IncrementJobsDone(g_progress_resource_cache);
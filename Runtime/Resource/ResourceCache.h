@@ -33,6 +33,7 @@ namespace Spartan
     class FontImporter;
     class ImageImporter;
     class ModelImporter;
+    class ImportCache;
 
 	enum Asset_Type
 	{
@@ -108,8 +109,11 @@ namespace Spartan
             // Prevent threads from colliding in critical section
             std::lock_guard<mutex> guard(m_mutex);
 
-            // In order to guarantee deserialization, we save it now
-            resource->SaveToFile(resource->GetResourceFilePathNative());
+            // In order to guarantee deserialization, we save it now (unless it's already in sync with its native file)
+            if (resource->IsDirty() && resource->SaveToFile(resource->GetResourceFilePathNative()))
+            {
+                resource->SetDirty(false);
+            }
 
 			// Cache it
 			return static_pointer_cast<T>(m_resource_groups[resource->GetResourceType()].emplace_back(resource));
@@ -164,6 +168,9 @@ namespace Spartan
 				return nullptr;
 			}
 
+			// Resources that were loaded from their native file, don't have to be saved again
+			typed->SetDirty(!FileSystem::IsEngineFile(file_path));
+
             // Returned cached reference which is guaranteed to be around after deserialization
 			return Cache<T>(typed);
 		}
@@ -195,6 +202,7 @@ namespace Spartan
 		auto GetModelImporter() const { return m_importer_model.get(); }
 		auto GetImageImporter() const { return m_importer_image.get(); }
 		auto GetFontImporter()  const { return m_importer_font.get(); }
+		auto GetImportCache()   const { return m_import_cache.get(); }
 
 	private:
 		// Cache
@@ -209,5 +217,6 @@ namespace Spartan
 		std::shared_ptr<ModelImporter> m_importer_model;
 		std::shared_ptr<ImageImporter> m_importer_image;
 		std::shared_ptr<FontImporter> m_importer_font;
+		std::shared_ptr<ImportCache> m_import_cache;
 	};
 }
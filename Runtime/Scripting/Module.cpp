@@ -19,18 +19,66 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+
 //= INCLUDES =============================
 #include "Module.h"
+#include <atomic>
+#include <cstring>
 #include <scriptbuilder/scriptbuilder.cpp>
 #include "Scripting.h"
 #include "../Logging/Log.h"
 #include "../Core/FileSystem.h"
+#include "../Core/Hash.h"
+#include "../IO/FileStream.h"
+#include "../Resource/ImportCache.h"
 //========================================
 
 //= NAMESPACES =====
 using namespace std;
 //==================
 
+namespace _Module
+{
+	// Bytecode depends on the AngelScript version and on the platform (pointer size), as well as on its own layout here
+	static const uint32_t cache_version = 2;
+
+	// Every module gets a number of its own, AngelScript replaces (and a destructed module discards) any module with the same name
+	static std::atomic<uint64_t> module_count = 0;
+
+	static uint64_t compute_settings_hash()
+	{
+		const uint64_t settings[3] = { ANGELSCRIPT_VERSION, sizeof(void*), cache_version };
+		return Spartan::Hash::Compute(settings, sizeof(settings), 0x5343524950542d42); // "SCRIPT-B"
+	}
+
+	class ByteCodeStream : public asIBinaryStream
+	{
+	public:
+		ByteCodeStream(vector<std::byte>* data) { m_data = data; }
+
+		int Write(const void* ptr, asUINT size) override
+		{
+			const auto bytes = static_cast<const std::byte*>(ptr);
+			m_data->insert(m_data->end(), bytes, bytes + size);
+			return 0;
+		}
+
+		int Read(void* ptr, asUINT size) override
+		{
+			if (m_position + size > m_data->size())
+				return -1;
+
+			memcpy(ptr, m_data->data() + m_position, size);
+			m_position += size;
+			return 0;
+		}
+
+	private:
+		vector<std::byte>* m_data;
+		size_t m_position = 0;
+	};
+}
+
 namespace Spartan
 {
 	Module::Module(const string& moduleName, weak_ptr<Scripting> scriptEngine)
@@ -56,9 +104,113 @@ namespace Spartan
 			return false;
 		}
 
+		// Versions of a script can be alive at the same time (instances created before it or an include changed, or before it was reverted),
+		// so every module gets a name of its own. The key can't be used for that, it doesn't change when only an include does.
+		m_key			= ComputeKey(scriptEngine.get(), filePath);
+		m_moduleName	= m_moduleName + "_" + to_string(++_Module::module_count);
+
+		if (LoadByteCode(scriptEngine.get(), filePath))
+			return true;
+
+		return Compile(scriptEngine.get(), filePath);
+	}
+
+	asIScriptModule* Module::GetAsIScriptModule()
+	{
+		if (!m_module)
+		{
+			LOG_ERROR_INVALID_INTERNALS();
+			return nullptr;
+		}
+
+		return m_module;
+	}
+
+	vector<string> Module::GetMetadata(const string& type_name) const
+	{
+		const auto it = m_type_metadata.find(type_name);
+		return it != m_type_metadata.end() ? it->second : vector<string>();
+	}
+
+	bool Module::IsCurrent(Scripting* scripting, const string& file_path) const
+	{
+		if (ComputeKey(scripting, file_path) != m_key)
+			return false;
+
+		// An include that's missing doesn't make it stale (same as the import cache), one that changed does
+		for (const auto& [dependency_path, dependency_hash] : m_dependencies)
+		{
+			const auto hash = scripting->GetFileHash(dependency_path);
+			if (hash != 0 && hash != dependency_hash)
+				return false;
+		}
+
+		return true;
+	}
+
+	uint64_t Module::ComputeKey(Scripting* scripting, const string& file_path)
+	{
+		if (!scripting || !scripting->GetImportCache())
+			return 0;
+
+		// Same as the import cache's key, but the hash of the file is only computed again once it was written to
+		const uint64_t content_hash = scripting->GetFileHash(file_path);
+		if (content_hash == 0)
+			return 0;
+
+		const uint64_t settings_hash = _Module::compute_settings_hash();
+		return Hash::Compute(&settings_hash, sizeof(settings_hash), content_hash);
+	}
+
+	bool Module::LoadByteCode(Scripting* scripting, const string& file_path)
+	{
+		const auto import_cache = scripting->GetImportCache();
+		vector<std::byte> metadata;
+		if (!import_cache || !import_cache->Fetch(m_key, file_path, &metadata))
+			return false;
+
+		// The entry holds the bytecode and the metadata of the types (it's only known when compiling)
+		vector<std::byte> bytecode;
+		{
+			auto stream = FileStream(metadata.data(), metadata.size());
+			stream.Read(&bytecode);
+
+			const auto type_count = stream.ReadAs<uint32_t>();
+			for (uint32_t i = 0; i < type_count; i++)
+			{
+				const auto type_name = stream.ReadAs<string>();
+				stream.Read(&m_type_metadata[type_name]);
+			}
+
+			m_dependencies.resize(stream.ReadAs<uint32_t>());
+			for (auto& [dependency_path, dependency_hash] : m_dependencies)
+			{
+				stream.Read(&dependency_path);
+				stream.Read(&dependency_hash);
+			}
+		}
+
+		m_module = scripting->GetAsIScriptEngine()->GetModule(m_moduleName.c_str(), asGM_ALWAYS_CREATE);
+		_Module::ByteCodeStream stream(&bytecode);
+		if (!m_module || m_module->LoadByteCode(&stream) < 0)
+		{
+			// E.g. the script interface changed since it was compiled
+			LOG_WARNING("Failed to load the bytecode of \"%s\", it will be compiled", FileSystem::GetFileNameFromFilePath(file_path).c_str());
+			scripting->DiscardModule(m_moduleName);
+			m_module = nullptr;
+			m_type_metadata.clear();
+			m_dependencies.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool Module::Compile(Scripting* scripting, const string& file_path)
+	{
 		// start new module
 		m_scriptBuilder = make_unique<CScriptBuilder>();
-		int result = m_scriptBuilder->StartNewModule(scriptEngine->GetAsIScriptEngine(), m_moduleName.c_str());
+		int result = m_scriptBuilder->StartNewModule(scripting->GetAsIScriptEngine(), m_moduleName.c_str());
 		if (result < 0)
 		{
 			LOG_ERROR("Failed to start new module, make sure there is enough memory for it to be allocated.");
@@ -66,10 +218,10 @@ namespace Spartan
 		}
 
 		// load the script
-		result = m_scriptBuilder->AddSectionFromFile(filePath.c_str());
+		result = m_scriptBuilder->AddSectionFromFile(file_path.c_str());
 		if (result < 0)
 		{
-			LOG_ERROR("Failed to load script \"%s\".", filePath);
+			LOG_ERROR("Failed to load script \"%s\".", file_path.c_str());
 			return false;
 		}
 
@@ -77,21 +229,68 @@ namespace Spartan
 		result = m_scriptBuilder->BuildModule();
 		if (result < 0)
 		{
-			LOG_ERROR("Failed to compile script \"%s\". Correct any errors and try again.", FileSystem::GetFileNameFromFilePath(filePath));
+			LOG_ERROR("Failed to compile script \"%s\". Correct any errors and try again.", FileSystem::GetFileNameFromFilePath(file_path).c_str());
 			return false;
 		}
+		m_module = m_scriptBuilder->GetModule();
 
-		return true;
-	}
+		// Keep the metadata of the types, it's not part of the bytecode
+		for (asUINT i = 0; i < m_module->GetObjectTypeCount(); i++)
+		{
+			const auto type		= m_module->GetObjectTypeByIndex(i);
+			auto metadata		= m_scriptBuilder->GetMetadataForType(type->GetTypeId());
+			if (!metadata.empty())
+			{
+				m_type_metadata[type->GetName()] = move(metadata);
+			}
+		}
 
-	asIScriptModule* Module::GetAsIScriptModule()
-	{
-		if (!m_scriptBuilder)
+		// The first section is the script itself, the rest are the files it included
+		for (uint32_t i = 1; i < m_scriptBuilder->GetSectionCount(); i++)
 		{
-			LOG_ERROR_INVALID_INTERNALS();
-			return false;
+			const string dependency_path = m_scriptBuilder->GetSectionName(i);
+			m_dependencies.emplace_back(dependency_path, scripting->GetFileHash(dependency_path));
+		}
+
+		// Cache the bytecode, the files that the script included make it stale as well
+		const auto import_cache = scripting->GetImportCache();
+		if (!import_cache || m_key == 0)
+			return true;
+
+		vector<std::byte> bytecode;
+		_Module::ByteCodeStream stream_bytecode(&bytecode);
+		if (m_module->SaveByteCode(&stream_bytecode) < 0)
+		{
+			LOG_WARNING("Failed to save the bytecode of \"%s\"", FileSystem::GetFileNameFromFilePath(file_path).c_str());
+			return true;
+		}
+
+		vector<std::byte> metadata;
+		{
+			auto stream = FileStream(&metadata);
+			stream.Write(bytecode);
+			stream.Write(static_cast<uint32_t>(m_type_metadata.size()));
+			for (const auto& [type_name, type_metadata] : m_type_metadata)
+			{
+				stream.Write(type_name);
+				stream.Write(type_metadata);
+			}
+
+			stream.Write(static_cast<uint32_t>(m_dependencies.size()));
+			for (const auto& [dependency_path, dependency_hash] : m_dependencies)
+			{
+				stream.Write(dependency_path);
+				stream.Write(dependency_hash);
+			}
 		}
 
-		return m_scriptBuilder->GetModule();
+		vector<string> dependencies;
+		for (const auto& dependency : m_dependencies)
+		{
+			dependencies.emplace_back(dependency.first);
+		}
+
+		import_cache->Store(m_key, file_path, {}, dependencies, metadata);
+		return true;
 	}
 }
@@ -21,10 +21,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ====
+//= INCLUDES ===========
 #include <string>
 #include <memory>
-//===============
+#include <vector>
+#include <unordered_map>
+//======================
 
 class asIScriptModule;
 class CScriptBuilder;
@@ -34,6 +36,8 @@ namespace Spartan
 {
 	class Scripting;
 
+	// A compiled script. Its bytecode is kept in the import cache (keyed by the source's contents), so a script 
+	// is only compiled the first time it's seen or after it (or a file it includes) changed.
 	class Module
 	{
 	public:
@@ -42,10 +46,25 @@ namespace Spartan
 
 		bool LoadScript(const std::string& filePath);
 		asIScriptModule* GetAsIScriptModule();
+		std::vector<std::string> GetMetadata(const std::string& type_name) const; // of a type, e.g. [parallel]
+		auto GetKey() const { return m_key; }
+
+		// False once the script or a file it includes changed since the module was loaded
+		bool IsCurrent(Scripting* scripting, const std::string& file_path) const;
+
+		// The key of a script's current contents
+		static uint64_t ComputeKey(Scripting* scripting, const std::string& file_path);
 
 	private:
+		bool LoadByteCode(Scripting* scripting, const std::string& file_path);
+		bool Compile(Scripting* scripting, const std::string& file_path);
+
 		std::string m_moduleName;
 		std::unique_ptr<CScriptBuilder> m_scriptBuilder;
 		std::weak_ptr<Scripting> m_scriptEngine;
+		asIScriptModule* m_module = nullptr;
+		std::unordered_map<std::string, std::vector<std::string>> m_type_metadata;
+		std::vector<std::pair<std::string, uint64_t>> m_dependencies; // the included files and their hashes
+		uint64_t m_key = 0;
 	};
 }
\ No newline at end of file
@@ -21,6 +21,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==================
 #include "ScriptInstance.h"
+#include <algorithm>
 #include <angelscript.h>
 #include "Module.h"
 #include "../Core/FileSystem.h"
@@ -65,7 +66,7 @@ namespace Spartan
 		m_scriptPath				= path;
 		m_entity					= entity;
 		m_className					= FileSystem::GetFileNameNoExtensionFromFilePath(m_scriptPath);
-		m_moduleName				= m_className + to_string(m_entity.lock()->GetId());
+		m_moduleName				= m_scriptPath;
 		m_constructorDeclaration	= m_className + " @" + m_className + "(Entity @)";
 
 		// Instantiate the script
@@ -96,6 +97,20 @@ namespace Spartan
 		m_scriptEngine->ExecuteCall(m_updateFunction, m_scriptObject, delta_time);
 	}
 
+	void ScriptInstance::QueueUpdate()
+	{
+		if (!m_scriptEngine)
+		{
+			LOG_ERROR_INVALID_INTERNALS();
+			return;
+		}
+
+		if (m_updateFunction)
+		{
+			m_scriptEngine->QueueUpdate(this);
+		}
+	}
+
 	bool ScriptInstance::CreateScriptObject()
 	{
 		if (!m_scriptEngine)
@@ -104,11 +119,16 @@ namespace Spartan
 			return false;
 		}
 
-		// Create module
-		m_module	= make_shared<Module>(m_moduleName, m_scriptEngine);
-		bool result = m_module->LoadScript(m_scriptPath);
-		if (!result)
-			return false;
+		// Get module, it's compiled by the first instance of the script and shared by the rest
+		m_module = m_scriptEngine->GetModule(m_scriptPath);
+		if (!m_module)
+		{
+			m_module = make_shared<Module>(m_moduleName, m_scriptEngine);
+			if (!m_module->LoadScript(m_scriptPath))
+				return false;
+
+			m_scriptEngine->AddModule(m_scriptPath, m_module);
+		}
 
 		// Get type
 		auto type_id		= m_module->GetAsIScriptModule()->GetTypeIdByDecl(m_className.c_str());
@@ -116,6 +136,10 @@ namespace Spartan
 		if (!type)
 			return false;
 
+		// Classes that only touch their own entity can declare it, their updates are then split across the worker threads
+		const auto metadata	= m_module->GetMetadata(m_className);
+		m_isParallel		= find(metadata.begin(), metadata.end(), "parallel") != metadata.end();
+
 		// Get functions in the script
 		m_startFunction			= type->GetMethodByDecl("void Start()"); // Get the Start function from the script
 		m_updateFunction		= type->GetMethodByDecl("void Update(float delta_time)"); // Get the Update function from the script
@@ -46,6 +46,11 @@ namespace Spartan
 
 		void ExecuteStart();
 		void ExecuteUpdate(float delta_time);
+		void QueueUpdate(); // executed in a batch, with the other instances of the same script
+
+		auto GetScriptObject() const	{ return m_scriptObject; }
+		auto GetUpdateFunction() const	{ return m_updateFunction; }
+		bool IsParallel() const			{ return m_isParallel; }
 
 	private:
 		bool CreateScriptObject();
@@ -62,5 +67,6 @@ namespace Spartan
 		asIScriptFunction* m_updateFunction			= nullptr;
 		std::shared_ptr<Scripting> m_scriptEngine	= nullptr;
 		bool m_isInstantiated						= false;
+		bool m_isParallel							= false;
 	};
 }
@@ -24,6 +24,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <angelscript.h>
 #include "../Rendering/Material.h"
 #include "../Input/Input.h"
+#include "../Physics/Physics.h"
+#include "../Physics/PhysicsQuery.h"
 #include "../World/Entity.h"
 #include "../World/Components/RigidBody.h"
 #include "../World/Components/Camera.h"
@@ -53,6 +55,7 @@ namespace Spartan
 		RegisterTransform();
 		RegisterMaterial();
 		RegisterRigidBody();
+		RegisterPhysics();
 		RegisterEntity();
 		RegisterLog();
 	}
@@ -129,6 +132,8 @@ namespace Spartan
 		m_scriptEngine->RegisterObjectType("Material", 0, asOBJ_REF | asOBJ_NOCOUNT);
 		m_scriptEngine->RegisterObjectType("Camera", 0, asOBJ_REF | asOBJ_NOCOUNT);
 		m_scriptEngine->RegisterObjectType("RigidBody", 0, asOBJ_REF | asOBJ_NOCOUNT);
+		m_scriptEngine->RegisterObjectType("Physics", 0, asOBJ_REF | asOBJ_NOCOUNT);
+		m_scriptEngine->RegisterObjectType("PhysicsQuery", 0, asOBJ_REF | asOBJ_SCOPED);
 		m_scriptEngine->RegisterObjectType("MathHelper", 0, asOBJ_REF | asOBJ_NOCOUNT);
 		m_scriptEngine->RegisterObjectType("Vector2", sizeof(Vector2), asOBJ_VALUE | asOBJ_APP_CLASS | asOBJ_APP_CLASS_CONSTRUCTOR | asOBJ_APP_CLASS_COPY_CONSTRUCTOR | asOBJ_APP_CLASS_DESTRUCTOR);
 		m_scriptEngine->RegisterObjectType("Vector3", sizeof(Vector3), asOBJ_VALUE | asOBJ_APP_CLASS | asOBJ_APP_CLASS_CONSTRUCTOR | asOBJ_APP_CLASS_COPY_CONSTRUCTOR | asOBJ_APP_CLASS_DESTRUCTOR);
@@ -216,6 +221,47 @@ namespace Spartan
 		m_scriptEngine->RegisterObjectMethod("RigidBody", "void SetRotation(Quaternion)", asMETHOD(RigidBody, SetRotation), asCALL_THISCALL);
 	}
 
+	/*------------------------------------------------------------------------------
+									[PHYSICS]
+	------------------------------------------------------------------------------*/
+	static PhysicsQuery* FactoryPhysicsQuery()
+	{
+		return new PhysicsQuery();
+	}
+
+	static void ReleasePhysicsQuery(PhysicsQuery* self)
+	{
+		delete self;
+	}
+
+	static void PhysicsExecuteQuery(PhysicsQuery& query, Physics* self)
+	{
+		self->Query(&query);
+	}
+
+	void ScriptInterface::RegisterPhysics()
+	{
+		auto r = 0;
+
+		// Query batches are scoped, scripts declare them as values and they are freed when they go out of scope
+		r = m_scriptEngine->RegisterObjectBehaviour("PhysicsQuery", asBEHAVE_FACTORY, "PhysicsQuery @f()",									asFUNCTION(FactoryPhysicsQuery),					asCALL_CDECL);			SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectBehaviour("PhysicsQuery", asBEHAVE_RELEASE, "void f()",											asFUNCTION(ReleasePhysicsQuery),					asCALL_CDECL_OBJLAST);	SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectMethod("PhysicsQuery", "uint AddRay(const Vector3 &in, const Vector3 &in)",						asMETHOD(PhysicsQuery, AddRay),						asCALL_THISCALL);		SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectMethod("PhysicsQuery", "uint AddSweep(const Vector3 &in, const Vector3 &in, float)",			asMETHOD(PhysicsQuery, AddSweep),					asCALL_THISCALL);		SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectMethod("PhysicsQuery", "uint AddOverlap(const Vector3 &in, float)",								asMETHOD(PhysicsQuery, AddOverlap),					asCALL_THISCALL);		SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectMethod("PhysicsQuery", "uint GetCount() const",													asMETHOD(PhysicsQuery, GetCount),					asCALL_THISCALL);		SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectMethod("PhysicsQuery", "void Clear()",															asMETHOD(PhysicsQuery, Clear),						asCALL_THISCALL);		SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectMethod("PhysicsQuery", "bool IsHit(uint) const",												asMETHOD(PhysicsQuery, IsHit),						asCALL_THISCALL);		SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectMethod("PhysicsQuery", "float GetHitFraction(uint) const",										asMETHOD(PhysicsQuery, GetHitFraction),				asCALL_THISCALL);		SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectMethod("PhysicsQuery", "Vector3 GetHitPosition(uint) const",									asMETHOD(PhysicsQuery, GetHitPosition),				asCALL_THISCALL);		SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectMethod("PhysicsQuery", "Vector3 GetHitNormal(uint) const",										asMETHOD(PhysicsQuery, GetHitNormal),				asCALL_THISCALL);		SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectMethod("PhysicsQuery", "RigidBody @GetHitBody(uint) const",										asMETHOD(PhysicsQuery, GetHitBody),					asCALL_THISCALL);		SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectMethod("PhysicsQuery", "Entity @GetHitEntity(uint) const",										asMETHOD(PhysicsQuery, GetHitEntity),				asCALL_THISCALL);		SPARTAN_ASSERT(r >= 0);
+
+		r = m_scriptEngine->RegisterGlobalProperty("Physics physics", m_context->GetSubsystem<Physics>().get());																									SPARTAN_ASSERT(r >= 0);
+		r = m_scriptEngine->RegisterObjectMethod("Physics", "void Query(PhysicsQuery &inout)",												asFUNCTION(PhysicsExecuteQuery),					asCALL_CDECL_OBJLAST);	SPARTAN_ASSERT(r >= 0);
+	}
+
 	/*------------------------------------------------------------------------------
 										[VECTOR2]
 	------------------------------------------------------------------------------*/
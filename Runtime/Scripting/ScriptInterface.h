@@ -40,6 +40,7 @@ namespace Spartan
 		void RegisterTransform();
 		void RegisterMaterial();
 		void RegisterRigidBody();
+		void RegisterPhysics();
 		void RegisterVector2();
 		void RegisterVector3();
 		void RegisterQuaternion();
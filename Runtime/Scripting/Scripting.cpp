@@ -21,15 +21,45 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =================================
 #include "Scripting.h"
+#include <atomic>
+#include <algorithm>
 #include <scriptstdstring/scriptstdstring.cpp>
 #include "ScriptInterface.h"
+#include "ScriptInstance.h"
+#include "Module.h"
 #include "../Logging/Log.h"
 #include "../Core/FileSystem.h"
 #include "../Core/EventSystem.h"
 #include "../Core/Settings.h"
 #include "../Core/Context.h"
+#include "../Threading/Threading.h"
+#include "../Resource/ResourceCache.h"
+#include "../Resource/ImportCache.h"
+#include "../Math/MathHelper.h"
 //===========================================
 
+namespace Spartan
+{
+	struct Scripting_ContextPool
+	{
+		std::vector<asIScriptContext*> contexts;
+	};
+}
+
+namespace _Scripting
+{
+	using namespace Spartan;
+
+	// A thread finds its pool through these, the generation changes whenever the pools are released
+	static std::atomic<uint64_t> pool_generation				= 1;
+	static thread_local Scripting_ContextPool* pool				= nullptr;
+	static thread_local uint64_t pool_generation_thread			= 0;
+
+	// Parallel classes are split in chunks, a few per thread so that uneven scripts even out
+	static const uint32_t update_chunks_per_thread	= 4;
+	static const uint32_t update_chunk_size_min		= 32;
+}
+
 namespace Spartan
 {
 	Scripting::Scripting(Context* context) : ISubsystem(context)
@@ -51,6 +81,15 @@ namespace Spartan
 
     bool Scripting::Initialize()
     {
+        m_threading = m_context->GetSubsystem<Threading>().get();
+
+        // Scripts are executed by the worker threads too
+        if (asPrepareMultithread() < 0)
+        {
+            LOG_ERROR("Failed to prepare AngelScript for multi-threading");
+            return false;
+        }
+
         m_scriptEngine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
         if (!m_scriptEngine)
         {
@@ -81,13 +120,19 @@ namespace Spartan
 
     void Scripting::Clear()
 	{
-		for (auto& context : m_contexts)
+		m_update_queue.clear();
+
+		// Nothing can be executing, so the pools of all threads can be released
+		lock_guard<mutex> lock(m_context_pools_mutex);
+		for (auto& pool : m_context_pools)
 		{
-			context->Release();
+			for (auto& context : pool->contexts)
+			{
+				context->Release();
+			}
 		}
-
-		m_contexts.clear();
-		m_contexts.shrink_to_fit();
+		m_context_pools.clear();
+		_Scripting::pool_generation++;
 	}
 
 	asIScriptEngine* Scripting::GetAsIScriptEngine()
@@ -102,22 +147,21 @@ namespace Spartan
 	// They say you must pool them to avoid overhead. So I do as they say.
 	asIScriptContext* Scripting::RequestContext()
 	{
-		asIScriptContext* context = nullptr;
-		if (m_contexts.size())
-		{
-			context = *m_contexts.rbegin();
-			m_contexts.pop_back();
-		}
-		else
+		auto& contexts = GetContextPool()->contexts;
+
+		if (!contexts.empty())
 		{
-			context = m_scriptEngine->CreateContext();
+			const auto context = contexts.back();
+			contexts.pop_back();
+			return context;
 		}
 
-		return context;
+		return m_scriptEngine->CreateContext();
 	}
 
 	// A context should be returned after calling an AngelScript function, 
-	// it will be inserted back in the pool for re-use
+	// it will be inserted back in the pool (of the calling thread) for re-use.
+	// It's unprepared first, so that it doesn't keep the object it was called on alive.
 	void Scripting::ReturnContext(asIScriptContext* context)
 	{
 		if (!context)
@@ -125,8 +169,23 @@ namespace Spartan
 			LOG_ERROR("Scripting::ReturnContext: Context is null");
 			return;
 		}
-		m_contexts.push_back(context);
+
 		context->Unprepare();
+		GetContextPool()->contexts.emplace_back(context);
+	}
+
+	Scripting_ContextPool* Scripting::GetContextPool()
+	{
+		const auto generation = _Scripting::pool_generation.load();
+		if (_Scripting::pool_generation_thread != generation)
+		{
+			lock_guard<mutex> lock(m_context_pools_mutex);
+			m_context_pools.emplace_back(make_unique<Scripting_ContextPool>());
+			_Scripting::pool					= m_context_pools.back().get();
+			_Scripting::pool_generation_thread	= generation;
+		}
+
+		return _Scripting::pool;
 	}
 
 	/*------------------------------------------------------------------------------
@@ -156,14 +215,115 @@ namespace Spartan
 		return true;
 	}
 
+	void Scripting::ExecuteUpdates(const float delta_time)
+	{
+		if (m_update_queue.empty())
+			return;
+
+		// Group the instances by class, instances of a script share their module, so they share the Update function as well
+		stable_sort(m_update_queue.begin(), m_update_queue.end(), [](const ScriptInstance* a, const ScriptInstance* b)
+		{
+			return a->GetUpdateFunction() < b->GetUpdateFunction();
+		});
+
+		for (uint32_t start = 0, end = 0; start < static_cast<uint32_t>(m_update_queue.size()); start = end)
+		{
+			const auto function = m_update_queue[start]->GetUpdateFunction();
+			for (end = start + 1; end < static_cast<uint32_t>(m_update_queue.size()) && m_update_queue[end]->GetUpdateFunction() == function; end++) {}
+
+			const auto count		= end - start;
+			const auto instances	= &m_update_queue[start];
+			const auto chunk_size	= Math::Max(count / ((m_threading->GetThreadCount() + 1) * _Scripting::update_chunks_per_thread), _Scripting::update_chunk_size_min);
+			const auto chunk_count	= (count + chunk_size - 1) / chunk_size;
+
+			if (!m_update_queue[start]->IsParallel() || chunk_count == 1)
+			{
+				ExecuteUpdateBatch(function, instances, count, delta_time);
+				continue;
+			}
+
+			m_threading->ForEach([this, function, instances, count, chunk_size, delta_time](const uint32_t chunk)
+			{
+				const auto chunk_start = chunk * chunk_size;
+				ExecuteUpdateBatch(function, instances + chunk_start, Math::Min(chunk_size, count - chunk_start), delta_time);
+			}, chunk_count);
+		}
+
+		m_update_queue.clear();
+	}
+
+	void Scripting::ExecuteUpdateBatch(asIScriptFunction* function, ScriptInstance* const* instances, const uint32_t count, const float delta_time)
+	{
+		// One context for the whole batch, after the first instance it's prepared for the same function again, which is cheap
+		auto context = RequestContext();
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			context->Prepare(function);
+			context->SetObject(instances[i]->GetScriptObject());
+			context->SetArgFloat(0, delta_time);
+
+			if (context->Execute() == asEXECUTION_EXCEPTION)
+			{
+				LogExceptionInfo(context);
+			}
+		}
+
+		ReturnContext(context);
+	}
+
 	/*------------------------------------------------------------------------------
 										[MODULE]
 	------------------------------------------------------------------------------*/
+	shared_ptr<Module> Scripting::GetModule(const string& file_path)
+	{
+		const auto it = m_modules.find(file_path);
+		auto module = it != m_modules.end() ? it->second.lock() : nullptr;
+
+		// A script that changed (or a file it includes) since its module was loaded is loaded again (new instances get the new version)
+		if (module && !module->IsCurrent(this, file_path))
+			return nullptr;
+
+		return module;
+	}
+
+	void Scripting::AddModule(const string& file_path, const shared_ptr<Module>& module)
+	{
+		m_modules[file_path] = module;
+	}
+
 	void Scripting::DiscardModule(string moduleName)
 	{
 		m_scriptEngine->DiscardModule(moduleName.c_str());
 	}
 
+	ImportCache* Scripting::GetImportCache() const
+	{
+		const auto resource_cache = m_context->GetSubsystem<ResourceCache>();
+		return resource_cache ? resource_cache->GetImportCache() : nullptr;
+	}
+
+	uint64_t Scripting::GetFileHash(const string& file_path)
+	{
+		// Instances of a script look its module up often, a file is only hashed again after it was written to
+		const auto write_time = FileSystem::GetLastWriteTime(file_path);
+		if (write_time == 0)
+			return 0;
+
+		{
+			lock_guard<mutex> guard(m_file_hashes_mutex);
+			const auto it = m_file_hashes.find(file_path);
+			if (it != m_file_hashes.end() && it->second.first == write_time)
+				return it->second.second;
+		}
+
+		const auto hash = ImportCache::ComputeFileHash(file_path);
+
+		lock_guard<mutex> guard(m_file_hashes_mutex);
+		m_file_hashes[file_path] = { write_time, hash };
+		return hash;
+	}
+
 	/*------------------------------------------------------------------------------
 									[PRIVATE]
 	------------------------------------------------------------------------------*/
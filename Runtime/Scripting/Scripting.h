@@ -24,6 +24,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ==================
 #include <vector>
 #include <string>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include "../Core/ISubsystem.h"
 //=============================
 
@@ -41,6 +44,10 @@ struct asSMessageInfo;
 namespace Spartan
 {
 	class Module;
+	class ImportCache;
+	class ScriptInstance;
+	class Threading;
+	struct Scripting_ContextPool;
 
 	class Scripting : public ISubsystem
 	{
@@ -55,19 +62,37 @@ namespace Spartan
 		void Clear();
 		asIScriptEngine* GetAsIScriptEngine();
 
-		// Contexts
+		// Contexts, every thread has a pool of its own
 		asIScriptContext* RequestContext();
 		void ReturnContext(asIScriptContext* ctx);
 
 		// Calls
 		bool ExecuteCall(asIScriptFunction* scriptFunc, asIScriptObject* obj, float delta_time = -1.0f);
 
-		// Modules
+		// Update calls are queued while the entities tick and executed in batches, one per script class. The instances
+		// of classes that are declared [parallel] are split across the worker threads, so they must only touch their own entity.
+		void QueueUpdate(ScriptInstance* instance) { m_update_queue.emplace_back(instance); }
+		void ExecuteUpdates(float delta_time);
+
+		// Modules, a script is compiled once and its module is shared by every instance of it
+		std::shared_ptr<Module> GetModule(const std::string& file_path);
+		void AddModule(const std::string& file_path, const std::shared_ptr<Module>& module);
 		void DiscardModule(std::string moduleName);
+		ImportCache* GetImportCache() const; // where the bytecode of the modules is cached
+		uint64_t GetFileHash(const std::string& file_path); // of a script or a file it includes, 0 if it can't be read
 
 	private:
+		Scripting_ContextPool* GetContextPool();
+		void ExecuteUpdateBatch(asIScriptFunction* function, ScriptInstance* const* instances, uint32_t count, float delta_time);
+
         asIScriptEngine* m_scriptEngine = nullptr;
-		std::vector<asIScriptContext*> m_contexts;
+		std::vector<std::unique_ptr<Scripting_ContextPool>> m_context_pools;
+		std::mutex m_context_pools_mutex;
+		std::vector<ScriptInstance*> m_update_queue;
+		std::unordered_map<std::string, std::weak_ptr<Module>> m_modules;
+		std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> m_file_hashes; // last write time and hash
+		std::mutex m_file_hashes_mutex;
+		Threading* m_threading = nullptr;
 
 		void LogExceptionInfo(asIScriptContext* ctx);
 		void message_callback(const asSMessageInfo& msg);
@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <thread>
 #include <mutex>
 #include <deque>
+#include <atomic>
 #include <functional>
 #include "../Logging/Log.h"
 #include "../Core/ISubsystem.h"
@@ -80,37 +81,33 @@ namespace Spartan
 			m_condition_var.notify_one();
 		}
 
+        // Splits [0, range) into a chunk per available thread (plus one for the current thread) and calls function(start, end) for each.
+        // The current thread takes part, and returns once every call has returned.
         template <typename Function>
         void Loop(Function&& function, uint32_t range)
         {
-            uint32_t available_threads  = GetThreadsAvailable();
-            vector<bool> tasks_done     = vector<bool>(available_threads, false);
-            uint32_t task_count         = available_threads + 1; // plus one for the current thread
+            const uint32_t chunk_count  = GetThreadsAvailable() + 1;
+            const uint32_t chunk_size   = range / chunk_count;
 
-            uint32_t start  = 0;
-            uint32_t end    = 0;
-            for (uint32_t i = 0; i < available_threads; i++)
+            const auto chunk = [&function, range, chunk_count, chunk_size](const uint32_t i)
             {
-                start   = (range / task_count) * i;
-                end     = start + (range / task_count);
-
-                // Kick off task
-                AddTask([&function, &tasks_done, i, start, end] { function(start, end); tasks_done[i] = true; });
-            }
-
-            // Do last task in the current thread
-            function(end, range);
-
-            // Wait till the threads are done
-            uint32_t tasks = 0;
-            while (tasks != tasks_done.size())
-            {
-                tasks = 0;
-                for (const bool job_done : tasks_done)
+                const uint32_t start    = chunk_size * i;
+                const uint32_t end      = (i == chunk_count - 1) ? range : start + chunk_size;
+                if (start != end)
                 {
-                    tasks += job_done ? 1 : 0;
+                    function(start, end);
                 }
-            }
+            };
+
+            Batch(chunk, chunk_count, chunk_count - 1);
+        }
+
+        // Calls function(i) for every i in [0, count), threads take one index at a time so it suits work of uneven cost.
+        // The current thread takes part, and returns once every call has returned.
+        template <typename Function>
+        void ForEach(Function&& function, uint32_t count)
+        {
+            Batch(function, count, m_thread_count < count ? m_thread_count : count);
         }
 
         uint32_t GetThreadCount()       { return m_thread_count; }
@@ -118,6 +115,45 @@ namespace Spartan
         uint32_t GetThreadsAvailable();
 
 	private:
+        // Calls function(i) for every i in [0, count), on the current thread and on up to helper_count threads. While waiting, the current
+        // thread only takes indices of its own batch, never other queued tasks (they could touch state that the caller is in the middle of).
+        // Helpers that start once every index is taken return without touching the function, so the batch doesn't wait for them to be picked
+        // up, and a batch issued from a task can't starve.
+        template <typename Function>
+        void Batch(Function& function, const uint32_t count, const uint32_t helper_count)
+        {
+            struct State
+            {
+                std::atomic<uint32_t> index_next        = 0;
+                std::atomic<uint32_t> helpers_running   = 0;
+            };
+            const auto state = std::make_shared<State>();
+
+            for (uint32_t helper = 0; helper < helper_count; helper++)
+            {
+                AddTask([state, &function, count]
+                {
+                    state->helpers_running++;
+                    for (uint32_t i = state->index_next++; i < count; i = state->index_next++)
+                    {
+                        function(i);
+                    }
+                    state->helpers_running--;
+                });
+            }
+
+            for (uint32_t i = state->index_next++; i < count; i = state->index_next++)
+            {
+                function(i);
+            }
+
+            // Every index has been taken, wait for the helpers that took some to finish them
+            while (state->helpers_running != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
 		uint32_t m_thread_count = 0;
         uint32_t m_thread_max   = 0;
 		std::vector<std::thread> m_threads;
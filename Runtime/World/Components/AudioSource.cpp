@@ -101,7 +101,7 @@ namespace Spartan
         }
 	}
 	
-	void AudioSource::Deserialize(FileStream* stream)
+	void AudioSource::Decode(FileStream* stream)
 	{
 		stream->Read(&m_mute);
 		stream->Read(&m_play_on_start);
@@ -113,10 +113,21 @@ namespace Spartan
 
         if (stream->ReadAs<bool>())
         {
-            m_audio_clip = m_context->GetSubsystem<ResourceCache>()->GetByName<AudioClip>(stream->ReadAs<string>());
+            stream->Read(&m_audio_clip_name_decoded);
         }
 	}
 
+	void AudioSource::Attach()
+	{
+        if (!m_audio_clip_name_decoded.empty())
+        {
+            m_audio_clip = m_context->GetSubsystem<ResourceCache>()->GetByName<AudioClip>(m_audio_clip_name_decoded);
+            m_audio_clip_name_decoded.clear();
+        }
+
+		OnInitialize();
+	}
+
     void AudioSource::SetAudioClip(const string& file_path)
     {
         // Create and load the audio clip
@@ -126,6 +137,7 @@ namespace Spartan
             // In order for the component to guarantee serialization/deserialization, we cache the audio clip
             m_audio_clip = m_context->GetSubsystem<ResourceCache>()->Cache(audio_clip);
         }
+        MakeDirty();
     }
 
     string AudioSource::GetAudioClipName()
@@ -163,6 +175,7 @@ namespace Spartan
 	
 		m_mute = mute;
 		m_audio_clip->SetMute(mute);
+		MakeDirty();
 	}
 	
 	void AudioSource::SetPriority(int priority)
@@ -174,6 +187,7 @@ namespace Spartan
 		// to 256 (least important), default = 128.
 		m_priority = static_cast<int>(Clamp(priority, 0, 255));
 		m_audio_clip->SetPriority(m_priority);
+		MakeDirty();
 	}
 	
 	void AudioSource::SetVolume(float volume)
@@ -183,6 +197,7 @@ namespace Spartan
 	
 		m_volume = Clamp(volume, 0.0f, 1.0f);
 		m_audio_clip->SetVolume(m_volume);
+		MakeDirty();
 	}
 	
 	void AudioSource::SetPitch(float pitch)
@@ -192,6 +207,7 @@ namespace Spartan
 	
 		m_pitch = Clamp(pitch, 0.0f, 3.0f);
 		m_audio_clip->SetPitch(m_pitch);
+		MakeDirty();
 	}
 	
 	void AudioSource::SetPan(float pan)
@@ -202,5 +218,6 @@ namespace Spartan
 		// Pan level, from -1.0 (left) to 1.0 (right).
 		m_pan = Clamp(pan, -1.0f, 1.0f);
 		m_audio_clip->SetPan(m_pan);
+		MakeDirty();
 	}
 }
@@ -44,7 +44,8 @@ namespace Spartan
 		void OnRemove() override;
 		void OnTick(float delta_time) override;
 		void Serialize(FileStream* stream) override;
-		void Deserialize(FileStream* stream) override;
+		void Decode(FileStream* stream) override;
+		void Attach() override;
 		//============================================
 
 		//= PROPERTIES ===================================================================
@@ -58,10 +59,10 @@ namespace Spartan
 		void SetMute(bool mute);
 
 		bool GetPlayOnStart() const						{ return m_play_on_start; }
-		void SetPlayOnStart(const bool play_on_start)	{ m_play_on_start = play_on_start; }
+		void SetPlayOnStart(const bool play_on_start)	{ m_play_on_start = play_on_start; MakeDirty(); }
 
 		bool GetLoop() const			{ return m_loop; }
-		void SetLoop(const bool loop)	{ m_loop = loop; }
+		void SetLoop(const bool loop)	{ m_loop = loop; MakeDirty(); }
 
 		int GetPriority() const { return m_priority; }
 		void SetPriority(int priority);
@@ -86,5 +87,6 @@ namespace Spartan
 		float m_pitch;
 		float m_pan;
 		bool m_audio_clip_loaded;
+		std::string m_audio_clip_name_decoded; // resolved once attached
 	};
 }
@@ -89,34 +89,34 @@ namespace Spartan
 		stream->Write(m_far_plane);
 	}
 
-	void Camera::Deserialize(FileStream* stream)
+	void Camera::Decode(FileStream* stream)
 	{
 		stream->Read(&m_clear_color);
 		m_projection_type = ProjectionType(stream->ReadAs<uint32_t>());
 		stream->Read(&m_fov_horizontal_rad);
 		stream->Read(&m_near_plane);
 		stream->Read(&m_far_plane);
-
-		m_mView         = ComputeViewMatrix();
-		m_mProjection   = ComputeProjection();
 	}
 
 	void Camera::SetNearPlane(const float near_plane)
 	{
 		m_near_plane = Max(0.01f, near_plane);
 		m_isDirty = true;
+		MakeDirty();
 	}
 
 	void Camera::SetFarPlane(const float far_plane)
 	{
 		m_far_plane = far_plane;
 		m_isDirty = true;
+		MakeDirty();
 	}
 
 	void Camera::SetProjection(const ProjectionType projection)
 	{
 		m_projection_type = projection;
 		m_isDirty = true;
+		MakeDirty();
 	}
 
     float Camera::GetFovHorizontalDeg() const
@@ -133,6 +133,7 @@ namespace Spartan
 	{
 		m_fov_horizontal_rad = DegreesToRadians(fov);
 		m_isDirty = true;
+		MakeDirty();
 	}
 
     const Spartan::RHI_Viewport& Camera::GetViewport()
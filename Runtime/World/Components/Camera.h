@@ -56,7 +56,7 @@ namespace Spartan
 		void OnInitialize() override;
 		void OnTick(float delta_time) override;
 		void Serialize(FileStream* stream) override;
-		void Deserialize(FileStream* stream) override;
+		void Decode(FileStream* stream) override;
 		//============================================
 
 		//= MATRICES ============================================================
@@ -98,8 +98,9 @@ namespace Spartan
 		//= MISC ========================================================================
 		bool IsInViewFrustrum(Renderable* renderable);
 		bool IsInViewFrustrum(const Math::Vector3& center, const Math::Vector3& extents);
+		const Math::Frustum& GetFrustrum() const { return m_frustrum; }
 		const Math::Vector4& GetClearColor() const		{ return m_clear_color; }
-		void SetClearColor(const Math::Vector4& color)	{ m_clear_color = color; }
+		void SetClearColor(const Math::Vector4& color)	{ m_clear_color = color; MakeDirty(); }
 		//===============================================================================
 
         Math::Matrix ComputeViewMatrix();
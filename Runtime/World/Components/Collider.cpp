@@ -25,6 +25,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RigidBody.h"
 #include "Renderable.h"
 #include "../Entity.h"
+#include "../../Core/Context.h"
+#include "../../Physics/Physics.h"
+#include "../../Physics/PhysicsShapeCache.h"
 #include "../../IO/FileStream.h"
 #include "../../Physics/BulletPhysicsHelper.h"
 #include "../../Logging/Log.h"
@@ -34,7 +37,6 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <BulletCollision/CollisionShapes/btCapsuleShape.h>
 #include <BulletCollision/CollisionShapes/btStaticPlaneShape.h>
 #include <BulletCollision/CollisionShapes/btConeShape.h>
-#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
 #pragma warning(pop)
 //=============================================================
 
@@ -50,7 +52,6 @@ namespace Spartan
 		m_shapeType = ColliderShape_Box;
 		m_center	= Vector3::Zero;
 		m_size		= Vector3::One;
-		m_shape		= nullptr;
 
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_size, Vector3);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_center, Vector3);
@@ -88,12 +89,16 @@ namespace Spartan
 		stream->Write(m_center);
 	}
 
-	void Collider::Deserialize(FileStream* stream)
+	void Collider::Decode(FileStream* stream)
 	{
 		m_shapeType = ColliderShape(stream->ReadAs<uint32_t>());
 		stream->Read(&m_size);
 		stream->Read(&m_center);
+	}
 
+	void Collider::Attach()
+	{
+		// Not OnInitialize(), the decoded size takes precedence over the renderable's
 		Shape_Update();
 	}
 
@@ -108,6 +113,7 @@ namespace Spartan
 		m_size.z = Clamp(m_size.z, M_EPSILON, INFINITY);
 
 		Shape_Update();
+		MakeDirty();
 	}
 
 	void Collider::SetCenter(const Vector3& center)
@@ -117,6 +123,7 @@ namespace Spartan
 
 		m_center = center;
 		RigidBody_SetCenterOfMass(m_center);
+		MakeDirty();
 	}
 
 	void Collider::SetShapeType(ColliderShape type)
@@ -126,6 +133,7 @@ namespace Spartan
 
 		m_shapeType = type;
 		Shape_Update();
+		MakeDirty();
 	}
 
 	void Collider::SetOptimize(bool optimize)
@@ -135,6 +143,7 @@ namespace Spartan
 
 		m_optimize = optimize;
 		Shape_Update();
+		MakeDirty();
 	}
 
 	void Collider::Shape_Update()
@@ -145,35 +154,37 @@ namespace Spartan
 		switch (m_shapeType)
 		{
 		case ColliderShape_Box:
-			m_shape = new btBoxShape(ToBtVector3(m_size * 0.5f));
+			m_shape = shared_ptr<btCollisionShape>(new btBoxShape(ToBtVector3(m_size * 0.5f)));
 			m_shape->setLocalScaling(ToBtVector3(worldScale));
 			break;
 
 		case ColliderShape_Sphere:
-			m_shape = new btSphereShape(m_size.x * 0.5f);
+			m_shape = shared_ptr<btCollisionShape>(new btSphereShape(m_size.x * 0.5f));
 			m_shape->setLocalScaling(ToBtVector3(worldScale));
 			break;
 
 		case ColliderShape_StaticPlane:
-			m_shape = new btStaticPlaneShape(btVector3(0.0f, 1.0f, 0.0f), 0.0f);
+			m_shape = shared_ptr<btCollisionShape>(new btStaticPlaneShape(btVector3(0.0f, 1.0f, 0.0f), 0.0f));
 			break;
 
 		case ColliderShape_Cylinder:
-			m_shape = new btCylinderShape(btVector3(m_size.x * 0.5f, m_size.y * 0.5f, m_size.x * 0.5f));
+			m_shape = shared_ptr<btCollisionShape>(new btCylinderShape(btVector3(m_size.x * 0.5f, m_size.y * 0.5f, m_size.x * 0.5f)));
 			m_shape->setLocalScaling(ToBtVector3(worldScale));
 			break;
 
 		case ColliderShape_Capsule:
-			m_shape = new btCapsuleShape(m_size.x * 0.5f, Max(m_size.y - m_size.x, 0.0f));
+			m_shape = shared_ptr<btCollisionShape>(new btCapsuleShape(m_size.x * 0.5f, Max(m_size.y - m_size.x, 0.0f)));
 			m_shape->setLocalScaling(ToBtVector3(worldScale));
 			break;
 
 		case ColliderShape_Cone:
-			m_shape = new btConeShape(m_size.x * 0.5f, m_size.y);
+			m_shape = shared_ptr<btCollisionShape>(new btConeShape(m_size.x * 0.5f, m_size.y));
 			m_shape->setLocalScaling(ToBtVector3(worldScale));
 			break;
 
 		case ColliderShape_Mesh:
+		case ColliderShape_MeshDecomposed:
+		case ColliderShape_MeshStatic:
 			// Get Renderable
 			Renderable* renderable = GetEntity_PtrRaw()->GetComponent<Renderable>().get();
 			if (!renderable)
@@ -182,53 +193,47 @@ namespace Spartan
 				return;
 			}
 
-			// Validate vertex count
-			if (renderable->GeometryVertexCount() >= m_vertexLimit)
+			auto type =
+				m_shapeType == ColliderShape_Mesh			? PhysicsShape_Hull :
+				m_shapeType == ColliderShape_MeshDecomposed	? PhysicsShape_Decomposition :
+				PhysicsShape_Triangles;
+
+			// Bullet can't collide a triangle mesh that moves, dynamic bodies get the convex decomposition of it instead
+			if (type == PhysicsShape_Triangles)
 			{
-				LOG_WARNING("No user defined collider with more than %d vertices is allowed.", m_vertexLimit);
-				return;
+				const auto& rigid_body = m_entity->GetComponent<RigidBody>();
+				if (rigid_body && rigid_body->GetMass() > 0.0f)
+				{
+					LOG_WARNING("Static mesh shapes can't be used by dynamic rigid bodies, using a decomposed mesh shape instead.");
+					type = PhysicsShape_Decomposition;
+				}
 			}
 
-			// Get geometry
-			vector<uint32_t> indices;
-			vector<RHI_Vertex_PosTexNorTan> vertices;
-			renderable->GeometryGet(&indices, &vertices);
-
-			if (vertices.empty())
+			// Validate vertex count (hulls only, the triangle shape has a BVH to deal with large meshes)
+			if (type != PhysicsShape_Triangles && renderable->GeometryVertexCount() >= m_vertexLimit)
 			{
-				LOG_WARNING("No vertices.");
+				LOG_WARNING("No user defined collider with more than %d vertices is allowed.", m_vertexLimit);
 				return;
 			}
 
-			// Construct hull approximation
-			m_shape = new btConvexHullShape(
-				(btScalar*)&vertices[0],					// points
-				renderable->GeometryVertexCount(),			// point count
-				static_cast<uint32_t>(sizeof(RHI_Vertex_PosTexNorTan)));	// stride
-
-			// Scaling has to be done before (potential) optimization
-			m_shape->setLocalScaling(ToBtVector3(worldScale));
-
-			// Optimize if requested
-			if (m_optimize)
+			// Built once per geometry (or loaded from the shape cache) and shared per scale
+			m_shape = m_context->GetSubsystem<Physics>()->GetShapeCache()->Acquire(renderable, type, m_optimize, worldScale);
+			if (!m_shape)
 			{
-				auto hull = static_cast<btConvexHullShape*>(m_shape);
-				hull->optimizeConvexHull();
-				hull->initializePolyhedralFeatures();
+				LOG_WARNING("Failed to construct mesh shape.");
+				return;
 			}
 			break;
 		}
 
-		m_shape->setUserPointer(this);
-
-		RigidBody_SetShape(m_shape);
+		RigidBody_SetShape(m_shape.get());
 		RigidBody_SetCenterOfMass(m_center);
 	}
 
 	void Collider::Shape_Release()
 	{
 		RigidBody_SetShape(nullptr);
-		safe_delete(m_shape);
+		m_shape.reset();
 	}
 
 	void Collider::RigidBody_SetShape(btCollisionShape* shape)
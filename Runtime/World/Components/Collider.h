@@ -42,6 +42,8 @@ namespace Spartan
 		ColliderShape_Capsule,
 		ColliderShape_Cone,
 		ColliderShape_Mesh,
+		ColliderShape_MeshDecomposed,	// several convex hulls, for concave dynamic bodies
+		ColliderShape_MeshStatic,		// the triangles themselves, for static bodies only
 	};
 
 	class SPARTAN_CLASS Collider : public IComponent
@@ -54,7 +56,8 @@ namespace Spartan
 		void OnInitialize() override;
 		void OnRemove() override;
 		void Serialize(FileStream* stream) override;
-		void Deserialize(FileStream* stream) override;
+		void Decode(FileStream* stream) override;
+		void Attach() override;
 		//============================================
 
 		// Bounding box
@@ -72,17 +75,20 @@ namespace Spartan
 		// Collision shape
 		const auto& GetShape() { return m_shape; }
 
+		// Simplifies the hulls of the mesh shapes
 		bool GetOptimize() { return m_optimize; }
 		void SetOptimize(bool optimize);
 
 	private:
+		friend class RigidBody; // static mesh shapes depend on the mass, see RigidBody::SetMass()
+
 		void Shape_Update();
 		void Shape_Release();
 		void RigidBody_SetShape(btCollisionShape* shape);
 		void RigidBody_SetCenterOfMass(const Math::Vector3& center);
 
 		ColliderShape m_shapeType;
-		btCollisionShape* m_shape;
+		std::shared_ptr<btCollisionShape> m_shape; // mesh shapes are shared with colliders of the same geometry and scale
 		Math::Vector3 m_size;
 		Math::Vector3 m_center;
 		uint32_t m_vertexLimit = 100000;
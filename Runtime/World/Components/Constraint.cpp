@@ -109,7 +109,7 @@ namespace Spartan
 		stream->Write(!m_bodyOther.expired() ? m_bodyOther.lock()->GetId() : static_cast<uint32_t>(0));
 	}
 
-	void Constraint::Deserialize(FileStream* stream)
+	void Constraint::Decode(FileStream* stream)
 	{
 		uint32_t constraint_type = 0;
 		stream->Read(&constraint_type);
@@ -119,8 +119,13 @@ namespace Spartan
 		stream->Read(&m_highLimit);
 		stream->Read(&m_lowLimit);
 
-		const auto body_other_id = stream->ReadAs<uint32_t>();
-		m_bodyOther = GetContext()->GetSubsystem<World>()->EntityGetById(body_other_id);
+		stream->Read(&m_bodyOther_id_decoded);
+	}
+
+	void Constraint::Attach()
+	{
+		m_bodyOther = GetContext()->GetSubsystem<World>()->EntityGetById(m_bodyOther_id_decoded);
+		m_bodyOther_id_decoded = 0;
 
 		Construct();
 	}
@@ -131,6 +136,7 @@ namespace Spartan
 		{
 			m_constraintType = type;
 			Construct();
+			MakeDirty();
 		}
 	}
 
@@ -140,6 +146,7 @@ namespace Spartan
 		{
 			m_position = position;
 			ApplyFrames();
+			MakeDirty();
 		}
 	}
 
@@ -149,6 +156,7 @@ namespace Spartan
 		{
 			m_rotation = rotation;
 			ApplyFrames();
+			MakeDirty();
 		}
 	}
 
@@ -158,6 +166,7 @@ namespace Spartan
 		{
 			m_positionOther = position;
 			ApplyFrames();
+			MakeDirty();
 		}
 	}
 
@@ -167,6 +176,7 @@ namespace Spartan
 		{
 			m_rotationOther = rotation;
 			ApplyFrames();
+			MakeDirty();
 		}
 	}
 
@@ -183,6 +193,7 @@ namespace Spartan
 
 		m_bodyOther = body_other;
 		Construct();
+		MakeDirty();
 	}
 
 	void Constraint::SetHighLimit(const Vector2& limit)
@@ -191,6 +202,7 @@ namespace Spartan
 		{
 			m_highLimit = limit;
 			ApplyLimits();
+			MakeDirty();
 		}
 	}
 
@@ -200,6 +212,7 @@ namespace Spartan
 		{
 			m_lowLimit = limit;
 			ApplyLimits();
+			MakeDirty();
 		}
 	}
 
@@ -214,6 +227,7 @@ namespace Spartan
 			if (rigid_body_own)	rigid_body_own->RemoveConstraint(this);
 			if (rigid_body_other) rigid_body_other->RemoveConstraint(this);
 
+			m_physics->Sync();
 			m_physics->GetWorld()->removeConstraint(m_constraint);
 			delete m_constraint;
 			m_constraint = nullptr;
@@ -360,6 +374,7 @@ namespace Spartan
 			}
 
 		    ApplyLimits();
+		    m_physics->Sync();
 		    m_physics->GetWorld()->addConstraint(m_constraint, !m_collisionWithLinkedBody);
 		}
 	}
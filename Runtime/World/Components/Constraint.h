@@ -57,7 +57,8 @@ namespace Spartan
 		void OnRemove() override;
 		void OnTick(float delta_time) override;
 		void Serialize(FileStream* stream) override;
-		void Deserialize(FileStream* stream) override;
+		void Decode(FileStream* stream) override;
+		void Attach() override;
 		//============================================
 
 		ConstraintType GetConstraintType() { return m_constraintType; }
@@ -106,6 +107,7 @@ namespace Spartan
 		Math::Vector2 m_lowLimit;
 
 		std::weak_ptr<Entity> m_bodyOther;
+		uint32_t m_bodyOther_id_decoded = 0; // resolved once attached
 		Math::Vector3 m_positionOther;
 		Math::Quaternion m_rotationOther;
 	
@@ -79,11 +79,14 @@ namespace Spartan
         stream->Write(m_file_paths);
     }
 
-    void Environment::Deserialize(FileStream* stream)
+    void Environment::Decode(FileStream* stream)
     {
         m_environment_type = static_cast<Environment_Type>(stream->ReadAs<uint8_t>());
         stream->Read(&m_file_paths);
+    }
 
+    void Environment::Attach()
+    {
         m_context->GetSubsystem<Threading>()->AddTask([this]
         {
             if (m_environment_type == Enviroment_Cubemap)
@@ -115,6 +118,7 @@ namespace Spartan
 
         // Save file path for serialization/deserialization
         m_file_paths = { texture->GetResourceFilePath() };
+        MakeDirty();
     }
 
     void Environment::SetFromTextureArray(const vector<string>& file_paths)
@@ -125,33 +129,33 @@ namespace Spartan
         LOG_INFO("Creating sky box...");
 
 		// Load all textures (sides)
-		vector<vector<vector<std::byte>>> cubemapData;
+		vector<RHI_TextureMips> cubemapData;
 
 		// Load all the cubemap sides
         auto m_generate_mipmaps = false;
 		auto loaderTex = make_shared<RHI_Texture2D>(GetContext(), m_generate_mipmaps);
 		{
 			loaderTex->LoadFromFile(file_paths[0]);
-			cubemapData.emplace_back(loaderTex->GetData());
+			cubemapData.emplace_back(move(loaderTex->GetMips()));
 
 			loaderTex->LoadFromFile(file_paths[1]);
-			cubemapData.emplace_back(loaderTex->GetData());
+			cubemapData.emplace_back(move(loaderTex->GetMips()));
 
 			loaderTex->LoadFromFile(file_paths[2]);
-			cubemapData.emplace_back(loaderTex->GetData());
+			cubemapData.emplace_back(move(loaderTex->GetMips()));
 
 			loaderTex->LoadFromFile(file_paths[3]);
-			cubemapData.emplace_back(loaderTex->GetData());
+			cubemapData.emplace_back(move(loaderTex->GetMips()));
 
 			loaderTex->LoadFromFile(file_paths[4]);
-			cubemapData.emplace_back(loaderTex->GetData());
+			cubemapData.emplace_back(move(loaderTex->GetMips()));
 
 			loaderTex->LoadFromFile(file_paths[5]);
-			cubemapData.emplace_back(loaderTex->GetData());
+			cubemapData.emplace_back(move(loaderTex->GetMips()));
 		}
 
 		// Texture
-        auto texture = make_shared<RHI_TextureCube>(GetContext(), loaderTex->GetWidth(), loaderTex->GetHeight(), loaderTex->GetFormat(), cubemapData);
+        auto texture = make_shared<RHI_TextureCube>(GetContext(), loaderTex->GetWidth(), loaderTex->GetHeight(), loaderTex->GetFormat(), move(cubemapData));
         texture->SetResourceFilePath(m_context->GetSubsystem<ResourceCache>()->GetProjectDirectory() + "environment" + EXTENSION_TEXTURE);
         texture->SetWidth(loaderTex->GetWidth());
         texture->SetHeight(loaderTex->GetHeight());
@@ -43,7 +43,8 @@ namespace Spartan
         //= IComponent ===============================
         void OnTick(float delta_time) override;
         void Serialize(FileStream* stream) override;
-        void Deserialize(FileStream* stream) override;
+        void Decode(FileStream* stream) override;
+        void Attach() override;
         //============================================
 
         void LoadDefault();
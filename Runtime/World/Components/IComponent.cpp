@@ -56,6 +56,14 @@ namespace Spartan
 		return m_entity->GetPtrShared();
 	}
 
+	void IComponent::MakeDirty() const
+	{
+		if (m_entity)
+		{
+			m_entity->MakeDirty();
+		}
+	}
+
 	string IComponent::GetEntityName() const
 	{
 		if (!m_entity)
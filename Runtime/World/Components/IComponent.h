@@ -86,7 +86,13 @@ namespace Spartan
 		virtual void Serialize(FileStream* stream) {}
 
 		// Runs when the entity is being loaded
-		virtual void Deserialize(FileStream* stream) {}
+		void Deserialize(FileStream* stream) { Decode(stream); Attach(); }
+
+		// Loading in two steps, so that worlds can decode their components on worker threads, before the entities are part of the world.
+		// Decode() only reads the stream into the component. Attach() runs on the loading thread and does the rest (looks up other
+		// entities and resources, adds to physics), it also stands in for OnInitialize(), which decoded components don't get.
+		virtual void Decode(FileStream* stream) {}
+		virtual void Attach() { OnInitialize(); }
 
 		//= TYPE ===================================
 		template <typename T>
@@ -111,6 +117,7 @@ namespace Spartan
 			{
 				m_attributes[i].setter(attributes[i].getter());
 			}
+			MakeDirty();
 		}
 		//=========================================================================================
 
@@ -127,6 +134,10 @@ namespace Spartan
 		[this]()						{ return value; },								\
 		[this](const std::any& valueIn) { value = std::any_cast<type>(valueIn); });		\
 
+		// Marks the entity as changed, so that the world encodes it again the next time it's saved.
+		// Setters of anything that the component serializes should call it.
+		void MakeDirty() const;
+
 		// Registers an attribute
 		void RegisterAttribute(std::function<std::any()>&& getter, std::function<void(std::any)>&& setter)
 		{ 
@@ -132,9 +132,9 @@ namespace Spartan
 		stream->Write(m_normal_bias);
 	}
 
-	void Light::Deserialize(FileStream* stream)
+	void Light::Decode(FileStream* stream)
 	{
-		SetLightType(static_cast<LightType>(stream->ReadAs<uint32_t>()));
+		m_light_type = static_cast<LightType>(stream->ReadAs<uint32_t>());
 		stream->Read(&m_cast_shadows);
 		stream->Read(&m_color);
 		stream->Read(&m_range);
@@ -144,6 +144,14 @@ namespace Spartan
 		stream->Read(&m_normal_bias);
 	}
 
+	void Light::Attach()
+	{
+		// The shadow map is created (for the decoded type) on the next tick
+		m_depth_texture.reset();
+		m_is_dirty = true;
+		m_context->GetSubsystem<World>()->MakeDirty();
+	}
+
 	void Light::SetLightType(LightType type)
 	{
         if (m_light_type == type)
@@ -157,6 +165,7 @@ namespace Spartan
         m_light_type    = type;
         m_is_dirty      = true;
         m_context->GetSubsystem<World>()->MakeDirty();
+		MakeDirty();
 	}
 
 	void Light::SetCastShadows(bool cast_shadows)
@@ -171,17 +180,20 @@ namespace Spartan
 
         m_cast_shadows  = cast_shadows;
         m_is_dirty      = true;
+		MakeDirty();
 	}
 
 	void Light::SetRange(float range)
 	{
 		m_range = Clamp(range, 0.0f, INFINITY);
+		MakeDirty();
 	}
 
 	void Light::SetAngle(float angle)
 	{
 		m_angle_rad = Clamp(angle, 0.0f, 1.0f);
 		m_is_dirty  = true;
+		MakeDirty();
 	}
 
 	Vector3 Light::GetDirection() const
@@ -65,17 +65,18 @@ namespace Spartan
 		void OnStart() override;
 		void OnTick(float delta_time) override;
 		void Serialize(FileStream* stream) override;
-		void Deserialize(FileStream* stream) override;
+		void Decode(FileStream* stream) override;
+		void Attach() override;
 		//============================================
 
         const auto GetLightType() const { return m_light_type; }
 		void SetLightType(LightType type);
 
-		void SetColor(float r, float g, float b, float a)	{ m_color = Math::Vector4(r, g, b, a); }
-		void SetColor(const Math::Vector4& color)			{ m_color = color; }
+		void SetColor(float r, float g, float b, float a)	{ m_color = Math::Vector4(r, g, b, a); MakeDirty(); }
+		void SetColor(const Math::Vector4& color)			{ m_color = color; MakeDirty(); }
 		const auto& GetColor()								{ return m_color; }
 
-		void SetIntensity(float value)	{ m_intensity = value; }
+		void SetIntensity(float value)	{ m_intensity = value; MakeDirty(); }
 		auto GetIntensity()				{ return m_intensity; }
 
 		bool GetCastShadows() const { return m_cast_shadows; }
@@ -87,10 +88,10 @@ namespace Spartan
 		void SetAngle(float angle);
 		auto GetAngle() { return m_angle_rad; }
 
-		void SetBias(float value)	{ m_bias = value; }
+		void SetBias(float value)	{ m_bias = value; MakeDirty(); }
 		float GetBias()				{ return m_bias; }
 
-		void SetNormalBias(float value) { m_normal_bias = value; }
+		void SetNormalBias(float value) { m_normal_bias = value; MakeDirty(); }
 		auto GetNormalBias()			{ return m_normal_bias; }
 
 		Math::Vector3 GetDirection() const;
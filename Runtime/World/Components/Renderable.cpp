@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Renderable.h"
 #include "Transform.h"
 #include "../../Rendering/Model.h"
+#include "../../Math/Frustum.h"
 #include "../../IO/FileStream.h"
 #include "../../Resource/ResourceCache.h"
 #include "../../Rendering/Utilities/Geometry.h"
@@ -134,7 +135,7 @@ namespace Spartan
 		}
 	}
 
-	void Renderable::Deserialize(FileStream* stream)
+	void Renderable::Decode(FileStream* stream)
 	{
 		// Geometry
 		m_geometry_type			= static_cast<Geometry_Type>(stream->ReadAs<uint32_t>());
@@ -143,9 +144,22 @@ namespace Spartan
 		m_geometryVertexOffset	= stream->ReadAs<uint32_t>();
 		m_geometryVertexCount	= stream->ReadAs<uint32_t>();
 		stream->Read(&m_bounding_box);
-		string model_name;
-		stream->Read(&model_name);
-		m_model = m_context->GetSubsystem<ResourceCache>()->GetByName<Model>(model_name);
+		stream->Read(&m_model_name_decoded);
+
+		// Material
+		stream->Read(&m_castShadows);
+		stream->Read(&m_receiveShadows);
+		stream->Read(&m_material_default);
+		if (!m_material_default)
+		{
+			stream->Read(&m_material_name_decoded);
+		}
+	}
+
+	void Renderable::Attach()
+	{
+		ResourceCache* resource_cache = m_context->GetSubsystem<ResourceCache>().get();
+		m_model = resource_cache->GetByName<Model>(m_model_name_decoded);
 
 		// If it was a default mesh, we have to reconstruct it
 		if (m_geometry_type != Geometry_Custom) 
@@ -153,20 +167,17 @@ namespace Spartan
 			GeometrySet(m_geometry_type);
 		}
 
-		// Material
-		stream->Read(&m_castShadows);
-		stream->Read(&m_receiveShadows);
-		stream->Read(&m_material_default);
 		if (m_material_default)
 		{
 			UseDefaultMaterial();		
 		}
 		else
 		{
-			string material_name;
-			stream->Read(&material_name);
-			m_material = m_context->GetSubsystem<ResourceCache>()->GetByName<Material>(material_name);
+			m_material = resource_cache->GetByName<Material>(m_material_name_decoded);
 		}
+
+		m_model_name_decoded.clear();
+		m_material_name_decoded.clear();
 	}
 
 	void Renderable::GeometrySet(const string& name, const uint32_t index_offset, const uint32_t index_count, const uint32_t vertex_offset, const uint32_t vertex_count, const BoundingBox& bounding_box, Model* model)
@@ -178,6 +189,7 @@ namespace Spartan
 		m_geometryVertexCount	= vertex_count;
 		m_bounding_box			= bounding_box;
 		m_model					= model ? model->GetSharedPtr() : nullptr;
+		MakeDirty();
 	}
 
 	void Renderable::GeometrySet(const Geometry_Type type)
@@ -188,6 +200,7 @@ namespace Spartan
 		{
 			build(type, this);
 		}
+		MakeDirty();
 	}
 
     void Renderable::GeometryClear()
@@ -222,6 +235,96 @@ namespace Spartan
 		return m_aabb;
 	}
 
+	void Renderable::GeometryLod(const Vector3& eye_position, const float projection_scale, const float error_threshold, uint32_t* index_offset, uint32_t* index_count)
+	{
+		*index_offset	= m_geometryIndexOffset;
+		*index_count	= m_geometryIndexCount;
+
+		if (!m_model || projection_scale <= 0.0f)
+			return;
+
+		const auto& lods = m_model->GetLods(m_geometryIndexOffset);
+		if (lods.empty())
+			return;
+
+		// Distance from the eye to the closest point of the bounding box, full detail when inside of it
+		const BoundingBox& aabb = GetAabb();
+		const Vector3 closest	= Vector3(
+			Clamp(eye_position.x, aabb.GetMin().x, aabb.GetMax().x),
+			Clamp(eye_position.y, aabb.GetMin().y, aabb.GetMax().y),
+			Clamp(eye_position.z, aabb.GetMin().z, aabb.GetMax().z)
+		);
+		const float distance = Vector3::Distance(eye_position, closest);
+		if (distance <= 0.0f)
+			return;
+
+		// The errors are in object space
+		const Vector3 scale			= GetTransform()->GetScale().Absolute();
+		const float error_scale		= Max3(scale.x, scale.y, scale.z) * projection_scale / distance;
+		for (const Model_Lod& lod : lods)
+		{
+			if (lod.error * error_scale > error_threshold)
+				break;
+
+			*index_offset	= lod.index_offset;
+			*index_count	= lod.index_count;
+		}
+	}
+
+	bool Renderable::GeometryMeshlets(const Frustum& frustum, const Vector3& eye_position, vector<pair<uint32_t, uint32_t>>* index_ranges)
+	{
+		index_ranges->clear();
+
+		if (!m_model)
+			return false;
+
+		const auto& meshlets = m_model->GetMeshlets(m_geometryIndexOffset);
+		if (meshlets.empty())
+			return false;
+
+		Transform* transform		= GetTransform();
+		const Matrix& world			= transform->GetMatrix();
+		const Quaternion rotation	= transform->GetRotation();
+		const Vector3 scale			= transform->GetScale();
+		const Vector3 scale_abs		= scale.Absolute();
+		const float radius_scale	= Max3(scale_abs.x, scale_abs.y, scale_abs.z);
+
+		// Normal cones only survive uniform scaling, mirroring flips them. Meshlets that face away are only invisible when back faces
+		// are culled, two sided (e.g. foliage) and transparent materials show them.
+		const bool back_faces_culled	= m_material && m_material->GetCullMode() == Cull_Back && m_material->GetColorAlbedo().w >= 1.0f;
+		const bool cone_culling			= back_faces_culled && scale.x > 0.0f && Abs(scale.x - scale.y) <= scale.x * 0.01f && Abs(scale.x - scale.z) <= scale.x * 0.01f;
+
+		for (const Model_Meshlet& meshlet : meshlets)
+		{
+			const Vector3 center	= world * meshlet.center;
+			const float radius		= meshlet.radius * radius_scale;
+
+			// Outside of the frustum
+			if (!frustum.IsVisible(center, radius))
+				continue;
+
+			// Facing away from the eye
+			if (cone_culling && meshlet.cone_cutoff < 1.0f)
+			{
+				const Vector3 direction = center - eye_position;
+				if (Vector3::Dot(direction, rotation * meshlet.cone_axis) >= meshlet.cone_cutoff * direction.Length() + radius)
+					continue;
+			}
+
+			// Extend the previous range if this meshlet follows it
+			if (!index_ranges->empty() && index_ranges->back().first + index_ranges->back().second == meshlet.index_offset)
+			{
+				index_ranges->back().second += meshlet.index_count;
+			}
+			else
+			{
+				index_ranges->emplace_back(meshlet.index_offset, meshlet.index_count);
+			}
+		}
+
+		return true;
+	}
+
 	// All functions (set/load) resolve to this
 	void Renderable::SetMaterial(const shared_ptr<Material>& material)
 	{
@@ -236,6 +339,7 @@ namespace Spartan
 
         // Set to false otherwise material won't serialize/deserialize
         m_material_default = false;
+		MakeDirty();
 	}
 
 	shared_ptr<Material> Renderable::SetMaterial(const string& file_path)
@@ -275,6 +379,7 @@ namespace Spartan
         // Set material
 		SetMaterial(material);
         m_material_default = true;
+		MakeDirty();
 	}
 
 	string Renderable::GetMaterialName()
@@ -37,6 +37,7 @@ namespace Spartan
 	namespace Math
 	{
 		class Vector3;
+		class Frustum;
 	}
 
 	enum Geometry_Type
@@ -57,7 +58,8 @@ namespace Spartan
 
 		//= ICOMPONENT ===============================
 		void Serialize(FileStream* stream) override;
-		void Deserialize(FileStream* stream) override;
+		void Decode(FileStream* stream) override;
+		void Attach() override;
 		//============================================
 
 		//= GEOMETRY ==========================================================================================
@@ -81,6 +83,15 @@ namespace Spartan
 		const auto& GeometryName()	const { return m_geometryName; }
 		const auto& GeometryModel() const { return m_model; }
 		const Math::BoundingBox& GetAabb();
+
+		// Picks the coarsest level of detail whose error, projected on the screen, is within error_threshold (in pixels).
+		// projection_scale is the viewport height divided by 2 * tan(fov / 2), zero picks full detail.
+		void GeometryLod(const Math::Vector3& eye_position, float projection_scale, float error_threshold, uint32_t* index_offset, uint32_t* index_count);
+
+		// Culls the meshlets of the full detail mesh against the frustum and the eye (meshlets that face away, if the material culls back faces), the index ranges of
+		// the visible ones are written to index_ranges as (offset, count), neighbouring meshlets are merged into a single range.
+		// Returns false if the mesh has no meshlets, in which case it should be drawn as a whole.
+		bool GeometryMeshlets(const Math::Frustum& frustum, const Math::Vector3& eye_position, std::vector<std::pair<uint32_t, uint32_t>>* index_ranges);
 		//=====================================================================================================
 
 		//= MATERIAL ============================================================
@@ -97,9 +108,9 @@ namespace Spartan
 		//=======================================================================
 
 		//= PROPERTIES ============================================================================
-		void SetCastShadows(const bool cast_shadows)		{ m_castShadows = cast_shadows; }
+		void SetCastShadows(const bool cast_shadows)		{ m_castShadows = cast_shadows; MakeDirty(); }
 		auto GetCastShadows() const							{ return m_castShadows; }
-		void SetReceiveShadows(const bool receive_shadows)	{ m_receiveShadows = receive_shadows; }
+		void SetReceiveShadows(const bool receive_shadows)	{ m_receiveShadows = receive_shadows; MakeDirty(); }
 		auto GetReceiveShadows() const						{ return m_receiveShadows; }
 		//=========================================================================================
 
@@ -120,5 +131,9 @@ namespace Spartan
         bool m_receiveShadows           = true;
 		bool m_material_default;
         std::shared_ptr<Material> m_material;
+
+        // Resolved once attached
+        std::string m_model_name_decoded;
+        std::string m_material_name_decoded;
 	};
 }
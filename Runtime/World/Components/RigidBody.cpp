@@ -53,8 +53,9 @@ namespace Spartan
 	class MotionState : public btMotionState
 	{
 		RigidBody* m_rigidBody;
+		Physics* m_physics;
 	public:
-		MotionState(RigidBody* rigidBody) { m_rigidBody = rigidBody; }
+		MotionState(RigidBody* rigidBody, Physics* physics) { m_rigidBody = rigidBody; m_physics = physics; }
 		// Update from engine, ENGINE -> BULLET
 		void getWorldTransform(btTransform& worldTrans) const override
 		{
@@ -69,11 +70,19 @@ namespace Spartan
 		// Update from bullet, BULLET -> ENGINE
 		void setWorldTransform(const btTransform& worldTrans) override
 		{
+			// Stepping on another thread, the body is recorded by the step and published to the transform at the sync point
+			if (m_physics->IsAsynchronous())
+			{
+				m_rigidBody->m_hasSimulated = true;
+				return;
+			}
+
 			Quaternion newWorldRot	= ToQuaternion(worldTrans.getRotation());
 			Vector3 newWorldPos		= ToVector3(worldTrans.getOrigin()) - newWorldRot * m_rigidBody->GetCenterOfMass();
 
-			m_rigidBody->GetTransform()->SetPosition(newWorldPos);
-			m_rigidBody->GetTransform()->SetRotation(newWorldRot);
+			// Kept until the step is over, then the transforms of every body that moved are synchronized in one pass
+			m_rigidBody->Pose_Store(newWorldPos, newWorldRot);
+			m_physics->AddMovedBody(m_rigidBody);
 
 			m_rigidBody->m_hasSimulated = true;
 		}
@@ -152,7 +161,7 @@ namespace Spartan
 		stream->Write(m_inWorld);
 	}
 
-	void RigidBody::Deserialize(FileStream* stream)
+	void RigidBody::Decode(FileStream* stream)
 	{
 		stream->Read(&m_mass);
 		stream->Read(&m_friction);
@@ -164,9 +173,6 @@ namespace Spartan
 		stream->Read(&m_positionLock);
 		stream->Read(&m_rotationLock);
 		stream->Read(&m_inWorld);
-
-		Body_AcquireShape();
-		Body_AddToWorld();
 	}
 
 	// = PROPERTIES =========================================================
@@ -175,9 +181,19 @@ namespace Spartan
 		mass = Max(mass, 0.0f);
 		if (mass != m_mass)
 		{
-			m_mass = mass;
+			const bool was_static	= m_mass == 0.0f;
+			m_mass					= mass;
+
+			// A static mesh shape is replaced when the body becomes dynamic (and restored when it becomes static again)
+			const auto& collider = m_entity->GetComponent<Collider>();
+			if (collider && collider->GetShapeType() == ColliderShape_MeshStatic && was_static != (m_mass == 0.0f))
+			{
+				collider->Shape_Update();
+			}
+
 			Body_AddToWorld();
 		}
+		MakeDirty();
 	}
 
 	void RigidBody::SetFriction(float friction)
@@ -187,6 +203,7 @@ namespace Spartan
 
 		m_friction = friction;
 		m_rigidBody->setFriction(friction);
+		MakeDirty();
 	}
 
 	void RigidBody::SetFrictionRolling(float frictionRolling)
@@ -196,6 +213,7 @@ namespace Spartan
 
 		m_frictionRolling = frictionRolling;
 		m_rigidBody->setRollingFriction(frictionRolling);
+		MakeDirty();
 	}
 
 	void RigidBody::SetRestitution(float restitution)
@@ -205,6 +223,7 @@ namespace Spartan
 
 		m_restitution = restitution;
 		m_rigidBody->setRestitution(restitution);
+		MakeDirty();
 	}
 
 	void RigidBody::SetUseGravity(bool gravity)
@@ -214,6 +233,7 @@ namespace Spartan
 
 		m_useGravity = gravity;
 		Body_AddToWorld();
+		MakeDirty();
 	}
 
 	void RigidBody::SetGravity(const Vector3& acceleration)
@@ -223,6 +243,7 @@ namespace Spartan
 
 		m_gravity = acceleration;
 		Body_AddToWorld();
+		MakeDirty();
 	}
 
 	void RigidBody::SetIsKinematic(bool kinematic)
@@ -232,6 +253,7 @@ namespace Spartan
 
 		m_isKinematic = kinematic;
 		Body_AddToWorld();
+		MakeDirty();
 	}
 
 	//= FORCE/TORQUE ========================================================
@@ -331,6 +353,7 @@ namespace Spartan
 		m_positionLock = lock;
 		Vector3 linearFactor = Vector3(!lock.x, !lock.y, !lock.z);
 		m_rigidBody->setLinearFactor(ToBtVector3(linearFactor));
+		MakeDirty();
 	}
 
 	void RigidBody::SetRotationLock(bool lock)
@@ -353,6 +376,7 @@ namespace Spartan
 		m_rotationLock = lock;
 		Vector3 angularFactor = Vector3(!lock.x, !lock.y, !lock.z);
 		m_rigidBody->setAngularFactor(ToBtVector3(angularFactor));
+		MakeDirty();
 	}
 
 	//= CENTER OF MASS ===============================================
@@ -360,6 +384,7 @@ namespace Spartan
 	{
 		m_centerOfMass = centerOfMass;
 		SetPosition(GetPosition());
+		MakeDirty();
 	}
 	//================================================================
 
@@ -391,6 +416,7 @@ namespace Spartan
 			m_rigidBody->setInterpolationWorldTransform(interpTrans);
 		}
 
+		Async_Reset();
 		Activate();
 	}
 
@@ -426,6 +452,7 @@ namespace Spartan
 
 		m_rigidBody->updateInertiaTensor();
 
+		Async_Reset();
 		Activate();
 	}
 
@@ -457,6 +484,44 @@ namespace Spartan
 		m_rigidBody->setActivationState(WANTS_DEACTIVATION);
 	}
 
+	void RigidBody::Pose_Publish() const
+	{
+		GetTransform()->SetPoseDeferred(m_pose_position, m_pose_rotation);
+	}
+
+	void RigidBody::Async_Record()
+	{
+		if (!m_rigidBody)
+			return;
+
+		m_async_position[0] = m_async_position[1];
+		m_async_rotation[0] = m_async_rotation[1];
+
+		const btTransform& transform	= m_rigidBody->getWorldTransform();
+		m_async_rotation[1]				= ToQuaternion(transform.getRotation());
+		m_async_position[1]				= ToVector3(transform.getOrigin()) - m_async_rotation[1] * m_centerOfMass;
+	}
+
+	void RigidBody::Async_Reset()
+	{
+		if (!m_rigidBody)
+			return;
+
+		m_async_position[0] = m_async_position[1] = GetPosition();
+		m_async_rotation[0] = m_async_rotation[1] = GetRotation();
+	}
+
+	void RigidBody::Async_Publish(const float alpha) const
+	{
+		if (!m_rigidBody)
+			return;
+
+		const auto position = Lerp(m_async_position[0], m_async_position[1], alpha);
+		const auto rotation = ToQuaternion(ToBtQuaternion(m_async_rotation[0]).slerp(ToBtQuaternion(m_async_rotation[1]), alpha));
+
+		GetTransform()->SetPoseDeferred(position, rotation);
+	}
+
 	void RigidBody::AddConstraint(Constraint* constraint)
 	{
 		m_constraints.emplace_back(constraint);
@@ -495,6 +560,8 @@ namespace Spartan
 
 	void RigidBody::Body_AddToWorld()
 	{
+		m_physics->Sync();
+
 		if (m_mass < 0.0f)
 		{
 			m_mass = 0.0f;
@@ -502,7 +569,7 @@ namespace Spartan
 
 		// Transfer inertia to new collision shape
 		btVector3 localInertia = btVector3(0, 0, 0);
-		if (m_collisionShape && m_rigidBody)
+		if (m_collisionShape && m_rigidBody && m_mass > 0.0f) // static bodies have no inertia (and concave shapes can't compute it)
 		{
 			localInertia = m_rigidBody ? m_rigidBody->getLocalInertia() : localInertia;
 			m_collisionShape->calculateLocalInertia(m_mass, localInertia);
@@ -513,7 +580,7 @@ namespace Spartan
 		// CONSTRUCTION
 		{
 			// Create a motion state (memory will be freed by the RigidBody)
-			auto motionState = new MotionState(this);
+			auto motionState = new MotionState(this, m_physics);
 			
 			// Info
 			btRigidBody::btRigidBodyConstructionInfo constructionInfo(m_mass, motionState, m_collisionShape, localInertia);
@@ -587,6 +654,7 @@ namespace Spartan
 
 		if (m_inWorld)
 		{
+			m_physics->Sync();
 			m_physics->GetWorld()->removeRigidBody(m_rigidBody);
 			delete m_rigidBody->getMotionState();
 			delete m_rigidBody;
@@ -599,7 +667,7 @@ namespace Spartan
 	{
 		if (const auto& collider = m_entity->GetComponent<Collider>())
 		{
-			m_collisionShape	= collider->GetShape();
+			m_collisionShape	= collider->GetShape().get();
 			m_centerOfMass		= collider->GetCenter();
 		}
 	}
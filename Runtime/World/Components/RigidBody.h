@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "IComponent.h"
 #include <memory>
 #include "../../Math/Vector3.h"
+#include "../../Math/Quaternion.h"
 #include <vector>
 //=============================
 
@@ -36,7 +37,6 @@ namespace Spartan
 	class Entity;
 	class Constraint;
 	class Physics;
-	namespace Math { class Quaternion; }
 
 	enum ForceMode
 	{
@@ -56,7 +56,7 @@ namespace Spartan
 		void OnStart() override;
 		void OnTick(float delta_time) override;
 		void Serialize(FileStream* stream) override;
-		void Deserialize(FileStream* stream) override;
+		void Decode(FileStream* stream) override;
 		//============================================
 
 		//= MASS =========================
@@ -134,6 +134,17 @@ namespace Spartan
 		bool IsInWorld() { return m_inWorld; }
 		//===================================================
 
+		// The pose that a step left the body at (reported by its motion state), Physics writes the poses of
+		// every body that moved to their transforms in one pass after the step
+		void Pose_Store(const Math::Vector3& position, const Math::Quaternion& rotation) { m_pose_position = position; m_pose_rotation = rotation; }
+		void Pose_Publish() const;
+
+		// Asynchronous stepping, the physics thread records the body after every step and the sync point publishes
+		// it to the transform (deferred), interpolated between the last two steps (alpha of 0 is the older one)
+		void Async_Record();
+		void Async_Reset();
+		void Async_Publish(float alpha) const;
+
 		// Communication with other physics components
 		void AddConstraint(Constraint* constraint);
 		void RemoveConstraint(Constraint* constraint);
@@ -164,6 +175,10 @@ namespace Spartan
 		std::vector<Constraint*> m_constraints;
 		bool m_inWorld;
 		Physics* m_physics;
+		Math::Vector3 m_pose_position;
+		Math::Quaternion m_pose_rotation;
+		Math::Vector3 m_async_position[2];
+		Math::Quaternion m_async_rotation[2];
 	public:
 		bool m_hasSimulated;
 	};
@@ -62,7 +62,7 @@ namespace Spartan
 		if (!m_scriptInstance->IsInstantiated())
 			return;
 
-		m_scriptInstance->ExecuteUpdate(delta_time);
+		m_scriptInstance->QueueUpdate();
 	}
 
 	void Script::Serialize(FileStream* stream)
@@ -70,14 +70,17 @@ namespace Spartan
 		stream->Write(m_scriptInstance ? m_scriptInstance->GetScriptPath() : "");
 	}
 
-	void Script::Deserialize(FileStream* stream)
+	void Script::Decode(FileStream* stream)
 	{
-		string script_path;
-		stream->Read(&script_path);
+		stream->Read(&m_script_path_decoded);
+	}
 
-		if (!script_path.empty())
+	void Script::Attach()
+	{
+		if (!m_script_path_decoded.empty())
 		{
-			SetScript(script_path);
+			SetScript(m_script_path_decoded);
+			m_script_path_decoded.clear();
 		}
 	}
 	//====================================================================================
@@ -87,6 +90,7 @@ namespace Spartan
 		// Instantiate the script
 		m_scriptInstance = make_shared<ScriptInstance>();
 		m_scriptInstance->Instantiate(filePath, GetEntity_PtrWeak(), GetContext()->GetSubsystem<Scripting>());
+		MakeDirty();
 
 		// Check if the script has been instantiated successfully.
 		if (!m_scriptInstance->IsInstantiated())
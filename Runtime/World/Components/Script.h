@@ -38,7 +38,8 @@ namespace Spartan
 		void OnStart() override;
 		void OnTick(float delta_time) override;
 		void Serialize(FileStream* stream) override;
-		void Deserialize(FileStream* stream) override;
+		void Decode(FileStream* stream) override;
+		void Attach() override;
 		//============================================
 
 		bool SetScript(const std::string& filePath);
@@ -48,5 +49,6 @@ namespace Spartan
 	private:
 		std::shared_ptr<ScriptInstance> m_scriptInstance;
 		std::string m_name;
+		std::string m_script_path_decoded; // loaded once attached
 	};
 }
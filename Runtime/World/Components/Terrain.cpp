@@ -62,13 +62,21 @@ namespace Spartan
         stream->Write(m_max_y);
     }
 
-    void Terrain::Deserialize(FileStream* stream)
+    void Terrain::Decode(FileStream* stream)
     {
-        ResourceCache* resource_cache = m_context->GetSubsystem<ResourceCache>().get();
-        m_height_map    = resource_cache->GetByPath<RHI_Texture2D>(stream->ReadAs<string>());
-        m_model         = resource_cache->GetByName<Model>(stream->ReadAs<string>());
+        stream->Read(&m_height_map_path_decoded);
+        stream->Read(&m_model_name_decoded);
         stream->Read(&m_min_y);
         stream->Read(&m_max_y);
+    }
+
+    void Terrain::Attach()
+    {
+        ResourceCache* resource_cache = m_context->GetSubsystem<ResourceCache>().get();
+        m_height_map    = resource_cache->GetByPath<RHI_Texture2D>(m_height_map_path_decoded);
+        m_model         = resource_cache->GetByName<Model>(m_model_name_decoded);
+        m_height_map_path_decoded.clear();
+        m_model_name_decoded.clear();
 
         UpdateFromModel(m_model);
     }
@@ -77,6 +85,7 @@ namespace Spartan
     {
         // In order for the component to guarantee serialization/deserialization, we cache the height_map
         m_height_map = m_context->GetSubsystem<ResourceCache>()->Cache<RHI_Texture2D>(height_map);
+        MakeDirty();
     }
 
     void Terrain::GenerateAsync()
@@ -101,20 +110,21 @@ namespace Spartan
             return;
         }
 
-        m_context->GetSubsystem<Threading>()->AddTask([this]()
+        // The task holds on to the height map, so it stays alive even if it's replaced in the meantime
+        m_context->GetSubsystem<Threading>()->AddTask([this, height_map = m_height_map]()
         {
             m_is_generating = true;
 
-            // Get height map data
-            vector<std::byte> height_map_data = m_height_map->GetMipmap(0);
+            // Get height map data (a copy, since saving the height map frees its mips while we are working)
+            const vector<std::byte> height_map_data = height_map->CopyMip(0);
             if (height_map_data.empty())
             {
                 LOG_ERROR("Height map has no data");
             }
 
             // Deduce some stuff
-            m_height                            = m_height_map->GetHeight();
-            m_width                             = m_height_map->GetWidth();
+            m_height                            = height_map->GetHeight();
+            m_width                             = height_map->GetWidth();
             m_vertex_count                      = m_height * m_width;
             m_face_count                        = (m_height - 1) * (m_width - 1) * 2;
             m_progress_jobs_done                = 0;
@@ -155,7 +165,7 @@ namespace Spartan
         });
     }
 
-    bool Terrain::GeneratePositions(vector<Vector3>& positions, const vector<std::byte>& height_map)
+    bool Terrain::GeneratePositions(vector<Vector3>& positions, const Span<const std::byte>& height_map)
     {
         if (height_map.empty())
         {
@@ -404,6 +414,7 @@ namespace Spartan
 
             renderable->UseDefaultMaterial();
         }
+        MakeDirty();
     }
 
     void Terrain::UpdateFromVertices(const vector<uint32_t>& indices, vector<RHI_Vertex_PosTexNorTan>& vertices)
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "IComponent.h"
 #include <atomic>
 #include "../../RHI/RHI_Definition.h"
+#include "../../Core/Span.h"
 //===================================
 
 namespace Spartan
@@ -44,17 +45,18 @@ namespace Spartan
         //= IComponent ===============================
         void OnInitialize() override;
         void Serialize(FileStream* stream) override;
-        void Deserialize(FileStream* stream) override;
+        void Decode(FileStream* stream) override;
+        void Attach() override;
         //============================================
 
         const auto& GetHeightMap() { return m_height_map; }
         void SetHeightMap(const std::shared_ptr<RHI_Texture2D>& height_map);
 
         float GetMinY()             { return m_min_y; }
-        void SetMinY(float min_z)   { m_min_y = min_z; }
+        void SetMinY(float min_z)   { m_min_y = min_z; MakeDirty(); }
 
         float GetMaxY()             { return m_max_y; }
-        void SetMaxY(float max_z)   { m_max_y = max_z; }
+        void SetMaxY(float max_z)   { m_max_y = max_z; MakeDirty(); }
 
         float GetProgress() { return static_cast<float>(static_cast<double>(m_progress_jobs_done) / static_cast<double>(m_progress_job_count)); }
         const auto& GetProgressDescription() { return m_progress_desc; }
@@ -62,7 +64,7 @@ namespace Spartan
         void GenerateAsync();
 
     private:
-        bool GeneratePositions(std::vector<Math::Vector3>& positions, const std::vector<std::byte>& height_map);
+        bool GeneratePositions(std::vector<Math::Vector3>& positions, const Span<const std::byte>& height_map);
         bool GenerateVerticesIndices(const std::vector<Math::Vector3>& positions, std::vector<uint32_t>& indices, std::vector<RHI_Vertex_PosTexNorTan>& vertices);
         bool GenerateNormalTangents(const std::vector<uint32_t>& indices, std::vector<RHI_Vertex_PosTexNorTan>& vertices);
         void UpdateFromModel(const std::shared_ptr<Model>& model);
@@ -81,5 +83,9 @@ namespace Spartan
         std::string m_progress_desc;
         std::shared_ptr<RHI_Texture2D> m_height_map;
         std::shared_ptr<Model> m_model;
+
+        // Resolved once attached
+        std::string m_height_map_path_decoded;
+        std::string m_model_name_decoded;
     };
 }
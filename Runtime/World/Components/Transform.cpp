@@ -20,6 +20,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
 //= INCLUDES =====================
+#include <algorithm>
 #include "Transform.h"
 #include "../World.h"
 #include "../Entity.h"
@@ -68,21 +69,24 @@ namespace Spartan
 		stream->Write(m_parent ? m_parent->GetEntity_PtrRaw()->GetId() : 0);
 	}
 
-	void Transform::Deserialize(FileStream* stream)
+	void Transform::Decode(FileStream* stream)
 	{
 		stream->Read(&m_positionLocal);
 		stream->Read(&m_rotationLocal);
 		stream->Read(&m_scaleLocal);
 		stream->Read(&m_lookAt);
-		uint32_t parententity_id = 0;
-		stream->Read(&parententity_id);
+		stream->Read(&m_parent_id_decoded);
+	}
 
-		if (parententity_id != 0)
+	void Transform::Attach()
+	{
+		if (m_parent_id_decoded != 0)
 		{
-			if (const auto parent = GetContext()->GetSubsystem<World>()->EntityGetById(parententity_id))
+			if (const auto parent = GetContext()->GetSubsystem<World>()->EntityGetById(m_parent_id_decoded))
 			{
 				parent->GetTransform_PtrRaw()->AddChild(this);
 			}
+			m_parent_id_decoded = 0;
 		}
 
 		UpdateTransform();
@@ -90,6 +94,22 @@ namespace Spartan
 	//===============================================================================================
 	void Transform::UpdateTransform()
 	{
+		// A deferred world space pose, the parent has been updated by now (parents update their children)
+		if (m_pose_pending)
+		{
+			if (!HasParent())
+			{
+				m_positionLocal = m_pose_position;
+				m_rotationLocal = m_pose_rotation;
+			}
+			else
+			{
+				m_positionLocal = m_pose_position * GetParent()->GetMatrix().Inverted();
+				m_rotationLocal = m_pose_rotation * GetParent()->GetRotation().Inverse();
+			}
+			m_pose_pending = false;
+		}
+
 		// Compute local transform
 		m_matrixLocal = Matrix(m_positionLocal, m_rotationLocal, m_scaleLocal);
 
@@ -103,6 +123,8 @@ namespace Spartan
 			m_matrix = m_matrixLocal * GetParentTransformMatrix();
 		}
 		
+		m_is_dirty = false;
+
 		// Update children
 		for (const auto& child : m_children)
 		{
@@ -110,6 +132,38 @@ namespace Spartan
 		}
 	}
 
+	void Transform::SetPoseDeferred(const Vector3& position, const Quaternion& rotation)
+	{
+		// The parent may be written in the same batch, so it's made local later, see UpdateTransform()
+		m_pose_position	= position;
+		m_pose_rotation	= rotation;
+		m_pose_pending	= true;
+		m_is_dirty		= true;
+		MakeDirty();
+	}
+
+	void Transform::UpdateTransforms(const vector<Transform*>& transforms)
+	{
+		for (const auto& transform : transforms)
+		{
+			// Already updated, by a dirty ancestor that came before it
+			if (!transform->m_is_dirty)
+				continue;
+
+			// Let the topmost dirty ancestor update, it takes care of everything below it
+			auto root = transform;
+			for (auto parent = transform->GetParent(); parent; parent = parent->GetParent())
+			{
+				if (parent->m_is_dirty)
+				{
+					root = parent;
+				}
+			}
+
+			root->UpdateTransform();
+		}
+	}
+
 	//= TRANSLATION ==================================================================================
 	void Transform::SetPosition(const Vector3& position)
 	{
@@ -126,6 +180,7 @@ namespace Spartan
 
 		m_positionLocal = position;
 		UpdateTransform();
+		MakeDirty();
 	}
 	//================================================================================================
 
@@ -145,6 +200,7 @@ namespace Spartan
 
 		m_rotationLocal = rotation;
 		UpdateTransform();
+		MakeDirty();
 	}
 	//================================================================================================
 
@@ -171,6 +227,7 @@ namespace Spartan
 		m_scaleLocal.z = (m_scaleLocal.z == 0.0f) ? M_EPSILON : m_scaleLocal.z;
 
 		UpdateTransform();
+		MakeDirty();
 	}
 	//================================================================================================
 
@@ -259,11 +316,14 @@ namespace Spartan
 		// if the new parent is a descendant of this transform
 		if (new_parent->IsDescendantOf(this))
 		{
+            // the children will be removing themselves from this transform, so iterate over a copy
+            const auto children = m_children;
+
 			// if this transform already has a parent
 			if (this->HasParent())
 			{
 				// assign the parent of this transform to the children
-				for (const auto& child : m_children)
+				for (const auto& child : children)
 				{
 					child->SetParent(GetParent());
 				}
@@ -271,25 +331,29 @@ namespace Spartan
 			else // if this transform doesn't have a parent
 			{
 				// make the children orphans
-				for (const auto& child : m_children)
+				for (const auto& child : children)
 				{
 					child->BecomeOrphan();
 				}
 			}
 		}
 
+		// The hierarchy that this transform leaves changes, as does the one it joins (below)
+		MakeDirty();
+
 		// Switch parent but keep a pointer to the old one
 		auto parent_old = m_parent;
 		m_parent = new_parent;
-		if (parent_old) parent_old->AcquireChildren(); // update the old parent (so it removes this child)
+		if (parent_old) parent_old->EraseChild(this); // update the old parent (so it removes this child)
 
 		// make the new parent "aware" of this transform/child
 		if (m_parent)
 		{
-			m_parent->AcquireChildren();
+			m_parent->m_children.emplace_back(this);
 		}
 
 		UpdateTransform();
+		MakeDirty();
 	}
 
 	void Transform::AddChild(Transform* child)
@@ -340,7 +404,7 @@ namespace Spartan
 		m_children.clear();
 		m_children.shrink_to_fit();
 
-		auto entities = GetContext()->GetSubsystem<World>()->EntityGetAll();
+		const auto& entities = GetContext()->GetSubsystem<World>()->EntityGetAll();
 		for (const auto& entity : entities)
 		{
 			if (!entity)
@@ -401,6 +465,9 @@ namespace Spartan
 		if (!m_parent)
 			return;
 
+		// The hierarchy that this transform leaves changes, and this transform becomes a root of it's own (below)
+		MakeDirty();
+
 		// create a temporary reference to the parent
 		auto temp_ref = m_parent;
 
@@ -409,13 +476,26 @@ namespace Spartan
 
 		// Update the transform without the parent now
 		UpdateTransform();
+		MakeDirty();
 
-		// make the parent search for children,
-		// that's indirect way of making the parent "forget"
-		// about this child, since it won't be able to find it
+		// make the parent forget about this child
 		if (temp_ref)
 		{
-			temp_ref->AcquireChildren();
+			temp_ref->EraseChild(this);
 		}
 	}
+
+    void Transform::RemoveChildrenPendingDestruction()
+    {
+        m_children.erase(remove_if(m_children.begin(), m_children.end(), [](Transform* child) { return child->GetEntity_PtrRaw()->IsPendingDestruction(); }), m_children.end());
+    }
+
+    void Transform::EraseChild(Transform* child)
+    {
+        const auto it = find(m_children.begin(), m_children.end(), child);
+        if (it != m_children.end())
+        {
+            m_children.erase(it);
+        }
+    }
 }
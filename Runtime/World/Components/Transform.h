@@ -44,11 +44,20 @@ namespace Spartan
 		//= ICOMPONENT ===============================
 		void OnInitialize() override;
 		void Serialize(FileStream* stream) override;
-		void Deserialize(FileStream* stream) override;
+		void Decode(FileStream* stream) override;
+		void Attach() override;
 		//============================================
 
 		void UpdateTransform();
 
+		// Batched updates, the world space pose is written without recomputing any matrices and
+		// UpdateTransforms() brings every hierarchy that was written to up to date, once each.
+		// The pose becomes local when the transform is updated, after its parent, so parents and
+		// children can be written in the same batch, in any order.
+		void SetPoseDeferred(const Math::Vector3& position, const Math::Quaternion& rotation);
+		bool IsDirty() const { return m_is_dirty; }
+		static void UpdateTransforms(const std::vector<Transform*>& transforms);
+
 		//= POSITION ================================================================
 		auto GetPosition()						{ return m_matrix.GetTranslation(); }
 		const auto& GetPositionLocal() const	{ return m_positionLocal; }
@@ -99,11 +108,12 @@ namespace Spartan
 		const std::vector<Transform*>& GetChildren() const	{ return m_children; }
 	
 		void AcquireChildren();
+		void RemoveChildrenPendingDestruction();
 		bool IsDescendantOf(Transform* transform) const;
 		void GetDescendants(std::vector<Transform*>* descendants);
 		//======================================================================================
 
-		void LookAt(const Math::Vector3& v) { m_lookAt = v; }
+		void LookAt(const Math::Vector3& v) { m_lookAt = v; MakeDirty(); }
 		const auto& GetMatrix()         const { return m_matrix; }     
 		const auto& GetLocalMatrix()    const { return m_matrixLocal; }
         const auto& GetWvpLastFrame()   const { return m_wvp_previous; }
@@ -111,6 +121,7 @@ namespace Spartan
 
 	private:
 		Math::Matrix GetParentTransformMatrix() const;
+		void EraseChild(Transform* child);
 
 		// local
 		Math::Vector3 m_positionLocal;
@@ -122,8 +133,15 @@ namespace Spartan
 		Math::Vector3 m_lookAt;
 
 		Transform* m_parent; // the parent of this transform
+		uint32_t m_parent_id_decoded = 0; // resolved once attached
 		std::vector<Transform*> m_children; // the children of this transform
 
 		Math::Matrix m_wvp_previous;
+		bool m_is_dirty = false;
+
+		// World space pose written by SetPoseDeferred()
+		Math::Vector3 m_pose_position;
+		Math::Quaternion m_pose_rotation;
+		bool m_pose_pending = false;
 	};
 }
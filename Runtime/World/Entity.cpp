@@ -71,6 +71,20 @@ namespace Spartan
 		m_components.clear();
 	}
 
+    void Entity::SetId(const uint32_t id)
+    {
+        if (m_id == id)
+            return;
+
+        const uint32_t id_previous = m_id;
+        m_id = id;
+
+        if (m_handle.IsValid())
+        {
+            m_context->GetSubsystem<World>()->EntityIdChanged(this, id_previous);
+        }
+    }
+
 	void Entity::Clone()
 	{
 		auto scene = m_context->GetSubsystem<World>();
@@ -210,7 +224,7 @@ namespace Spartan
         {
             stream->Read(&m_is_active);
             stream->Read(&m_hierarchy_visibility);
-            stream->Read(&m_id);
+            SetId(stream->ReadAs<uint32_t>());
             stream->Read(&m_name);
         }
 
@@ -225,7 +239,7 @@ namespace Spartan
                 stream->Read(&type);	// load component's type
                 stream->Read(&id);		// load component's id
 
-                auto component = AddComponent(static_cast<ComponentType>(type), id);
+                AddComponent(static_cast<ComponentType>(type), id, false); // deserializing initializes them
             }
 
             // Sometimes there are component dependencies, e.g. a collider that needs
@@ -258,43 +272,38 @@ namespace Spartan
                 children.emplace_back(child);
             }
 
-            // Children
+            // Children (they register themselves with this transform as they get parented)
             for (const auto& child : children)
             {
                 child.lock()->Deserialize(stream, GetTransform_PtrRaw());
             }
-
-            if (m_transform)
-            {
-                m_transform->AcquireChildren();
-            }
         }
 
 		// Make the scene resolve
-		FIRE_EVENT(Event_World_Resolve_Pending);
+		FIRE_EVENT_DEFERRED(Event_World_Resolve_Pending);
 	}
 
-    shared_ptr<IComponent> Entity::AddComponent(const ComponentType type, uint32_t id /*= 0*/)
+    shared_ptr<IComponent> Entity::AddComponent(const ComponentType type, uint32_t id /*= 0*/, const bool initialize /*= true*/)
     {
         // This is the only hardcoded part regarding components. It's 
         // one function but it would be nice if that gets automated too, somehow...
         shared_ptr<IComponent> component;
         switch (type)
         {
-            case ComponentType_AudioListener:	component = AddComponent<AudioListener>(id);    break;
-            case ComponentType_AudioSource:		component = AddComponent<AudioSource>(id);	    break;
-            case ComponentType_Camera:			component = AddComponent<Camera>(id);		    break;
-            case ComponentType_Collider:		component = AddComponent<Collider>(id);		    break;
-            case ComponentType_Constraint:		component = AddComponent<Constraint>(id);	    break;
-            case ComponentType_Light:			component = AddComponent<Light>(id);		    break;
-            case ComponentType_Renderable:		component = AddComponent<Renderable>(id);	    break;
-            case ComponentType_RigidBody:		component = AddComponent<RigidBody>(id);	    break;
-            case ComponentType_Script:			component = AddComponent<Script>(id);		    break;
-            case ComponentType_Environment:		component = AddComponent<Environment>(id);		break;
-            case ComponentType_Transform:		component = AddComponent<Transform>(id);	    break;
-            case ComponentType_Terrain:		    component = AddComponent<Terrain>(id);	        break;
-            case ComponentType_Unknown:														    break;
-            default:																		    break;
+            case ComponentType_AudioListener:   component = AddComponent<AudioListener>(id, initialize);      break;
+            case ComponentType_AudioSource:     component = AddComponent<AudioSource>(id, initialize);        break;
+            case ComponentType_Camera:          component = AddComponent<Camera>(id, initialize);             break;
+            case ComponentType_Collider:        component = AddComponent<Collider>(id, initialize);           break;
+            case ComponentType_Constraint:      component = AddComponent<Constraint>(id, initialize);         break;
+            case ComponentType_Light:           component = AddComponent<Light>(id, initialize);              break;
+            case ComponentType_Renderable:      component = AddComponent<Renderable>(id, initialize);         break;
+            case ComponentType_RigidBody:       component = AddComponent<RigidBody>(id, initialize);          break;
+            case ComponentType_Script:          component = AddComponent<Script>(id, initialize);             break;
+            case ComponentType_Environment:     component = AddComponent<Environment>(id, initialize);        break;
+            case ComponentType_Transform:       component = AddComponent<Transform>(id, initialize);          break;
+            case ComponentType_Terrain:         component = AddComponent<Terrain>(id, initialize);            break;
+            case ComponentType_Unknown:                                                                       break;
+            default:                                                                                          break;
         }
 
         return component;
@@ -334,6 +343,21 @@ namespace Spartan
         }
 
 		// Make the scene resolve
-		FIRE_EVENT(Event_World_Resolve_Pending);
+		FIRE_EVENT_DEFERRED(Event_World_Resolve_Pending);
+		MakeDirty();
+	}
+
+	void Entity::MakeDirty()
+	{
+		auto root = this;
+		if (m_transform)
+		{
+			if (auto transform_root = m_transform->GetRoot()->GetEntity_PtrRaw())
+			{
+				root = transform_root;
+			}
+		}
+
+		root->m_is_dirty.store(true, memory_order_relaxed);
 	}
 }
@@ -22,6 +22,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES =====================
+#include <atomic>
 #include <vector>
 #include "../Core/EventSystem.h"
 #include "Components/IComponent.h"
@@ -32,6 +33,18 @@ namespace Spartan
 	class Context;
 	class Transform;
 	class Renderable;
+	class World;
+
+    // A stable reference to an entity in the world, it becomes invalid once the entity is destroyed (even if its slot gets reused)
+    struct EntityHandle
+    {
+        bool IsValid() const                                { return generation != 0; }
+        bool operator==(const EntityHandle& rhs) const      { return index == rhs.index && generation == rhs.generation; }
+        bool operator!=(const EntityHandle& rhs) const      { return !(*this == rhs); }
+
+        uint32_t index      = 0;
+        uint32_t generation = 0; // zero is never a live generation
+    };
 	
 	class SPARTAN_CLASS Entity : public Spartan_Object, public std::enable_shared_from_this<Entity>
 	{
@@ -47,19 +60,26 @@ namespace Spartan
 		void Deserialize(FileStream* stream, Transform* parent);
 
 		//= PROPERTIES ===================================================================================================
+		void SetId(uint32_t id); // keeps the world's id lookup up to date
+
 		const std::string& GetName() const								{ return m_name; }
-		void SetName(const std::string& name)							{ m_name = name; }
+		void SetName(const std::string& name)							{ m_name = name; MakeDirty(); }
 
 		bool IsActive() const											{ return m_is_active; }
-		void SetActive(const bool active)								{ m_is_active = active; }
+		void SetActive(const bool active)								{ m_is_active = active; MakeDirty(); }
 
 		bool IsVisibleInHierarchy() const								{ return m_hierarchy_visibility; }
-		void SetHierarchyVisibility(const bool hierarchy_visibility)	{ m_hierarchy_visibility = hierarchy_visibility; }
+		void SetHierarchyVisibility(const bool hierarchy_visibility)	{ m_hierarchy_visibility = hierarchy_visibility; MakeDirty(); }
+
+		// Marks the hierarchy that the entity is part of as changed since the world was last saved.
+		// Worlds are saved per root, so the flag is kept by the root (thread safe, scripts can call it in parallel).
+		void MakeDirty();
+		bool IsDirty() const											{ return m_is_dirty; }
 		//================================================================================================================
 
-		// Adds a component of type T
+		// Adds a component of type T, components that aren't initialized have to be attached later on (see IComponent::Attach())
 		template <class T>
-		std::shared_ptr<T> AddComponent(uint32_t id = 0)
+		std::shared_ptr<T> AddComponent(uint32_t id = 0, bool initialize = true)
 		{
 			const ComponentType type = IComponent::TypeToEnum<T>();
 
@@ -80,16 +100,20 @@ namespace Spartan
 
             // Initialize component
             component->SetType(type);
-            component->OnInitialize();
+            if (initialize)
+            {
+                component->OnInitialize();
+            }
 
 			// Make the scene resolve
-			FIRE_EVENT(Event_World_Resolve_Pending);
+			FIRE_EVENT_DEFERRED(Event_World_Resolve_Pending);
+			MakeDirty();
 
             return component;
 		}
 
         // Adds a component of ComponentType 
-        std::shared_ptr<IComponent> AddComponent(ComponentType type, uint32_t id = 0);
+        std::shared_ptr<IComponent> AddComponent(ComponentType type, uint32_t id = 0, bool initialize = true);
 
 		// Returns a component of type T (if it exists)
 		template <class T>
@@ -159,7 +183,8 @@ namespace Spartan
 			}
 
 			// Make the scene resolve
-			FIRE_EVENT(Event_World_Resolve_Pending);
+			FIRE_EVENT_DEFERRED(Event_World_Resolve_Pending);
+			MakeDirty();
 		}
 
 		void RemoveComponentById(uint32_t id);
@@ -172,8 +197,11 @@ namespace Spartan
 		Transform* GetTransform_PtrRaw() const		{ return m_transform; }
 		Renderable* GetRenderable_PtrRaw() const	{ return m_renderable; }
 		std::shared_ptr<Entity> GetPtrShared()		{ return shared_from_this(); }
+        const EntityHandle& GetHandle() const       { return m_handle; }
 
 	private:
+        friend class World;
+
         constexpr uint32_t GetComponentMask(ComponentType type) { return static_cast<uint32_t>(1) << static_cast<uint32_t>(type); }
 
 		std::string m_name			= "Entity";
@@ -183,6 +211,8 @@ namespace Spartan
 		Renderable* m_renderable	= nullptr;
         Context* m_context          = nullptr;
         bool m_destruction_pending  = false;
+        std::atomic<bool> m_is_dirty = true; // only meaningful for roots, see MakeDirty()
+        EntityHandle m_handle;
 		
         // Components
         std::vector<std::shared_ptr<IComponent>> m_components;
@@ -20,7 +20,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
 //= INCLUDES ==========================
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <unordered_set>
 #include "World.h"
+#include "WorldChunk.h"
 #include "Entity.h"
 #include "Components/Transform.h"
 #include "Components/Camera.h"
@@ -35,6 +40,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Profiling/Profiler.h"
 #include "../Rendering/Renderer.h"
 #include "../Input/Input.h"
+#include "../Threading/Threading.h"
+#include "../Scripting/Scripting.h"
 //=====================================
 
 //= NAMESPACES ================
@@ -47,9 +54,9 @@ namespace Spartan
 	World::World(Context* context) : ISubsystem(context)
 	{
 		// Subscribe to events
-		SUBSCRIBE_TO_EVENT(Event_World_Resolve_Pending, [this](Variant) { m_is_dirty = true; });
-		SUBSCRIBE_TO_EVENT(Event_World_Stop,	        [this](Variant)	{ m_state = Idle; });
-		SUBSCRIBE_TO_EVENT(Event_World_Start,	        [this](Variant)	{ m_state = Ticking; });
+		SUBSCRIBE_TO_EVENT(Event_World_Resolve_Pending, [this](const EventData&) { m_is_dirty = true; });
+		SUBSCRIBE_TO_EVENT(Event_World_Stop,	        [this](const EventData&)	{ m_state = Idle; });
+		SUBSCRIBE_TO_EVENT(Event_World_Start,	        [this](const EventData&)	{ m_state = Ticking; });
 	}
 
 	World::~World()
@@ -57,12 +64,14 @@ namespace Spartan
 		Unload();
         m_input     = nullptr;
         m_profiler  = nullptr;
+        m_scripting = nullptr;
 	}
 
 	bool World::Initialize()
 	{
 		m_input		= m_context->GetSubsystem<Input>().get();
 		m_profiler	= m_context->GetSubsystem<Profiler>().get();
+		m_scripting	= m_context->GetSubsystem<Scripting>().get();
 
 		CreateCamera();
 		CreateEnvironment();
@@ -82,6 +91,11 @@ namespace Spartan
 		if (m_state != Ticking)
 			return;
 
+        // Entities are being added from another thread, skip this tick instead of stalling the frame
+        unique_lock<recursive_mutex> lock(m_mutex_tick, try_to_lock);
+        if (!lock.owns_lock())
+            return;
+
         TIME_BLOCK_START_CPU(m_profiler);
 
         // Tick entities
@@ -114,29 +128,24 @@ namespace Spartan
             {
                 entity->Tick(delta_time);
             }
+
+            // Scripts queued their updates while their entities ticked, they run in batches (one per script class)
+            m_scripting->ExecuteUpdates(delta_time);
 		}
 
         if (m_is_dirty)
         {
-            // Update dirty entities
-            {
-                // Make a copy so we can iterate while removing entities
-                auto entities_copy = m_entities;
-
-                for (const auto& entity : entities_copy)
-                {
-                    if (entity->IsPendingDestruction())
-                    {
-                        _EntityRemove(entity);
-                    }
-                }
-            }
+            // Remove entities that are pending destruction
+            EntitiesRemovePending();
 
             // Notify Renderer
             FIRE_EVENT_DATA(Event_World_Resolve_Complete, m_entities);
             m_is_dirty = false;
         }
 
+        // Entities are done for this frame, so systems that work in the background can pick them up
+        FIRE_EVENT(Event_World_Ticked);
+
         TIME_BLOCK_END(m_profiler);
 	}
 
@@ -145,8 +154,13 @@ namespace Spartan
         // Notify any systems that the entities are about to be cleared
 		FIRE_EVENT(Event_World_Unload);
 
-        m_entities.clear();
+        // Release all slots, invalidating any outstanding handles
+        while (!m_entities.empty())
+        {
+            SlotRelease(static_cast<uint32_t>(m_entities.size()) - 1);
+        }
         m_entities.shrink_to_fit();
+        m_saved_roots.clear();
 
 		m_is_dirty = true;
 	}
@@ -170,39 +184,49 @@ namespace Spartan
 		// Notify subsystems that need to save data
 		FIRE_EVENT(Event_World_Save);
 
-		// Create a prefab file
-		auto file = make_unique<FileStream>(file_path, FileStream_Write);
-		if (!file->IsOpen())
-		{
-			LOG_ERROR_GENERIC_FAILURE();
-			return false;
-		}
-
 		// Only save root entities as they will also save their descendants
-		auto root_actors = EntityGetRoots();
-		const auto root_entity_count = static_cast<uint32_t>(root_actors.size());
-
-		ProgressReport::Get().SetJobCount(g_progress_world, root_entity_count);
-
-		// Save root entity count
-		file->Write(root_entity_count);
-
-		// Save root entity IDs
-		for (const auto& root : root_actors)
+		auto root_entities = EntityGetRoots();
+		ProgressReport::Get().SetJobCount(g_progress_world, static_cast<int>(root_entities.size()));
+
+		// Encode the roots that changed since the last save, the rest reuse the chunks (data and hash) that they were saved as
+		unordered_map<const Entity*, vector<WorldChunk>> saved_roots;
+		vector<WorldChunk*> chunks;
+		uint32_t encoded_count = 0;
+		for (const auto& root : root_entities)
 		{
-			file->Write(root->GetId());
+			auto& root_chunks	= saved_roots[root.get()];
+			const auto it		= m_saved_roots.find(root.get());
+			if (root->IsDirty() || it == m_saved_roots.end())
+			{
+				// Cleared before encoding, so that a change made in the meantime isn't lost
+				root->m_is_dirty = false;
+				WorldChunk::Encode(root.get(), &root_chunks);
+				encoded_count++;
+			}
+			else
+			{
+				root_chunks = move(it->second);
+			}
+
+			for (auto& chunk : root_chunks)
+			{
+				chunks.emplace_back(&chunk);
+			}
+			ProgressReport::Get().IncrementJobsDone(g_progress_world);
 		}
+		m_saved_roots = move(saved_roots);
 
-		// Save root entities
-		for (const auto& root : root_actors)
+		// Write the chunks that changed
+		if (!SaveChunks(file_path, chunks))
 		{
-			root->Serialize(file.get());
-			ProgressReport::Get().IncrementJobsDone(g_progress_world);
+			LOG_ERROR_GENERIC_FAILURE();
+			ProgressReport::Get().SetIsLoading(g_progress_world, false);
+			return false;
 		}
 
 		// Finish with progress report and timer
 		ProgressReport::Get().SetIsLoading(g_progress_world, false);
-		LOG_INFO("Saving took %.2f ms", timer.GetElapsedTimeMs());
+		LOG_INFO("Saving took %.2f ms (%d of %d roots encoded)", timer.GetElapsedTimeMs(), encoded_count, static_cast<uint32_t>(root_entities.size()));
 
 		// Notify subsystems waiting for us to finish
 		FIRE_EVENT(Event_World_Saved);
@@ -233,15 +257,222 @@ namespace Spartan
 		// Read all the resource file paths
 		auto file = make_unique<FileStream>(file_path, FileStream_Read);
 		if (!file->IsOpen())
+		{
+			m_state = Ticking;
+			ProgressReport::Get().SetIsLoading(g_progress_world, false);
 			return false;
+		}
 
 		m_name = FileSystem::GetFileNameNoExtensionFromFilePath(file_path);
 
 		// Notify subsystems that need to load data
 		FIRE_EVENT(Event_World_Load);
 
+		// Forget the layout of any previous file
+		m_file_path.clear();
+		m_file_size = 0;
+		m_file_chunks.clear();
+		m_file_table.clear();
+
+		// Worlds saved before the chunked format start directly with the root entity count
+		auto result = false;
+		if (file->ReadAs<uint32_t>() == WorldFormat::magic)
+		{
+			result = LoadChunks(file.get(), file_path);
+		}
+		else
+		{
+			file->Seek(0);
+			result = LoadLegacy(file.get());
+		}
+
+		if (!result)
+		{
+			LOG_ERROR("Failed to load \"%s\"", file_path.c_str());
+		}
+
+		m_is_dirty	= true;
+		m_state		= Ticking;
+		ProgressReport::Get().SetIsLoading(g_progress_world, false);	
+		LOG_INFO("Loading took %.2f ms", timer.GetElapsedTimeMs());
+
+		FIRE_EVENT(Event_World_Loaded);
+		return result;
+	}
+
+	bool World::SaveChunks(const string& file_path, const vector<WorldChunk*>& chunks)
+	{
+		const auto table_size = WorldFormat::GetTableSize(chunks.size());
+
+		// Nothing changed since the last save
+		const auto is_same_file = m_file_path == file_path && m_file_size != 0 && FileSystem::FileExists(file_path);
+		if (is_same_file && chunks.size() == m_file_table.size())
+		{
+			auto is_same_table = true;
+			for (size_t i = 0; i < chunks.size() && is_same_table; i++)
+			{
+				is_same_table = chunks[i]->GetHash() == m_file_table[i];
+			}
+
+			if (is_same_table)
+				return true;
+		}
+
+		// Measure the data that an incremental save would append, against the data that would still be in use
+		uint64_t size_live		= WorldFormat::header_size + table_size;
+		uint64_t size_append	= table_size;
+		unordered_set<uint64_t> hashes;
+		for (const auto& chunk : chunks)
+		{
+			if (!hashes.emplace(chunk->GetHash()).second)
+				continue;
+
+			size_live	+= chunk->GetSize();
+			size_append	+= m_file_chunks.count(chunk->GetHash()) ? 0 : chunk->GetSize();
+		}
+
+		// Append what changed, unless the file has accumulated too much stale data, in which case it's rewritten (compacted)
+		const auto is_incremental = is_same_file && (m_file_size + size_append) <= size_live * WorldFormat::compaction_ratio;
+
+		auto file = make_unique<FileStream>(file_path, is_incremental ? (FileStream_Read | FileStream_Write) : FileStream_Write);
+		if (!file->IsOpen())
+			return false;
+
+		// Header, when appending, the previous table of contents stays in effect until the header is patched (at the end)
+		uint64_t offset = is_incremental ? m_file_size : WorldFormat::header_size;
+		if (is_incremental)
+		{
+			file->Seek(offset);
+		}
+		else
+		{
+			file->Write(WorldFormat::magic);
+			file->Write(WorldFormat::version);
+			file->Write(size_live - table_size);
+		}
+
+		// Chunks
+		unordered_map<uint64_t, uint64_t> offsets;
+		for (auto& chunk : chunks)
+		{
+			// Already written (identical chunks are only stored once)
+			auto it = offsets.find(chunk->GetHash());
+			if (it != offsets.end())
+			{
+				chunk->SetOffset(it->second);
+				continue;
+			}
+
+			// Already in the file
+			auto it_file = m_file_chunks.find(chunk->GetHash());
+			if (is_incremental && it_file != m_file_chunks.end())
+			{
+				chunk->SetOffset(it_file->second);
+			}
+			else
+			{
+				chunk->SetOffset(offset);
+				file->Write(chunk->GetData().data(), chunk->GetSize());
+				offset += chunk->GetSize();
+			}
+
+			offsets[chunk->GetHash()] = chunk->GetOffset();
+		}
+
+		// Table of contents
+		const auto table_offset = offset;
+		file->Write(static_cast<uint32_t>(chunks.size()));
+		for (const auto& chunk : chunks)
+		{
+			chunk->WriteEntry(file.get());
+		}
+
+		// Point the header to the new table of contents
+		if (is_incremental)
+		{
+			file->Seek(sizeof(uint32_t) * 2);
+			file->Write(table_offset);
+		}
+		file->Close();
+
+		// Remember the file's layout, so the next save can be incremental
+		m_file_path		= file_path;
+		m_file_size		= table_offset + table_size;
+		m_file_chunks	= move(offsets);
+		m_file_table.clear();
+		for (const auto& chunk : chunks)
+		{
+			m_file_table.emplace_back(chunk->GetHash());
+		}
+
+		LOG_INFO("%s \"%s\", %llu bytes written", is_incremental ? "Appended to" : "Rewrote", file_path.c_str(), is_incremental ? size_append : m_file_size);
+
+		return true;
+	}
+
+	bool World::LoadChunks(FileStream* file, const string& file_path)
+	{
+		const auto version = file->ReadAs<uint32_t>();
+		if (version != WorldFormat::version)
+		{
+			LOG_ERROR("Unsupported world format version (%d)", version);
+			return false;
+		}
+
+		// Table of contents
+		const auto table_offset = file->ReadAs<uint64_t>();
+		file->Seek(table_offset);
+
+		vector<WorldChunk> chunks(file->ReadAs<uint32_t>());
+		for (auto& chunk : chunks)
+		{
+			chunk.ReadEntry(file);
+		}
+		const auto chunk_count = static_cast<uint32_t>(chunks.size());
+		ProgressReport::Get().SetJobCount(g_progress_world, static_cast<int>(chunk_count));
+
+		// Read and decode the chunks in parallel, every thread uses it's own file handle
+		atomic<bool> failed = false;
+		auto decode = [this, &file_path, &chunks, &failed](uint32_t start, uint32_t end)
+		{
+			if (start == end)
+				return;
+
+			FileStream stream(file_path, FileStream_Read);
+			for (uint32_t i = start; i < end; i++)
+			{
+				if (!stream.IsOpen() || !chunks[i].Load(&stream, m_context))
+				{
+					failed = true;
+					return;
+				}
+			}
+		};
+		m_context->GetSubsystem<Threading>()->Loop(decode, chunk_count);
+
+		if (failed)
+			return false;
+
+		// Add the decoded entities to the world and attach their components in one batch
+		WorldChunk::Commit(chunks, this);
+		ProgressReport::Get().SetJobsDone(g_progress_world, static_cast<int>(chunk_count));
+
+		// Remember the file's layout, so the next save can be incremental
+		m_file_path = file_path;
+		m_file_size = table_offset + WorldFormat::GetTableSize(chunk_count);
+		for (const auto& chunk : chunks)
+		{
+			m_file_chunks[chunk.GetHash()] = chunk.GetOffset();
+			m_file_table.emplace_back(chunk.GetHash());
+		}
+
+		return true;
+	}
+
+	bool World::LoadLegacy(FileStream* file)
+	{
 		// Load root entity count
-        const auto root_entity_count = file->ReadAs<uint32_t>();
+		const auto root_entity_count = file->ReadAs<uint32_t>();
 
 		ProgressReport::Get().SetJobCount(g_progress_world, root_entity_count);
 
@@ -255,22 +486,16 @@ namespace Spartan
 		// Serialize root entities
 		for (uint32_t i = 0; i < root_entity_count; i++)
 		{
-			m_entities[i]->Deserialize(file.get(), nullptr);
+			m_entities[i]->Deserialize(file, nullptr);
 			ProgressReport::Get().IncrementJobsDone(g_progress_world);
 		}
 
-		m_is_dirty	= true;
-		m_state		= Ticking;
-		ProgressReport::Get().SetIsLoading(g_progress_world, false);	
-		LOG_INFO("Loading took %.2f ms", timer.GetElapsedTimeMs());
-
-		FIRE_EVENT(Event_World_Loaded);
 		return true;
 	}
 
     shared_ptr<Entity>& World::EntityCreate(bool is_active /*= true*/)
     {
-        auto& entity = m_entities.emplace_back(make_shared<Entity>(m_context));
+        auto& entity = SlotAcquire(make_shared<Entity>(m_context));
         entity->SetActive(is_active);
         return entity;
     }
@@ -282,7 +507,11 @@ namespace Spartan
 		if (!entity)
 			return empty;
 
-		return m_entities.emplace_back(entity);
+        // Already part of the world
+        if (EntityExists(entity->GetHandle()))
+            return m_entities[m_slots[entity->GetHandle().index].index_dense];
+
+		return SlotAcquire(entity);
 	}
 
 	bool World::EntityExists(const shared_ptr<Entity>& entity)
@@ -290,9 +519,14 @@ namespace Spartan
 		if (!entity)
 			return false;
 
-		return EntityGetById(entity->GetId()) != nullptr;
+		return EntityGetByHandle(entity->GetHandle()) == entity;
 	}
 
+    bool World::EntityExists(const EntityHandle& handle) const
+    {
+        return handle.IsValid() && handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+    }
+
 	void World::EntityRemove(const shared_ptr<Entity>& entity)
 	{
 		if (!entity)
@@ -301,6 +535,7 @@ namespace Spartan
         // Mark for destruction but don't delete now
 	    // as the Renderer might still be using it.
         entity->MarkForDestruction();
+        entity->MakeDirty();
         m_is_dirty = true;
 	}
 
@@ -332,46 +567,142 @@ namespace Spartan
 
 	const shared_ptr<Entity>& World::EntityGetById(const uint32_t id)
 	{
-		for (const auto& entity : m_entities)
-		{
-			if (entity->GetId() == id)
-				return entity;
-		}
+        const auto it = m_slot_by_id.find(id);
+        if (it != m_slot_by_id.end())
+            return m_entities[m_slots[it->second].index_dense];
 
         static shared_ptr<Entity> empty;
 		return empty;
 	}
 
-    // Removes an entity and all of it's children
-    void World::_EntityRemove(const std::shared_ptr<Entity>& entity)
+    const shared_ptr<Entity>& World::EntityGetByHandle(const EntityHandle& handle)
     {
-        // Remove any descendants
-        auto children = entity->GetTransform_PtrRaw()->GetChildren();
-        for (const auto& child : children)
+        if (EntityExists(handle))
+            return m_entities[m_slots[handle.index].index_dense];
+
+        static shared_ptr<Entity> empty;
+        return empty;
+    }
+
+    void World::EntitiesRemovePending()
+    {
+        // Descendants of an entity that is pending destruction, are pending destruction as well. Only walk the hierarchies
+        // of the top-most entities that are pending destruction, so that every descendant is visited once.
+        vector<Transform*> descendants;
+        vector<Transform*> parents;
+        bool any_pending = false;
+        for (const auto& entity : m_entities)
         {
-            EntityRemove(child->GetEntity_PtrShared());
+            if (!entity->IsPendingDestruction())
+                continue;
+
+            any_pending = true;
+
+            Transform* parent = entity->GetTransform_PtrRaw()->GetParent();
+            if (parent && parent->GetEntity_PtrRaw()->IsPendingDestruction())
+                continue;
+
+            descendants.clear();
+            entity->GetTransform_PtrRaw()->GetDescendants(&descendants);
+            for (Transform* descendant : descendants)
+            {
+                descendant->GetEntity_PtrRaw()->MarkForDestruction();
+            }
+
+            // Surviving parents have to forget about their destroyed children
+            if (parent)
+            {
+                parents.emplace_back(parent);
+            }
         }
 
-        // Keep a reference to it's parent (in case it has one)
-        auto parent = entity->GetTransform_PtrRaw()->GetParent();
+        if (!any_pending)
+            return;
 
-        // Remove this entity
-        for (auto it = m_entities.begin(); it < m_entities.end();)
+        sort(parents.begin(), parents.end());
+        parents.erase(unique(parents.begin(), parents.end()), parents.end());
+        for (Transform* parent : parents)
         {
-            const auto temp = *it;
-            if (temp->GetId() == entity->GetId())
+            if (!parent->GetEntity_PtrRaw()->IsPendingDestruction())
             {
-                it = m_entities.erase(it);
-                break;
+                parent->RemoveChildrenPendingDestruction();
             }
-            ++it;
         }
 
-        // If there was a parent, update it
-        if (parent)
+        // Swap and pop
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_entities.size());)
+        {
+            if (m_entities[i]->IsPendingDestruction())
+            {
+                SlotRelease(i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+
+    shared_ptr<Entity>& World::SlotAcquire(const shared_ptr<Entity>& entity)
+    {
+        uint32_t index;
+        if (!m_slots_free.empty())
         {
-            parent->AcquireChildren();
+            index = m_slots_free.back();
+            m_slots_free.pop_back();
         }
+        else
+        {
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+
+        EntitySlot& slot        = m_slots[index];
+        slot.index_dense        = static_cast<uint32_t>(m_entities.size());
+        entity->m_handle.index      = index;
+        entity->m_handle.generation = slot.generation;
+        m_slot_by_id[entity->GetId()] = index;
+
+        return m_entities.emplace_back(entity);
+    }
+
+    void World::SlotRelease(const uint32_t index_dense)
+    {
+        shared_ptr<Entity>& entity  = m_entities[index_dense];
+        const uint32_t index        = entity->m_handle.index;
+
+        // Invalidate any outstanding handles
+        EntitySlot& slot = m_slots[index];
+        slot.generation  = (slot.generation == numeric_limits<uint32_t>::max()) ? 1 : slot.generation + 1;
+        m_slots_free.emplace_back(index);
+
+        const auto it = m_slot_by_id.find(entity->GetId());
+        if (it != m_slot_by_id.end() && it->second == index)
+        {
+            m_slot_by_id.erase(it);
+        }
+        entity->m_handle = EntityHandle();
+
+        // Move the last entity into the hole
+        if (index_dense != m_entities.size() - 1)
+        {
+            entity = move(m_entities.back());
+            m_slots[entity->m_handle.index].index_dense = index_dense;
+        }
+        m_entities.pop_back();
+    }
+
+    void World::EntityIdChanged(Entity* entity, const uint32_t id_previous)
+    {
+        const uint32_t index = entity->GetHandle().index;
+
+        const auto it = m_slot_by_id.find(id_previous);
+        if (it != m_slot_by_id.end() && it->second == index)
+        {
+            m_slot_by_id.erase(it);
+        }
+
+        m_slot_by_id[entity->GetId()] = index;
     }
 
 	shared_ptr<Entity>& World::CreateEnvironment()
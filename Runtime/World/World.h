@@ -25,6 +25,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 #include <memory>
 #include <string>
+#include <mutex>
+#include <unordered_map>
 #include "../Core/EngineDefs.h"
 #include "../Core/ISubsystem.h"
 //=============================
@@ -32,9 +34,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace Spartan
 {
 	class Entity;
+	struct EntityHandle;
+	class FileStream;
+	class WorldChunk;
 	class Light;
 	class Input;
 	class Profiler;
+	class Scripting;
 
 	enum Scene_State
 	{
@@ -61,20 +67,40 @@ namespace Spartan
 		const auto& GetName() const { return m_name; }
         void MakeDirty() { m_is_dirty = true; }
 
+        // Thread safe, the world doesn't tick while the lock is held (e.g. by an importer adding entities from a worker)
+        std::unique_lock<std::recursive_mutex> Lock() { return std::unique_lock<std::recursive_mutex>(m_mutex_tick); }
+
 		//= Entities ===========================================================================
 		std::shared_ptr<Entity>& EntityCreate(bool is_active = true);
 		std::shared_ptr<Entity>& EntityAdd(const std::shared_ptr<Entity>& entity);
 		bool EntityExists(const std::shared_ptr<Entity>& entity);
+		bool EntityExists(const EntityHandle& handle) const;
 		void EntityRemove(const std::shared_ptr<Entity>& entity);	
 		std::vector<std::shared_ptr<Entity>> EntityGetRoots();
 		const std::shared_ptr<Entity>& EntityGetByName(const std::string& name);
 		const std::shared_ptr<Entity>& EntityGetById(uint32_t id);
+		const std::shared_ptr<Entity>& EntityGetByHandle(const EntityHandle& handle);
 		const auto& EntityGetAll() const    { return m_entities; }
 		auto EntityGetCount() const         { return static_cast<uint32_t>(m_entities.size()); }
 		//======================================================================================
 
 	private:
-        void _EntityRemove(const std::shared_ptr<Entity>& entity);
+        friend class Entity;
+
+        //= SAVING/LOADING =======================================================================
+        bool SaveChunks(const std::string& file_path, const std::vector<WorldChunk*>& chunks);
+        bool LoadChunks(FileStream* file, const std::string& file_path);
+        bool LoadLegacy(FileStream* file);
+        //======================================================================================
+
+        // Removes all the entities (and their descendants) that are pending destruction, in one pass
+        void EntitiesRemovePending();
+
+        //= SLOTS ==============================================================================
+        std::shared_ptr<Entity>& SlotAcquire(const std::shared_ptr<Entity>& entity);
+        void SlotRelease(uint32_t index_dense);
+        void EntityIdChanged(Entity* entity, uint32_t id_previous);
+        //======================================================================================
 
 		//= COMMON ENTITY CREATION ========================
 		std::shared_ptr<Entity>& CreateEnvironment();
@@ -86,9 +112,30 @@ namespace Spartan
         bool m_was_in_editor_mode   = false;
         bool m_is_dirty             = true;
         Scene_State m_state         = Ticking;	
+        std::recursive_mutex m_mutex_tick;
         Input* m_input              = nullptr;
         Profiler* m_profiler        = nullptr;
+        Scripting* m_scripting      = nullptr;
 
+        // Entities are densely packed (for iteration) and referenced by slots (for stable handles)
+        struct EntitySlot
+        {
+            uint32_t index_dense    = 0;
+            uint32_t generation     = 1;
+        };
         std::vector<std::shared_ptr<Entity>> m_entities;
+        std::vector<EntitySlot> m_slots;
+        std::vector<uint32_t> m_slots_free;
+        std::unordered_map<uint32_t, uint32_t> m_slot_by_id;
+
+        // Layout of the world file that was last saved or loaded, it allows saving only the chunks that changed
+        std::string m_file_path;
+        uint64_t m_file_size = 0;
+        std::unordered_map<uint64_t, uint64_t> m_file_chunks;  // chunk hash to offset
+        std::vector<uint64_t> m_file_table;                      // chunk hashes, in table of contents order
+
+        // The chunks that each root was last saved as, roots that aren't dirty are saved as they are, without encoding them again.
+        // An entity that's created where a removed one used to be (same address) is dirty, so it never picks up the chunks of the latter.
+        std::unordered_map<const Entity*, std::vector<WorldChunk>> m_saved_roots;
 	};
 }
@@ -0,0 +1,311 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =====================
+#include <functional>
+#include <algorithm>
+#include "WorldChunk.h"
+#include "World.h"
+#include "Entity.h"
+#include "Components/Transform.h"
+#include "../IO/FileStream.h"
+#include "../Logging/Log.h"
+#include "../Core/Hash.h"
+//================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+	// Components are attached one type at a time, in an order that satisfies their dependencies.
+	// Transforms go first (parents precede children within and across chunks), colliders have to
+	// build their shape before rigid bodies acquire it and constraints need both of their bodies.
+	static const ComponentType deserialization_order[] =
+	{
+		ComponentType_Transform,
+		ComponentType_Camera,
+		ComponentType_Light,
+		ComponentType_Environment,
+		ComponentType_Renderable,
+		ComponentType_Terrain,
+		ComponentType_AudioListener,
+		ComponentType_AudioSource,
+		ComponentType_Collider,
+		ComponentType_RigidBody,
+		ComponentType_Constraint,
+		ComponentType_Script
+	};
+	static_assert(sizeof(deserialization_order) / sizeof(ComponentType) == ComponentType_Unknown, "Every component type must be deserialized");
+
+	void WorldChunk::Encode(Entity* root, vector<WorldChunk>* chunks)
+	{
+		if (!root || !chunks)
+			return;
+
+		// Gather the hierarchy, parents before children
+		vector<Entity*> entities;
+		function<void(Entity*)> gather = [&gather, &entities](Entity* entity)
+		{
+			entities.emplace_back(entity);
+			for (const auto& child : entity->GetTransform_PtrRaw()->GetChildren())
+			{
+				if (auto child_entity = child->GetEntity_PtrRaw())
+				{
+					gather(child_entity);
+				}
+			}
+		};
+		gather(root);
+
+		// Split it into chunks
+		for (size_t start = 0; start < entities.size(); start += WorldFormat::chunk_entity_count_max)
+		{
+			const auto end = min(entities.size(), start + static_cast<size_t>(WorldFormat::chunk_entity_count_max));
+			chunks->emplace_back().EncodeEntities(vector<Entity*>(entities.begin() + start, entities.begin() + end));
+		}
+	}
+
+	void WorldChunk::EncodeEntities(const vector<Entity*>& entities)
+	{
+		m_data.clear();
+		m_entity_count = static_cast<uint32_t>(entities.size());
+		FileStream stream(&m_data);
+
+		// Entity table
+		array<vector<IComponent*>, ComponentType_Unknown> components;
+		stream.Write(m_entity_count);
+		for (const auto& entity : entities)
+		{
+			stream.Write(entity->IsActive());
+			stream.Write(entity->IsVisibleInHierarchy());
+			stream.Write(entity->GetId());
+			stream.Write(entity->GetName());
+
+			const auto& entity_components = entity->GetAllComponents();
+			stream.Write(static_cast<uint32_t>(entity_components.size()));
+			for (const auto& component : entity_components)
+			{
+				stream.Write(static_cast<uint32_t>(component->GetType()));
+				stream.Write(component->GetId());
+				components[component->GetType()].emplace_back(component.get());
+			}
+		}
+
+		// Component data, one section per type
+		uint32_t section_count = 0;
+		for (const auto& type_components : components)
+		{
+			section_count += type_components.empty() ? 0 : 1;
+		}
+		stream.Write(section_count);
+
+		vector<std::byte> section;
+		for (uint32_t type = 0; type < ComponentType_Unknown; type++)
+		{
+			if (components[type].empty())
+				continue;
+
+			section.clear();
+			{
+				FileStream stream_section(&section);
+				for (const auto& component : components[type])
+				{
+					component->Serialize(&stream_section);
+				}
+			}
+
+			stream.Write(type);
+			stream.Write(static_cast<uint32_t>(section.size()));
+			stream.Write(section.data(), section.size());
+		}
+
+		stream.Close();
+		m_size = static_cast<uint64_t>(m_data.size());
+		m_hash = Hash::Compute(m_data.data(), m_size);
+	}
+
+	void WorldChunk::WriteEntry(FileStream* stream) const
+	{
+		stream->Write(m_offset);
+		stream->Write(m_size);
+		stream->Write(m_hash);
+		stream->Write(m_entity_count);
+	}
+
+	void WorldChunk::ReadEntry(FileStream* stream)
+	{
+		stream->Read(&m_offset);
+		stream->Read(&m_size);
+		stream->Read(&m_hash);
+		stream->Read(&m_entity_count);
+	}
+
+	bool WorldChunk::Load(FileStream* stream, Context* context)
+	{
+		// Read
+		m_data.resize(m_size);
+		stream->Seek(m_offset);
+		stream->Read(m_data.data(), m_size);
+		if (stream->GetPosition() != m_offset + m_size)
+		{
+			LOG_ERROR("Failed to read chunk at offset %llu", m_offset);
+			return false;
+		}
+
+		FileStream chunk(m_data.data(), m_size);
+
+		// Entity table
+		if (chunk.ReadAs<uint32_t>() != m_entity_count)
+		{
+			LOG_ERROR("Chunk at offset %llu doesn't match the table of contents", m_offset);
+			return false;
+		}
+
+		m_entities.resize(m_entity_count);
+		for (auto& entity : m_entities)
+		{
+			chunk.Read(&entity.active);
+			chunk.Read(&entity.visible);
+			chunk.Read(&entity.id);
+			chunk.Read(&entity.name);
+
+			const auto component_count = chunk.ReadAs<uint32_t>();
+			entity.components.resize(component_count);
+			for (auto& component : entity.components)
+			{
+				const auto type = chunk.ReadAs<uint32_t>();
+				if (type >= ComponentType_Unknown)
+				{
+					LOG_ERROR("Chunk at offset %llu contains an unknown component type (%d)", m_offset, type);
+					return false;
+				}
+
+				component.first		= static_cast<ComponentType>(type);
+				component.second	= chunk.ReadAs<uint32_t>();
+			}
+		}
+
+		// Component data sections, these are deserialized later on
+		const auto section_count = chunk.ReadAs<uint32_t>();
+		for (uint32_t i = 0; i < section_count; i++)
+		{
+			const auto type		= chunk.ReadAs<uint32_t>();
+			const auto size		= chunk.ReadAs<uint32_t>();
+			const auto offset	= chunk.GetPosition();
+			if (type >= ComponentType_Unknown || offset + size > m_size)
+			{
+				LOG_ERROR("Chunk at offset %llu has an invalid component section", m_offset);
+				return false;
+			}
+
+			m_sections[type].offset	= offset;
+			m_sections[type].size	= size;
+			chunk.Seek(offset + size);
+		}
+
+		// Decode the components into entities of their own, they are added to the world when committing
+		CreateEntities(context);
+		for (uint32_t type = 0; type < ComponentType_Unknown; type++)
+		{
+			DecodeComponents(static_cast<ComponentType>(type));
+		}
+
+		// The chunk data is no longer needed
+		m_data.clear();
+		m_data.shrink_to_fit();
+
+		return true;
+	}
+
+	void WorldChunk::Commit(vector<WorldChunk>& chunks, World* world)
+	{
+		// Add all the entities first, so that any references between them (parents, constraints) can be resolved
+		for (auto& chunk : chunks)
+		{
+			for (const auto& record : chunk.m_entities)
+			{
+				world->EntityAdd(record.entity);
+			}
+		}
+
+		for (const auto type : deserialization_order)
+		{
+			for (auto& chunk : chunks)
+			{
+				chunk.AttachComponents(type);
+			}
+		}
+
+		for (auto& chunk : chunks)
+		{
+			chunk.m_entities.clear();
+			for (auto& components : chunk.m_components)
+			{
+				components.clear();
+			}
+		}
+	}
+
+	void WorldChunk::CreateEntities(Context* context)
+	{
+		for (auto& record : m_entities)
+		{
+			record.entity = make_shared<Entity>(context);
+			record.entity->SetId(record.id); // not part of the world yet, so it doesn't touch the world's id lookup
+			record.entity->SetActive(record.active);
+			record.entity->SetName(record.name);
+			record.entity->SetHierarchyVisibility(record.visible);
+
+			for (const auto& component : record.components)
+			{
+				// Not initialized, attaching takes care of that
+				if (auto instance = record.entity->AddComponent(component.first, component.second, false))
+				{
+					m_components[component.first].emplace_back(instance.get());
+				}
+			}
+		}
+	}
+
+	void WorldChunk::DecodeComponents(const ComponentType type)
+	{
+		const auto& components = m_components[type];
+		if (components.empty())
+			return;
+
+		const auto& section = m_sections[type];
+		FileStream stream(m_data.data() + section.offset, section.size);
+		for (const auto& component : components)
+		{
+			component->Decode(&stream);
+		}
+	}
+
+	void WorldChunk::AttachComponents(const ComponentType type)
+	{
+		for (const auto& component : m_components[type])
+		{
+			component->Attach();
+		}
+	}
+}
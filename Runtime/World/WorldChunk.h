@@ -0,0 +1,118 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =========================
+#include <array>
+#include <memory>
+#include <vector>
+#include <string>
+#include "Components/IComponent.h"
+//====================================
+
+namespace Spartan
+{
+	class Context;
+	class Entity;
+	class World;
+	class FileStream;
+
+	// World files are laid out as [header][chunks][table of contents]. Every root entity gets its own
+	// chunk(s) which hold an entity table followed by the component data, grouped per component type.
+	// Chunks are independent of each other, so they can be read and decoded on any thread.
+	// Chunks are content addressed (by hash), so saving can append only the ones that changed, followed
+	// by a new table of contents, and then patch the header to point to it.
+	namespace WorldFormat
+	{
+		static const uint32_t magic						= 0x44575053; // "SPWD"
+		static const uint32_t version					= 1;
+		static const uint32_t chunk_entity_count_max	= 512;
+		static const uint64_t header_size				= sizeof(uint32_t) * 2 + sizeof(uint64_t);	// magic, version, table of contents offset
+		static const uint64_t entry_size				= sizeof(uint64_t) * 3 + sizeof(uint32_t);	// offset, size, hash, entity count
+		static const uint64_t compaction_ratio			= 2;										// rewrite the file once it's this many times larger than its live data
+		inline uint64_t GetTableSize(const uint64_t chunk_count) { return sizeof(uint32_t) + entry_size * chunk_count; }
+	}
+
+	class WorldChunk
+	{
+	public:
+		//= ENCODING ==================================================================================
+		// Encodes a root entity and it's descendants, large hierarchies are split into several chunks
+		static void Encode(Entity* root, std::vector<WorldChunk>* chunks);
+		//=============================================================================================
+
+		//= TABLE OF CONTENTS =========================================================================
+		void WriteEntry(FileStream* stream) const;
+		void ReadEntry(FileStream* stream);
+		auto GetOffset() const					{ return m_offset; }
+		void SetOffset(const uint64_t offset)	{ m_offset = offset; }
+		auto GetSize() const					{ return m_size; }
+		auto GetHash() const					{ return m_hash; }
+		auto GetEntityCount() const				{ return m_entity_count; }
+		//=============================================================================================
+
+		//= DECODING ==================================================================================
+		// Reads the chunk's data and decodes it into entities that aren't part of the world yet, safe to call from any thread
+		bool Load(FileStream* stream, Context* context);
+
+		// Adds the entities of all the chunks to the world and then attaches their components, one type at a time.
+		// This touches the world, resources and physics, so it must run on the loading thread.
+		static void Commit(std::vector<WorldChunk>& chunks, World* world);
+		//=============================================================================================
+
+		const auto& GetData() const { return m_data; }
+
+	private:
+		void EncodeEntities(const std::vector<Entity*>& entities);
+		void CreateEntities(Context* context);
+		void DecodeComponents(ComponentType type);
+		void AttachComponents(ComponentType type);
+
+		struct EntityRecord
+		{
+			uint32_t id			= 0;
+			bool active			= true;
+			bool visible		= true;
+			std::string name;
+			std::vector<std::pair<ComponentType, uint32_t>> components; // type and id
+			std::shared_ptr<Entity> entity; // decoded, until it's added to the world
+		};
+
+		struct Section
+		{
+			uint64_t offset	= 0;
+			uint64_t size	= 0;
+		};
+
+		// Table of contents
+		uint64_t m_offset		= 0;
+		uint64_t m_size			= 0;
+		uint64_t m_hash			= 0;
+		uint32_t m_entity_count	= 0;
+
+		// Contents
+		std::vector<std::byte> m_data;
+		std::vector<EntityRecord> m_entities;
+		std::array<Section, ComponentType_Unknown> m_sections;
+		std::array<std::vector<IComponent*>, ComponentType_Unknown> m_components;
+	};
+}
@@ -20,8 +20,10 @@
 SOLUTION_NAME 		= "Spartan"
 EDITOR_NAME 		= "Editor"
 RUNTIME_NAME 		= "Runtime"
+BULLET_NAME			= "Bullet"
 EDITOR_DIR			= "../" .. EDITOR_NAME
 RUNTIME_DIR			= "../" .. RUNTIME_NAME
+BULLET_DIR			= "../ThirdParty/Bullet_2.88"
 LIBRARY_DIR 		= "../ThirdParty/libraries"
 DEBUG_FORMAT		= "c7"
 TARGET_DIR_RELEASE 	= "../Binaries/Release"
@@ -61,13 +63,51 @@ solution (SOLUTION_NAME)
 		symbols "Off"	
 		optimize "Full"
 
+-- Bullet --------------------------------------------------------------------------------------------------
+-- Built from source, with multi-threading (what BULLET2_MULTITHREADING does), so that physics can run on the thread pool.
+-- BT_THREADSAFE changes Bullet's headers, so anything that includes them has to define it the same way.
+project (BULLET_NAME)
+	location (BULLET_DIR)
+	objdir (INTERMEDIATE_DIR)
+	kind "StaticLib"
+	staticruntime "On"
+	warnings "Off"
+	defines{ "BT_THREADSAFE=1" }
+	
+	-- Files
+	files 
+	{ 
+		BULLET_DIR .. "/LinearMath/**.h",
+		BULLET_DIR .. "/LinearMath/**.cpp",
+		BULLET_DIR .. "/BulletCollision/**.h",
+		BULLET_DIR .. "/BulletCollision/**.cpp",
+		BULLET_DIR .. "/BulletDynamics/**.h",
+		BULLET_DIR .. "/BulletDynamics/**.cpp",
+		BULLET_DIR .. "/BulletSoftBody/**.h",
+		BULLET_DIR .. "/BulletSoftBody/**.cpp"
+	}
+
+	-- Includes
+	includedirs { BULLET_DIR }
+
+	-- 	"Debug"
+	filter "configurations:Debug"
+		targetdir (TARGET_DIR_DEBUG)
+		debugformat (DEBUG_FORMAT)
+			
+	-- 	"Release"
+	filter "configurations:Release"
+		targetdir (TARGET_DIR_RELEASE)
+
 -- Runtime -------------------------------------------------------------------------------------------------
 project (RUNTIME_NAME)
 	location (RUNTIME_DIR)
 	objdir (INTERMEDIATE_DIR)
 	kind "StaticLib"
 	staticruntime "On"
-	defines{ "SPARTAN_RUNTIME" }
+	defines{ "SPARTAN_RUNTIME", "BT_THREADSAFE=1" } -- has to match the Bullet project
+	links { BULLET_NAME }
+	dependson { BULLET_NAME }
 	
 	-- Files
 	files 
@@ -84,7 +124,7 @@ project (RUNTIME_NAME)
 	includedirs { "../ThirdParty/Vulkan_1.1.121.2" }
 	includedirs { "../ThirdParty/AngelScript_2.33.0" }
 	includedirs { "../ThirdParty/Assimp_5.0.0" }
-	includedirs { "../ThirdParty/Bullet_2.88" }
+	includedirs { BULLET_DIR }
 	includedirs { "../ThirdParty/FMOD_1.10.10" }
 	includedirs { "../ThirdParty/FreeImage_3.18.0" }
 	includedirs { "../ThirdParty/FreeType_2.10.0" }
@@ -104,7 +144,6 @@ project (RUNTIME_NAME)
 		links { "fmodL64_vc" }
 		links { "FreeImageLib_debug" }
 		links { "freetype_debug" }
-		links { "BulletCollision_debug", "BulletDynamics_debug", "BulletSoftBody_debug", "LinearMath_debug" }
 		links { "pugixml_debug" }
 		links { "IrrXML_debug" }
 			
@@ -118,14 +157,13 @@ project (RUNTIME_NAME)
 		links { "fmod64_vc" }
 		links { "FreeImageLib" }
 		links { "freetype" }
-		links { "BulletCollision", "BulletDynamics", "BulletSoftBody", "LinearMath" }
 		links { "pugixml" }
 		links { "IrrXML" }
 
 -- Editor --------------------------------------------------------------------------------------------------
 project (EDITOR_NAME)
 	location (EDITOR_DIR)
-	links { RUNTIME_NAME }
+	links { RUNTIME_NAME, BULLET_NAME }
 	dependson { RUNTIME_NAME }
 	objdir (INTERMEDIATE_DIR)
 	kind "WindowedApp"